@@ -1,7 +1,9 @@
 # Set Fortran compiler flags specific to the GNU Compiler
 # -ffree-line-length-none: Remove the limit on the length of lines in the source file
+# -fopenmp-simd: Honor `!$omp simd` directives without linking the OpenMP runtime
 set(FORTRAN_COMPILER_GNU_FLAGS
     $<$<COMPILE_LANGUAGE:Fortran>:-ffree-line-length-none>
+    $<$<COMPILE_LANGUAGE:Fortran>:-fopenmp-simd>
 )
 
 # Set Fortran compiler flags specific to the GNU Compiler and Linux OS.
@@ -21,8 +23,10 @@ set(FORTRAN_COMPILER_GNU_DEBUG_FLAGS
 
 # Set Fortran compiler flags for the Intel Compiler
 # -mcmodel=medium: Allow for larger datasets in memory
+# -qopenmp-simd: Honor `!$omp simd` directives without linking the OpenMP runtime
 set(FORTRAN_COMPILER_INTEL_FLAGS
     $<$<COMPILE_LANGUAGE:Fortran>:-mcmodel=medium>
+    $<$<COMPILE_LANGUAGE:Fortran>:-qopenmp-simd>
 )
 
 # Set Debugging Fortran compiler flags for the Intel Compiler
@@ -33,4 +37,17 @@ set(FORTRAN_COMPILER_INTEL_FLAGS
 # -fpe0: Stop execution when a floating-point exception occurs
 set(FORTRAN_COMPILER_INTEL_DEBUG_FLAGS
     $<$<COMPILE_LANGUAGE:Fortran>:-check uninit -ftrapuv -g -traceback -fpe0>
-)
\ No newline at end of file
+)
+# Set C++ compiler flags for the GNU and Clang Compilers
+# -fopenmp-simd: Honor `#pragma omp simd` directives without linking the OpenMP runtime
+# -fno-math-errno: Let math functions be inlined and vectorized, they do not need to set errno
+set(CXX_COMPILER_GNU_FLAGS
+    $<$<COMPILE_LANGUAGE:CXX>:-fopenmp-simd>
+    $<$<COMPILE_LANGUAGE:CXX>:-fno-math-errno>
+)
+
+# Set C++ compiler flags for the Intel Compiler
+# -qopenmp-simd: Honor `#pragma omp simd` directives without linking the OpenMP runtime
+set(CXX_COMPILER_INTEL_FLAGS
+    $<$<COMPILE_LANGUAGE:CXX>:-qopenmp-simd>
+)
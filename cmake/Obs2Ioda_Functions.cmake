@@ -82,6 +82,7 @@ endfunction()
 #    relative to the target's installation directory.
 # * Links the provided public libraries to the target using `target_link_libraries`.
 # * Sets the include directories for the target using `target_include_directories`.
+# * Sets compiler-specific options, e.g. to honor `#pragma omp simd` directives.
 #
 # This setup ensures that the target is correctly linked with its public dependencies and that
 # runtime shared library paths are properly configured for relocatable installations, and that the target
@@ -90,4 +91,9 @@ function(obs2ioda_cxx_library target include_dirs public_link_libraries)
     set_target_properties(${target} PROPERTIES INSTALL_RPATH "\$ORIGIN/../${CMAKE_INSTALL_LIBDIR}")
     target_link_libraries(${target} PUBLIC ${public_link_libraries})
     target_include_directories(${target} PUBLIC ${include_dirs})
+    if (CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+        target_compile_options(${target} PRIVATE ${CXX_COMPILER_GNU_FLAGS})
+    elseif (CMAKE_CXX_COMPILER_ID MATCHES Intel)
+        target_compile_options(${target} PRIVATE ${CXX_COMPILER_INTEL_FLAGS})
+    endif ()
 endfunction()
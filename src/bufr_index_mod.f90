@@ -0,0 +1,461 @@
+module bufr_index_mod
+
+! Index of the messages of a BUFR file built from the section headers only.
+!
+! The scan reads section 0, 1 and 3 of each message (a few dozen bytes per
+! message) with stream access and jumps to the next one, so it is much faster
+! than reading the file with ireadmg. For each data message it records the
+! offset and length, the NCEP message type (NCcccsss from the data category
+! and local subcategory), the message date and the number of subsets. BUFR
+! table messages (data category 11), which ireadmg skips, are not indexed, so
+! message i of the index is the i-th message returned by ireadmg.
+!
+! The index is cached in <file>.idx next to the input and reused as long as
+! the size of the input and a checksum of its first and last bytes are
+! unchanged, and the last indexed message is still a whole BUFR message at
+! its offset. Satellite IDs are only stored in the
+! data section of each subset and are not part of the index.
+!
+! Readers use the index to select messages by type and to split the messages
+! of one file into contiguous ranges of about equal numbers of subsets, one
+! per MPI rank.
+
+use kinds, only: i_kind, i_llong
+
+implicit none
+private
+public :: bufr_msg_type
+public :: bufr_index_type
+public :: bufr_index_build
+public :: bufr_index_scan
+public :: bufr_index_range
+public :: bufr_index_matches
+
+type bufr_msg_type
+   integer(i_llong)  :: offset      ! zero-based offset of 'BUFR' in the file
+   integer(i_kind)   :: length      ! total length of the message in bytes
+   integer(i_kind)   :: edition
+   integer(i_kind)   :: category    ! data category
+   integer(i_kind)   :: subcategory ! local data subcategory
+   integer(i_kind)   :: idate       ! ccyymmddhh of section 1
+   integer(i_kind)   :: minute
+   integer(i_kind)   :: nsubsets
+   character(len=8)  :: subset      ! NCEP message type, NCcccsss
+end type bufr_msg_type
+
+type bufr_index_type
+   integer(i_llong)                                :: file_size = -1
+   integer(i_kind)                                 :: nmsg = 0
+   type(bufr_msg_type), allocatable, dimension(:) :: msg
+end type bufr_index_type
+
+character(len=*), parameter :: cache_magic   = 'obs2ioda-bufr-index'
+integer(i_kind),  parameter :: cache_version = 2
+integer(i_kind),  parameter :: checksum_bytes = 4096
+integer(i_kind),  parameter :: category_table = 11
+integer(i_kind),  parameter :: scan_chunk = 65536
+
+contains
+
+!--------------------------------------------------------------
+
+subroutine bufr_index_build(filename, bindex, iret, write_cache)
+
+! read the cached index of filename, or scan the file and cache its index
+
+   implicit none
+
+   character(len=*),      intent(in)  :: filename
+   type(bufr_index_type), intent(out) :: bindex
+   integer(i_kind),       intent(out) :: iret
+   logical, optional,     intent(in)  :: write_cache  ! default .true.
+
+   integer(i_llong) :: file_size, checksum
+   logical          :: fexist
+
+   inquire(file=trim(filename), exist=fexist, size=file_size)
+   if ( .not. fexist .or. file_size < 0 ) then
+      iret = -1
+      return
+   end if
+
+   call file_checksum(filename, file_size, checksum, iret)
+   if ( iret /= 0 ) return
+
+   call read_cache(trim(filename)//'.idx', file_size, checksum, bindex, iret)
+   if ( iret == 0 ) then
+      if ( last_message_valid(filename, bindex) ) return
+      deallocate (bindex%msg)
+      bindex%nmsg = 0
+   end if
+
+   call bufr_index_scan(filename, bindex, iret)
+   if ( iret /= 0 ) return
+
+   if ( present(write_cache) ) then
+      if ( .not. write_cache ) return
+   end if
+   call write_cache_file(trim(filename)//'.idx', checksum, bindex)
+
+end subroutine bufr_index_build
+
+!--------------------------------------------------------------
+
+subroutine bufr_index_scan(filename, bindex, iret)
+
+! scan the section headers of all messages of filename
+
+   implicit none
+
+   character(len=*),      intent(in)  :: filename
+   type(bufr_index_type), intent(out) :: bindex
+   integer(i_kind),       intent(out) :: iret
+
+   character(len=scan_chunk)          :: chunk
+   character(len=32)                  :: sec
+   type(bufr_msg_type), allocatable   :: msg(:), tmp(:)
+   type(bufr_msg_type)                :: m
+   integer(i_llong)                   :: file_size, pos, nread
+   integer(i_kind)                    :: iunit, iost, nmsg, ibufr, len1, len2, ioff, flag, year
+
+   inquire(file=trim(filename), size=file_size)
+   open(newunit=iunit, file=trim(filename), access='stream', form='unformatted', &
+        status='old', action='read', iostat=iost)
+   if ( iost /= 0 ) then
+      iret = iost
+      return
+   end if
+
+   nmsg = 0
+   allocate (msg(1024))
+   pos = 0
+   scan_loop: do while ( pos + 8 <= file_size )
+
+      ! find the next 'BUFR', skipping record markers and padding between messages
+      nread = min(int(scan_chunk, i_llong), file_size - pos)
+      read(iunit, pos=pos+1, iostat=iost) chunk(1:nread)
+      if ( iost /= 0 ) exit scan_loop
+      ibufr = index(chunk(1:nread), 'BUFR')
+      if ( ibufr == 0 ) then
+         ! keep 3 bytes in case 'BUFR' straddles two chunks
+         pos = pos + max(nread - 3, 1_i_llong)
+         cycle scan_loop
+      end if
+      pos = pos + ibufr - 1
+      if ( pos + 8 > file_size ) exit scan_loop
+
+      ! section 0: 'BUFR', total length, edition
+      read(iunit, pos=pos+1, iostat=iost) sec(1:8)
+      if ( iost /= 0 ) exit scan_loop
+      m%offset  = pos
+      m%length  = octets(sec, 5, 3)
+      m%edition = octets(sec, 8, 1)
+      if ( m%length < 8 .or. pos + m%length > file_size .or. m%edition < 2 ) then
+         pos = pos + 4
+         cycle scan_loop
+      end if
+
+      ! section 1
+      ioff = 8
+      read(iunit, pos=pos+ioff+1, iostat=iost) sec(1:22)
+      if ( iost /= 0 ) exit scan_loop
+      len1 = octets(sec, 1, 3)
+      if ( m%edition >= 4 ) then
+         flag          = octets(sec, 10, 1)
+         m%category    = octets(sec, 11, 1)
+         m%subcategory = octets(sec, 13, 1)
+         year          = octets(sec, 16, 2)
+         m%idate       = ((year * 100 + octets(sec, 18, 1)) * 100 + octets(sec, 19, 1)) * 100 + octets(sec, 20, 1)
+         m%minute      = octets(sec, 21, 1)
+      else
+         flag          = octets(sec, 8, 1)
+         m%category    = octets(sec, 9, 1)
+         m%subcategory = octets(sec, 10, 1)
+         ! year of century, 100 is 2000
+         year          = octets(sec, 13, 1)
+         year          = merge(1900 + year, 2000 + mod(year, 100), year > 50 .and. year < 100)
+         m%idate       = ((year * 100 + octets(sec, 14, 1)) * 100 + octets(sec, 15, 1)) * 100 + octets(sec, 16, 1)
+         m%minute      = octets(sec, 17, 1)
+      end if
+      ioff = ioff + len1
+
+      ! optional section 2
+      if ( btest(flag, 7) ) then
+         read(iunit, pos=pos+ioff+1, iostat=iost) sec(1:3)
+         if ( iost /= 0 ) exit scan_loop
+         len2 = octets(sec, 1, 3)
+         ioff = ioff + len2
+      end if
+
+      ! section 3: number of subsets
+      read(iunit, pos=pos+ioff+1, iostat=iost) sec(1:7)
+      if ( iost /= 0 ) exit scan_loop
+      m%nsubsets = octets(sec, 5, 2)
+      write(m%subset, '(a2,i3.3,i3.3)') 'NC', m%category, m%subcategory
+
+      if ( m%category /= category_table ) then
+         nmsg = nmsg + 1
+         if ( nmsg > size(msg) ) then
+            allocate (tmp(2*size(msg)))
+            tmp(1:size(msg)) = msg
+            call move_alloc(tmp, msg)
+         end if
+         msg(nmsg) = m
+      end if
+
+      pos = pos + m%length
+
+   end do scan_loop
+   close(iunit)
+
+   bindex%file_size = file_size
+   bindex%nmsg = nmsg
+   allocate (bindex%msg(nmsg))
+   bindex%msg(:) = msg(1:nmsg)
+   deallocate (msg)
+   iret = 0
+
+end subroutine bufr_index_scan
+
+!--------------------------------------------------------------
+
+subroutine bufr_index_range(bindex, irank, nrank, imsg_first, imsg_last, wanted)
+
+! the messages of rank irank (0-based) of nrank
+!
+! The wanted messages (default all) are split into contiguous ranges of about
+! the same number of subsets. A rank without messages gets imsg_first > imsg_last.
+
+   implicit none
+
+   type(bufr_index_type),                    intent(in)  :: bindex
+   integer(i_kind),                          intent(in)  :: irank
+   integer(i_kind),                          intent(in)  :: nrank
+   integer(i_kind),                          intent(out) :: imsg_first
+   integer(i_kind),                          intent(out) :: imsg_last
+   character(len=*), dimension(:), optional, intent(in)  :: wanted
+
+   integer(i_llong) :: total, cum
+   integer(i_kind)  :: i, owner
+   logical          :: mask(bindex%nmsg)
+
+   mask(:) = .true.
+   if ( present(wanted) ) then
+      do i = 1, bindex%nmsg
+         mask(i) = any(wanted == bindex%msg(i)%subset)
+      end do
+   end if
+
+   imsg_first = bindex%nmsg + 1
+   imsg_last  = 0
+   total = sum(int(max(bindex%msg(:)%nsubsets, 1), i_llong), mask=mask)
+   if ( total == 0 ) return
+
+   ! a message belongs to the rank its first subset falls on
+   cum = 0
+   do i = 1, bindex%nmsg
+      if ( .not. mask(i) ) cycle
+      owner = int((cum * nrank) / total, i_kind)
+      cum = cum + max(bindex%msg(i)%nsubsets, 1)
+      if ( owner /= irank ) cycle
+      imsg_first = min(imsg_first, i)
+      imsg_last  = i
+   end do
+
+end subroutine bufr_index_range
+
+!--------------------------------------------------------------
+
+logical function bufr_index_matches(bindex, imsg, subset)
+
+! whether the imsg-th message returned by ireadmg, of type subset, is message imsg of the index
+
+   implicit none
+
+   type(bufr_index_type), intent(in) :: bindex
+   integer(i_kind),       intent(in) :: imsg
+   character(len=*),      intent(in) :: subset
+
+   bufr_index_matches = .false.
+   if ( imsg < 1 .or. imsg > bindex%nmsg ) return
+   bufr_index_matches = bindex%msg(imsg)%subset == subset
+
+end function bufr_index_matches
+
+!--------------------------------------------------------------
+
+subroutine read_cache(fname, file_size, checksum, bindex, iret)
+
+   implicit none
+
+   character(len=*),      intent(in)  :: fname
+   integer(i_llong),      intent(in)  :: file_size
+   integer(i_llong),      intent(in)  :: checksum
+   type(bufr_index_type), intent(out) :: bindex
+   integer(i_kind),       intent(out) :: iret
+
+   character(len=len(cache_magic)) :: magic
+   character(len=8)                :: trailer
+   integer(i_llong)                :: cached_size, cached_checksum
+   integer(i_kind)                 :: iunit, version, nmsg, i
+
+   open(newunit=iunit, file=trim(fname), status='old', form='formatted', action='read', iostat=iret)
+   if ( iret /= 0 ) return
+
+   read(iunit, *, iostat=iret) magic, version, cached_size, cached_checksum, nmsg
+   if ( iret == 0 ) then
+      if ( magic /= cache_magic .or. version /= cache_version .or. cached_size /= file_size .or. &
+           cached_checksum /= checksum ) iret = -1
+   end if
+   if ( iret == 0 ) then
+      allocate (bindex%msg(nmsg))
+      do i = 1, nmsg
+         read(iunit, *, iostat=iret) bindex%msg(i)
+         if ( iret /= 0 ) exit
+      end do
+   end if
+   ! a cache written concurrently by another process may be incomplete
+   if ( iret == 0 ) then
+      read(iunit, *, iostat=iret) trailer
+      if ( iret == 0 .and. trailer /= 'end' ) iret = -1
+   end if
+   close(iunit)
+
+   if ( iret == 0 ) then
+      bindex%file_size = cached_size
+      bindex%nmsg = nmsg
+   else if ( allocated(bindex%msg) ) then
+      deallocate (bindex%msg)
+   end if
+
+end subroutine read_cache
+
+!--------------------------------------------------------------
+
+subroutine write_cache_file(fname, checksum, bindex)
+
+! best effort: the input directory may not be writable
+
+   implicit none
+
+   character(len=*),      intent(in) :: fname
+   integer(i_llong),      intent(in) :: checksum
+   type(bufr_index_type), intent(in) :: bindex
+
+   integer(i_kind) :: iunit, iost, i
+
+   open(newunit=iunit, file=trim(fname), status='replace', form='formatted', action='write', iostat=iost)
+   if ( iost /= 0 ) return
+
+   write(iunit, '(a,4(1x,i0))', iostat=iost) cache_magic, cache_version, bindex%file_size, checksum, bindex%nmsg
+   do i = 1, bindex%nmsg
+      if ( iost /= 0 ) exit
+      write(iunit, '(i0,6(1x,i0),1x,i0,1x,a)', iostat=iost) bindex%msg(i)%offset, bindex%msg(i)%length, &
+         bindex%msg(i)%edition, bindex%msg(i)%category, bindex%msg(i)%subcategory, bindex%msg(i)%idate, &
+         bindex%msg(i)%minute, bindex%msg(i)%nsubsets, bindex%msg(i)%subset
+   end do
+   if ( iost == 0 ) write(iunit, '(a)', iostat=iost) 'end'
+   close(iunit)
+
+end subroutine write_cache_file
+
+!--------------------------------------------------------------
+
+subroutine file_checksum(filename, file_size, checksum, iret)
+
+! Adler-32 of the first and last checksum_bytes of filename
+!
+! A file rewritten with the same size, e.g. the next cycle of a feed under a
+! fixed name, changes at least the dates in the headers of its first and last
+! messages.
+
+   implicit none
+
+   character(len=*), intent(in)  :: filename
+   integer(i_llong), intent(in)  :: file_size
+   integer(i_llong), intent(out) :: checksum
+   integer(i_kind),  intent(out) :: iret
+
+   character(len=checksum_bytes) :: buf
+   integer(i_llong)              :: a, b, pos, nread
+   integer(i_kind)               :: iunit, ipart, i
+
+   open(newunit=iunit, file=trim(filename), access='stream', form='unformatted', &
+        status='old', action='read', iostat=iret)
+   if ( iret /= 0 ) return
+
+   a = 1
+   b = 0
+   do ipart = 1, 2
+      nread = min(int(checksum_bytes, i_llong), file_size)
+      pos = merge(0_i_llong, file_size - nread, ipart == 1)
+      if ( nread == 0 ) exit
+      read(iunit, pos=pos+1, iostat=iret) buf(1:nread)
+      if ( iret /= 0 ) exit
+      do i = 1, int(nread, i_kind)
+         a = mod(a + ichar(buf(i:i)), 65521_i_llong)
+         b = mod(b + a, 65521_i_llong)
+      end do
+   end do
+   close(iunit)
+   checksum = b * 65536 + a
+
+end subroutine file_checksum
+
+!--------------------------------------------------------------
+
+logical function last_message_valid(filename, bindex)
+
+! whether the last indexed message of filename still starts with 'BUFR' and
+! its length, and ends with '7777'
+
+   implicit none
+
+   character(len=*),      intent(in) :: filename
+   type(bufr_index_type), intent(in) :: bindex
+
+   character(len=8) :: sec
+   character(len=4) :: trailer
+   integer(i_kind)  :: iunit, iost
+
+   last_message_valid = .true.
+   if ( bindex%nmsg == 0 ) return
+
+   last_message_valid = .false.
+   associate ( m => bindex%msg(bindex%nmsg) )
+      if ( m%offset + m%length > bindex%file_size ) return
+      open(newunit=iunit, file=trim(filename), access='stream', form='unformatted', &
+           status='old', action='read', iostat=iost)
+      if ( iost /= 0 ) return
+      read(iunit, pos=m%offset+1, iostat=iost) sec
+      if ( iost == 0 ) read(iunit, pos=m%offset+m%length-3, iostat=iost) trailer
+      close(iunit)
+      if ( iost /= 0 ) return
+      last_message_valid = sec(1:4) == 'BUFR' .and. octets(sec, 5, 3) == m%length .and. trailer == '7777'
+   end associate
+
+end function last_message_valid
+
+!--------------------------------------------------------------
+
+pure function octets(buf, istart, n) result(val)
+
+! big-endian unsigned integer of n octets starting at octet istart
+
+   implicit none
+
+   character(len=*), intent(in) :: buf
+   integer(i_kind),  intent(in) :: istart
+   integer(i_kind),  intent(in) :: n
+   integer(i_kind)              :: val
+
+   integer(i_kind) :: i
+
+   val = 0
+   do i = istart, istart + n - 1
+      val = val * 256 + ichar(buf(i:i))
+   end do
+
+end function octets
+
+end module bufr_index_mod
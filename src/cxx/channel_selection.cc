@@ -0,0 +1,102 @@
+#include "channel_selection.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace Obs2Ioda {
+
+    ChannelSelection &ChannelSelection::getInstance() {
+        static ChannelSelection instance;
+        return instance;
+    }
+
+    /**
+     * @brief Appends a channel number or a `"first-last"` range to `channels`.
+     */
+    static void addChannels(const std::string &instrument, const YAML::Node &entry, std::vector<int> &channels) {
+        const auto text = entry.as<std::string>();
+        size_t end = 0;
+        int first = -1;
+        int last = -1;
+        try {
+            first = std::stoi(text, &end);
+            last = first;
+            if (end < text.size() && text[end] == '-') {
+                size_t lastEnd = 0;
+                last = std::stoi(text.substr(end + 1), &lastEnd);
+                end += 1 + lastEnd;
+            }
+        } catch (std::exception &) {
+            end = 0;
+        }
+        if (end == 0 || end != text.size() || first < 1 || last < first) {
+            throw std::invalid_argument("invalid channel " + text + " of " + instrument);
+        }
+        for (int channel = first; channel <= last; channel++) {
+            channels.push_back(channel);
+        }
+    }
+
+    void ChannelSelection::load(const YAML::Node &node) {
+        std::map<std::string, std::vector<int> > loaded;
+        const auto channelsNode = node["channels"];
+        if (channelsNode && !channelsNode.IsNull() && !channelsNode.IsMap()) {
+            throw std::invalid_argument("channels of the channel selection must be a map");
+        }
+        for (const auto &entry: channelsNode) {
+            const auto instrument = entry.first.as<std::string>();
+            auto &channels = loaded[instrument];
+            if (entry.second.IsSequence()) {
+                for (const auto &item: entry.second) {
+                    addChannels(instrument, item, channels);
+                }
+            } else {
+                addChannels(instrument, entry.second, channels);
+            }
+            std::sort(channels.begin(), channels.end());
+            channels.erase(std::unique(channels.begin(), channels.end()), channels.end());
+        }
+        selections = std::move(loaded);
+    }
+
+    void ChannelSelection::clear() {
+        selections.clear();
+    }
+
+    const std::vector<int> *ChannelSelection::find(const std::string &instrument) const {
+        auto it = selections.find(instrument);
+        if (it == selections.end()) {
+            it = selections.find(instrument.substr(0, instrument.find('_')));
+        }
+        return it == selections.end() ? nullptr : &it->second;
+    }
+
+    static int channelSelectionErrorMessage(const std::exception &e, int lineNumber, const char *fileName) {
+        std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+        return -1;
+    }
+
+    int channelSelectionLoad(const char *path) {
+        try {
+            ChannelSelection::getInstance().load(YAML::LoadFile(path));
+            return 0;
+        } catch (std::exception &e) {
+            return channelSelectionErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int channelSelectionGet(const char *instrument, int *channels, int maxChannels, int *nChannels) {
+        try {
+            const auto *selected = ChannelSelection::getInstance().find(instrument);
+            if (!selected) {
+                *nChannels = -1;
+                return 0;
+            }
+            *nChannels = static_cast<int>(selected->size());
+            std::copy_n(selected->begin(), std::min(*nChannels, std::max(maxChannels, 0)), channels);
+            return 0;
+        } catch (std::exception &e) {
+            return channelSelectionErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef OBS2IODA_CHANNEL_SELECTION_H
+#define OBS2IODA_CHANNEL_SELECTION_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "yaml-cpp/yaml.h"
+
+namespace Obs2Ioda {
+    /**
+     * @class ChannelSelection
+     * @brief Singleton class holding the channels kept per radiance instrument.
+     *
+     * The selection is read from a YAML file such as `share/ChannelSelection.yaml`:
+     *
+     * @code
+     * channels:
+     *   iasi: [16, 29, 32, "35-38"]
+     *   cris_n20: ["19-27", 31]
+     * @endcode
+     *
+     * Keys are instrument names (`iasi_metop-b`) or sensor names (`iasi`); a
+     * sensor entry applies to every platform without its own entry. Entries are
+     * channel numbers or `"first-last"` ranges. Instruments without an entry keep
+     * all their channels.
+     */
+    class ChannelSelection {
+    public:
+        /**
+         * @brief Retrieves the singleton instance of the ChannelSelection.
+         *
+         * @return A reference to the singleton instance of ChannelSelection.
+         */
+        static ChannelSelection &getInstance();
+
+        ChannelSelection(
+            const ChannelSelection &
+        ) = delete;
+
+        ChannelSelection &operator=(
+            const ChannelSelection &
+        ) = delete;
+
+        /**
+         * @brief Replaces the selection by the `channels` map of a YAML document.
+         *
+         * @param node The root node of the document.
+         * @throws std::invalid_argument if an entry is not a channel number or range.
+         */
+        void load(
+            const YAML::Node &node
+        );
+
+        /**
+         * @brief Removes all entries, so that every instrument keeps all its channels.
+         */
+        void clear();
+
+        /**
+         * @brief Finds the channels kept for an instrument.
+         *
+         * @param instrument The instrument name, `<sensor>_<platform>`.
+         * @return The sorted channel numbers, or nullptr if all channels are kept.
+         */
+        const std::vector<int> *find(
+            const std::string &instrument
+        ) const;
+
+    private:
+        ChannelSelection() = default;
+
+        std::map<std::string, std::vector<int> > selections;
+    };
+
+    extern "C" {
+    /**
+     * @brief Loads the channel selection from a YAML file.
+     *
+     * @param path The YAML file.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int channelSelectionLoad(
+        const char *path
+    );
+
+    /**
+     * @brief Retrieves the channels kept for an instrument.
+     *
+     * @param instrument The instrument name, `<sensor>_<platform>`.
+     * @param channels Array receiving the sorted channel numbers.
+     * @param maxChannels The size of `channels`.
+     * @param nChannels Receives the number of selected channels, or -1 if all
+     *                  channels are kept. Only the first `maxChannels` are copied.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int channelSelectionGet(
+        const char *instrument,
+        int *channels,
+        int maxChannels,
+        int *nChannels
+    );
+    }
+}
+
+#endif //OBS2IODA_CHANNEL_SELECTION_H
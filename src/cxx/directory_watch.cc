@@ -0,0 +1,185 @@
+#include "directory_watch.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace Obs2Ioda {
+    static bool isNetcdfFile(
+        const std::filesystem::directory_entry &entry
+    ) {
+        return entry.is_regular_file() && entry.path().extension() == ".nc";
+    }
+
+    DirectoryWatch::DirectoryWatch(
+        const std::string &path
+    ) : path(path) {
+        fd = inotify_init1(IN_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "inotify_init1");
+        }
+        if (inotify_add_watch(fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR) < 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "cannot watch " + path);
+        }
+        try {
+            for (const auto &entry: std::filesystem::directory_iterator(path)) {
+                if (isNetcdfFile(entry)) {
+                    seen.insert(entry.path().filename().string());
+                }
+            }
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    DirectoryWatch::~DirectoryWatch() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    bool DirectoryWatch::next(
+        const int timeoutMs,
+        std::string &name
+    ) {
+        while (arrived.empty()) {
+            pollfd event{fd, POLLIN, 0};
+            const int ready = poll(&event, 1, timeoutMs);
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready < 0) {
+                throw std::system_error(errno, std::generic_category(), "poll");
+            }
+            if (ready == 0) {
+                return false;
+            }
+            alignas(inotify_event) char buffer[64 * 1024];
+            const ssize_t len = read(fd, buffer, sizeof(buffer));
+            if (len < 0 && errno == EINTR) {
+                continue;
+            }
+            if (len < 0) {
+                throw std::system_error(errno, std::generic_category(), "read of inotify events");
+            }
+            bool overflow = false;
+            for (ssize_t offset = 0; offset < len;) {
+                const auto *inotifyEvent = reinterpret_cast<const inotify_event *>(buffer + offset);
+                if (inotifyEvent->mask & IN_Q_OVERFLOW) {
+                    overflow = true;
+                } else if (inotifyEvent->len > 0 && !(inotifyEvent->mask & IN_ISDIR)) {
+                    arrived.emplace_back(inotifyEvent->name);
+                }
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + inotifyEvent->len);
+            }
+            if (overflow) {
+                std::cerr << "Warning: events of " << path << " were lost, rescanning the directory" << std::endl;
+                rescan();
+            }
+        }
+        name = arrived.front();
+        arrived.pop_front();
+        seen.insert(name);
+        return true;
+    }
+
+    void DirectoryWatch::rescan() {
+        const std::set<std::string> queued(arrived.begin(), arrived.end());
+        std::set<std::string> missed;
+        for (const auto &entry: std::filesystem::directory_iterator(path)) {
+            const auto fileName = entry.path().filename().string();
+            if (isNetcdfFile(entry) && seen.count(fileName) == 0 && queued.count(fileName) == 0) {
+                missed.insert(fileName);
+            }
+        }
+        arrived.insert(arrived.end(), missed.begin(), missed.end());
+    }
+
+    DirectoryWatchMap &DirectoryWatchMap::getInstance() {
+        static DirectoryWatchMap instance;
+        return instance;
+    }
+
+    int DirectoryWatchMap::open(
+        const std::string &path
+    ) {
+        auto watch = std::make_unique<DirectoryWatch>(path);
+        watches[++lastID] = std::move(watch);
+        return lastID;
+    }
+
+    DirectoryWatch &DirectoryWatchMap::get(
+        const int watchID
+    ) {
+        return *watches.at(watchID);
+    }
+
+    void DirectoryWatchMap::close(
+        const int watchID
+    ) {
+        if (watches.erase(watchID) == 0) {
+            throw std::out_of_range("directory watch ID " + std::to_string(watchID) + " is not open");
+        }
+    }
+
+    static int directoryWatchErrorMessage(const std::exception &e, int lineNumber, const char *fileName) {
+        std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+        return -1;
+    }
+
+    int directoryWatchOpen(
+        const char *path,
+        int *watchID
+    ) {
+        try {
+            *watchID = DirectoryWatchMap::getInstance().open(path);
+            return 0;
+        } catch (std::exception &e) {
+            return directoryWatchErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int directoryWatchNext(
+        const int watchID,
+        const int timeoutMs,
+        char *name,
+        const int nameLen
+    ) {
+        try {
+            std::string arrivedName;
+            if (!DirectoryWatchMap::getInstance().get(watchID).next(timeoutMs, arrivedName)) {
+                return 1;
+            }
+            if (nameLen <= 0 || arrivedName.size() > static_cast<size_t>(nameLen - 1)) {
+                std::cerr << "Error: name of arrived file " << arrivedName << " is longer than "
+                          << std::max(nameLen - 1, 0) << " characters" << std::endl;
+                return 2;
+            }
+            std::memcpy(name, arrivedName.data(), arrivedName.size());
+            name[arrivedName.size()] = '\0';
+            return 0;
+        } catch (std::exception &e) {
+            return directoryWatchErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int directoryWatchClose(
+        const int watchID
+    ) {
+        try {
+            DirectoryWatchMap::getInstance().close(watchID);
+            return 0;
+        } catch (std::exception &e) {
+            return directoryWatchErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+} // namespace Obs2Ioda
@@ -0,0 +1,167 @@
+#ifndef OBS2IODA_DIRECTORY_WATCH_H
+#define OBS2IODA_DIRECTORY_WATCH_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace Obs2Ioda {
+    /**
+     * @class DirectoryWatch
+     * @brief Reports the files that arrive in a directory, using inotify.
+     *
+     * A file is reported once it is complete: when a writer closes it, or when it
+     * is moved into the directory (the usual way of delivering a file atomically).
+     * Files that are only opened or still being written are not reported.
+     *
+     * If the kernel queue of events overflows, events are lost; the directory is
+     * then rescanned and the `.nc` files that were neither there when the watch
+     * started nor reported since are reported.
+     */
+    class DirectoryWatch {
+    public:
+        /**
+         * @brief Starts watching a directory.
+         *
+         * @param path The directory.
+         * @throws std::system_error if the directory cannot be watched.
+         */
+        explicit DirectoryWatch(
+            const std::string &path
+        );
+
+        ~DirectoryWatch();
+
+        DirectoryWatch(
+            const DirectoryWatch &
+        ) = delete;
+
+        DirectoryWatch &operator=(
+            const DirectoryWatch &
+        ) = delete;
+
+        /**
+         * @brief Waits for the next file to arrive.
+         *
+         * @param timeoutMs The longest wait in milliseconds, or a negative value to wait forever.
+         * @param name Receives the name of the file, relative to the directory.
+         * @return true if a file arrived, false if the wait timed out.
+         * @throws std::system_error if the events cannot be read.
+         */
+        bool next(
+            int timeoutMs,
+            std::string &name
+        );
+
+    private:
+        /// Queues the `.nc` files of the directory that were not seen yet.
+        void rescan();
+
+        std::string path;
+        int fd = -1;
+        /// Files reported by the last read of events and not returned yet.
+        std::deque<std::string> arrived;
+        /// `.nc` files present when the watch started, and files returned since.
+        std::set<std::string> seen;
+    };
+
+    /**
+     * @class DirectoryWatchMap
+     * @brief Singleton class mapping the watch IDs of the C interface to their watches.
+     */
+    class DirectoryWatchMap {
+    public:
+        /**
+         * @brief Retrieves the singleton instance of the DirectoryWatchMap.
+         *
+         * @return A reference to the singleton instance of DirectoryWatchMap.
+         */
+        static DirectoryWatchMap &getInstance();
+
+        DirectoryWatchMap(
+            const DirectoryWatchMap &
+        ) = delete;
+
+        DirectoryWatchMap &operator=(
+            const DirectoryWatchMap &
+        ) = delete;
+
+        /**
+         * @brief Starts watching a directory.
+         *
+         * @return The ID of the new watch.
+         */
+        int open(
+            const std::string &path
+        );
+
+        /**
+         * @brief Retrieves a watch.
+         *
+         * @throws std::out_of_range if the ID is not an open watch.
+         */
+        DirectoryWatch &get(
+            int watchID
+        );
+
+        /**
+         * @brief Stops a watch.
+         *
+         * @throws std::out_of_range if the ID is not an open watch.
+         */
+        void close(
+            int watchID
+        );
+
+    private:
+        DirectoryWatchMap() = default;
+
+        int lastID = 0;
+        std::map<int, std::unique_ptr<DirectoryWatch> > watches;
+    };
+
+    extern "C" {
+    /**
+     * @brief Starts watching a directory for arriving files.
+     *
+     * @param path The directory.
+     * @param watchID Receives the ID of the watch.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int directoryWatchOpen(
+        const char *path,
+        int *watchID
+    );
+
+    /**
+     * @brief Waits for the next file to arrive in a watched directory.
+     *
+     * @param watchID The ID of the watch.
+     * @param timeoutMs The longest wait in milliseconds, or a negative value to wait forever.
+     * @param name Buffer receiving the null-terminated file name, relative to the directory.
+     * @param nameLen The size of `name`.
+     * @return 0 if a file arrived, 1 if the wait timed out, 2 if a file arrived
+     *         whose name does not fit in `name`, or -1 on failure.
+     */
+    int directoryWatchNext(
+        int watchID,
+        int timeoutMs,
+        char *name,
+        int nameLen
+    );
+
+    /**
+     * @brief Stops watching a directory.
+     *
+     * @param watchID The ID of the watch.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int directoryWatchClose(
+        int watchID
+    );
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_DIRECTORY_WATCH_H
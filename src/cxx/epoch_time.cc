@@ -0,0 +1,254 @@
+#include "epoch_time.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <stdexcept>
+
+namespace Obs2Ioda {
+    namespace {
+        constexpr long long secondsPerDay = 86400;
+
+        /// Julian day number of 1970-01-01.
+        constexpr long long epochJulianDay = 2440588;
+
+        /// The date of the previous conversion of timeCalendarToEpoch and its day.
+        struct DayCache {
+            int year = 0;
+            int month = 0;
+            int day = 0;
+            long long epochDay = 0;
+            bool valid = false;
+        };
+
+        thread_local DayCache dayCache;
+
+        void putDigits(
+            char *text,
+            const int value,
+            const int numDigits
+        ) {
+            int remainder = value;
+            for (int i = numDigits - 1; i >= 0; i--) {
+                text[i] = static_cast<char>('0' + remainder % 10);
+                remainder /= 10;
+            }
+        }
+
+        int timeErrorMessage(
+            const std::exception &e,
+            const int lineNumber,
+            const char *fileName
+        ) {
+            std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+            return -1;
+        }
+    }
+
+    bool validCalendar(
+        const int year,
+        const int month,
+        const int day,
+        const int hour,
+        const int minute,
+        const int second
+    ) {
+        static const int monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        if (year < 0 || year > 9999 || month < 1 || month > 12) {
+            return false;
+        }
+        const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        const int lastDay = monthDays[month - 1] + (month == 2 && leap);
+        return day >= 1 && day <= lastDay && hour >= 0 && hour < 24 && minute >= 0 && minute < 60 &&
+               second >= 0 && second < 60;
+    }
+
+    long long epochDay(
+        const int year,
+        const int month,
+        const int day
+    ) {
+        const long long y = year;
+        const long long m = month;
+        const long long a = (m - 14) / 12;
+        const long long julianDay = day - 32075 + 1461 * (y + 4800 + a) / 4 + 367 * (m - 2 - a * 12) / 12
+                                    - 3 * ((y + 4900 + a) / 100) / 4;
+        return julianDay - epochJulianDay;
+    }
+
+    long long calendarToEpoch(
+        const int year,
+        const int month,
+        const int day,
+        const int hour,
+        const int minute,
+        const int second
+    ) {
+        return epochDay(year, month, day) * secondsPerDay + hour * 3600LL + minute * 60LL + second;
+    }
+
+    long long dateToEpoch(
+        const std::string &date
+    ) {
+        const size_t length = date.size();
+        bool digits = length == 10 || length == 12 || length == 14;
+        for (const char c: date) {
+            digits = digits && std::isdigit(static_cast<unsigned char>(c));
+        }
+        if (!digits) {
+            throw std::invalid_argument("invalid date '" + date + "', expected ccyymmddhh[nn[ss]]");
+        }
+        const auto field = [&date](const size_t pos, const size_t len) {
+            return pos < date.size() ? std::stoi(date.substr(pos, len)) : 0;
+        };
+        const int year = field(0, 4);
+        const int month = field(4, 2);
+        const int day = field(6, 2);
+        const int hour = field(8, 2);
+        const int minute = field(10, 2);
+        const int second = field(12, 2);
+        if (!validCalendar(year, month, day, hour, minute, second)) {
+            throw std::invalid_argument("invalid date '" + date + "'");
+        }
+        return calendarToEpoch(year, month, day, hour, minute, second);
+    }
+
+    void formatDatetime(
+        const long long seconds,
+        char *text
+    ) {
+        long long days = seconds / secondsPerDay;
+        long long secondOfDay = seconds % secondsPerDay;
+        if (secondOfDay < 0) {
+            secondOfDay += secondsPerDay;
+            days -= 1;
+        }
+        // civil date of a day count (H. Hinnant, chrono-compatible low-level date algorithms)
+        days += 719468;
+        const long long era = (days >= 0 ? days : days - 146096) / 146097;
+        const long long dayOfEra = days - era * 146097;
+        const long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const long long monthIndex = (5 * dayOfYear + 2) / 153;
+        const int day = static_cast<int>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+        const int month = static_cast<int>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+        const long long year = yearOfEra + era * 400 + (month <= 2);
+        if (year < 0 || year > 9999) {
+            throw std::out_of_range("time " + std::to_string(seconds) + " is outside of years 0 to 9999");
+        }
+        const int second = static_cast<int>(secondOfDay);
+        putDigits(text, static_cast<int>(year), 4);
+        text[4] = '-';
+        putDigits(text + 5, month, 2);
+        text[7] = '-';
+        putDigits(text + 8, day, 2);
+        text[10] = 'T';
+        putDigits(text + 11, second / 3600, 2);
+        text[13] = ':';
+        putDigits(text + 14, second / 60 % 60, 2);
+        text[16] = ':';
+        putDigits(text + 17, second % 60, 2);
+        text[19] = 'Z';
+    }
+
+    std::string epochToDatetime(
+        const long long seconds
+    ) {
+        std::string text(datetimeLength, ' ');
+        formatDatetime(seconds, &text[0]);
+        return text;
+    }
+
+    std::vector<long long> timeSlots(
+        const long long begin,
+        const long long end,
+        const int numSlots
+    ) {
+        if (numSlots < 1) {
+            throw std::invalid_argument("invalid number of time slots " + std::to_string(numSlots));
+        }
+        std::vector<long long> slots(numSlots + 1);
+        slots.front() = begin;
+        slots.back() = end;
+        // slot i (1-based) is centred on begin + (i - 1) * dt, dt = (end - begin) / (numSlots - 1)
+        for (int i = 1; i < numSlots; i++) {
+            slots[i] = begin + (2 * i - 1) * (end - begin) / (2 * (numSlots - 1));
+        }
+        return slots;
+    }
+
+    int timeCalendarToEpoch(
+        const int numTimes,
+        const int *year,
+        const int *month,
+        const int *day,
+        const int *hour,
+        const int *minute,
+        const int *second,
+        long long *epoch
+    ) {
+        try {
+            if (numTimes < 0) {
+                throw std::invalid_argument("invalid number of times " + std::to_string(numTimes));
+            }
+            DayCache cache = dayCache;
+            int numInvalid = 0;
+            for (int i = 0; i < numTimes; i++) {
+                if (!validCalendar(year[i], month[i], day[i], hour[i], minute[i], second[i])) {
+                    epoch[i] = invalidEpoch;
+                    numInvalid++;
+                    continue;
+                }
+                if (!cache.valid || year[i] != cache.year || month[i] != cache.month || day[i] != cache.day) {
+                    cache = {year[i], month[i], day[i], epochDay(year[i], month[i], day[i]), true};
+                }
+                epoch[i] = cache.epochDay * secondsPerDay + hour[i] * 3600LL + minute[i] * 60LL + second[i];
+            }
+            dayCache = cache;
+            return numInvalid;
+        } catch (const std::exception &e) {
+            return timeErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int timeDateToEpoch(
+        const char *date,
+        long long *epoch
+    ) {
+        try {
+            *epoch = dateToEpoch(date);
+            return 0;
+        } catch (const std::exception &e) {
+            return timeErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int timeWindowSlots(
+        const long long begin,
+        const long long end,
+        const int numSlots,
+        long long *slots
+    ) {
+        try {
+            const auto boundaries = timeSlots(begin, end, numSlots);
+            std::copy(boundaries.begin(), boundaries.end(), slots);
+            return 0;
+        } catch (const std::exception &e) {
+            return timeErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int timeEpochToDatetime(
+        const int numTimes,
+        const long long *epoch,
+        char *datetimes
+    ) {
+        try {
+            for (int i = 0; i < numTimes; i++) {
+                formatDatetime(epoch[i], datetimes + static_cast<size_t>(i) * datetimeLength);
+            }
+            return 0;
+        } catch (const std::exception &e) {
+            return timeErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+} // namespace Obs2Ioda
@@ -0,0 +1,181 @@
+#ifndef OBS2IODA_EPOCH_TIME_H
+#define OBS2IODA_EPOCH_TIME_H
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Obs2Ioda {
+    /// Length of a date and time `ccyy-mm-ddThh:mm:ssZ`, `ndatetime` of define_mod.
+    constexpr size_t datetimeLength = 20;
+
+    /// Time given by timeCalendarToEpoch to a date or time with a field out of range.
+    constexpr long long invalidEpoch = std::numeric_limits<long long>::min();
+
+    /**
+     * @brief Whether a date and time has all its fields in range.
+     *
+     * Years are 0 to 9999, the range of `ccyy-mm-ddThh:mm:ssZ`, and days are
+     * within their month, with the leap years of the Gregorian calendar.
+     */
+    bool validCalendar(
+        int year,
+        int month,
+        int day,
+        int hour,
+        int minute,
+        int second
+    );
+
+    /**
+     * @brief Days from 1970-01-01 to a date.
+     *
+     * Uses the Julian day number formula of `get_julian_time` in utils_mod, so
+     * that days and months beyond their range carry over the same way.
+     */
+    long long epochDay(
+        int year,
+        int month,
+        int day
+    );
+
+    /**
+     * @brief Seconds since 1970-01-01T00:00:00Z of a date and time.
+     */
+    long long calendarToEpoch(
+        int year,
+        int month,
+        int day,
+        int hour,
+        int minute,
+        int second
+    );
+
+    /**
+     * @brief Parses a date `ccyymmddhh[nn[ss]]`, as used for file dates and time
+     * windows, into seconds since 1970-01-01T00:00:00Z.
+     *
+     * @throws std::invalid_argument if the date is not 10, 12 or 14 digits, or
+     *     not a valid date (see validCalendar).
+     */
+    long long dateToEpoch(
+        const std::string &date
+    );
+
+    /**
+     * @brief Writes seconds since 1970-01-01T00:00:00Z as `ccyy-mm-ddThh:mm:ssZ`.
+     *
+     * @param seconds The time.
+     * @param text Receives the `datetimeLength` characters, without a terminating null.
+     * @throws std::out_of_range if the year is not in 0 to 9999.
+     */
+    void formatDatetime(
+        long long seconds,
+        char *text
+    );
+
+    /**
+     * @brief Formats seconds since 1970-01-01T00:00:00Z as `ccyy-mm-ddThh:mm:ssZ`.
+     *
+     * This is the format of the `min_datetime` and `max_datetime` attributes.
+     */
+    std::string epochToDatetime(
+        long long seconds
+    );
+
+    /**
+     * @brief Boundaries of the time slots of a window, as `da_get_time_slots` of
+     * WRFDA computed them in minutes.
+     *
+     * The first and last slot are half as long as the others, which are centred
+     * on `begin + i * (end - begin) / (numSlots - 1)`. Boundaries are truncated to
+     * whole seconds.
+     *
+     * @param begin The start of the window, in seconds since 1970-01-01T00:00:00Z.
+     * @param end The end of the window.
+     * @param numSlots The number of slots.
+     * @return The `numSlots + 1` boundaries, `begin` first and `end` last.
+     */
+    std::vector<long long> timeSlots(
+        long long begin,
+        long long end,
+        int numSlots
+    );
+
+    extern "C" {
+    /**
+     * @brief Converts dates and times to seconds since 1970-01-01T00:00:00Z.
+     *
+     * Observations of one report or file mostly share their date, so the day of
+     * the previous time is kept and only the time of day is added for the others.
+     * Times with a field out of range (see validCalendar) receive `invalidEpoch`,
+     * and the others are still converted.
+     *
+     * @param numTimes The number of times.
+     * @param year The years, e.g. 2018.
+     * @param month The months, 1 to 12.
+     * @param day The days of the month.
+     * @param hour The hours.
+     * @param minute The minutes.
+     * @param second The seconds.
+     * @param epoch Receives the `numTimes` times in seconds.
+     * @return 0 on success, the number of invalid times, or -1 on failure.
+     */
+    int timeCalendarToEpoch(
+        int numTimes,
+        const int *year,
+        const int *month,
+        const int *day,
+        const int *hour,
+        const int *minute,
+        const int *second,
+        long long *epoch
+    );
+
+    /**
+     * @brief Parses a date `ccyymmddhh[nn[ss]]` into seconds since 1970-01-01T00:00:00Z.
+     *
+     * @param date The date.
+     * @param epoch Receives the time in seconds.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int timeDateToEpoch(
+        const char *date,
+        long long *epoch
+    );
+
+    /**
+     * @brief Computes the boundaries of the time slots of a window (see timeSlots).
+     *
+     * @param begin The start of the window, in seconds since 1970-01-01T00:00:00Z.
+     * @param end The end of the window.
+     * @param numSlots The number of slots.
+     * @param slots Receives the `numSlots + 1` boundaries.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int timeWindowSlots(
+        long long begin,
+        long long end,
+        int numSlots,
+        long long *slots
+    );
+
+    /**
+     * @brief Formats times as `ccyy-mm-ddThh:mm:ssZ` strings.
+     *
+     * @param numTimes The number of times.
+     * @param epoch The times in seconds since 1970-01-01T00:00:00Z.
+     * @param datetimes Receives `numTimes` strings of `datetimeLength` characters,
+     *     one after the other without terminating nulls.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int timeEpochToDatetime(
+        int numTimes,
+        const long long *epoch,
+        char *datetimes
+    );
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_EPOCH_TIME_H
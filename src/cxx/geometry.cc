@@ -0,0 +1,288 @@
+#include "geometry.h"
+#include "run_threads.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Obs2Ioda {
+    namespace {
+        constexpr double pi = 3.14159265358979323846;
+        constexpr double deg2rad = pi / 180.0;
+        constexpr double rad2deg = 180.0 / pi;
+
+        /**
+         * Calls `tile(begin, end)` for consecutive tiles of `tileSize` of `numItems`
+         * items, spread over up to one thread per hardware thread.
+         */
+        template<typename Tile>
+        void forEachTile(
+            const size_t numItems,
+            const size_t tileSize,
+            const Tile &tile
+        ) {
+            const size_t numTiles = (numItems + tileSize - 1) / tileSize;
+            const auto numThreads = static_cast<unsigned>(std::min<size_t>(
+                numTiles, std::max(1u, std::thread::hardware_concurrency())));
+            std::atomic<size_t> next{0};
+            runThreads(std::max(1u, numThreads), [&](unsigned) {
+                for (size_t t = next++; t < numTiles; t = next++) {
+                    tile(t * tileSize, std::min(numItems, (t + 1) * tileSize));
+                }
+            });
+        }
+
+        /// Wraps a longitude in degrees from -540-540 to -180-180.
+        inline double wrapLongitude(
+            const double lon
+        ) {
+            return lon > 180.0 ? lon - 360.0 : (lon < -180.0 ? lon + 360.0 : lon);
+        }
+
+        /**
+         * Computes one row of `geoFixedGridToLatLon`. Pixels off the earth are
+         * computed with a zero discriminant and then masked, so that the loop has
+         * no branches and raises no floating-point exceptions.
+         */
+        void fixedGridRow(
+            const GeosProjection &proj,
+            const size_t nx,
+            const double *cosX,
+            const double *sinX,
+            const double cosY,
+            const double sinY,
+            float *lat,
+            float *lon,
+            int *valid
+        ) {
+            const double h = proj.satDist;
+            const double k = (proj.rEq / proj.rPol) * (proj.rEq / proj.rPol);
+            const double c = h * h - proj.rEq * proj.rEq;
+            if (proj.sweepX != 0) {
+                // GOES-R PUG Vol. 3, 4.2.8.1
+#pragma omp simd
+                for (size_t i = 0; i < nx; i++) {
+                    const double a = sinX[i] * sinX[i] + cosX[i] * cosX[i] * (cosY * cosY + k * sinY * sinY);
+                    const double b = -2.0 * h * cosX[i] * cosY;
+                    const double disc = b * b - 4.0 * a * c;
+                    const bool onEarth = disc >= 0.0;
+                    const double rs = (-b - std::sqrt(onEarth ? disc : 0.0)) / (2.0 * a);
+                    const double sx = rs * cosX[i] * cosY;
+                    const double sy = -rs * sinX[i];
+                    const double sz = rs * cosX[i] * sinY;
+                    const double la = std::atan(k * sz / std::sqrt((h - sx) * (h - sx) + sy * sy));
+                    const double lo = proj.subLon - std::atan(sy / (h - sx)) * rad2deg;
+                    lat[i] = onEarth ? static_cast<float>(la * rad2deg) : geometryMissing;
+                    lon[i] = onEarth ? static_cast<float>(wrapLongitude(lo)) : geometryMissing;
+                    valid[i] = onEarth;
+                }
+            } else {
+                // CGMS LRIT/HRIT Global Specification 4.4.3.2
+#pragma omp simd
+                for (size_t i = 0; i < nx; i++) {
+                    const double cc = cosY * cosY + k * sinY * sinY;
+                    const double t = h * cosX[i] * cosY;
+                    const double sd2 = t * t - cc * c;
+                    const bool onEarth = sd2 >= 0.0;
+                    const double sn = (t - std::sqrt(onEarth ? sd2 : 0.0)) / cc;
+                    const double s1 = h - sn * cosX[i] * cosY;
+                    const double s2 = sn * sinX[i] * cosY;
+                    const double s3 = -sn * sinY;
+                    const double la = std::atan(k * s3 / std::sqrt(s1 * s1 + s2 * s2));
+                    const double lo = std::atan2(s2, s1) * rad2deg + proj.subLon;
+                    lat[i] = onEarth ? static_cast<float>(la * rad2deg) : geometryMissing;
+                    lon[i] = onEarth ? static_cast<float>(wrapLongitude(lo)) : geometryMissing;
+                    valid[i] = onEarth;
+                }
+            }
+        }
+
+        /// Throws if a pointer that must be given is null.
+        void requirePointer(
+            const void *pointer,
+            const char *name
+        ) {
+            if (pointer == nullptr) {
+                throw std::invalid_argument(std::string(name) + " must not be null");
+            }
+        }
+
+        /// Checks the sizes and pointers of the locations of a kernel.
+        void checkLocations(
+            const int numLocs,
+            const float *lat,
+            const float *lon,
+            const float *zenith
+        ) {
+            if (numLocs < 0) {
+                throw std::invalid_argument("numLocs must not be negative");
+            }
+            if (numLocs > 0) {
+                requirePointer(lat, "lat");
+                requirePointer(lon, "lon");
+                requirePointer(zenith, "zenith");
+            }
+        }
+    } // namespace
+
+    static int geometryErrorMessage(const std::exception &e, int lineNumber, const char *fileName) {
+        std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+        return -1;
+    }
+
+    int geoFixedGridToLatLon(
+        const GeosProjection *proj,
+        const int nx,
+        const int ny,
+        const double *x,
+        const double *y,
+        float *lat,
+        float *lon,
+        int *valid
+    ) {
+        try {
+            requirePointer(proj, "proj");
+            if (nx < 0 || ny < 0) {
+                throw std::invalid_argument("nx and ny must not be negative");
+            }
+            if (nx == 0 || ny == 0) {
+                return 0;
+            }
+            requirePointer(x, "x");
+            requirePointer(y, "y");
+            requirePointer(lat, "lat");
+            requirePointer(lon, "lon");
+            requirePointer(valid, "valid");
+            if (!(proj->rEq > 0.0 && proj->rPol > 0.0 && proj->satDist > proj->rEq)) {
+                throw std::invalid_argument("the satellite must be above an earth with positive radii");
+            }
+            const auto columns = static_cast<size_t>(nx);
+            std::vector<double> cosX(columns);
+            std::vector<double> sinX(columns);
+            for (size_t i = 0; i < columns; i++) {
+                cosX[i] = std::cos(x[i]);
+                sinX[i] = std::sin(x[i]);
+            }
+            forEachTile(static_cast<size_t>(ny), geometryTileRows, [&](const size_t begin, const size_t end) {
+                for (size_t j = begin; j < end; j++) {
+                    fixedGridRow(*proj, columns, cosX.data(), sinX.data(), std::cos(y[j]), std::sin(y[j]),
+                                 lat + j * columns, lon + j * columns, valid + j * columns);
+                }
+            });
+            return 0;
+        } catch (const std::exception &e) {
+            return geometryErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int geoSatelliteAngles(
+        const GeosProjection *proj,
+        const int numLocs,
+        const float *lat,
+        const float *lon,
+        float *zenith,
+        float *azimuth
+    ) {
+        try {
+            requirePointer(proj, "proj");
+            checkLocations(numLocs, lat, lon, zenith);
+            const double rEq = proj->rEq;
+            const double h = proj->satDist;
+            const double subLon = proj->subLon * deg2rad;
+            forEachTile(static_cast<size_t>(numLocs), geometryTileSize, [&](const size_t begin, const size_t end) {
+#pragma omp simd
+                for (size_t i = begin; i < end; i++) {
+                    const bool located = (std::abs(lat[i]) <= 90.0f) & (std::abs(lon[i]) <= 360.0f);
+                    const double rlat = lat[i] * deg2rad;
+                    const double lonDiff = lon[i] * deg2rad - subLon;
+                    const double s = std::sin(std::abs(lonDiff) / 2.0);
+                    const double d = rEq * (1.0 - std::cos(rlat)) * s;
+                    const double e = 2.0 * rEq * std::sin(rlat / 2.0);
+                    const double tmp = (2.0 * rEq * s - d) * (2.0 * rEq * s - d) + e * e - d * d;
+                    const bool visible = located & (tmp >= 0.0);
+                    const double theta1 = 2.0 * std::asin(std::fmin(1.0, std::sqrt(visible ? tmp : 0.0) / rEq / 2.0));
+                    const double theta2 = std::atan(rEq * std::sin(theta1) /
+                                                    ((h - rEq) + rEq * (1.0 - std::sin(theta1))));
+                    zenith[i] = visible ? static_cast<float>((theta1 + theta2) * rad2deg) : geometryMissing;
+                }
+                if (azimuth == nullptr) {
+                    return;
+                }
+#pragma omp simd
+                for (size_t i = begin; i < end; i++) {
+                    const bool located = (std::abs(lat[i]) <= 90.0f) & (std::abs(lon[i]) <= 360.0f);
+                    const double rlat = lat[i] * deg2rad;
+                    const double toSat = subLon - lon[i] * deg2rad;
+                    double az = std::atan2(std::sin(toSat), -std::sin(rlat) * std::cos(toSat)) * rad2deg;
+                    az = az < 0.0 ? az + 360.0 : az;
+                    azimuth[i] = located ? static_cast<float>(az) : geometryMissing;
+                }
+            });
+            return 0;
+        } catch (const std::exception &e) {
+            return geometryErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int geoSolarAngles(
+        const int julian,
+        const int gmt,
+        const int minute,
+        const int numLocs,
+        const float *lat,
+        const float *lon,
+        float *zenith,
+        float *azimuth
+    ) {
+        try {
+            if (julian < 1 || julian > 366 || gmt < 0 || gmt > 23 || minute < 0 || minute > 59) {
+                throw std::invalid_argument("invalid time: julian = " + std::to_string(julian) + ", gmt = " +
+                                            std::to_string(gmt) + ", minute = " + std::to_string(minute));
+            }
+            checkLocations(numLocs, lat, lon, zenith);
+            // longitude of the sun from the vernal equinox, declination and equation of time (radconst)
+            const float degPerDay = 360.0f / 365.0f;
+            const float slon = static_cast<float>(julian >= 80 ? julian - 80 : julian + 285) * degPerDay;
+            const auto declin = static_cast<float>(std::asin(std::sin(23.5f * deg2rad) * std::sin(slon * deg2rad)));
+            const float da = 6.2831853071795862f * static_cast<float>(julian - 1) / 365.0f;
+            const float eot = (0.000075f + 0.001868f * std::cos(da) - 0.032077f * std::sin(da)
+                               - 0.014615f * std::cos(2.0f * da) - 0.04089f * std::sin(2.0f * da)) * 229.18f;
+            const float xt = static_cast<float>(gmt) + (static_cast<float>(minute) + eot) / 60.0f;
+            const float sinDeclin = std::sin(declin);
+            const float cosDeclin = std::cos(declin);
+            const auto deg2radF = static_cast<float>(deg2rad);
+            const auto rad2degF = static_cast<float>(rad2deg);
+            forEachTile(static_cast<size_t>(numLocs), geometryTileSize, [&](const size_t begin, const size_t end) {
+#pragma omp simd
+                for (size_t i = begin; i < end; i++) {
+                    const bool located = (std::abs(lat[i]) <= 90.0f) & (std::abs(lon[i]) <= 360.0f);
+                    const float hrang = 15.0f * (xt + lon[i] / 15.0f - 12.0f) * deg2radF;
+                    const float rlat = lat[i] * deg2radF;
+                    const float cosZenith = sinDeclin * std::sin(rlat) + cosDeclin * std::cos(rlat) * std::cos(hrang);
+                    const float solzen = std::acos(std::fmax(-1.0f, std::fmin(1.0f, cosZenith))) * rad2degF;
+                    zenith[i] = located ? solzen : geometryMissing;
+                }
+                if (azimuth == nullptr) {
+                    return;
+                }
+#pragma omp simd
+                for (size_t i = begin; i < end; i++) {
+                    const bool located = (std::abs(lat[i]) <= 90.0f) & (std::abs(lon[i]) <= 360.0f);
+                    const float hrang = 15.0f * (xt + lon[i] / 15.0f - 12.0f) * deg2radF;
+                    const float rlat = lat[i] * deg2radF;
+                    float az = std::atan2(-std::sin(hrang) * cosDeclin,
+                                          sinDeclin * std::cos(rlat) - cosDeclin * std::sin(rlat) * std::cos(hrang))
+                               * rad2degF;
+                    az = az < 0.0f ? az + 360.0f : az;
+                    azimuth[i] = located ? az : geometryMissing;
+                }
+            });
+            return 0;
+        } catch (const std::exception &e) {
+            return geometryErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+} // namespace Obs2Ioda
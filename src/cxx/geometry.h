@@ -0,0 +1,128 @@
+#ifndef OBS2IODA_GEOMETRY_H
+#define OBS2IODA_GEOMETRY_H
+
+#include <cstddef>
+
+namespace Obs2Ioda {
+    /// Value of the angles and coordinates that cannot be computed, `missing_r` of define_mod.
+    constexpr float geometryMissing = -999.0f;
+
+    /// Number of rows of a grid computed by one task.
+    constexpr size_t geometryTileRows = 64;
+
+    /// Number of locations of a list computed by one task.
+    constexpr size_t geometryTileSize = 16384;
+
+    /**
+     * @brief The geostationary projection of a fixed grid, as in `geos_projection` of netcdf_cxx_i_mod.
+     *
+     * The distances may be in any unit, e.g. km for Himawari Standard Data and m
+     * for the GOES-R `goes_imager_projection`, as long as it is the same for all.
+     */
+    struct GeosProjection {
+        /// Longitude of the sub-satellite point in degrees.
+        double subLon;
+        /// Distance from the centre of the earth to the satellite.
+        double satDist;
+        /// Equatorial radius of the earth.
+        double rEq;
+        /// Polar radius of the earth.
+        double rPol;
+        /// 1 if the sweep angle axis is x (GOES-R), 0 if it is y (CGMS, Himawari).
+        int sweepX;
+    };
+
+    extern "C" {
+    /**
+     * @brief Computes the latitude and longitude of the pixels of a fixed grid.
+     *
+     * The scan angles of a column and of a row enter the inverse projection only
+     * through their sine and cosine, which are computed once per column and row;
+     * every row is then computed in one SIMD loop, and tiles of
+     * `geometryTileRows` rows are computed on separate threads. Sweep x uses the
+     * formulas of the GOES-R Product Definition and User's Guide, Vol. 3, and
+     * sweep y those of the CGMS LRIT/HRIT Global Specification, 4.4.3.2.
+     *
+     * @param proj The projection.
+     * @param nx The number of columns.
+     * @param ny The number of rows.
+     * @param x The scan angle of each column in radians (E/W, positive to the east).
+     * @param y The scan angle of each row in radians (N/S, as in the product).
+     * @param lat Receives the latitude of the `nx * ny` pixels in degrees, row by
+     *     row, i.e. `lat(nx, ny)` in Fortran; `geometryMissing` off the earth.
+     * @param lon Receives the longitude in degrees, -180 to 180.
+     * @param valid Receives 1 for pixels on the earth, 0 otherwise.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int geoFixedGridToLatLon(
+        const GeosProjection *proj,
+        int nx,
+        int ny,
+        const double *x,
+        const double *y,
+        float *lat,
+        float *lon,
+        int *valid
+    );
+
+    /**
+     * @brief Computes the zenith and azimuth angle of a geostationary satellite.
+     *
+     * The zenith angle is the great-circle angle between the location and the
+     * sub-satellite point plus the parallax seen from the satellite's height, as
+     * the converters computed it so far; the azimuth angle is the bearing of the
+     * sub-satellite point, clockwise from north.
+     *
+     * @param proj The projection; its `rEq`, `satDist` and `subLon` are used.
+     * @param numLocs The number of locations.
+     * @param lat The latitude of each location in degrees.
+     * @param lon The longitude of each location in degrees.
+     * @param zenith Receives the zenith angles in degrees, `geometryMissing` for
+     *     locations with |lat| > 90 or |lon| > 360.
+     * @param azimuth Receives the azimuth angles in degrees, 0 to 360, or null.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int geoSatelliteAngles(
+        const GeosProjection *proj,
+        int numLocs,
+        const float *lat,
+        const float *lon,
+        float *zenith,
+        float *azimuth
+    );
+
+    /**
+     * @brief Computes the solar zenith and azimuth angle at one time.
+     *
+     * The declination of the sun and the equation of time are those of
+     * `radconst` and `calc_coszen` in WRF phys/module_radiation_driver.F, as in
+     * `calc_solar_zenith_angle` of hsd.f90. The angles are computed in single
+     * precision like there, which also doubles the SIMD width.
+     *
+     * @param julian The day of the year, 1 to 366.
+     * @param gmt The hour, 0 to 23.
+     * @param minute The minute, 0 to 59.
+     * @param numLocs The number of locations.
+     * @param lat The latitude of each location in degrees.
+     * @param lon The longitude of each location in degrees.
+     * @param zenith Receives the solar zenith angles in degrees, `geometryMissing`
+     *     for locations with |lat| > 90 or |lon| > 360.
+     * @param azimuth Receives the solar azimuth angles in degrees clockwise from
+     *     north, 0 to 360, or null.
+     * @return 0 on success, or a non-zero error code on failure, e.g. for a time
+     *     out of range.
+     */
+    int geoSolarAngles(
+        int julian,
+        int gmt,
+        int minute,
+        int numLocs,
+        const float *lat,
+        const float *lon,
+        float *zenith,
+        float *azimuth
+    );
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_GEOMETRY_H
@@ -0,0 +1,45 @@
+#include "netcdf_merge.h"
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    int usage() {
+        std::cerr << "Usage: ioda_merge_split merge output_file input_file [input_file ...]\n"
+                  << "       ioda_merge_split split input_file output_prefix [window_hours]\n"
+                  << "merge concatenates IODA files with the same variables along the location dimension.\n"
+                  << "split writes the locations of each time window (default 1 hour, centred on the\n"
+                  << "full hours) to <output_prefix><ccyymmddhh><extension of input_file>." << std::endl;
+        return 1;
+    }
+}
+
+int main(
+    int argc,
+    char **argv
+) {
+    if (argc < 4) {
+        return usage();
+    }
+    const std::string command = argv[1];
+    try {
+        if (command == "merge") {
+            Obs2Ioda::iodaMerge(std::vector<std::string>(argv + 3, argv + argc), argv[2]);
+            return 0;
+        }
+        if (command == "split" && argc <= 5) {
+            const double windowHours = argc == 5 ? std::atof(argv[4]) : 1.0;
+            for (const auto &path: Obs2Ioda::iodaSplit(argv[2], argv[3],
+                                                       static_cast<long long>(windowHours * 3600.0))) {
+                std::cout << path << std::endl;
+            }
+            return 0;
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return usage();
+}
@@ -0,0 +1,394 @@
+#include "ioda_writer.h"
+#include "netcdf_append.h"
+#include "netcdf_dictionary.h"
+#include "netcdf_encoding.h"
+#include "netcdf_file.h"
+#include "netcdf_fill.h"
+#include "netcdf_parallel.h"
+#include "spatial_index.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace Obs2Ioda {
+    namespace {
+        std::vector<char> flattenCharPtrArray(const char *const *values, const size_t numStrings, const size_t stringSize) {
+            std::vector<char> contiguousValues(numStrings * stringSize + numStrings, ' ');
+
+            for (size_t i = 0; i < numStrings; ++i) {
+                const size_t len = std::strlen(values[i]);
+                std::copy_n(values[i], std::min(len, stringSize), contiguousValues.begin() + i * stringSize);
+                contiguousValues[i * stringSize + stringSize] = '\0';
+            }
+            return contiguousValues;
+        }
+
+        template<typename T>
+        void putFillValue(
+            const netCDF::NcVar &var,
+            T fillValue
+        ) {
+            var.putAtt("_FillValue", var.getType(), fillValue);
+        }
+
+        void putFillValue(
+            const netCDF::NcVar &var,
+            const char *fillValue
+        ) {
+            const int ncid = var.getParentGroup().getId();
+            if (var.getType() == netCDF::ncString) {
+                netCDF::ncCheck(nc_put_att_string(ncid, var.getId(), "_FillValue", 1, &fillValue),
+                                __FILE__, __LINE__);
+            } else {
+                netCDF::ncCheck(nc_put_att_text(ncid, var.getId(), "_FillValue", 1, fillValue),
+                                __FILE__, __LINE__);
+            }
+        }
+
+        /// The group of a file, mapped by the IODA schema; the root group for an empty name.
+        netCDF::NcGroup schemaGroup(
+            const netCDF::NcFile &file,
+            const std::string &groupName
+        ) {
+            return groupName.empty()
+                       ? static_cast<netCDF::NcGroup>(file)
+                       : file.getGroup(iodaSchema.getGroup(groupName)->getValidName());
+        }
+
+        /// The root dimension of strings stored in `length` characters, added if it is missing.
+        netCDF::NcDim stringLengthDim(
+            const netCDF::NcFile &file,
+            const size_t length
+        ) {
+            const auto name = "nchars" + std::to_string(length);
+            const auto dim = file.getDim(name);
+            return dim.isNull() ? file.addDim(name, length) : dim;
+        }
+    }
+
+    template<typename T>
+    VariableWriter<T>::VariableWriter(
+        const int netcdfID,
+        const netCDF::NcVar &var
+    ) : netcdfID(netcdfID),
+        var(var),
+        parallel(isParallelFile(*FileMap::getInstance().getFile(netcdfID))),
+        encoded(false) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            encoded = isEncoded<T>(var);
+        } else {
+            encoded = isDictionaryEncoded(var);
+        }
+    }
+
+    template<typename T>
+    std::vector<size_t> VariableWriter<T>::getDimLens() const {
+        std::vector<size_t> dimLens;
+        for (const auto &dim: var.getDims()) {
+            dimLens.push_back(dim.getSize());
+        }
+        return dimLens;
+    }
+
+    template<typename T>
+    size_t VariableWriter<T>::getNumValues() const {
+        auto dimLens = getDimLens();
+        if (var.getType() == netCDF::ncChar && !dimLens.empty()) {
+            dimLens.pop_back();
+        }
+        size_t numValues = 1;
+        for (const auto n: dimLens) {
+            numValues *= n;
+        }
+        return numValues;
+    }
+
+    template<typename T>
+    void VariableWriter<T>::put(
+        const T *values
+    ) const {
+        // Special handling for char arrays
+        if (var.getType() == netCDF::ncChar) {
+            const auto contiguousValues = flattenCharPtrArray(
+                reinterpret_cast<const char * const *>(values),
+                getNumValues(),
+                getDimLens().back()
+            );
+            var.putVar(contiguousValues.data());
+        } else if (encoded) {
+            if constexpr (std::is_arithmetic_v<T>) {
+                putEncoded(var, std::vector<size_t>(var.getDimCount(), 0), getDimLens(), values);
+            } else {
+                var.putVar(StringDictionary::getInstance().encode(netcdfID, var, values, getNumValues()).data());
+            }
+        } else {
+            var.putVar(values);
+        }
+        FillTracker::getInstance().markWritten(netcdfID, var);
+    }
+
+    template<typename T>
+    void VariableWriter<T>::put(
+        const std::vector<size_t> &start,
+        const std::vector<size_t> &count,
+        const T *values
+    ) const {
+        if (parallel) {
+            netCDF::ncCheck(nc_var_par_access(var.getParentGroup().getId(), var.getId(), NC_COLLECTIVE),
+                            __FILE__, __LINE__);
+        }
+        size_t numValues = 1;
+        for (const auto n: count) {
+            numValues *= n;
+        }
+        if constexpr (std::is_arithmetic_v<T>) {
+            // rows only partly covered by this write are filled before it
+            FillTracker::getInstance().markWritten(netcdfID, var, start, count);
+            if (encoded) {
+                putEncoded(var, start, count, values);
+            } else {
+                var.putVar(start, count, values);
+            }
+        } else if (var.getType() == netCDF::ncChar) {
+            // the hyperslab is of strings; the last dimension is their length
+            const size_t stringSize = getDimLens().back();
+            auto charStart = start;
+            auto charCount = count;
+            charStart.push_back(0);
+            charCount.push_back(stringSize);
+            FillTracker::getInstance().markWritten(netcdfID, var, charStart, charCount);
+            const auto contiguousValues = flattenCharPtrArray(values, numValues, stringSize);
+            var.putVar(charStart, charCount, contiguousValues.data());
+        } else if (encoded) {
+            FillTracker::getInstance().markWritten(netcdfID, var, start, count);
+            var.putVar(start, count, StringDictionary::getInstance().encode(netcdfID, var, values, numValues).data());
+        } else {
+            FillTracker::getInstance().markWritten(netcdfID, var, start, count);
+            var.putVar(start, count, values);
+        }
+        if constexpr (std::is_same_v<T, long long>) {
+            DatetimeRange::getInstance().record(netcdfID, var, values, numValues);
+        }
+    }
+
+    template<typename T>
+    void VariableWriter<T>::setFill(
+        const bool fillMode,
+        const T fillValue
+    ) const {
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (encoded) {
+                // the fill value is stored in the narrower type of the variable
+                if (fillMode) {
+                    putFillValue(var, encodedFillValue(var, static_cast<double>(fillValue)));
+                }
+                if (parallel) {
+                    netCDF::ncCheck(nc_def_var_fill(var.getParentGroup().getId(), var.getId(),
+                                                    fillMode ? NC_FILL : NC_NOFILL, nullptr), __FILE__, __LINE__);
+                } else if (!fillMode) {
+                    FillTracker::getInstance().untrack(netcdfID, var);
+                }
+                return;
+            }
+        } else if (encoded) {
+            // the fill string is an entry of the table, and the fill value its index;
+            // dictionaries are not used in parallel files
+            if (fillMode) {
+                putFillValue(var, StringDictionary::getInstance().encode(netcdfID, var, &fillValue, 1)[0]);
+            } else {
+                FillTracker::getInstance().untrack(netcdfID, var);
+            }
+            return;
+        }
+        if (parallel) {
+            var.setFill(
+                fillMode,
+                fillValue
+            );
+        } else if (fillMode) {
+            // fill mode stays off; the unwritten rows are filled at close
+            putFillValue(var, fillValue);
+        } else {
+            FillTracker::getInstance().untrack(netcdfID, var);
+        }
+    }
+
+    template class VariableWriter<int>;
+    template class VariableWriter<long long>;
+    template class VariableWriter<float>;
+    template class VariableWriter<double>;
+    template class VariableWriter<const char *>;
+
+    IodaWriter::IodaWriter(
+        const std::string &path,
+        const int fileMode
+    ) : IodaWriter(path, fileMode, environmentNetcdfFileOptions()) {
+    }
+
+    IodaWriter::IodaWriter(
+        const std::string &path,
+        const int fileMode,
+        const NetcdfFileOptions &options
+    ) : file(netcdfOpenFile(path, fileMode, options)),
+        owned(true) {
+        netcdfID = file->getId();
+        FileMap::getInstance().addFile(
+            netcdfID,
+            file
+        );
+        // locations appended to an existing file are filled at close like those of a new file
+        if (fileMode == netCDF::NcFile::write && !isParallelFile(*file)) {
+            FillTracker::getInstance().resume(netcdfID, *file);
+        }
+    }
+
+    IodaWriter::IodaWriter(
+        const int netcdfID
+    ) : netcdfID(netcdfID),
+        file(FileMap::getInstance().getFile(netcdfID)) {
+    }
+
+    IodaWriter::~IodaWriter() {
+        if (!owned) {
+            return;
+        }
+        try {
+            close();
+        } catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << " closing NetCDF file " << netcdfID << std::endl;
+        }
+    }
+
+    IodaWriter::IodaWriter(
+        IodaWriter &&other
+    ) noexcept : netcdfID(other.netcdfID),
+                 file(std::move(other.file)),
+                 owned(std::exchange(other.owned, false)) {
+    }
+
+    IodaWriter &IodaWriter::operator=(
+        IodaWriter &&other
+    ) noexcept {
+        if (this != &other) {
+            std::swap(netcdfID, other.netcdfID);
+            std::swap(file, other.file);
+            std::swap(owned, other.owned);
+        }
+        return *this;
+    }
+
+    netCDF::NcFile &IodaWriter::getFile() const {
+        if (!file) {
+            throw netCDF::exceptions::NcBadId("NetCDF file is closed", __FILE__, __LINE__);
+        }
+        return *file;
+    }
+
+    void IodaWriter::addGroup(
+        const std::string &groupName,
+        const std::string &parentGroupName
+    ) const {
+        // parent groups are named as they are in the file
+        const auto parentGroup = parentGroupName.empty()
+                                     ? static_cast<netCDF::NcGroup>(getFile())
+                                     : getFile().getGroup(parentGroupName);
+        parentGroup.addGroup(iodaSchema.getGroup(groupName)->getValidName());
+    }
+
+    netCDF::NcDim IodaWriter::addDim(
+        const std::string &dimName,
+        const size_t len,
+        const std::string &groupName
+    ) const {
+        const auto group = groupName.empty()
+                               ? static_cast<netCDF::NcGroup>(getFile())
+                               : getFile().getGroup(groupName);
+        return group.addDim(iodaSchema.getDimension(dimName)->getValidName(), len);
+    }
+
+    netCDF::NcVar IodaWriter::defineVar(
+        const std::string &groupName,
+        const std::string &varName,
+        const nc_type netcdfDataType,
+        const std::vector<std::string> &dimNames
+    ) const {
+        const auto group = schemaGroup(getFile(), groupName);
+        std::vector<netCDF::NcDim> dims;
+        dims.reserve(dimNames.size());
+        for (const auto &dimName: dimNames) {
+            dims.push_back(getFile().getDim(iodaSchema.getDimension(dimName)->getValidName()));
+        }
+        auto iodaVarName = iodaSchema.getVariable(varName)->getValidName();
+        // the output encoding policy may store the variable in a narrower type
+        const auto *encoding = OutputEncoding::getInstance().find(group.getName(), iodaVarName, netcdfDataType);
+        if (encoding && encoding->isString() && isParallelFile(getFile())) {
+            // the tables of strings are built by each process; parallel files keep NC_STRING
+            encoding = nullptr;
+        }
+        const nc_type storageType = encoding ? encoding->type : netcdfDataType;
+        if (encoding && storageType == NC_CHAR) {
+            dims.push_back(stringLengthDim(getFile(), encoding->stringLength));
+        }
+        auto var = group.addVar(
+            iodaVarName,
+            netCDF::NcType(storageType),
+            dims
+        );
+        if (encoding && encoding->dictionary) {
+            defineDictionary(var);
+        } else if (encoding && !encoding->isString()) {
+            defineEncoding(var, *encoding, netcdfDataType);
+        }
+        if (!dims.empty() && dims[0].isUnlimited()) {
+            // chunks of whole rows, so that an appended block of locations only touches its own chunks
+            size_t rowBytes;
+            netCDF::ncCheck(nc_inq_type(group.getId(), storageType, nullptr, &rowBytes), __FILE__, __LINE__);
+            std::vector<size_t> chunkSizes(dims.size());
+            for (size_t i = 1; i < dims.size(); i++) {
+                chunkSizes[i] = std::max<size_t>(1, dims[i].getSize());
+                rowBytes *= chunkSizes[i];
+            }
+            chunkSizes[0] = appendChunkRows(rowBytes);
+            var.setChunking(netCDF::NcVar::nc_CHUNKED, chunkSizes);
+        } else {
+            LocationBlocks::getInstance().chunk(var);
+        }
+        if (!isParallelFile(getFile())) {
+            FillTracker::getInstance().track(netcdfID, var);
+        }
+        return var;
+    }
+
+    netCDF::NcVar IodaWriter::findVar(
+        const std::string &groupName,
+        const std::string &varName
+    ) const {
+        const auto var = schemaGroup(getFile(), groupName).getVar(iodaSchema.getVariable(varName)->getValidName());
+        if (var.isNull()) {
+            throw netCDF::exceptions::NcNotVar(
+                "variable " + varName + " not found",
+                __FILE__,
+                __LINE__
+            );
+        }
+        return var;
+    }
+
+    int IodaWriter::release() {
+        owned = false;
+        return netcdfID;
+    }
+
+    void IodaWriter::close() {
+        if (!file) {
+            return;
+        }
+        DatetimeRange::getInstance().write(netcdfID, *file);
+        StringDictionary::getInstance().write(netcdfID);
+        FillTracker::getInstance().fillGaps(netcdfID);
+        file->close();
+        FileMap::getInstance().removeFile(netcdfID);
+        file.reset();
+        owned = false;
+    }
+} // namespace Obs2Ioda
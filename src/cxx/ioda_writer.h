@@ -0,0 +1,491 @@
+#ifndef OBS2IODA_IODA_WRITER_H
+#define OBS2IODA_IODA_WRITER_H
+
+#include <netcdf>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "netcdf_file_options.h"
+
+namespace Obs2Ioda {
+    /// The rank of an `IodaVariable` whose rank is only known at run time.
+    constexpr size_t dynamicRank = std::numeric_limits<size_t>::max();
+
+    /**
+     * @class Span
+     * @brief A pointer and a number of elements: a view of contiguous values that is not copied.
+     *
+     * A minimal `std::span` for C++17. A span is made from a pointer and a size,
+     * or from a C array or any container with `data()` and `size()`, e.g. a
+     * `std::vector` or `std::array`.
+     */
+    template<typename T>
+    class Span {
+    public:
+        constexpr Span() = default;
+
+        constexpr Span(
+            T *data,
+            const size_t size
+        ) : pointer(data), length(size) {
+        }
+
+        template<size_t N>
+        constexpr Span(
+            T (&array)[N]
+        ) : pointer(array), length(N) {
+        }
+
+        template<typename Container, typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<Container>, Span> &&
+            std::is_convertible_v<decltype(std::declval<Container &>().data()), T *> > >
+        constexpr Span(
+            Container &&container
+        ) : pointer(container.data()), length(container.size()) {
+        }
+
+        constexpr T *data() const {
+            return pointer;
+        }
+
+        constexpr size_t size() const {
+            return length;
+        }
+
+        constexpr bool empty() const {
+            return length == 0;
+        }
+
+        constexpr T &operator[](
+            const size_t i
+        ) const {
+            return pointer[i];
+        }
+
+        constexpr T *begin() const {
+            return pointer;
+        }
+
+        constexpr T *end() const {
+            return pointer + length;
+        }
+
+    private:
+        T *pointer = nullptr;
+        size_t length = 0;
+    };
+
+    /**
+     * @brief The NetCDF type of the values of a C++ type.
+     *
+     * Defined for the types of the `netcdfPutVar` functions: `int`, `long long`,
+     * `float`, `double` and `const char *` for strings.
+     */
+    template<typename T>
+    struct NetcdfType;
+
+    template<>
+    struct NetcdfType<int> {
+        static constexpr nc_type value = NC_INT;
+    };
+
+    template<>
+    struct NetcdfType<long long> {
+        static constexpr nc_type value = NC_INT64;
+    };
+
+    template<>
+    struct NetcdfType<float> {
+        static constexpr nc_type value = NC_FLOAT;
+    };
+
+    template<>
+    struct NetcdfType<double> {
+        static constexpr nc_type value = NC_DOUBLE;
+    };
+
+    template<>
+    struct NetcdfType<const char *> {
+        static constexpr nc_type value = NC_STRING;
+    };
+
+    /**
+     * @class VariableWriter
+     * @brief Writes the values of type T of one variable, whatever its rank.
+     *
+     * The file, the storage encoding and whether the file is parallel are resolved
+     * once, when the writer is made. Writes go through the same encoding, fill
+     * tracking and `dateTime` range as the `netcdfPutVar` functions, which use it.
+     * Strings of a dictionary-encoded variable are written as indices into its table.
+     * Defined for the types of `NetcdfType`.
+     */
+    template<typename T>
+    class VariableWriter {
+    public:
+        /**
+         * @param netcdfID The NetCDF ID of the file of the variable.
+         * @param var The variable.
+         * @throws netCDF::exceptions::NcBadId if the file is not open.
+         */
+        VariableWriter(
+            int netcdfID,
+            const netCDF::NcVar &var
+        );
+
+        /// The variable.
+        const netCDF::NcVar &getVar() const {
+            return var;
+        }
+
+        /// The current length of each dimension of the variable.
+        std::vector<size_t> getDimLens() const;
+
+        /**
+         * @brief The number of values of the whole variable.
+         *
+         * For `NC_CHAR` variables written as strings, the last dimension is the string
+         * length and is not counted.
+         */
+        size_t getNumValues() const;
+
+        /**
+         * @brief Writes all values of the variable.
+         *
+         * @param values `getNumValues()` values, in row-major order.
+         */
+        void put(
+            const T *values
+        ) const;
+
+        /**
+         * @brief Writes a hyperslab of the variable.
+         *
+         * In a parallel file the write is collective.
+         *
+         * @param start The zero-based index of the first value written, per dimension.
+         * @param count The number of values written, per dimension.
+         * @param values The values, in row-major order.
+         */
+        void put(
+            const std::vector<size_t> &start,
+            const std::vector<size_t> &count,
+            const T *values
+        ) const;
+
+        /**
+         * @brief Sets the fill value of the variable, or disables its fill.
+         *
+         * @param fillMode true to fill the unwritten values with `fillValue`.
+         * @param fillValue The fill value.
+         */
+        void setFill(
+            bool fillMode,
+            T fillValue
+        ) const;
+
+    private:
+        int netcdfID;
+        netCDF::NcVar var;
+        bool parallel;
+        bool encoded;
+    };
+
+    /**
+     * @class IodaVariable
+     * @brief A variable of an IODA file with values of type T and `Rank` dimensions.
+     *
+     * Values are passed as spans and written without copies, except where the
+     * variable is stored in a narrower type. The rank is checked once, when the
+     * variable is made; start and count of hyperslabs are `std::array`s of `Rank`
+     * indices, or `std::vector`s for `dynamicRank`.
+     *
+     * @tparam T The type of the values, one of the types of `NetcdfType`.
+     * @tparam Rank The number of dimensions, or `dynamicRank`.
+     */
+    template<typename T, size_t Rank = dynamicRank>
+    class IodaVariable {
+    public:
+        using Index = std::conditional_t<Rank == dynamicRank, std::vector<size_t>, std::array<size_t, Rank> >;
+
+        /**
+         * @param netcdfID The NetCDF ID of the file of the variable.
+         * @param var The variable.
+         * @throws std::invalid_argument if the variable does not have `Rank` dimensions.
+         */
+        IodaVariable(
+            const int netcdfID,
+            const netCDF::NcVar &var
+        ) : writer(netcdfID, var) {
+            if constexpr (Rank != dynamicRank) {
+                // the string length of NC_CHAR variables is not a dimension of their values
+                const size_t rank = var.getDimCount() - (var.getType() == netCDF::ncChar ? 1 : 0);
+                if (rank != Rank) {
+                    throw std::invalid_argument("variable " + var.getName() + " has " + std::to_string(rank) +
+                                                " dimensions, not " + std::to_string(Rank));
+                }
+            }
+        }
+
+        /// The variable.
+        const netCDF::NcVar &getVar() const {
+            return writer.getVar();
+        }
+
+        /// The number of values of the whole variable.
+        size_t size() const {
+            return writer.getNumValues();
+        }
+
+        /**
+         * @brief Writes all values of the variable.
+         *
+         * @param values `size()` values, in row-major order.
+         * @throws std::invalid_argument if the number of values does not match.
+         */
+        void put(
+            const Span<const T> values
+        ) const {
+            checkSize(values.size(), size());
+            writer.put(values.data());
+        }
+
+        /**
+         * @brief Writes a hyperslab of the variable.
+         *
+         * @param start The zero-based index of the first value written, per dimension.
+         * @param count The number of values written, per dimension.
+         * @param values The product of `count` values, in row-major order.
+         * @throws std::invalid_argument if the number of values does not match.
+         */
+        void put(
+            const Index &start,
+            const Index &count,
+            const Span<const T> values
+        ) const {
+            if constexpr (Rank == dynamicRank) {
+                if (start.size() != count.size()) {
+                    throw std::invalid_argument("start and count of " + getVar().getName() +
+                                                " have different ranks");
+                }
+            }
+            size_t numValues = 1;
+            for (const auto n: count) {
+                numValues *= n;
+            }
+            checkSize(values.size(), numValues);
+            writer.put(std::vector<size_t>(start.begin(), start.end()),
+                       std::vector<size_t>(count.begin(), count.end()), values.data());
+        }
+
+        /**
+         * @brief Fills the unwritten values of the variable with `fillValue`.
+         */
+        void setFill(
+            const T fillValue
+        ) const {
+            writer.setFill(true, fillValue);
+        }
+
+        /**
+         * @brief Leaves the unwritten values of the variable undefined.
+         */
+        void disableFill() const {
+            writer.setFill(false, T{});
+        }
+
+    private:
+        void checkSize(
+            const size_t numValues,
+            const size_t expected
+        ) const {
+            if (numValues != expected) {
+                throw std::invalid_argument(std::to_string(numValues) + " values for " + getVar().getName() +
+                                            ", expected " + std::to_string(expected));
+            }
+        }
+
+        VariableWriter<T> writer;
+    };
+
+    /**
+     * @class IodaWriter
+     * @brief A NetCDF file of the IODA format, open for writing.
+     *
+     * Group, dimension and variable names are mapped to their valid names by the
+     * IODA schema. The file is registered in the `FileMap` under its NetCDF ID, so
+     * that the C interface and the Fortran code can also write to it.
+     *
+     * A writer that opened its file closes it when it is destroyed, unless the
+     * file was released to the C interface with `release`.
+     */
+    class IodaWriter {
+    public:
+        /**
+         * @brief Creates or opens a file, with the HDF5 tuning of the environment.
+         *
+         * @param path The path of the file or store (see `netcdfDatasetPath`).
+         * @param fileMode The mode for creating the file (see `netcdfCreate`).
+         * @throws netCDF::exceptions::NcException if the file cannot be opened.
+         */
+        IodaWriter(
+            const std::string &path,
+            int fileMode
+        );
+
+        /**
+         * @brief Creates or opens a file with HDF5 tuning.
+         *
+         * @param path The path of the file or store (see `netcdfDatasetPath`).
+         * @param fileMode The mode for creating the file (see `netcdfCreate`).
+         * @param options The HDF5 tuning; ignored for NCZarr stores and URLs.
+         * @throws netCDF::exceptions::NcException if the file cannot be opened.
+         */
+        IodaWriter(
+            const std::string &path,
+            int fileMode,
+            const NetcdfFileOptions &options
+        );
+
+        /**
+         * @brief Refers to a file opened by the C interface, without taking it over.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         * @throws netCDF::exceptions::NcBadId if the file is not open.
+         */
+        explicit IodaWriter(
+            int netcdfID
+        );
+
+        ~IodaWriter();
+
+        IodaWriter(
+            const IodaWriter &
+        ) = delete;
+
+        IodaWriter &operator=(
+            const IodaWriter &
+        ) = delete;
+
+        IodaWriter(
+            IodaWriter &&other
+        ) noexcept;
+
+        IodaWriter &operator=(
+            IodaWriter &&other
+        ) noexcept;
+
+        /// The NetCDF ID of the file.
+        int getNetcdfID() const {
+            return netcdfID;
+        }
+
+        /// The file, e.g. to write attributes.
+        netCDF::NcFile &getFile() const;
+
+        /**
+         * @brief Adds a group.
+         *
+         * @param groupName The name of the group.
+         * @param parentGroupName The group to add it to, empty for the root group.
+         */
+        void addGroup(
+            const std::string &groupName,
+            const std::string &parentGroupName = ""
+        ) const;
+
+        /**
+         * @brief Adds a dimension.
+         *
+         * @param dimName The name of the dimension.
+         * @param len The length, or 0 for an unlimited dimension.
+         * @param groupName The group to add it to, empty for the root group.
+         * @return The dimension.
+         */
+        netCDF::NcDim addDim(
+            const std::string &dimName,
+            size_t len,
+            const std::string &groupName = ""
+        ) const;
+
+        /**
+         * @brief Defines a variable, stored in the type of the output encoding policy.
+         *
+         * @param groupName The group of the variable, empty for the root group.
+         * @param varName The name of the variable.
+         * @param netcdfDataType The type of the values written to the variable.
+         * @param dimNames The dimensions of the variable.
+         * @return The variable.
+         */
+        netCDF::NcVar defineVar(
+            const std::string &groupName,
+            const std::string &varName,
+            nc_type netcdfDataType,
+            const std::vector<std::string> &dimNames
+        ) const;
+
+        /**
+         * @brief Finds a variable.
+         *
+         * @throws netCDF::exceptions::NcException if there is no such variable.
+         */
+        netCDF::NcVar findVar(
+            const std::string &groupName,
+            const std::string &varName
+        ) const;
+
+        /**
+         * @brief Defines a variable for values of type T.
+         *
+         * @return The variable, ready for writing.
+         */
+        template<typename T, size_t Rank = dynamicRank>
+        IodaVariable<T, Rank> addVar(
+            const std::string &groupName,
+            const std::string &varName,
+            const std::vector<std::string> &dimNames
+        ) const {
+            return IodaVariable<T, Rank>(netcdfID, defineVar(groupName, varName, NetcdfType<T>::value, dimNames));
+        }
+
+        /**
+         * @brief Looks up a variable of the file for writing values of type T.
+         */
+        template<typename T, size_t Rank = dynamicRank>
+        IodaVariable<T, Rank> getVar(
+            const std::string &groupName,
+            const std::string &varName
+        ) const {
+            return IodaVariable<T, Rank>(netcdfID, findVar(groupName, varName));
+        }
+
+        /**
+         * @brief Hands the file over to the C interface, which closes it with `netcdfClose`.
+         *
+         * @return The NetCDF ID of the file.
+         */
+        int release();
+
+        /**
+         * @brief Closes the file.
+         *
+         * Before closing, unwritten rows of the variables are filled and the
+         * `min_datetime`/`max_datetime` of an appended file are widened. A writer
+         * referring to a file of the C interface also closes it.
+         */
+        void close();
+
+    private:
+        int netcdfID = -1;
+        std::shared_ptr<netCDF::NcFile> file;
+        /// Whether the file is closed with the writer.
+        bool owned = false;
+    };
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_IODA_WRITER_H
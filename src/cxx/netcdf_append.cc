@@ -0,0 +1,75 @@
+#include "netcdf_append.h"
+#include "netcdf_file.h"
+#include <algorithm>
+
+namespace Obs2Ioda {
+    size_t appendChunkRows(
+        const size_t rowBytes
+    ) {
+        return std::max<size_t>(1, appendChunkBytes / std::max<size_t>(1, rowBytes));
+    }
+
+    DatetimeRange &DatetimeRange::getInstance() {
+        static DatetimeRange instance;
+        return instance;
+    }
+
+    void DatetimeRange::record(
+        const int netcdfID,
+        const netCDF::NcVar &var,
+        const long long *values,
+        const size_t numValues
+    ) {
+        if (var.getDimCount() == 0 || !var.getDim(0).isUnlimited() ||
+            var.getName() != iodaSchema.getVariable("dateTime")->getValidName() ||
+            var.getParentGroup().getName() != iodaSchema.getGroup("MetaData")->getValidName()) {
+            return;
+        }
+        long long fillValue;
+        int noFill;
+        netCDF::ncCheck(nc_inq_var_fill(var.getParentGroup().getId(), var.getId(), &noFill, &fillValue),
+                        __FILE__, __LINE__);
+        auto range = ranges.find(netcdfID);
+        for (size_t i = 0; i < numValues; i++) {
+            if (values[i] == fillValue) {
+                continue;
+            }
+            if (range == ranges.end()) {
+                range = ranges.emplace(netcdfID, std::make_pair(values[i], values[i])).first;
+            }
+            range->second.first = std::min(range->second.first, values[i]);
+            range->second.second = std::max(range->second.second, values[i]);
+        }
+    }
+
+    void DatetimeRange::write(
+        const int netcdfID,
+        const netCDF::NcGroup &file
+    ) {
+        const auto range = ranges.find(netcdfID);
+        if (range == ranges.end()) {
+            return;
+        }
+        auto minDatetime = epochToDatetime(range->second.first);
+        auto maxDatetime = epochToDatetime(range->second.second);
+        ranges.erase(range);
+        // the ISO 8601 strings of the attributes order like the times they represent
+        const auto atts = file.getAtts();
+        const auto minAtt = atts.find("min_datetime");
+        if (minAtt != atts.end() && minAtt->second.getType() == netCDF::ncChar) {
+            std::string value;
+            minAtt->second.getValues(value);
+            if (!value.empty()) {
+                minDatetime = std::min(minDatetime, value);
+            }
+        }
+        const auto maxAtt = atts.find("max_datetime");
+        if (maxAtt != atts.end() && maxAtt->second.getType() == netCDF::ncChar) {
+            std::string value;
+            maxAtt->second.getValues(value);
+            maxDatetime = std::max(maxDatetime, value);
+        }
+        file.putAtt("min_datetime", minDatetime);
+        file.putAtt("max_datetime", maxDatetime);
+    }
+} // namespace Obs2Ioda
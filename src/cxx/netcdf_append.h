@@ -0,0 +1,94 @@
+#ifndef OBS2IODA_NETCDF_APPEND_H
+#define OBS2IODA_NETCDF_APPEND_H
+
+#include <netcdf>
+#include <map>
+#include <string>
+#include <utility>
+#include "epoch_time.h"
+
+namespace Obs2Ioda {
+    /// Target size, in bytes, of a chunk of a variable along an unlimited dimension.
+    constexpr size_t appendChunkBytes = 1 << 20;
+
+    /**
+     * @brief Number of rows in a chunk of a variable whose first dimension is unlimited.
+     *
+     * The chunk holds about `appendChunkBytes`, the size of the default HDF5 chunk
+     * cache, so that the partly written last chunk of a file stays in the cache
+     * while a block of locations is appended to it.
+     *
+     * @param rowBytes The size of one row (one location) of the variable in bytes.
+     * @return The number of rows per chunk, at least 1.
+     */
+    size_t appendChunkRows(
+        size_t rowBytes
+    );
+
+    /**
+     * @class DatetimeRange
+     * @brief Singleton class keeping the range of the `dateTime` values appended to files.
+     *
+     * Files with an unlimited location dimension grow by blocks of locations, e.g.
+     * one block per scan of a geostationary imager. The `dateTime` values of every
+     * block are folded into a running minimum and maximum, and the `min_datetime`
+     * and `max_datetime` attributes are widened to this range when the file is
+     * closed, so that an append never reads the locations already in the file.
+     */
+    class DatetimeRange {
+    public:
+        /**
+         * @brief Retrieves the singleton instance of the DatetimeRange.
+         *
+         * @return A reference to the singleton instance of DatetimeRange.
+         */
+        static DatetimeRange &getInstance();
+
+        DatetimeRange(
+            const DatetimeRange &
+        ) = delete;
+
+        DatetimeRange &operator=(
+            const DatetimeRange &
+        ) = delete;
+
+        /**
+         * @brief Records the values written to a variable, if it is `MetaData/dateTime`
+         * along an unlimited dimension.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         * @param var The variable written.
+         * @param values The values, in seconds since 1970-01-01T00:00:00Z.
+         * @param numValues The number of values.
+         */
+        void record(
+            int netcdfID,
+            const netCDF::NcVar &var,
+            const long long *values,
+            size_t numValues
+        );
+
+        /**
+         * @brief Widens the `min_datetime` and `max_datetime` attributes of a file to
+         * the recorded range and forgets the range.
+         *
+         * Called before the file is closed. Nothing is written if no `dateTime` values
+         * were recorded for the file.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         * @param file The file.
+         */
+        void write(
+            int netcdfID,
+            const netCDF::NcGroup &file
+        );
+
+    private:
+        DatetimeRange() = default;
+
+        /// Smallest and largest `dateTime` written, per NetCDF file ID.
+        std::map<int, std::pair<long long, long long> > ranges;
+    };
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_NETCDF_APPEND_H
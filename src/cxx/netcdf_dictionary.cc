@@ -0,0 +1,138 @@
+#include "netcdf_dictionary.h"
+#include "netcdf_fill.h"
+#include <limits>
+#include <stdexcept>
+
+namespace Obs2Ioda {
+    namespace {
+        std::string tableName(
+            const netCDF::NcVar &var
+        ) {
+            return var.getName() + "_dictionary";
+        }
+
+        netCDF::NcVar tableVar(
+            const netCDF::NcVar &var
+        ) {
+            std::string name;
+            var.getAtt(dictionaryAttName).getValues(name);
+            const auto table = var.getParentGroup().getVar(name);
+            if (table.isNull()) {
+                throw netCDF::exceptions::NcNotVar(
+                    "dictionary " + name + " of " + var.getName() + " not found",
+                    __FILE__,
+                    __LINE__
+                );
+            }
+            return table;
+        }
+    }
+
+    void defineDictionary(
+        const netCDF::NcVar &var
+    ) {
+        const auto group = var.getParentGroup();
+        const auto name = tableName(var);
+        const auto dim = group.addDim(name);
+        group.addVar(name, netCDF::ncString, std::vector<netCDF::NcDim>{dim});
+        var.putAtt(dictionaryAttName, name);
+    }
+
+    bool isDictionaryEncoded(
+        const netCDF::NcVar &var
+    ) {
+        if (var.getType() != netCDF::ncInt) {
+            return false;
+        }
+        const auto atts = var.getAtts();
+        return atts.find(dictionaryAttName) != atts.end();
+    }
+
+    std::vector<std::string> readDictionary(
+        const netCDF::NcVar &var
+    ) {
+        const auto table = tableVar(var);
+        const size_t numEntries = table.getDim(0).getSize();
+        std::vector<std::string> entries;
+        if (numEntries == 0) {
+            return entries;
+        }
+        std::vector<char *> strings(numEntries);
+        table.getVar(strings.data());
+        entries.reserve(numEntries);
+        for (const auto *string: strings) {
+            entries.emplace_back(string ? string : "");
+        }
+        nc_free_string(numEntries, strings.data());
+        return entries;
+    }
+
+    StringDictionary &StringDictionary::getInstance() {
+        static StringDictionary instance;
+        return instance;
+    }
+
+    std::vector<int> StringDictionary::encode(
+        const int netcdfID,
+        const netCDF::NcVar &var,
+        const char *const *values,
+        const size_t numValues
+    ) {
+        const auto key = std::make_pair(var.getParentGroup().getId(), var.getId());
+        auto &tables = files[netcdfID];
+        auto found = tables.find(key);
+        if (found == tables.end()) {
+            Table table;
+            table.var = tableVar(var);
+            for (auto &entry: readDictionary(var)) {
+                table.entries.push_back(std::move(entry));
+                table.indices.emplace(table.entries.back(), static_cast<int>(table.entries.size() - 1));
+            }
+            table.numWritten = table.entries.size();
+            found = tables.emplace(key, std::move(table)).first;
+        }
+        auto &table = found->second;
+        std::vector<int> indices(numValues);
+        for (size_t i = 0; i < numValues; i++) {
+            const std::string_view value = values[i] ? values[i] : "";
+            const auto entry = table.indices.find(value);
+            if (entry != table.indices.end()) {
+                indices[i] = entry->second;
+                continue;
+            }
+            if (table.entries.size() >= static_cast<size_t>(std::numeric_limits<int>::max())) {
+                throw std::length_error("dictionary of " + var.getName() + " is full");
+            }
+            table.entries.emplace_back(value);
+            indices[i] = static_cast<int>(table.entries.size() - 1);
+            table.indices.emplace(table.entries.back(), indices[i]);
+        }
+        return indices;
+    }
+
+    void StringDictionary::write(
+        const int netcdfID
+    ) {
+        const auto file = files.find(netcdfID);
+        if (file == files.end()) {
+            return;
+        }
+        const auto tables = std::move(file->second);
+        files.erase(file);
+        for (const auto &pair: tables) {
+            const auto &table = pair.second;
+            if (table.entries.size() == table.numWritten) {
+                continue;
+            }
+            std::vector<const char *> strings;
+            for (size_t i = table.numWritten; i < table.entries.size(); i++) {
+                strings.push_back(table.entries[i].c_str());
+            }
+            const std::vector<size_t> start = {table.numWritten};
+            const std::vector<size_t> count = {strings.size()};
+            // the table of a file opened for appending is tracked like its other variables
+            FillTracker::getInstance().markWritten(netcdfID, table.var, start, count);
+            table.var.putVar(start, count, strings.data());
+        }
+    }
+} // namespace Obs2Ioda
@@ -0,0 +1,117 @@
+#ifndef OBS2IODA_NETCDF_DICTIONARY_H
+#define OBS2IODA_NETCDF_DICTIONARY_H
+
+#include <netcdf>
+#include <deque>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Obs2Ioda {
+    /// Attribute of a dictionary-encoded variable naming its table of strings.
+    constexpr const char *dictionaryAttName = "dictionary";
+
+    /**
+     * @brief Defines the table of strings of a dictionary-encoded variable.
+     *
+     * The variable holds an `NC_INT` index into the table per value. The table is the
+     * `NC_STRING` variable `<name>_dictionary` of the same group, along an unlimited
+     * dimension of the same name, and is named by the `dictionary` attribute of the
+     * variable.
+     *
+     * @param var The index variable, just defined.
+     */
+    void defineDictionary(
+        const netCDF::NcVar &var
+    );
+
+    /**
+     * @brief Whether a variable holds indices into a table of strings.
+     */
+    bool isDictionaryEncoded(
+        const netCDF::NcVar &var
+    );
+
+    /**
+     * @brief Reads the table of strings of a dictionary-encoded variable.
+     *
+     * @return The strings, by index.
+     */
+    std::vector<std::string> readDictionary(
+        const netCDF::NcVar &var
+    );
+
+    /**
+     * @class StringDictionary
+     * @brief Singleton class building the tables of strings of dictionary-encoded variables.
+     *
+     * Strings are looked up in one hash table per variable as they are written. Each
+     * distinct string is stored once, and the new entries are written to the table
+     * when the file is closed. The table of a file opened for appending is read on
+     * the first write, so that earlier indices stay valid.
+     */
+    class StringDictionary {
+    public:
+        /**
+         * @brief Retrieves the singleton instance of the StringDictionary.
+         *
+         * @return A reference to the singleton instance of StringDictionary.
+         */
+        static StringDictionary &getInstance();
+
+        StringDictionary(
+            const StringDictionary &
+        ) = delete;
+
+        StringDictionary &operator=(
+            const StringDictionary &
+        ) = delete;
+
+        /**
+         * @brief Looks up strings, adding the new ones to the table of a variable.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         * @param var The dictionary-encoded variable.
+         * @param values The strings; null pointers are empty strings.
+         * @param numValues The number of strings.
+         * @return The index of each string.
+         */
+        std::vector<int> encode(
+            int netcdfID,
+            const netCDF::NcVar &var,
+            const char *const *values,
+            size_t numValues
+        );
+
+        /**
+         * @brief Writes the new entries of the tables of a file and forgets them.
+         *
+         * Called before the file is closed.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         */
+        void write(
+            int netcdfID
+        );
+
+    private:
+        StringDictionary() = default;
+
+        struct Table {
+            netCDF::NcVar var;
+            /// The strings by index; a deque, so that the keys of `indices` stay valid.
+            std::deque<std::string> entries;
+            std::unordered_map<std::string_view, int> indices;
+            /// The number of entries already in the file.
+            size_t numWritten = 0;
+        };
+
+        /// Tables by NetCDF ID and by group and variable ID of the index variable.
+        std::map<int, std::map<std::pair<int, int>, Table> > files;
+    };
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_NETCDF_DICTIONARY_H
@@ -1,4 +1,5 @@
 #include "netcdf_dimension.h"
+#include "ioda_writer.h"
 #include "netcdf_file.h"
 #include "netcdf_error.h"
 
@@ -7,8 +8,31 @@ namespace Obs2Ioda {
         const int netcdfID,
         const char *groupName,
         const char *dimName,
-        const int len,
+        const size_t len,
         int *dimID
+    ) {
+        try {
+            const auto dim = IodaWriter(netcdfID).addDim(
+                dimName,
+                len,
+                groupName ? groupName : ""
+            );
+            *dimID = dim.getId();
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        }
+    }
+
+    int netcdfGetDimLen(
+        const int netcdfID,
+        const char *groupName,
+        const char *dimName,
+        size_t *len
     ) {
         try {
             const auto file = FileMap::getInstance().getFile(netcdfID);
@@ -18,9 +42,16 @@ namespace Obs2Ioda {
                                        netCDF::NcGroup>(
                                        file->getGroup(
                                            groupName));
-            auto iodaDimName = iodaSchema.getDimension(dimName)->getValidName();
-            auto dim = group->addDim(iodaDimName, len);
-            *dimID = dim.getId();
+            const auto iodaDimName = iodaSchema.getDimension(dimName)->getValidName();
+            const auto dim = group->getDim(iodaDimName, netCDF::NcGroup::ParentsAndCurrent);
+            if (dim.isNull()) {
+                throw netCDF::exceptions::NcBadDim(
+                    "dimension " + iodaDimName + " not found",
+                    __FILE__,
+                    __LINE__
+                );
+            }
+            *len = dim.getSize();
             return 0;
         } catch (netCDF::exceptions::NcException &e) {
             return netcdfErrorMessage(
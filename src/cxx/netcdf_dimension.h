@@ -1,6 +1,7 @@
 #ifndef NETCDF_DIMENSION_H
 #define NETCDF_DIMENSION_H
 
+#include <cstddef>
 
 namespace Obs2Ioda {
     extern "C" {
@@ -20,7 +21,9 @@ namespace Obs2Ioda {
 *     A null-terminated string specifying the name of the new dimension. The name must
 *     be unique within the target group.
 * @param len
-*     The length of the dimension.
+*     The length of the dimension. A length of 0 (`NC_UNLIMITED`) creates an
+*     unlimited dimension, e.g. a location dimension that grows as blocks of
+*     locations are appended to the file.
 *
 * @param dimID
 *     A pointer to an integer that will be set to the ID of the new dimension.
@@ -33,9 +36,28 @@ namespace Obs2Ioda {
         int netcdfID,
         const char *groupName,
         const char *dimName,
-        int len,
+        size_t len,
         int *dimID
     );
+
+    /**
+     * @brief Retrieves the current length of a dimension.
+     *
+     * Used to find the first free location of a file opened for append, whose
+     * location dimension is unlimited.
+     *
+     * @param netcdfID The identifier of the NetCDF file.
+     * @param groupName The name of the group of the dimension, or NULL for the root group.
+     * @param dimName The name of the dimension.
+     * @param len Receives the length of the dimension.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfGetDimLen(
+        int netcdfID,
+        const char *groupName,
+        const char *dimName,
+        size_t *len
+    );
     }
 }
 
@@ -0,0 +1,445 @@
+#include "netcdf_encoding.h"
+#include "netcdf_file.h"
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Obs2Ioda {
+    namespace {
+        bool isInteger(
+            const nc_type type
+        ) {
+            return type == NC_BYTE || type == NC_SHORT || type == NC_INT || type == NC_INT64;
+        }
+
+        size_t typeSize(
+            const nc_type type
+        ) {
+            switch (type) {
+                case NC_BYTE:
+                    return 1;
+                case NC_SHORT:
+                    return 2;
+                case NC_INT:
+                case NC_FLOAT:
+                    return 4;
+                default:
+                    return 8;
+            }
+        }
+
+        /**
+         * @brief Calls `f` with a value of the C++ type of a numeric NetCDF type.
+         */
+        template<typename F>
+        void visitStorageType(
+            const nc_type type,
+            F &&f
+        ) {
+            switch (type) {
+                case NC_BYTE:
+                    f(static_cast<signed char>(0));
+                    return;
+                case NC_SHORT:
+                    f(static_cast<short>(0));
+                    return;
+                case NC_INT:
+                    f(0);
+                    return;
+                case NC_INT64:
+                    f(0LL);
+                    return;
+                case NC_FLOAT:
+                    f(0.0f);
+                    return;
+                case NC_DOUBLE:
+                    f(0.0);
+                    return;
+                default:
+                    throw std::invalid_argument("unsupported storage type " + std::to_string(type));
+            }
+        }
+
+        template<typename T>
+        constexpr nc_type ncTypeOf() {
+            if constexpr (std::is_same_v<T, int>) {
+                return NC_INT;
+            } else if constexpr (std::is_same_v<T, long long>) {
+                return NC_INT64;
+            } else if constexpr (std::is_same_v<T, float>) {
+                return NC_FLOAT;
+            } else {
+                return NC_DOUBLE;
+            }
+        }
+
+        /// The `_FillValue` of packed variables and of values the storage type cannot represent.
+        template<typename S>
+        S fillCode() {
+            return std::numeric_limits<S>::lowest();
+        }
+
+        template<typename S>
+        bool isRepresentable(
+            const double value
+        ) {
+            if constexpr (std::is_integral_v<S>) {
+                return value == std::trunc(value) && value >= static_cast<double>(std::numeric_limits<S>::min())
+                       && value <= static_cast<double>(std::numeric_limits<S>::max());
+            } else {
+                return static_cast<double>(static_cast<S>(value)) == value;
+            }
+        }
+
+        struct Packing {
+            bool packed = false;
+            double scaleFactor = 1.0;
+            double addOffset = 0.0;
+        };
+
+        Packing readPacking(
+            const netCDF::NcVar &var
+        ) {
+            Packing packing;
+            const auto atts = var.getAtts();
+            const auto scaleFactor = atts.find("scale_factor");
+            if (scaleFactor != atts.end()) {
+                packing.packed = true;
+                scaleFactor->second.getValues(&packing.scaleFactor);
+            }
+            const auto addOffset = atts.find("add_offset");
+            if (packing.packed && addOffset != atts.end()) {
+                addOffset->second.getValues(&packing.addOffset);
+            }
+            return packing;
+        }
+
+        template<typename S>
+        S readFillValue(
+            const netCDF::NcVar &var
+        ) {
+            const auto atts = var.getAtts();
+            const auto fillValue = atts.find("_FillValue");
+            if (fillValue == atts.end()) {
+                return fillCode<S>();
+            }
+            S value;
+            fillValue->second.getValues(&value);
+            return value;
+        }
+
+        double varMissingValue(
+            const netCDF::NcVar &var
+        ) {
+            return OutputEncoding::getInstance().missingValue(var.getParentGroup().getName(), var.getName());
+        }
+
+        size_t numValues(
+            const std::vector<size_t> &count
+        ) {
+            size_t n = 1;
+            for (const auto c: count) {
+                n *= c;
+            }
+            return n;
+        }
+    }
+
+    OutputEncoding &OutputEncoding::getInstance() {
+        static OutputEncoding instance;
+        return instance;
+    }
+
+    void OutputEncoding::load(const YAML::Node &node) {
+        static const std::map<std::string, nc_type> types = {
+            {"byte", NC_BYTE}, {"short", NC_SHORT}, {"int", NC_INT}, {"int64", NC_INT64}, {"float", NC_FLOAT},
+            {"dictionary", NC_INT}, {"char", NC_CHAR}
+        };
+        std::map<std::string, VariableEncoding> loaded;
+        const double missing = node["missing_value"] ? node["missing_value"].as<double>() : encodingMissingValue;
+        const auto encodingsNode = node["encodings"];
+        if (encodingsNode && !encodingsNode.IsNull() && !encodingsNode.IsMap()) {
+            throw std::invalid_argument("encodings of the output encoding must be a map");
+        }
+        const bool iodaCompatible = node["ioda_compatible"] ? node["ioda_compatible"].as<bool>() : true;
+        for (const auto &entry: encodingsNode) {
+            const auto key = entry.first.as<std::string>();
+            const auto slash = key.rfind('/');
+            if (slash == std::string::npos || slash == 0 || slash + 1 == key.size()) {
+                throw std::invalid_argument("output encoding key " + key + " is not <group>/<variable>");
+            }
+            const auto groupName = iodaSchema.getGroup(key.substr(0, slash))->getValidName();
+            const auto varName = key.substr(slash + 1);
+            if (iodaCompatible) {
+                throw std::invalid_argument("output encoding of " + key
+                                            + " changes a type IODA reads and needs ioda_compatible: false");
+            }
+            const auto type = types.find(entry.second["type"] ? entry.second["type"].as<std::string>() : "");
+            if (type == types.end()) {
+                throw std::invalid_argument("output encoding of " + key
+                                            + " needs a type: byte, short, int, int64, float, dictionary or char");
+            }
+            VariableEncoding encoding{type->second, 0.0, 0.0, missing};
+            if (type->first == "dictionary") {
+                encoding.dictionary = true;
+            } else if (type->second == NC_CHAR) {
+                const long long length = entry.second["length"] ? entry.second["length"].as<long long>() : 0;
+                if (length <= 0) {
+                    throw std::invalid_argument("char output encoding of " + key + " needs a positive length");
+                }
+                encoding.stringLength = static_cast<size_t>(length);
+            }
+            if (encoding.isString() && entry.second["scale_factor"]) {
+                throw std::invalid_argument("string output encoding of " + key + " cannot be packed");
+            }
+            if (entry.second["scale_factor"]) {
+                encoding.scaleFactor = entry.second["scale_factor"].as<double>();
+                encoding.addOffset = entry.second["add_offset"] ? entry.second["add_offset"].as<double>() : 0.0;
+                if (!std::isfinite(encoding.scaleFactor) || encoding.scaleFactor == 0.0 || !isInteger(encoding.type)) {
+                    throw std::invalid_argument("packed output encoding of " + key
+                                                + " needs a non-zero scale_factor and an integer type");
+                }
+            }
+            if (entry.second["missing_value"]) {
+                encoding.missingValue = entry.second["missing_value"].as<double>();
+            }
+            loaded[groupName + "/" + (varName == "*" ? varName : iodaSchema.getVariable(varName)->getValidName())] =
+                    encoding;
+        }
+        encodings = std::move(loaded);
+        defaultMissingValue = missing;
+    }
+
+    void OutputEncoding::clear() {
+        encodings.clear();
+        defaultMissingValue = encodingMissingValue;
+    }
+
+    const VariableEncoding *OutputEncoding::find(
+        const std::string &groupName,
+        const std::string &varName
+    ) const {
+        auto it = encodings.find(groupName + "/" + varName);
+        if (it == encodings.end()) {
+            it = encodings.find(groupName + "/*");
+        }
+        return it == encodings.end() ? nullptr : &it->second;
+    }
+
+    const VariableEncoding *OutputEncoding::find(
+        const std::string &groupName,
+        const std::string &varName,
+        const nc_type declaredType
+    ) const {
+        const auto *encoding = find(groupName, varName);
+        if (!encoding) {
+            return nullptr;
+        }
+        bool applies;
+        if (encoding->isString() || declaredType == NC_STRING) {
+            applies = encoding->isString() && declaredType == NC_STRING;
+        } else {
+            applies = encoding->packed()
+                          ? declaredType == NC_FLOAT || declaredType == NC_DOUBLE
+                          : isNarrowing(encoding->type, declaredType);
+        }
+        return applies ? encoding : nullptr;
+    }
+
+    double OutputEncoding::missingValue(
+        const std::string &groupName,
+        const std::string &varName
+    ) const {
+        const auto *encoding = find(groupName, varName);
+        return encoding ? encoding->missingValue : defaultMissingValue;
+    }
+
+    bool isNarrowing(
+        const nc_type storageType,
+        const nc_type dataType
+    ) {
+        if (isInteger(storageType)) {
+            return dataType == NC_FLOAT || dataType == NC_DOUBLE
+                   || (isInteger(dataType) && typeSize(dataType) > typeSize(storageType));
+        }
+        return storageType == NC_FLOAT && dataType == NC_DOUBLE;
+    }
+
+    template<typename T>
+    bool isEncoded(
+        const netCDF::NcVar &var
+    ) {
+        if (!isNarrowing(var.getType().getId(), ncTypeOf<T>())) {
+            return false;
+        }
+        // other narrowing writes, e.g. of float scan positions to an int variable, are converted by netCDF-C
+        return readPacking(var).packed
+               || OutputEncoding::getInstance().find(var.getParentGroup().getName(), var.getName(), ncTypeOf<T>()) != nullptr;
+    }
+
+    double encodedFillValue(
+        const netCDF::NcVar &var,
+        const double fillValue
+    ) {
+        const bool packed = readPacking(var).packed;
+        double storedFill = fillValue;
+        visitStorageType(var.getType().getId(), [&](auto tag) {
+            using S = decltype(tag);
+            if (packed || !isRepresentable<S>(fillValue)) {
+                const double missing = varMissingValue(var);
+                if (fillValue != missing) {
+                    std::ostringstream message;
+                    message << "fill value " << fillValue << " of " << var.getParentGroup().getName() << "/"
+                            << var.getName() << " differs from the missing value " << missing << " of its encoding";
+                    throw std::invalid_argument(message.str());
+                }
+                storedFill = static_cast<double>(fillCode<S>());
+            }
+        });
+        return storedFill;
+    }
+
+    void defineEncoding(
+        const netCDF::NcVar &var,
+        const VariableEncoding &encoding,
+        const nc_type declaredType
+    ) {
+        if (encoding.packed()) {
+            var.putAtt("scale_factor", netCDF::NcType(declaredType), encoding.scaleFactor);
+            var.putAtt("add_offset", netCDF::NcType(declaredType), encoding.addOffset);
+        }
+        visitStorageType(encoding.type, [&](auto tag) {
+            using S = decltype(tag);
+            if (encoding.packed() || !isRepresentable<S>(encoding.missingValue)) {
+                var.putAtt("_FillValue", var.getType(), static_cast<double>(fillCode<S>()));
+            }
+        });
+    }
+
+    template<typename T>
+    void putEncoded(
+        const netCDF::NcVar &var,
+        const std::vector<size_t> &start,
+        const std::vector<size_t> &count,
+        const T *values
+    ) {
+        const size_t n = numValues(count);
+        const auto packing = readPacking(var);
+        const double missing = varMissingValue(var);
+        visitStorageType(var.getType().getId(), [&](auto tag) {
+            using S = decltype(tag);
+            const bool mapsMissing = packing.packed || !isRepresentable<S>(missing);
+            const S fillValue = readFillValue<S>(var);
+            // the smallest integer is the fill value of packed and byte variables, never data
+            const double lowest = std::is_integral_v<S>
+                                      ? static_cast<double>(std::numeric_limits<S>::min()) + 1.0
+                                      : -static_cast<double>(std::numeric_limits<S>::max());
+            const double highest = static_cast<double>(std::numeric_limits<S>::max());
+            std::vector<S> stored(n);
+            size_t firstBad = n;
+            for (size_t i = 0; i < n; i++) {
+                const double value = static_cast<double>(values[i]);
+                if (mapsMissing && value == missing) {
+                    stored[i] = fillValue;
+                    continue;
+                }
+                double x = packing.packed ? std::round((value - packing.addOffset) / packing.scaleFactor) : value;
+                bool inRange;
+                if constexpr (std::is_integral_v<S>) {
+                    x = std::trunc(x);
+                    // the largest int64 is not a double; 2^63 itself is out of range
+                    inRange = x >= lowest && (sizeof(S) < 8 ? x <= highest : x < highest);
+                } else {
+                    inRange = !std::isfinite(x) || (x >= lowest && x <= highest);
+                }
+                if (!inRange) {
+                    firstBad = std::min(firstBad, i);
+                    continue;
+                }
+                stored[i] = static_cast<S>(x);
+            }
+            if (firstBad < n) {
+                std::ostringstream message;
+                message << "value " << static_cast<double>(values[firstBad]) << " of "
+                        << var.getParentGroup().getName() << "/" << var.getName()
+                        << " does not fit its output encoding";
+                throw std::out_of_range(message.str());
+            }
+            if (start.empty()) {
+                var.putVar(stored.data());
+            } else {
+                var.putVar(start, count, stored.data());
+            }
+        });
+    }
+
+    template<typename T>
+    void getEncoded(
+        const netCDF::NcVar &var,
+        const std::vector<size_t> &start,
+        const std::vector<size_t> &count,
+        T *values
+    ) {
+        const size_t n = numValues(count);
+        const auto packing = readPacking(var);
+        const double missing = varMissingValue(var);
+        visitStorageType(var.getType().getId(), [&](auto tag) {
+            using S = decltype(tag);
+            const bool mapsMissing = packing.packed || !isRepresentable<S>(missing);
+            const S fillValue = readFillValue<S>(var);
+            std::vector<S> stored(n);
+            if (start.empty()) {
+                var.getVar(stored.data());
+            } else {
+                var.getVar(start, count, stored.data());
+            }
+            for (size_t i = 0; i < n; i++) {
+                if (mapsMissing && stored[i] == fillValue) {
+                    values[i] = static_cast<T>(missing);
+                } else if (packing.packed) {
+                    values[i] = static_cast<T>(stored[i] * packing.scaleFactor + packing.addOffset);
+                } else {
+                    values[i] = static_cast<T>(stored[i]);
+                }
+            }
+        });
+    }
+
+    template bool isEncoded<int>(const netCDF::NcVar &);
+    template bool isEncoded<long long>(const netCDF::NcVar &);
+    template bool isEncoded<float>(const netCDF::NcVar &);
+    template bool isEncoded<double>(const netCDF::NcVar &);
+    template void putEncoded(const netCDF::NcVar &, const std::vector<size_t> &, const std::vector<size_t> &,
+                             const int *);
+    template void putEncoded(const netCDF::NcVar &, const std::vector<size_t> &, const std::vector<size_t> &,
+                             const long long *);
+    template void putEncoded(const netCDF::NcVar &, const std::vector<size_t> &, const std::vector<size_t> &,
+                             const float *);
+    template void putEncoded(const netCDF::NcVar &, const std::vector<size_t> &, const std::vector<size_t> &,
+                             const double *);
+    template void getEncoded(const netCDF::NcVar &, const std::vector<size_t> &, const std::vector<size_t> &,
+                             int *);
+    template void getEncoded(const netCDF::NcVar &, const std::vector<size_t> &, const std::vector<size_t> &,
+                             long long *);
+    template void getEncoded(const netCDF::NcVar &, const std::vector<size_t> &, const std::vector<size_t> &,
+                             float *);
+    template void getEncoded(const netCDF::NcVar &, const std::vector<size_t> &, const std::vector<size_t> &,
+                             double *);
+
+    static int encodingErrorMessage(const std::exception &e, int lineNumber, const char *fileName) {
+        std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+        return -1;
+    }
+
+    int netcdfEncodingLoad(const char *path) {
+        try {
+            OutputEncoding::getInstance().load(YAML::LoadFile(path));
+            return 0;
+        } catch (std::exception &e) {
+            return encodingErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#ifndef OBS2IODA_NETCDF_ENCODING_H
+#define OBS2IODA_NETCDF_ENCODING_H
+
+#include <netcdf>
+#include <map>
+#include <string>
+#include <vector>
+#include "yaml-cpp/yaml.h"
+
+namespace Obs2Ioda {
+    /// Missing value of obs2ioda (`missing_r` and `missing_i` in define_mod.f90).
+    constexpr double encodingMissingValue = -999.0;
+
+    /**
+     * @brief Storage of a variable in a narrower type than it is written with.
+     *
+     * Without a scale factor, values are stored in `type`. With one, floating
+     * point values are packed as `round((value - addOffset) / scaleFactor)` in the
+     * integer `type`, with `scale_factor` and `add_offset` attributes (CF
+     * conventions). Only readers that apply these attributes unpack the values;
+     * IODA reads the stored integers, so these files are not IODA files.
+     *
+     * Strings are stored either as `NC_INT` indices into a table of the distinct
+     * strings (`dictionary`), or as `NC_CHAR` arrays of `stringLength` characters.
+     */
+    struct VariableEncoding {
+        nc_type type;        ///< The storage type.
+        double scaleFactor;  ///< The packing scale factor, or 0 if the values are not packed.
+        double addOffset;    ///< The packing offset.
+        double missingValue; ///< The value that marks missing values in the data written.
+        bool dictionary = false; ///< Whether strings are stored as indices into a table.
+        size_t stringLength = 0; ///< The length of strings stored as `NC_CHAR`.
+
+        /// Whether the values are packed.
+        bool packed() const {
+            return scaleFactor != 0.0;
+        }
+
+        /// Whether the encoding is one of strings.
+        bool isString() const {
+            return dictionary || type == NC_CHAR;
+        }
+    };
+
+    /**
+     * @class OutputEncoding
+     * @brief Singleton class holding the storage types of output variables.
+     *
+     * The policy is read from a YAML file such as `share/OutputEncoding.yaml`:
+     *
+     * @code
+     * ioda_compatible: false
+     * encodings:
+     *   "<group>/<variable>": {type: short, scale_factor: 0.01, add_offset: 300}
+     * @endcode
+     *
+     * Keys are `<group>/<variable>`, by valid or deprecated IODA name; the variable
+     * `*` stands for every variable of the group without its own entry. Types are
+     * `byte`, `short`, `int`, `int64` or `float`. An entry applies to variables
+     * defined with a wider type, and a packed entry to floating point variables;
+     * other variables keep their type. Variables without an entry keep their type.
+     *
+     * Every entry changes the type, or the meaning of the values, of a variable
+     * IODA reads, so entries are only accepted with `ioda_compatible: false`,
+     * for files written for other readers.
+     *
+     * String variables take the types `dictionary` and `char`, which needs a
+     * `length`; these entries apply to string variables only, and not in parallel
+     * files.
+     */
+    class OutputEncoding {
+    public:
+        /**
+         * @brief Retrieves the singleton instance of the OutputEncoding.
+         *
+         * @return A reference to the singleton instance of OutputEncoding.
+         */
+        static OutputEncoding &getInstance();
+
+        OutputEncoding(
+            const OutputEncoding &
+        ) = delete;
+
+        OutputEncoding &operator=(
+            const OutputEncoding &
+        ) = delete;
+
+        /**
+         * @brief Replaces the policy by the `encodings` map of a YAML document.
+         *
+         * The optional `missing_value` of the document, or of an entry, replaces
+         * `encodingMissingValue` as the value that marks missing values.
+         *
+         * @param node The root node of the document.
+         * @throws std::invalid_argument if a key or an entry is invalid, or if
+         *         the document has entries without `ioda_compatible: false`.
+         */
+        void load(
+            const YAML::Node &node
+        );
+
+        /**
+         * @brief Removes all entries, so that every variable keeps its type.
+         */
+        void clear();
+
+        /**
+         * @brief Finds the encoding of a variable being defined.
+         *
+         * @param groupName The valid name of the group.
+         * @param varName The valid name of the variable.
+         * @param declaredType The type the variable is defined with.
+         * @return The encoding, or nullptr if the variable keeps `declaredType`.
+         */
+        const VariableEncoding *find(
+            const std::string &groupName,
+            const std::string &varName,
+            nc_type declaredType
+        ) const;
+
+        /**
+         * @brief The value that marks missing values written to a variable.
+         */
+        double missingValue(
+            const std::string &groupName,
+            const std::string &varName
+        ) const;
+
+    private:
+        OutputEncoding() = default;
+
+        const VariableEncoding *find(
+            const std::string &groupName,
+            const std::string &varName
+        ) const;
+
+        std::map<std::string, VariableEncoding> encodings;
+        double defaultMissingValue = encodingMissingValue;
+    };
+
+    /**
+     * @brief Whether values of type `dataType` are narrowed when stored in `storageType`.
+     *
+     * This is the case for floating point values stored in an integer type, for
+     * `double` values stored in `float`, and for integers stored in a smaller integer.
+     */
+    bool isNarrowing(
+        nc_type storageType,
+        nc_type dataType
+    );
+
+    /**
+     * @brief Whether values of type T written to or read from a variable pass through its encoding.
+     *
+     * This is the case for a narrowing type if the variable is packed or has an
+     * entry in the policy. Other values are converted by netCDF-C.
+     */
+    template<typename T>
+    bool isEncoded(
+        const netCDF::NcVar &var
+    );
+
+    /**
+     * @brief The `_FillValue` of a variable for the fill value it is written with.
+     *
+     * The fill value is kept if the storage type represents it. Otherwise, and for
+     * packed variables, the fill value is the smallest value of the storage type,
+     * which is never used for data, and `fillValue` must be the missing value of
+     * the variable.
+     *
+     * @throws std::invalid_argument if the fill value cannot be stored.
+     */
+    double encodedFillValue(
+        const netCDF::NcVar &var,
+        double fillValue
+    );
+
+    /**
+     * @brief Defines the storage of a new variable: the packing attributes and the fill value.
+     *
+     * @param var The variable, defined with `encoding.type`.
+     * @param encoding The encoding.
+     * @param declaredType The type the variable was defined with by the caller.
+     */
+    void defineEncoding(
+        const netCDF::NcVar &var,
+        const VariableEncoding &encoding,
+        nc_type declaredType
+    );
+
+    /**
+     * @brief Writes a hyperslab of values in the narrower storage type of a variable.
+     *
+     * Values equal to the missing value of the variable are written as its
+     * `_FillValue` if the storage type cannot represent them; the others are
+     * packed, or truncated to integers, and checked against the range of the
+     * storage type.
+     *
+     * @param var The variable.
+     * @param start The first index of the hyperslab in each dimension; empty for
+     *     scalar variables.
+     * @param count The length of the hyperslab in each dimension.
+     * @param values The values, in row-major order.
+     * @throws std::out_of_range if a value does not fit the storage type; only `float`
+     *     stores non-finite values.
+     */
+    template<typename T>
+    void putEncoded(
+        const netCDF::NcVar &var,
+        const std::vector<size_t> &start,
+        const std::vector<size_t> &count,
+        const T *values
+    );
+
+    /**
+     * @brief Reads a hyperslab of a variable stored in a narrower type, reversing `putEncoded`.
+     */
+    template<typename T>
+    void getEncoded(
+        const netCDF::NcVar &var,
+        const std::vector<size_t> &start,
+        const std::vector<size_t> &count,
+        T *values
+    );
+
+    extern "C" {
+    /**
+     * @brief Loads the output encoding policy from a YAML file.
+     *
+     * @param path The YAML file.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfEncodingLoad(
+        const char *path
+    );
+    }
+}
+
+#endif //OBS2IODA_NETCDF_ENCODING_H
@@ -1,11 +1,49 @@
 #include "netcdf_file.h"
+#include "ioda_writer.h"
 #include "netcdf_error.h"
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
 #include <memory>
 
 
 namespace Obs2Ioda {
     IodaObsSchema iodaSchema(YAML::LoadFile(IODA_SCHEMA_YAML));
 
+    std::string netcdfDatasetPath(
+        const std::string &path
+    ) {
+        const std::string zarrExtension = ".zarr";
+        const bool isZarr = path.size() > zarrExtension.size() &&
+                            path.compare(path.size() - zarrExtension.size(),
+                                         zarrExtension.size(), zarrExtension) == 0;
+        if (!isZarr || path.find("://") != std::string::npos) {
+            return path;
+        }
+        return "file://" + std::filesystem::absolute(path).lexically_normal().string() +
+               "#mode=nczarr,file";
+    }
+
+    std::shared_ptr<netCDF::NcFile> netcdfOpenFile(
+        const std::string &path,
+        const int fileMode,
+        const NetcdfFileOptions &options
+    ) {
+        const auto datasetPath = netcdfDatasetPath(path);
+        if (!isTuned(options) || datasetPath != path || path.find("://") != std::string::npos) {
+            return std::make_shared<netCDF::NcFile>(
+                datasetPath,
+                static_cast<netCDF::NcFile::FileMode>(fileMode)
+            );
+        }
+        // the tuned HDF5 handle only has to stay open until the NetCDF library has opened the file
+        const TunedFileAccess access(path, fileMode, options);
+        return std::make_shared<netCDF::NcFile>(
+            path,
+            static_cast<netCDF::NcFile::FileMode>(access.netcdfFileMode())
+        );
+    }
+
     FileMap &FileMap::getInstance() {
         static FileMap instance;
         return instance;
@@ -57,18 +95,28 @@ namespace Obs2Ioda {
         const char *path,
         int *netcdfID,
         int fileMode
+    ) {
+        return netcdfCreateWithOptions(
+            path,
+            netcdfID,
+            fileMode,
+            nullptr
+        );
+    }
+
+    int netcdfCreateWithOptions(
+        const char *path,
+        int *netcdfID,
+        const int fileMode,
+        const NetcdfFileOptions *options
     ) {
         try {
-            const auto file = std::make_shared<netCDF::NcFile>(
+            IodaWriter writer(
                 path,
-                static_cast<netCDF::NcFile::FileMode>(fileMode)
+                fileMode,
+                options ? *options : environmentNetcdfFileOptions()
             );
-            *netcdfID = file->getId();
-            FileMap::getInstance().addFile(
-                *netcdfID,
-                file
-            );
-
+            *netcdfID = writer.release();
             return 0;
         } catch (netCDF::exceptions::NcException &e) {
             return netcdfErrorMessage(
@@ -76,13 +124,15 @@ namespace Obs2Ioda {
                 __LINE__,
                 __FILE__
             );
+        } catch (std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << " at " << __FILE__ << ":" << __LINE__ << std::endl;
+            return -1;
         }
     }
 
     int netcdfClose(const int netcdfID) {
         try {
-            FileMap::getInstance().getFile(netcdfID)->close();
-            FileMap::getInstance().removeFile(netcdfID);
+            IodaWriter(netcdfID).close();
             return 0;
         } catch (netCDF::exceptions::NcException &e) {
             return netcdfErrorMessage(
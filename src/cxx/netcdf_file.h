@@ -4,10 +4,42 @@
 #include <netcdf>
 #include <unordered_map>
 #include <memory>
+#include <string>
 #include "ioda_obs_schema.h"
+#include "netcdf_file_options.h"
 
 namespace Obs2Ioda {
     extern IodaObsSchema iodaSchema;
+
+    /**
+     * @brief Maps an output path to the dataset path passed to the NetCDF library.
+     *
+     * Paths ending in `.zarr` select the NCZarr backend and are mapped to a local
+     * directory store URL, `file://<absolute path>#mode=nczarr,file`. All other paths,
+     * including paths that already are URLs, are returned unchanged and create HDF5
+     * (NetCDF-4) files.
+     *
+     * @param path The path of the file or store.
+     * @return The dataset path for the NetCDF library.
+     */
+    std::string netcdfDatasetPath(
+        const std::string &path
+    );
+
+    /**
+     * @brief Creates or opens a NetCDF file, applying HDF5 tuning to HDF5 files.
+     *
+     * @param path The path of the file or store (see `netcdfDatasetPath`).
+     * @param fileMode The mode for creating the NetCDF file (see `netcdfCreate`).
+     * @param options The HDF5 tuning; ignored for NCZarr stores and URLs.
+     * @return The open file.
+     */
+    std::shared_ptr<netCDF::NcFile> netcdfOpenFile(
+        const std::string &path,
+        int fileMode,
+        const NetcdfFileOptions &options
+    );
+
     /**
      * @class FileMap
      * @brief Singleton class for managing a mapping of NetCDF file IDs to file objects.
@@ -96,12 +128,18 @@ namespace Obs2Ioda {
      *
      * This function creates and opens a new NetCDF file at the specified path.
      * It stores the NetCDF file object in a map for future reference.
+     * A path ending in `.zarr` creates an NCZarr directory store instead of an
+     * HDF5 file (see `netcdfDatasetPath`). HDF5 files are tuned with the options
+     * of the `OBS2IODA_HDF5_OPTIONS` environment variable, if it is set.
      *
      * @param path The path to the NetCDF file to be created.
      * @param netcdfID Output parameter that will receive the ID of the created NetCDF file.
      * @param fileMode The mode for creating the NetCDF file:
      *     - 0: Open an existing file in read-only mode.
-     *     - 1: Open an existing file for writing.
+     *     - 1: Open an existing file for writing, e.g. to append locations along an
+     *          unlimited location dimension. At close, the appended but unwritten
+     *          rows are filled and `min_datetime`/`max_datetime` are widened to the
+     *          appended `dateTime` values.
      *     - 2: Create a new file, overwriting any existing file.
      *     - 3: Create a new file, failing if it already exists.
      *
@@ -115,6 +153,26 @@ namespace Obs2Ioda {
         int fileMode ///< File mode for creating the NetCDF file.
     );
 
+    /**
+     * @brief Creates and opens a NetCDF file with HDF5 tuning.
+     *
+     * As `netcdfCreate`, with the HDF5 file-creation and file-access settings
+     * of `options` instead of those of the environment.
+     *
+     * @param path The path to the NetCDF file to be created.
+     * @param netcdfID Output parameter that will receive the ID of the created NetCDF file.
+     * @param fileMode The mode for creating the NetCDF file (see `netcdfCreate`).
+     * @param options The HDF5 tuning, or NULL for the options of the environment.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfCreateWithOptions(
+        const char *path,
+        int *netcdfID,
+        int fileMode,
+        const NetcdfFileOptions *options
+    );
+
     /**
      * @brief Closes the NetCDF file associated with the given ID.
      *
@@ -0,0 +1,229 @@
+#include "netcdf_file_options.h"
+#include <netcdf>
+#include <netcdf.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef OBS2IODA_USE_HDF5
+#include <hdf5.h>
+#endif
+
+namespace Obs2Ioda {
+    namespace {
+        long long parseSize(
+            const std::string &key,
+            const std::string &value
+        ) {
+            size_t end = 0;
+            long long size = -1;
+            try {
+                size = std::stoll(value, &end);
+            } catch (std::exception &) {
+                end = 0;
+            }
+            std::string suffix = value.substr(end);
+            long long scale = 1;
+            if (suffix == "K" || suffix == "k") {
+                scale = 1024LL;
+            } else if (suffix == "M" || suffix == "m") {
+                scale = 1024LL * 1024;
+            } else if (suffix == "G" || suffix == "g") {
+                scale = 1024LL * 1024 * 1024;
+            } else if (!suffix.empty()) {
+                end = 0;
+            }
+            if (end == 0 || size < 0) {
+                throw std::invalid_argument("invalid HDF5 option " + key + "=" + value);
+            }
+            return size * scale;
+        }
+
+#ifndef OBS2IODA_USE_HDF5
+        void warnIgnored(
+            const char *setting
+        ) {
+            std::cerr << "Warning: obs2ioda was built without HDF5 tuning (OBS2IODA_ENABLE_HDF5_TUNING), "
+                    << setting << " is ignored" << std::endl;
+        }
+#endif
+    }
+
+    NetcdfFileOptions defaultNetcdfFileOptions() {
+        return NetcdfFileOptions{0, 0, 0, 0, 0, 1};
+    }
+
+    NetcdfFileOptions parseNetcdfFileOptions(
+        const std::string &spec
+    ) {
+        auto options = defaultNetcdfFileOptions();
+        std::istringstream items(spec);
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+            if (item.empty()) {
+                continue;
+            }
+            const auto equal = item.find('=');
+            if (equal == std::string::npos) {
+                throw std::invalid_argument("HDF5 option " + item + " has no value");
+            }
+            const auto key = item.substr(0, equal);
+            const auto value = item.substr(equal + 1);
+            if (key == "metadata_cache") {
+                options.metadataCacheSize = parseSize(key, value);
+            } else if (key == "page_size") {
+                options.pageSize = parseSize(key, value);
+            } else if (key == "page_buffer") {
+                options.pageBufferSize = parseSize(key, value);
+            } else if (key == "alignment") {
+                options.alignment = parseSize(key, value);
+            } else if (key == "alignment_threshold") {
+                options.alignmentThreshold = parseSize(key, value);
+            } else if (key == "collective_metadata") {
+                options.collectiveMetadataWrite = parseSize(key, value) != 0;
+            } else {
+                throw std::invalid_argument("unknown HDF5 option " + key);
+            }
+        }
+        if (options.pageBufferSize > 0 && (options.pageSize == 0 || options.pageBufferSize % options.pageSize != 0)) {
+            throw std::invalid_argument("HDF5 option page_buffer must be a multiple of page_size");
+        }
+        return options;
+    }
+
+    NetcdfFileOptions environmentNetcdfFileOptions() {
+        const char *spec = std::getenv("OBS2IODA_HDF5_OPTIONS");
+        return spec ? parseNetcdfFileOptions(spec) : defaultNetcdfFileOptions();
+    }
+
+    bool isTuned(
+        const NetcdfFileOptions &options
+    ) {
+        return options.metadataCacheSize > 0 || options.pageSize > 0 || options.pageBufferSize > 0 ||
+               options.alignment > 0;
+    }
+
+    TunedFileAccess::TunedFileAccess(
+        const std::string &path,
+        const int fileMode,
+        const NetcdfFileOptions &options
+    ) : fileMode(fileMode) {
+        open(path, options, nullptr);
+    }
+
+#ifdef OBS2IODA_USE_MPI
+    TunedFileAccess::TunedFileAccess(
+        const std::string &path,
+        const int fileMode,
+        const NetcdfFileOptions &options,
+        MPI_Comm comm
+    ) : fileMode(fileMode) {
+        open(path, options, &comm);
+    }
+#endif
+
+    void TunedFileAccess::open(
+        const std::string &path,
+        const NetcdfFileOptions &options,
+        const void *comm
+    ) {
+#ifdef OBS2IODA_USE_HDF5
+        const bool create = fileMode == netCDF::NcFile::replace || fileMode == netCDF::NcFile::newFile;
+        const hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+        const hid_t fcpl = H5Pcreate(H5P_FILE_CREATE);
+        // the close degree of the NetCDF library, which must match to share the open file
+        H5Pset_fclose_degree(fapl, H5F_CLOSE_WEAK);
+        if (comm) {
+#if defined(OBS2IODA_USE_MPI) && defined(H5_HAVE_PARALLEL)
+            H5Pset_fapl_mpio(fapl, *static_cast<const MPI_Comm *>(comm), MPI_INFO_NULL);
+            H5Pset_all_coll_metadata_ops(fapl, true);
+            H5Pset_coll_metadata_write(fapl, options.collectiveMetadataWrite != 0);
+#endif
+        }
+        if (options.metadataCacheSize > 0) {
+            H5AC_cache_config_t config;
+            config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+            H5Pget_mdc_config(fapl, &config);
+            config.set_initial_size = true;
+            config.initial_size = static_cast<size_t>(options.metadataCacheSize);
+            config.max_size = static_cast<size_t>(options.metadataCacheSize);
+            config.min_size = std::min(config.min_size, config.max_size);
+            H5Pset_mdc_config(fapl, &config);
+        }
+        if (options.alignment > 0) {
+            H5Pset_alignment(fapl, static_cast<hsize_t>(options.alignmentThreshold),
+                             static_cast<hsize_t>(options.alignment));
+        }
+        // page buffering needs a paged file and is not supported for parallel I/O
+        if (options.pageSize > 0 && options.pageBufferSize > 0 && !comm) {
+            H5Pset_page_buffer_size(fapl, static_cast<size_t>(options.pageBufferSize), 0, 0);
+        }
+
+        if (create) {
+            // the group and attribute ordering of files created by the NetCDF library
+            H5Pset_link_creation_order(fcpl, H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED);
+            H5Pset_attr_creation_order(fcpl, H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED);
+            if (options.pageSize > 0) {
+                H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, false, 1);
+                H5Pset_file_space_page_size(fcpl, static_cast<hsize_t>(options.pageSize));
+            }
+            hdf5Id = H5Fcreate(path.c_str(), fileMode == netCDF::NcFile::newFile ? H5F_ACC_EXCL : H5F_ACC_TRUNC,
+                               fcpl, fapl);
+        } else {
+            hdf5Id = H5Fopen(path.c_str(), fileMode == netCDF::NcFile::read ? H5F_ACC_RDONLY : H5F_ACC_RDWR, fapl);
+        }
+        H5Pclose(fcpl);
+        H5Pclose(fapl);
+        if (hdf5Id < 0) {
+            throw netCDF::exceptions::NcCantCreate(
+                "HDF5 cannot " + std::string(create ? "create " : "open ") + path + " with the tuned properties",
+                __FILE__,
+                __LINE__
+            );
+        }
+        if (create) {
+            fileMode = netCDF::NcFile::write;
+        }
+#else
+        (void) path;
+        (void) comm;
+        if (options.alignment > 0) {
+#if NC_VERSION_MAJOR > 4 || (NC_VERSION_MAJOR == 4 && NC_VERSION_MINOR >= 9)
+            nc_get_alignment(&savedAlignmentThreshold, &savedAlignment);
+            nc_set_alignment(static_cast<int>(options.alignmentThreshold), static_cast<int>(options.alignment));
+            alignmentSet = true;
+#else
+            warnIgnored("alignment");
+#endif
+        }
+        if (options.metadataCacheSize > 0) {
+            warnIgnored("metadata_cache");
+        }
+        if (options.pageSize > 0 || options.pageBufferSize > 0) {
+            warnIgnored("paged aggregation");
+        }
+#endif
+    }
+
+    TunedFileAccess::~TunedFileAccess() {
+#ifdef OBS2IODA_USE_HDF5
+        if (hdf5Id >= 0) {
+            H5Fclose(hdf5Id);
+        }
+#else
+#if NC_VERSION_MAJOR > 4 || (NC_VERSION_MAJOR == 4 && NC_VERSION_MINOR >= 9)
+        if (alignmentSet) {
+            nc_set_alignment(savedAlignmentThreshold, savedAlignment);
+        }
+#endif
+#endif
+    }
+
+    int TunedFileAccess::netcdfFileMode() const {
+        return fileMode;
+    }
+} // namespace Obs2Ioda
@@ -0,0 +1,147 @@
+#ifndef OBS2IODA_NETCDF_FILE_OPTIONS_H
+#define OBS2IODA_NETCDF_FILE_OPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+#ifdef OBS2IODA_USE_MPI
+#include <mpi.h>
+#endif
+
+namespace Obs2Ioda {
+    /**
+     * @brief HDF5 file-creation and file-access tuning of the NetCDF-4 files written by obs2ioda.
+     *
+     * All sizes are in bytes, and 0 keeps the HDF5 default. The layout is shared
+     * with the Fortran type `netcdf_file_options` of `netcdf_cxx_i_mod`.
+     */
+    struct NetcdfFileOptions {
+        /// Initial and maximum size of the HDF5 metadata cache.
+        long long metadataCacheSize;
+        /// File-space page size; a non-zero size selects paged aggregation of the file space.
+        long long pageSize;
+        /// Size of the page buffer, a multiple of `pageSize`; needs paged aggregation.
+        long long pageBufferSize;
+        /// Objects of at least `alignmentThreshold` bytes start at a multiple of this, e.g. the Lustre
+        /// stripe size. With paged aggregation HDF5 aligns to the page size instead.
+        long long alignment;
+        /// Smallest object that is aligned.
+        long long alignmentThreshold;
+        /// Parallel files only: 1 writes the metadata collectively at flush and close, 0 from rank 0.
+        int collectiveMetadataWrite;
+    };
+
+    /**
+     * @brief Options with every setting at its HDF5 default.
+     */
+    NetcdfFileOptions defaultNetcdfFileOptions();
+
+    /**
+     * @brief Parses options from a comma-separated `key=value` list.
+     *
+     * The keys are `metadata_cache`, `page_size`, `page_buffer`, `alignment`,
+     * `alignment_threshold` and `collective_metadata`. Sizes may end in `K`, `M`
+     * or `G` (powers of 1024), e.g. `page_size=4M,page_buffer=64M,alignment=1M`.
+     *
+     * @param spec The option list; keys that are not given keep their defaults.
+     * @return The options.
+     * @throws std::invalid_argument if a key or value is not valid.
+     */
+    NetcdfFileOptions parseNetcdfFileOptions(
+        const std::string &spec
+    );
+
+    /**
+     * @brief The options of the `OBS2IODA_HDF5_OPTIONS` environment variable (see `parseNetcdfFileOptions`).
+     *
+     * @return The parsed options, or the defaults if the variable is not set.
+     * @throws std::invalid_argument if the variable is not valid.
+     */
+    NetcdfFileOptions environmentNetcdfFileOptions();
+
+    /**
+     * @return true if any size of `options` differs from the HDF5 default.
+     */
+    bool isTuned(
+        const NetcdfFileOptions &options
+    );
+
+    /**
+     * @class TunedFileAccess
+     * @brief Opens an HDF5 file with tuned properties for the NetCDF library to open next.
+     *
+     * NetCDF-C creates and opens HDF5 files with its own property lists. Within one
+     * process HDF5 shares an open file between all its handles, and the file-access
+     * settings (metadata cache, page buffer, alignment) are those of the first open.
+     * This class therefore creates (or opens) the file with HDF5 first, with the
+     * tuned file-creation and file-access properties; the NetCDF library then opens
+     * the same file for writing and inherits the settings. The HDF5 handle is closed
+     * on destruction, which may be as soon as the NetCDF library has opened the file.
+     *
+     * Without HDF5 support (`OBS2IODA_USE_HDF5` undefined), only the alignment is
+     * applied, through `nc_set_alignment` of NetCDF-C 4.9 and later, and other
+     * settings are ignored with a warning.
+     */
+    class TunedFileAccess {
+    public:
+        /**
+         * @brief Creates or opens `path` with the tuned properties.
+         *
+         * @param path The HDF5 file.
+         * @param fileMode The mode of `netcdfCreate`: 0 read, 1 write, 2 replace, 3 new file.
+         * @param options The tuning.
+         * @throws netCDF::exceptions::NcCantCreate if HDF5 cannot create or open the file.
+         */
+        TunedFileAccess(
+            const std::string &path,
+            int fileMode,
+            const NetcdfFileOptions &options
+        );
+
+#ifdef OBS2IODA_USE_MPI
+        /**
+         * @brief Collectively creates or opens `path` for parallel I/O with the tuned properties.
+         *
+         * @param comm The communicator of the ranks that share the file.
+         */
+        TunedFileAccess(
+            const std::string &path,
+            int fileMode,
+            const NetcdfFileOptions &options,
+            MPI_Comm comm
+        );
+#endif
+
+        ~TunedFileAccess();
+
+        TunedFileAccess(
+            const TunedFileAccess &
+        ) = delete;
+
+        TunedFileAccess &operator=(
+            const TunedFileAccess &
+        ) = delete;
+
+        /**
+         * @brief The mode the NetCDF library must open the file with.
+         *
+         * Files created by HDF5 are opened for writing (1) instead of being created again.
+         */
+        int netcdfFileMode() const;
+
+    private:
+        void open(
+            const std::string &path,
+            const NetcdfFileOptions &options,
+            const void *comm
+        );
+
+        int fileMode;
+        std::int64_t hdf5Id = -1;
+        bool alignmentSet = false;
+        int savedAlignmentThreshold = 0;
+        int savedAlignment = 0;
+    };
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_NETCDF_FILE_OPTIONS_H
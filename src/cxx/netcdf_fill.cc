@@ -0,0 +1,246 @@
+#include "netcdf_fill.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace Obs2Ioda {
+    namespace {
+        /// Upper bound of the number of values written by one fill call.
+        constexpr size_t maxFillBlock = 1 << 22;
+
+        /**
+         * @brief Writes the fill value (`_FillValue`, or the NetCDF default) to rows `[begin, end)`.
+         */
+        void writeFillRows(
+            const netCDF::NcVar &var,
+            const size_t begin,
+            const size_t end
+        ) {
+            const int ncid = var.getParentGroup().getId();
+            const int varid = var.getId();
+            const nc_type type = var.getType().getId();
+            size_t typeSize;
+            netCDF::ncCheck(nc_inq_type(ncid, type, nullptr, &typeSize), __FILE__, __LINE__);
+            std::vector<unsigned char> fillValue(typeSize);
+            int noFill;
+            netCDF::ncCheck(nc_inq_var_fill(ncid, varid, &noFill, fillValue.data()), __FILE__, __LINE__);
+
+            const auto dims = var.getDims();
+            std::vector<size_t> start(dims.size(), 0);
+            std::vector<size_t> count(dims.size());
+            size_t rowSize = 1;
+            for (size_t i = 1; i < dims.size(); i++) {
+                count[i] = dims[i].getSize();
+                rowSize *= count[i];
+            }
+            if (rowSize > 0 && begin < end) {
+                const size_t rowsPerBlock = std::max<size_t>(1, maxFillBlock / rowSize);
+                const size_t blockValues = std::min(end - begin, rowsPerBlock) * rowSize;
+                std::vector<unsigned char> block(blockValues * typeSize);
+                for (size_t i = 0; i < blockValues; i++) {
+                    std::memcpy(block.data() + i * typeSize, fillValue.data(), typeSize);
+                }
+                if (dims.empty()) {
+                    netCDF::ncCheck(nc_put_var(ncid, varid, block.data()), __FILE__, __LINE__);
+                }
+                for (size_t row = begin; row < end && !dims.empty(); row += rowsPerBlock) {
+                    start[0] = row;
+                    count[0] = std::min(rowsPerBlock, end - row);
+                    netCDF::ncCheck(nc_put_vara(ncid, varid, start.data(), count.data(), block.data()),
+                                    __FILE__, __LINE__);
+                }
+            }
+            if (type == NC_STRING) {
+                nc_free_string(1, reinterpret_cast<char **>(fillValue.data()));
+            }
+        }
+
+        size_t numRows(
+            const netCDF::NcVar &var
+        ) {
+            return var.getDimCount() == 0 ? 1 : var.getDim(0).getSize();
+        }
+    }
+
+    void RowCoverage::add(
+        size_t begin,
+        size_t end
+    ) {
+        if (begin >= end) {
+            return;
+        }
+        auto it = ranges.upper_bound(begin);
+        if (it != ranges.begin()) {
+            const auto prev = std::prev(it);
+            if (prev->second >= begin) {
+                begin = prev->first;
+                end = std::max(end, prev->second);
+                ranges.erase(prev);
+            }
+        }
+        while (it != ranges.end() && it->first <= end) {
+            end = std::max(end, it->second);
+            it = ranges.erase(it);
+        }
+        ranges[begin] = end;
+    }
+
+    bool RowCoverage::covers(
+        const size_t begin,
+        const size_t end
+    ) const {
+        if (begin >= end) {
+            return true;
+        }
+        const auto it = ranges.upper_bound(begin);
+        if (it == ranges.begin()) {
+            return false;
+        }
+        return std::prev(it)->second >= end;
+    }
+
+    std::vector<std::pair<size_t, size_t> > RowCoverage::gaps(
+        const size_t begin,
+        const size_t end
+    ) const {
+        std::vector<std::pair<size_t, size_t> > unwritten;
+        size_t cursor = begin;
+        auto it = ranges.upper_bound(begin);
+        if (it != ranges.begin()) {
+            cursor = std::max(cursor, std::prev(it)->second);
+        }
+        for (; it != ranges.end() && it->first < end; ++it) {
+            if (it->first > cursor) {
+                unwritten.emplace_back(cursor, it->first);
+            }
+            cursor = std::max(cursor, it->second);
+        }
+        if (cursor < end) {
+            unwritten.emplace_back(cursor, end);
+        }
+        return unwritten;
+    }
+
+    FillTracker &FillTracker::getInstance() {
+        static FillTracker instance;
+        return instance;
+    }
+
+    void FillTracker::track(
+        const int netcdfID,
+        const netCDF::NcVar &var
+    ) {
+        netCDF::ncCheck(nc_def_var_fill(var.getParentGroup().getId(), var.getId(), NC_NOFILL, nullptr),
+                        __FILE__, __LINE__);
+        files[netcdfID][{var.getParentGroup().getId(), var.getId()}] = RowCoverage();
+    }
+
+    void FillTracker::trackAll(
+        const int netcdfID,
+        const netCDF::NcGroup &group
+    ) {
+        for (const auto &var: group.getVars()) {
+            track(netcdfID, var.second);
+        }
+        for (const auto &subgroup: group.getGroups()) {
+            trackAll(netcdfID, subgroup.second);
+        }
+    }
+
+    void FillTracker::resume(
+        const int netcdfID,
+        const netCDF::NcGroup &group
+    ) {
+        for (const auto &entry: group.getVars()) {
+            const auto &var = entry.second;
+            if (var.getDimCount() == 0 || !var.getDim(0).isUnlimited()) {
+                continue;
+            }
+            int noFill;
+            netCDF::ncCheck(nc_inq_var_fill(group.getId(), var.getId(), &noFill, nullptr), __FILE__, __LINE__);
+            if (noFill) {
+                auto &coverage = files[netcdfID][{group.getId(), var.getId()}];
+                coverage.add(0, numRows(var));
+            }
+        }
+        for (const auto &subgroup: group.getGroups()) {
+            resume(netcdfID, subgroup.second);
+        }
+    }
+
+    void FillTracker::untrack(
+        const int netcdfID,
+        const netCDF::NcVar &var
+    ) {
+        const auto file = files.find(netcdfID);
+        if (file != files.end()) {
+            file->second.erase({var.getParentGroup().getId(), var.getId()});
+        }
+    }
+
+    void FillTracker::markWritten(
+        const int netcdfID,
+        const netCDF::NcVar &var
+    ) {
+        const auto file = files.find(netcdfID);
+        if (file == files.end()) {
+            return;
+        }
+        const auto coverage = file->second.find({var.getParentGroup().getId(), var.getId()});
+        if (coverage != file->second.end()) {
+            coverage->second.add(0, numRows(var));
+        }
+    }
+
+    void FillTracker::markWritten(
+        const int netcdfID,
+        const netCDF::NcVar &var,
+        const std::vector<size_t> &start,
+        const std::vector<size_t> &count
+    ) {
+        const auto file = files.find(netcdfID);
+        if (file == files.end()) {
+            return;
+        }
+        const auto coverage = file->second.find({var.getParentGroup().getId(), var.getId()});
+        if (coverage == file->second.end()) {
+            return;
+        }
+        if (start.empty()) {
+            coverage->second.add(0, 1);
+            return;
+        }
+        const auto dims = var.getDims();
+        bool wholeRows = true;
+        for (size_t i = 1; i < dims.size() && i < start.size(); i++) {
+            wholeRows = wholeRows && start[i] == 0 && count[i] == dims[i].getSize();
+        }
+        const size_t begin = start[0];
+        const size_t end = start[0] + count[0];
+        if (!wholeRows) {
+            for (const auto &gap: coverage->second.gaps(begin, end)) {
+                writeFillRows(var, gap.first, gap.second);
+            }
+        }
+        coverage->second.add(begin, end);
+    }
+
+    void FillTracker::fillGaps(
+        const int netcdfID
+    ) {
+        const auto file = files.find(netcdfID);
+        if (file == files.end()) {
+            return;
+        }
+        // stop tracking first, so that a failed write does not fill again at the next close attempt
+        const auto vars = std::move(file->second);
+        files.erase(file);
+        for (const auto &entry: vars) {
+            const netCDF::NcGroup group(entry.first.first);
+            const netCDF::NcVar var(group, entry.first.second);
+            for (const auto &gap: entry.second.gaps(0, numRows(var))) {
+                writeFillRows(var, gap.first, gap.second);
+            }
+        }
+    }
+} // namespace Obs2Ioda
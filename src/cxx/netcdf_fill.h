@@ -0,0 +1,168 @@
+#ifndef OBS2IODA_NETCDF_FILL_H
+#define OBS2IODA_NETCDF_FILL_H
+
+#include <netcdf>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace Obs2Ioda {
+    /**
+     * @class RowCoverage
+     * @brief The ranges of rows (indices of the first dimension) written to a variable.
+     */
+    class RowCoverage {
+    public:
+        /**
+         * @brief Marks rows `[begin, end)` as written.
+         */
+        void add(
+            size_t begin,
+            size_t end
+        );
+
+        /**
+         * @return true if all rows `[begin, end)` are written.
+         */
+        bool covers(
+            size_t begin,
+            size_t end
+        ) const;
+
+        /**
+         * @brief The ranges of rows of `[begin, end)` that are not written, in order.
+         */
+        std::vector<std::pair<size_t, size_t> > gaps(
+            size_t begin,
+            size_t end
+        ) const;
+
+    private:
+        /// Disjoint, non-adjacent written ranges, keyed by their first row.
+        std::map<size_t, size_t> ranges;
+    };
+
+    /**
+     * @class FillTracker
+     * @brief Singleton class replacing the fill of variables at allocation by a fill of the unwritten rows at close.
+     *
+     * With fill mode on, HDF5 writes the fill value when it allocates the storage of
+     * a variable, and obs2ioda then overwrites almost every variable in full. Tracked
+     * variables are therefore defined with fill mode off, keeping their `_FillValue`
+     * attribute, and the rows written to them are recorded. When the file is closed,
+     * only the rows that were never written are filled, so completely written
+     * variables are written once.
+     *
+     * Writes that cover part of the trailing dimensions of a row fill the unwritten
+     * rows of the write first, since the coverage is only tracked per row.
+     * Variables of files opened for parallel I/O are not tracked and keep fill mode
+     * on, because each rank only sees its own writes.
+     */
+    class FillTracker {
+    public:
+        /**
+         * @brief Retrieves the singleton instance of the FillTracker.
+         *
+         * @return A reference to the singleton instance of FillTracker.
+         */
+        static FillTracker &getInstance();
+
+        FillTracker(
+            const FillTracker &
+        ) = delete;
+
+        FillTracker &operator=(
+            const FillTracker &
+        ) = delete;
+
+        /**
+         * @brief Turns fill mode off for a variable in define mode and starts tracking its writes.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         * @param var The variable.
+         */
+        void track(
+            int netcdfID,
+            const netCDF::NcVar &var
+        );
+
+        /**
+         * @brief Tracks all variables of a group and of its subgroups.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         * @param group The group, usually the file itself.
+         */
+        void trackAll(
+            int netcdfID,
+            const netCDF::NcGroup &group
+        );
+
+        /**
+         * @brief Resumes tracking the variables of an existing file opened for append.
+         *
+         * Variables whose first dimension is unlimited and whose fill mode is off are
+         * tracked with their current rows marked as written, so that only the rows
+         * appended but left unwritten are filled at close. Fill mode cannot be changed
+         * once a variable holds data, so variables with fill mode on are left alone.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         * @param group The group, usually the file itself.
+         */
+        void resume(
+            int netcdfID,
+            const netCDF::NcGroup &group
+        );
+
+        /**
+         * @brief Stops tracking a variable, so that its unwritten rows are not filled at close.
+         */
+        void untrack(
+            int netcdfID,
+            const netCDF::NcVar &var
+        );
+
+        /**
+         * @brief Records a write of the whole variable.
+         */
+        void markWritten(
+            int netcdfID,
+            const netCDF::NcVar &var
+        );
+
+        /**
+         * @brief Records a write of a hyperslab.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         * @param var The variable.
+         * @param start The first index of the hyperslab in each dimension.
+         * @param count The length of the hyperslab in each dimension.
+         */
+        void markWritten(
+            int netcdfID,
+            const netCDF::NcVar &var,
+            const std::vector<size_t> &start,
+            const std::vector<size_t> &count
+        );
+
+        /**
+         * @brief Fills the unwritten rows of all tracked variables of a file and stops tracking them.
+         *
+         * Called before the file is closed.
+         *
+         * @param netcdfID The NetCDF ID of the file.
+         */
+        void fillGaps(
+            int netcdfID
+        );
+
+    private:
+        FillTracker() = default;
+
+        using VarKey = std::pair<int, int>; ///< Group ID and variable ID.
+
+        /// Tracked variables and their written rows, per NetCDF file ID.
+        std::map<int, std::map<VarKey, RowCoverage> > files;
+    };
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_NETCDF_FILL_H
@@ -0,0 +1,360 @@
+#include "netcdf_layout.h"
+#include "netcdf_file.h"
+#include "netcdf_error.h"
+#include "netcdf_fill.h"
+#include "spatial_index.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace Obs2Ioda {
+    namespace {
+        template<typename T>
+        std::vector<T> sortedById(
+            const std::multimap<std::string, T> &objects
+        ) {
+            std::vector<T> sorted;
+            sorted.reserve(objects.size());
+            for (const auto &object: objects) {
+                sorted.push_back(object.second);
+            }
+            // NetCDF-4 hands out IDs in creation order, so sorting by ID reproduces
+            // the order in which the original file was defined.
+            std::sort(sorted.begin(), sorted.end(), [](const T &a, const T &b) {
+                return a.getId() < b.getId();
+            });
+            return sorted;
+        }
+
+        std::vector<NetcdfAttributeLayout> captureAttributes(
+            const int ncid,
+            const int varid
+        ) {
+            int numAtts;
+            netCDF::ncCheck(nc_inq_varnatts(ncid, varid, &numAtts), __FILE__, __LINE__);
+            std::vector<NetcdfAttributeLayout> atts(numAtts);
+            for (int i = 0; i < numAtts; i++) {
+                auto &att = atts[i];
+                char attName[NC_MAX_NAME + 1];
+                netCDF::ncCheck(nc_inq_attname(ncid, varid, i, attName), __FILE__, __LINE__);
+                att.name = attName;
+                netCDF::ncCheck(nc_inq_att(ncid, varid, attName, &att.type, &att.len), __FILE__, __LINE__);
+                if (att.type == NC_STRING) {
+                    std::vector<char *> strings(att.len);
+                    netCDF::ncCheck(nc_get_att_string(ncid, varid, attName, strings.data()), __FILE__, __LINE__);
+                    for (const auto *string: strings) {
+                        att.strings.emplace_back(string ? string : "");
+                    }
+                    nc_free_string(att.len, strings.data());
+                } else {
+                    size_t typeSize;
+                    netCDF::ncCheck(nc_inq_type(ncid, att.type, nullptr, &typeSize), __FILE__, __LINE__);
+                    att.values.resize(att.len * typeSize);
+                    netCDF::ncCheck(nc_get_att(ncid, varid, attName, att.values.data()), __FILE__, __LINE__);
+                }
+            }
+            return atts;
+        }
+
+        void instantiateAttributes(
+            const int ncid,
+            const int varid,
+            const std::vector<NetcdfAttributeLayout> &atts
+        ) {
+            for (const auto &att: atts) {
+                if (att.type == NC_STRING) {
+                    std::vector<const char *> strings;
+                    strings.reserve(att.strings.size());
+                    for (const auto &string: att.strings) {
+                        strings.push_back(string.c_str());
+                    }
+                    netCDF::ncCheck(nc_put_att_string(ncid, varid, att.name.c_str(), att.len, strings.data()),
+                                    __FILE__, __LINE__);
+                } else {
+                    netCDF::ncCheck(nc_put_att(ncid, varid, att.name.c_str(), att.type, att.len, att.values.data()),
+                                    __FILE__, __LINE__);
+                }
+            }
+        }
+
+        NetcdfGroupLayout captureGroup(
+            const netCDF::NcGroup &group
+        ) {
+            NetcdfGroupLayout layout;
+            layout.name = group.getName();
+            for (const auto &dim: sortedById(group.getDims())) {
+                layout.dims.push_back({dim.getName(), dim.getSize(), dim.isUnlimited()});
+            }
+            layout.atts = captureAttributes(group.getId(), NC_GLOBAL);
+            for (const auto &var: sortedById(group.getVars())) {
+                NetcdfVariableLayout varLayout;
+                varLayout.name = var.getName();
+                varLayout.type = var.getType().getId();
+                for (const auto &dim: var.getDims()) {
+                    varLayout.dimNames.push_back(dim.getName());
+                }
+                varLayout.atts = captureAttributes(group.getId(), var.getId());
+                int storage;
+                varLayout.chunkSizes.resize(varLayout.dimNames.size());
+                netCDF::ncCheck(nc_inq_var_chunking(group.getId(), var.getId(), &storage,
+                                                    varLayout.chunkSizes.data()), __FILE__, __LINE__);
+                varLayout.chunked = storage == NC_CHUNKED && !varLayout.chunkSizes.empty();
+                int shuffle;
+                int deflate;
+                netCDF::ncCheck(nc_inq_var_deflate(group.getId(), var.getId(), &shuffle, &deflate,
+                                                   &varLayout.deflateLevel), __FILE__, __LINE__);
+                varLayout.shuffle = shuffle != 0;
+                varLayout.deflate = deflate != 0;
+                layout.vars.push_back(std::move(varLayout));
+            }
+            for (const auto &subgroup: sortedById(group.getGroups())) {
+                layout.groups.push_back(captureGroup(subgroup));
+            }
+            return layout;
+        }
+
+        void instantiateGroup(
+            const NetcdfGroupLayout &layout,
+            const netCDF::NcGroup &group,
+            const std::unordered_map<std::string, size_t> &dimLens
+        ) {
+            for (const auto &dim: layout.dims) {
+                if (dim.unlimited) {
+                    group.addDim(dim.name);
+                    continue;
+                }
+                const auto dimLen = dimLens.find(dim.name);
+                group.addDim(dim.name, dimLen != dimLens.end() ? dimLen->second : dim.len);
+            }
+            instantiateAttributes(group.getId(), NC_GLOBAL, layout.atts);
+            for (const auto &varLayout: layout.vars) {
+                std::vector<netCDF::NcDim> dims;
+                dims.reserve(varLayout.dimNames.size());
+                for (const auto &dimName: varLayout.dimNames) {
+                    dims.push_back(group.getDim(dimName, netCDF::NcGroup::ParentsAndCurrent));
+                }
+                const auto var = group.addVar(varLayout.name, netCDF::NcType(varLayout.type), dims);
+                if (varLayout.chunked) {
+                    auto chunkSizes = varLayout.chunkSizes;
+                    for (size_t i = 0; i < dims.size(); i++) {
+                        if (!dims[i].isUnlimited()) {
+                            chunkSizes[i] = std::max<size_t>(1, std::min(chunkSizes[i], dims[i].getSize()));
+                        }
+                    }
+                    var.setChunking(netCDF::NcVar::nc_CHUNKED, chunkSizes);
+                }
+                LocationBlocks::getInstance().chunk(var);
+                if (varLayout.shuffle || varLayout.deflate) {
+                    var.setCompression(varLayout.shuffle, varLayout.deflate, varLayout.deflateLevel);
+                }
+                instantiateAttributes(group.getId(), var.getId(), varLayout.atts);
+            }
+            for (const auto &subgroupLayout: layout.groups) {
+                instantiateGroup(subgroupLayout, group.addGroup(subgroupLayout.name), dimLens);
+            }
+        }
+
+        void copyGroupData(
+            const netCDF::NcGroup &srcGroup,
+            const netCDF::NcGroup &dstGroup
+        ) {
+            for (const auto &varEntry: srcGroup.getVars()) {
+                const auto &srcVar = varEntry.second;
+                const auto dstVar = dstGroup.getVar(varEntry.first);
+                // Write with explicit counts so that unlimited dimensions grow to the source length.
+                std::vector<size_t> start, count;
+                size_t numValues = 1;
+                for (const auto &dim: srcVar.getDims()) {
+                    start.push_back(0);
+                    count.push_back(dim.getSize());
+                    numValues *= dim.getSize();
+                }
+                if (numValues == 0) {
+                    continue;
+                }
+                const nc_type varType = srcVar.getType().getId();
+                if (varType == NC_STRING) {
+                    std::vector<char *> values(numValues);
+                    netCDF::ncCheck(nc_get_var_string(srcGroup.getId(), srcVar.getId(), values.data()),
+                                    __FILE__, __LINE__);
+                    const int status = nc_put_vara_string(dstGroup.getId(), dstVar.getId(), start.data(),
+                                                          count.data(),
+                                                          const_cast<const char **>(values.data()));
+                    nc_free_string(numValues, values.data());
+                    netCDF::ncCheck(status, __FILE__, __LINE__);
+                } else {
+                    size_t typeSize;
+                    netCDF::ncCheck(nc_inq_type(srcGroup.getId(), varType, nullptr, &typeSize), __FILE__, __LINE__);
+                    std::vector<unsigned char> values(numValues * typeSize);
+                    netCDF::ncCheck(nc_get_var(srcGroup.getId(), srcVar.getId(), values.data()), __FILE__, __LINE__);
+                    netCDF::ncCheck(nc_put_vara(dstGroup.getId(), dstVar.getId(), start.data(), count.data(),
+                                                values.data()), __FILE__, __LINE__);
+                }
+            }
+            for (const auto &groupEntry: srcGroup.getGroups()) {
+                copyGroupData(groupEntry.second, dstGroup.getGroup(groupEntry.first));
+            }
+        }
+    }
+
+    NetcdfLayout::NetcdfLayout(
+        const netCDF::NcGroup &root
+    ) : rootLayout(captureGroup(root)) {
+    }
+
+    void NetcdfLayout::instantiate(
+        const netCDF::NcGroup &root,
+        const std::unordered_map<std::string, size_t> &dimLens
+    ) const {
+        instantiateGroup(this->rootLayout, root, dimLens);
+    }
+
+    void NetcdfLayout::removeGroup(
+        const std::string &name
+    ) {
+        auto &groups = this->rootLayout.groups;
+        groups.erase(std::remove_if(groups.begin(), groups.end(), [&](const NetcdfGroupLayout &group) {
+            return group.name == name;
+        }), groups.end());
+    }
+
+    LayoutMap &LayoutMap::getInstance() {
+        static LayoutMap instance;
+        return instance;
+    }
+
+    int LayoutMap::addLayout(
+        const std::shared_ptr<const NetcdfLayout> &layout
+    ) {
+        const int layoutID = this->nextLayoutID++;
+        this->layoutMap[layoutID] = layout;
+        return layoutID;
+    }
+
+    void LayoutMap::removeLayout(
+        const int layoutID
+    ) {
+        auto layoutIterator = this->layoutMap.find(layoutID);
+        if (layoutIterator == this->layoutMap.end()) {
+            throw netCDF::exceptions::NcBadId(
+                "Layout ID not found in the layout map",
+                __FILE__,
+                __LINE__
+            );
+        }
+        this->layoutMap.erase(layoutIterator);
+    }
+
+    std::shared_ptr<const NetcdfLayout> LayoutMap::getLayout(
+        const int layoutID
+    ) {
+        const auto layoutIterator = this->layoutMap.find(layoutID);
+        if (layoutIterator == this->layoutMap.end()) {
+            throw netCDF::exceptions::NcBadId(
+                "Layout ID not found in the layout map",
+                __FILE__,
+                __LINE__
+            );
+        }
+        return layoutIterator->second;
+    }
+
+    int netcdfSaveLayout(
+        const int netcdfID,
+        int *layoutID
+    ) {
+        try {
+            const auto file = FileMap::getInstance().getFile(netcdfID);
+            *layoutID = LayoutMap::getInstance().addLayout(
+                std::make_shared<const NetcdfLayout>(*file)
+            );
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        }
+    }
+
+    int netcdfCreateFromLayout(
+        const char *path,
+        const int layoutID,
+        const int numDims,
+        const char **dimNames,
+        const size_t *dimLens,
+        int *netcdfID,
+        const int fileMode
+    ) {
+        try {
+            const auto layout = LayoutMap::getInstance().getLayout(layoutID);
+            std::unordered_map<std::string, size_t> iodaDimLens;
+            for (int i = 0; i < numDims; i++) {
+                iodaDimLens[iodaSchema.getDimension(dimNames[i])->getValidName()] = dimLens[i];
+            }
+            const auto file = netcdfOpenFile(
+                path,
+                fileMode,
+                environmentNetcdfFileOptions()
+            );
+            layout->instantiate(*file, iodaDimLens);
+            *netcdfID = file->getId();
+            FillTracker::getInstance().trackAll(*netcdfID, *file);
+            FileMap::getInstance().addFile(
+                *netcdfID,
+                file
+            );
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        } catch (std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << " at " << __FILE__ << ":" << __LINE__ << std::endl;
+            return -1;
+        }
+    }
+
+    int netcdfFreeLayout(
+        const int layoutID
+    ) {
+        try {
+            LayoutMap::getInstance().removeLayout(layoutID);
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        }
+    }
+
+    int netcdfCopy(
+        const char *srcPath,
+        const char *dstPath
+    ) {
+        try {
+            const netCDF::NcFile srcFile(
+                netcdfDatasetPath(srcPath),
+                netCDF::NcFile::read
+            );
+            const netCDF::NcFile dstFile(
+                netcdfDatasetPath(dstPath),
+                netCDF::NcFile::replace
+            );
+            NetcdfLayout(srcFile).instantiate(dstFile, {});
+            copyGroupData(srcFile, dstFile);
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        }
+    }
+}
@@ -0,0 +1,250 @@
+#ifndef OBS2IODA_NETCDF_LAYOUT_H
+#define OBS2IODA_NETCDF_LAYOUT_H
+
+#include <netcdf>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Obs2Ioda {
+    /**
+     * @brief Captured definition of a single NetCDF attribute.
+     *
+     * Numeric and character attributes keep their raw bytes in `values`;
+     * `NC_STRING` attributes keep their elements in `strings`.
+     */
+    struct NetcdfAttributeLayout {
+        std::string name;
+        nc_type type;
+        size_t len;
+        std::vector<unsigned char> values;
+        std::vector<std::string> strings;
+    };
+
+    /**
+     * @brief Captured definition of a NetCDF variable: type, dimension names, storage and attributes.
+     *
+     * The `_FillValue` attribute is captured like any other attribute, so replaying it
+     * restores the fill value of the variable. The chunking and the shuffle and deflate
+     * filters are replayed too; chunks are cut to the length of shorter dimensions.
+     */
+    struct NetcdfVariableLayout {
+        std::string name;
+        nc_type type;
+        std::vector<std::string> dimNames;
+        std::vector<NetcdfAttributeLayout> atts;
+        bool chunked;
+        std::vector<size_t> chunkSizes;
+        bool shuffle;
+        bool deflate;
+        int deflateLevel;
+    };
+
+    /**
+     * @brief Captured definition of a NetCDF dimension.
+     */
+    struct NetcdfDimensionLayout {
+        std::string name;
+        size_t len;
+        bool unlimited;
+    };
+
+    /**
+     * @brief Captured definition of a NetCDF group and, recursively, of its subgroups.
+     */
+    struct NetcdfGroupLayout {
+        std::string name;
+        std::vector<NetcdfDimensionLayout> dims;
+        std::vector<NetcdfAttributeLayout> atts;
+        std::vector<NetcdfVariableLayout> vars;
+        std::vector<NetcdfGroupLayout> groups;
+    };
+
+    /**
+     * @class NetcdfLayout
+     * @brief Reusable, in-memory template of the define phase of a NetCDF file.
+     *
+     * A layout is captured once from a fully defined file and can then be replayed
+     * into any number of new files. Only dimension lengths may differ between
+     * instances, which is what the per-window and per-obtype IODA outputs need:
+     * their groups, variables, fill values and attributes are identical.
+     */
+    class NetcdfLayout {
+    public:
+        /**
+         * @brief Captures the layout of a group and all of its subgroups.
+         *
+         * Dimensions, variables and subgroups are recorded in creation order.
+         *
+         * @param root The group to capture, usually the `netCDF::NcFile` itself.
+         */
+        explicit NetcdfLayout(
+            const netCDF::NcGroup &root
+        );
+
+        /**
+         * @brief Replays the captured layout into an empty group.
+         *
+         * @param root The group to define, usually a newly created `netCDF::NcFile`.
+         * @param dimLens Dimension lengths, keyed by valid IODA dimension name, that
+         *     override the captured lengths. Dimensions not listed keep their captured length.
+         */
+        void instantiate(
+            const netCDF::NcGroup &root,
+            const std::unordered_map<std::string, size_t> &dimLens
+        ) const;
+
+        /**
+         * @brief Drops a subgroup of the root group, and everything in it, from the layout.
+         *
+         * Used for groups that describe the data of the captured file only, e.g. the
+         * `SpatialIndex` of its locations. Nothing happens if there is no such group.
+         *
+         * @param name The name of the subgroup.
+         */
+        void removeGroup(
+            const std::string &name
+        );
+
+    private:
+        NetcdfGroupLayout rootLayout;
+    };
+
+    /**
+     * @class LayoutMap
+     * @brief Singleton class for managing a mapping of layout IDs to captured layouts.
+     */
+    class LayoutMap {
+    public:
+        /**
+         * @brief Retrieves the singleton instance of the LayoutMap.
+         *
+         * @return A reference to the singleton instance of LayoutMap.
+         */
+        static LayoutMap &getInstance();
+
+        LayoutMap(
+            const LayoutMap &
+        ) = delete;
+
+        LayoutMap &operator=(
+            const LayoutMap &
+        ) = delete;
+
+        /**
+         * @brief Adds a layout to the map.
+         *
+         * @param layout A shared pointer to the layout to be added.
+         * @return The unique ID assigned to the layout.
+         */
+        int addLayout(
+            const std::shared_ptr<const NetcdfLayout> &layout
+        );
+
+        /**
+         * @brief Removes a layout from the map.
+         *
+         * @param layoutID The ID of the layout to be removed.
+         * @throws netCDF::exceptions::NcBadId if the `layoutID` does not exist in the map.
+         */
+        void removeLayout(
+            int layoutID
+        );
+
+        /**
+         * @brief Retrieves a layout from the map.
+         *
+         * @param layoutID The ID of the layout to retrieve.
+         * @return A shared pointer to the layout.
+         * @throws netCDF::exceptions::NcBadId if the `layoutID` does not exist in the map.
+         */
+        std::shared_ptr<const NetcdfLayout> getLayout(
+            int layoutID
+        );
+
+    private:
+        LayoutMap() = default;
+
+        /// ID handed out by the next call to addLayout.
+        int nextLayoutID = 0;
+
+        /// Map associating layout IDs with their captured layouts.
+        std::unordered_map<int, std::shared_ptr<const NetcdfLayout> >
+        layoutMap;
+    };
+
+    extern "C" {
+    /**
+     * @brief Captures the layout of an open NetCDF file for reuse.
+     *
+     * The file must have all of its dimensions, groups, variables and attributes
+     * defined. Data already written to the file is not part of the layout.
+     *
+     * @param netcdfID The ID of the NetCDF file whose layout is captured.
+     * @param layoutID Output parameter that will receive the ID of the captured layout.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfSaveLayout(
+        int netcdfID,
+        int *layoutID
+    );
+
+    /**
+     * @brief Creates a NetCDF file whose definitions are replayed from a captured layout.
+     *
+     * The new file is registered in the file map exactly as with `netcdfCreate`, and is
+     * ready for data to be written.
+     *
+     * @param path The path to the NetCDF file to be created.
+     * @param layoutID The ID of the layout to replay.
+     * @param numDims The number of dimension lengths to override.
+     * @param dimNames The names of the dimensions to override. Deprecated names are
+     *     mapped to their valid IODA names.
+     * @param dimLens The new lengths of the dimensions listed in `dimNames`.
+     * @param netcdfID Output parameter that will receive the ID of the created NetCDF file.
+     * @param fileMode The mode for creating the NetCDF file (see `netcdfCreate`).
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfCreateFromLayout(
+        const char *path,
+        int layoutID,
+        int numDims,
+        const char **dimNames,
+        const size_t *dimLens,
+        int *netcdfID,
+        int fileMode
+    );
+
+    /**
+     * @brief Releases a captured layout.
+     *
+     * @param layoutID The ID of the layout to release.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfFreeLayout(
+        int layoutID
+    );
+
+    /**
+     * @brief Copies a NetCDF dataset, definitions and data, to a new file.
+     *
+     * Either path may end in `.zarr` to select an NCZarr directory store (see
+     * `netcdfDatasetPath`), so this converts NCZarr output to HDF5 and back.
+     *
+     * @param srcPath The path of the dataset to copy.
+     * @param dstPath The path of the copy. An existing file is overwritten.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfCopy(
+        const char *srcPath,
+        const char *dstPath
+    );
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_NETCDF_LAYOUT_H
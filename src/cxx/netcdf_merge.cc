@@ -0,0 +1,496 @@
+#include "netcdf_merge.h"
+#include "netcdf_append.h"
+#include "netcdf_dictionary.h"
+#include "netcdf_error.h"
+#include "netcdf_file.h"
+#include "netcdf_layout.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace Obs2Ioda {
+    namespace {
+        /// Group of the spatial index, which describes the blocks of one file only.
+        const char *const spatialIndexGroup = "SpatialIndex";
+
+        std::string locationDimName() {
+            return iodaSchema.getDimension("nlocs")->getValidName();
+        }
+
+        bool alongLocation(
+            const netCDF::NcVar &var
+        ) {
+            return var.getDimCount() > 0 && var.getDim(0).getName() == locationDimName();
+        }
+
+        /// Number of values per location, or of the whole variable if it has no dimensions.
+        size_t rowValues(
+            const netCDF::NcVar &var
+        ) {
+            size_t numValues = 1;
+            const auto dims = var.getDims();
+            for (size_t i = 1; i < dims.size(); i++) {
+                numValues *= dims[i].getSize();
+            }
+            return numValues;
+        }
+
+        /// Size of one value in memory; a `char *` for `NC_STRING`.
+        size_t valueBytes(
+            const netCDF::NcVar &var
+        ) {
+            size_t size;
+            netCDF::ncCheck(nc_inq_type(var.getParentGroup().getId(), var.getType().getId(), nullptr, &size),
+                            __FILE__, __LINE__);
+            return size;
+        }
+
+        /// Start and count of `numRows` rows from `firstRow`; the other dimensions are whole.
+        std::pair<std::vector<size_t>, std::vector<size_t> > rowSlab(
+            const netCDF::NcVar &var,
+            const size_t firstRow,
+            const size_t numRows
+        ) {
+            std::vector<size_t> start(var.getDimCount(), 0);
+            std::vector<size_t> count;
+            for (const auto &dim: var.getDims()) {
+                count.push_back(dim.getSize());
+            }
+            if (!start.empty()) {
+                start[0] = firstRow;
+                count[0] = numRows;
+            }
+            return {start, count};
+        }
+
+        /**
+         * @brief Consecutive rows of a variable of any type, read with the C API.
+         *
+         * The strings of an `NC_STRING` variable are allocated by NetCDF and freed
+         * when the block is destroyed, so they can be written from the block as is.
+         */
+        class RowBlock {
+        public:
+            RowBlock(
+                const netCDF::NcVar &var,
+                const size_t firstRow,
+                const size_t numRows
+            ) : isString(var.getType().getId() == NC_STRING),
+                numValues(numRows * rowValues(var)),
+                rowBytes(rowValues(var) * valueBytes(var)),
+                data(numRows * rowBytes) {
+                if (numValues == 0) {
+                    return;
+                }
+                const auto slab = rowSlab(var, firstRow, numRows);
+                netCDF::ncCheck(nc_get_vara(var.getParentGroup().getId(), var.getId(), slab.first.data(),
+                                            slab.second.data(), data.data()), __FILE__, __LINE__);
+            }
+
+            RowBlock(
+                const RowBlock &
+            ) = delete;
+
+            RowBlock &operator=(
+                const RowBlock &
+            ) = delete;
+
+            ~RowBlock() {
+                if (isString && numValues > 0) {
+                    nc_free_string(numValues, reinterpret_cast<char **>(data.data()));
+                }
+            }
+
+            const unsigned char *row(
+                const size_t i
+            ) const {
+                return data.data() + i * rowBytes;
+            }
+
+            size_t getRowBytes() const {
+                return rowBytes;
+            }
+
+        private:
+            bool isString;
+            size_t numValues;
+            size_t rowBytes;
+            std::vector<unsigned char> data;
+        };
+
+        void putRows(
+            const netCDF::NcVar &var,
+            const size_t firstRow,
+            const size_t numRows,
+            const void *values
+        ) {
+            if (numRows == 0 || rowValues(var) == 0) {
+                return;
+            }
+            const auto slab = rowSlab(var, firstRow, numRows);
+            netCDF::ncCheck(nc_put_vara(var.getParentGroup().getId(), var.getId(), slab.first.data(),
+                                        slab.second.data(), values), __FILE__, __LINE__);
+        }
+
+        /// Streams `numRows` locations of `src` from `srcRow` to `dst` at `dstRow`.
+        void copyRows(
+            const netCDF::NcVar &src,
+            const size_t srcRow,
+            const size_t numRows,
+            const netCDF::NcVar &dst,
+            const size_t dstRow
+        ) {
+            const size_t blockRows = copyBlockRows(src, rowValues(src) * valueBytes(src));
+            for (size_t row = 0; row < numRows; row += blockRows) {
+                const size_t n = std::min(blockRows, numRows - row);
+                const RowBlock block(src, srcRow + row, n);
+                putRows(dst, dstRow + row, n, block.row(0));
+            }
+        }
+
+        /// Copies a variable that is not along the location dimension in one piece.
+        void copyWhole(
+            const netCDF::NcVar &src,
+            const netCDF::NcVar &dst
+        ) {
+            const size_t numRows = src.getDimCount() > 0 ? src.getDim(0).getSize() : 1;
+            const RowBlock block(src, 0, numRows);
+            putRows(dst, 0, numRows, block.row(0));
+        }
+
+        /// Pairs every variable of `src` with the variable of the same name and group in `dst`.
+        void pairVars(
+            const netCDF::NcGroup &src,
+            const netCDF::NcGroup &dst,
+            std::vector<std::pair<netCDF::NcVar, netCDF::NcVar> > &pairs
+        ) {
+            for (const auto &varEntry: src.getVars()) {
+                const auto dstVar = dst.getVar(varEntry.first);
+                if (dstVar.isNull()) {
+                    throw std::invalid_argument("variable " + varEntry.first + " of group " + src.getName() +
+                                                " is not in the first input");
+                }
+                pairs.emplace_back(varEntry.second, dstVar);
+            }
+            for (const auto &groupEntry: src.getGroups()) {
+                if (src.isRootGroup() && groupEntry.first == spatialIndexGroup) {
+                    continue;
+                }
+                const auto dstGroup = dst.getGroup(groupEntry.first);
+                if (dstGroup.isNull()) {
+                    throw std::invalid_argument("group " + groupEntry.first + " is not in the first input");
+                }
+                pairVars(groupEntry.second, dstGroup, pairs);
+            }
+        }
+
+        std::vector<std::pair<netCDF::NcVar, netCDF::NcVar> > pairVars(
+            const netCDF::NcGroup &src,
+            const netCDF::NcGroup &dst
+        ) {
+            std::vector<std::pair<netCDF::NcVar, netCDF::NcVar> > pairs;
+            pairVars(src, dst, pairs);
+            return pairs;
+        }
+
+        std::string textAtt(
+            const netCDF::NcGroup &group,
+            const std::string &name
+        ) {
+            const auto atts = group.getAtts();
+            const auto att = atts.find(name);
+            std::string value;
+            if (att != atts.end() && att->second.getType() == netCDF::ncChar) {
+                att->second.getValues(value);
+            }
+            return value;
+        }
+
+        /// Defines an output from the layout of the input and sets its per-file attributes.
+        void defineOutput(
+            const NetcdfLayout &layout,
+            const netCDF::NcFile &input,
+            const netCDF::NcFile &output,
+            const size_t numLocs,
+            const std::string &minDatetime,
+            const std::string &maxDatetime
+        ) {
+            // the layout gives the variables the chunking and the filters of the input
+            layout.instantiate(output, {{locationDimName(), numLocs}});
+            const auto atts = output.getAtts();
+            if (atts.find("nlocs") != atts.end()) {
+                output.putAtt("nlocs", netCDF::ncInt, static_cast<int>(numLocs));
+            }
+            if (!minDatetime.empty()) {
+                output.putAtt("min_datetime", minDatetime);
+                output.putAtt("max_datetime", maxDatetime);
+            }
+        }
+
+        long long floorDivide(
+            const long long a,
+            const long long b
+        ) {
+            return a >= 0 ? a / b : -((-a + b - 1) / b);
+        }
+
+        std::string pathExtension(
+            const std::string &path
+        ) {
+            const auto slash = path.find_last_of('/');
+            const auto dot = path.find_last_of('.');
+            return dot != std::string::npos && (slash == std::string::npos || dot > slash) ? path.substr(dot) : "";
+        }
+
+        /// `ccyymmddhh`, and `nn` if windows do not start on whole hours.
+        std::string windowDate(
+            const long long centre,
+            const long long windowSeconds
+        ) {
+            const auto datetime = epochToDatetime(centre);
+            auto date = datetime.substr(0, 4) + datetime.substr(5, 2) + datetime.substr(8, 2) +
+                        datetime.substr(11, 2);
+            if (windowSeconds % 3600 != 0) {
+                date += datetime.substr(14, 2);
+            }
+            return date;
+        }
+
+        /// A time window of `iodaSplit` and the range of its `dateTime` values.
+        struct SplitWindow {
+            size_t numLocs = 0;
+            long long minTime = std::numeric_limits<long long>::max();
+            long long maxTime = std::numeric_limits<long long>::min();
+            int output = -1;
+        };
+    } // namespace
+
+    size_t copyBlockRows(
+        const netCDF::NcVar &var,
+        const size_t rowBytes
+    ) {
+        size_t blockRows = appendChunkRows(rowBytes);
+        netCDF::NcVar::ChunkMode chunkMode;
+        std::vector<size_t> chunkSizes;
+        var.getChunkingParameters(chunkMode, chunkSizes);
+        if (chunkMode == netCDF::NcVar::nc_CHUNKED && !chunkSizes.empty() && chunkSizes[0] > 0) {
+            blockRows = std::max(chunkSizes[0], blockRows / chunkSizes[0] * chunkSizes[0]);
+        }
+        return blockRows;
+    }
+
+    void iodaMerge(
+        const std::vector<std::string> &inputPaths,
+        const std::string &outputPath
+    ) {
+        if (inputPaths.empty()) {
+            throw std::invalid_argument("no files to merge");
+        }
+        const auto locationDim = locationDimName();
+        size_t numLocs = 0;
+        std::string minDatetime;
+        std::string maxDatetime;
+        for (const auto &path: inputPaths) {
+            const netCDF::NcFile input(netcdfDatasetPath(path), netCDF::NcFile::read);
+            numLocs += input.getDim(locationDim).getSize();
+            // the ISO 8601 strings of the attributes order like the times they represent
+            const auto inputMin = textAtt(input, "min_datetime");
+            const auto inputMax = textAtt(input, "max_datetime");
+            if (!inputMin.empty() && (minDatetime.empty() || inputMin < minDatetime)) {
+                minDatetime = inputMin;
+            }
+            maxDatetime = std::max(maxDatetime, inputMax);
+        }
+
+        const netCDF::NcFile output(netcdfDatasetPath(outputPath), netCDF::NcFile::replace);
+        size_t offset = 0;
+        for (size_t i = 0; i < inputPaths.size(); i++) {
+            const netCDF::NcFile input(netcdfDatasetPath(inputPaths[i]), netCDF::NcFile::read);
+            if (i == 0) {
+                NetcdfLayout layout(input);
+                layout.removeGroup(spatialIndexGroup);
+                defineOutput(layout, input, output, numLocs, minDatetime, maxDatetime);
+            }
+            const size_t inputLocs = input.getDim(locationDim).getSize();
+            for (const auto &pair: pairVars(input, output)) {
+                if (alongLocation(pair.first)) {
+                    if (rowValues(pair.first) != rowValues(pair.second)) {
+                        throw std::invalid_argument("variable " + pair.first.getName() + " of " + inputPaths[i] +
+                                                    " has other dimensions than in the first input");
+                    }
+                    if (inputPaths.size() > 1 && isDictionaryEncoded(pair.first)) {
+                        // the indices of each input are into its own table of strings
+                        throw std::invalid_argument("variable " + pair.first.getName() + " of " + inputPaths[i] +
+                                                    " is dictionary-encoded and cannot be merged");
+                    }
+                    copyRows(pair.first, 0, inputLocs, pair.second, offset);
+                } else if (i == 0) {
+                    copyWhole(pair.first, pair.second);
+                }
+            }
+            offset += inputLocs;
+        }
+    }
+
+    std::vector<std::string> iodaSplit(
+        const std::string &inputPath,
+        const std::string &outputPrefix,
+        const long long windowSeconds
+    ) {
+        if (windowSeconds <= 0) {
+            throw std::invalid_argument("the window length must be positive");
+        }
+        const netCDF::NcFile input(netcdfDatasetPath(inputPath), netCDF::NcFile::read);
+        const size_t numLocs = input.getDim(locationDimName()).getSize();
+        const auto metaData = input.getGroup(iodaSchema.getGroup("MetaData")->getValidName());
+        const auto dateTime = metaData.isNull()
+                                  ? netCDF::NcVar()
+                                  : metaData.getVar(iodaSchema.getVariable("dateTime")->getValidName());
+        if (dateTime.isNull() || dateTime.getType() != netCDF::ncInt64 || !alongLocation(dateTime)) {
+            throw std::invalid_argument(inputPath + " has no 64-bit integer MetaData/dateTime");
+        }
+        long long fillValue;
+        int noFill;
+        netCDF::ncCheck(nc_inq_var_fill(metaData.getId(), dateTime.getId(), &noFill, &fillValue),
+                        __FILE__, __LINE__);
+
+        // the windows and their sizes, streamed like the data; locations without a time are dropped
+        std::map<long long, SplitWindow> windows;
+        const size_t blockRows = copyBlockRows(dateTime, sizeof(long long));
+        std::vector<long long> times;
+        for (size_t row = 0; row < numLocs; row += blockRows) {
+            const size_t n = std::min(blockRows, numLocs - row);
+            times.resize(n);
+            dateTime.getVar({row}, {n}, times.data());
+            for (size_t i = 0; i < n; i++) {
+                if (times[i] == fillValue) {
+                    continue;
+                }
+                const long long window = floorDivide(times[i] + windowSeconds / 2, windowSeconds);
+                auto &splitWindow = windows[window];
+                splitWindow.numLocs++;
+                splitWindow.minTime = std::min(splitWindow.minTime, times[i]);
+                splitWindow.maxTime = std::max(splitWindow.maxTime, times[i]);
+            }
+        }
+
+        NetcdfLayout layout(input);
+        layout.removeGroup(spatialIndexGroup);
+        std::vector<std::string> outputPaths;
+        std::vector<std::unique_ptr<netCDF::NcFile> > outputs;
+        for (auto &window: windows) {
+            window.second.output = static_cast<int>(outputs.size());
+            outputPaths.push_back(outputPrefix + windowDate(window.first * windowSeconds, windowSeconds) +
+                                  pathExtension(inputPath));
+            outputs.push_back(std::make_unique<netCDF::NcFile>(netcdfDatasetPath(outputPaths.back()),
+                                                               netCDF::NcFile::replace));
+            defineOutput(layout, input, *outputs.back(), window.second.numLocs,
+                         epochToDatetime(window.second.minTime), epochToDatetime(window.second.maxTime));
+        }
+        // the output of every location of a block is found again from its time, so that
+        // no array over all locations is kept
+        std::vector<int> outputOf;
+        const auto blockOutputs = [&](const size_t row, const size_t n) {
+            times.resize(n);
+            dateTime.getVar({row}, {n}, times.data());
+            outputOf.assign(n, -1);
+            for (size_t i = 0; i < n; i++) {
+                if (times[i] != fillValue) {
+                    outputOf[i] = windows.at(floorDivide(times[i] + windowSeconds / 2, windowSeconds)).output;
+                }
+            }
+        };
+
+        std::vector<std::vector<std::pair<netCDF::NcVar, netCDF::NcVar> > > pairs;
+        for (const auto &output: outputs) {
+            pairs.push_back(pairVars(input, *output));
+        }
+        std::vector<size_t> offsets(outputs.size());
+        std::vector<std::vector<size_t> > rowsOf(outputs.size());
+        std::vector<unsigned char> gathered;
+        for (size_t v = 0; !outputs.empty() && v < pairs[0].size(); v++) {
+            const auto &src = pairs[0][v].first;
+            if (!alongLocation(src)) {
+                for (const auto &outputPairs: pairs) {
+                    copyWhole(src, outputPairs[v].second);
+                }
+                continue;
+            }
+            const size_t varBlockRows = copyBlockRows(src, rowValues(src) * valueBytes(src));
+            std::fill(offsets.begin(), offsets.end(), 0);
+            for (size_t row = 0; row < numLocs; row += varBlockRows) {
+                const size_t n = std::min(varBlockRows, numLocs - row);
+                const RowBlock block(src, row, n);
+                blockOutputs(row, n);
+                for (auto &rows: rowsOf) {
+                    rows.clear();
+                }
+                for (size_t i = 0; i < n; i++) {
+                    if (outputOf[i] >= 0) {
+                        rowsOf[outputOf[i]].push_back(i);
+                    }
+                }
+                for (size_t o = 0; o < outputs.size(); o++) {
+                    const auto &rows = rowsOf[o];
+                    if (rows.empty()) {
+                        continue;
+                    }
+                    const void *values = block.row(rows.front());
+                    // a run of consecutive locations, e.g. of a time-sorted file, is written as read
+                    if (rows.back() - rows.front() + 1 != rows.size()) {
+                        const size_t rowBytes = block.getRowBytes();
+                        gathered.resize(rows.size() * rowBytes);
+                        for (size_t k = 0; k < rows.size(); k++) {
+                            std::memcpy(gathered.data() + k * rowBytes, block.row(rows[k]), rowBytes);
+                        }
+                        values = gathered.data();
+                    }
+                    putRows(pairs[o][v].second, offsets[o], rows.size(), values);
+                    offsets[o] += rows.size();
+                }
+            }
+        }
+        return outputPaths;
+    }
+
+    static int mergeErrorMessage(const std::exception &e, int lineNumber, const char *fileName) {
+        std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+        return -1;
+    }
+
+    int netcdfMerge(
+        const int numInputs,
+        const char **inputPaths,
+        const char *outputPath
+    ) {
+        try {
+            iodaMerge(std::vector<std::string>(inputPaths, inputPaths + std::max(0, numInputs)), outputPath);
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(e, __LINE__, __FILE__);
+        } catch (std::exception &e) {
+            return mergeErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int netcdfSplit(
+        const char *inputPath,
+        const char *outputPrefix,
+        const int windowSeconds,
+        int *numOutputs
+    ) {
+        try {
+            *numOutputs = static_cast<int>(iodaSplit(inputPath, outputPrefix, windowSeconds).size());
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(e, __LINE__, __FILE__);
+        } catch (std::exception &e) {
+            return mergeErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+} // namespace Obs2Ioda
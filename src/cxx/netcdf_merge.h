@@ -0,0 +1,110 @@
+#ifndef OBS2IODA_NETCDF_MERGE_H
+#define OBS2IODA_NETCDF_MERGE_H
+
+#include <netcdf>
+#include <string>
+#include <vector>
+
+namespace Obs2Ioda {
+    /**
+     * @brief Number of locations of a variable copied at a time by `iodaMerge` and `iodaSplit`.
+     *
+     * A block holds about `appendChunkBytes` and, if the variable is chunked, a
+     * whole number of its chunks along the location dimension, so that every chunk
+     * is read and decompressed once.
+     *
+     * Chunks are copied through netCDF-C, so they are decompressed and compressed
+     * again. A raw copy with `H5Dread_chunk` and `H5Dwrite_chunk` of the optional
+     * HDF5 link would need the HDF5 datasets of files netCDF-C has open, which it
+     * does not expose, and does not apply to NCZarr stores or to the rows a split
+     * regroups by window.
+     *
+     * @param var The source variable; its first dimension is the location dimension.
+     * @param rowBytes The size of one location of the variable in bytes.
+     * @return The number of locations per block, at least 1.
+     */
+    size_t copyBlockRows(
+        const netCDF::NcVar &var,
+        size_t rowBytes
+    );
+
+    /**
+     * @brief Concatenates IODA files along the location dimension.
+     *
+     * All inputs must have the groups and variables of the first one, which gives
+     * the layout, chunking and compression of the output. Location variables are
+     * streamed block by block (see `copyBlockRows`), so no file is held in memory;
+     * the other variables, e.g. the channel numbers, are copied from the first
+     * input. The `nlocs` attribute and the `min_datetime` and `max_datetime`
+     * attributes are set to cover all inputs.
+     *
+     * @param inputPaths The files to merge, in output order. Paths ending in `.zarr`
+     *     are NCZarr stores (see `netcdfDatasetPath`).
+     * @param outputPath The merged file. An existing file is overwritten.
+     * @throws std::invalid_argument if there are no inputs, their variables differ, or
+     *     several inputs have dictionary-encoded string variables.
+     */
+    void iodaMerge(
+        const std::vector<std::string> &inputPaths,
+        const std::string &outputPath
+    );
+
+    /**
+     * @brief Partitions an IODA file into time windows along the location dimension.
+     *
+     * Window k covers `MetaData/dateTime` from (k - 1/2) to (k + 1/2) times
+     * `windowSeconds` since 1970-01-01T00:00:00Z, so hourly windows are centred on
+     * the full hours like the `-split` output of obs2ioda-v3. Every non-empty window
+     * is written to `<outputPrefix><ccyymmddhh>[nn]<extension of inputPath>`, named
+     * by its centre (minutes only for windows that are not whole hours), with the
+     * locations in input order. Location variables are streamed block by block,
+     * and the window of each location of a block is found again from its
+     * `dateTime`, so that memory use does not grow with the number of locations.
+     *
+     * @param inputPath The file to split.
+     * @param outputPrefix The path of the outputs up to their date.
+     * @param windowSeconds The length of the windows in seconds.
+     * @return The paths of the outputs, in time order.
+     * @throws std::invalid_argument if the window length is not positive or the
+     *     file has no `MetaData/dateTime`.
+     */
+    std::vector<std::string> iodaSplit(
+        const std::string &inputPath,
+        const std::string &outputPrefix,
+        long long windowSeconds
+    );
+
+    extern "C" {
+    /**
+     * @brief Concatenates IODA files along the location dimension (see `iodaMerge`).
+     *
+     * @param numInputs The number of input files.
+     * @param inputPaths The paths of the input files, in output order.
+     * @param outputPath The path of the merged file.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfMerge(
+        int numInputs,
+        const char **inputPaths,
+        const char *outputPath
+    );
+
+    /**
+     * @brief Partitions an IODA file into time windows (see `iodaSplit`).
+     *
+     * @param inputPath The path of the file to split.
+     * @param outputPrefix The path of the outputs up to their date.
+     * @param windowSeconds The length of the windows in seconds.
+     * @param numOutputs Receives the number of files written.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfSplit(
+        const char *inputPath,
+        const char *outputPrefix,
+        int windowSeconds,
+        int *numOutputs
+    );
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_NETCDF_MERGE_H
@@ -0,0 +1,246 @@
+#include "netcdf_parallel.h"
+#include "netcdf_file.h"
+#include "netcdf_error.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef OBS2IODA_USE_MPI
+#include <mpi.h>
+#include <netcdf_par.h>
+#endif
+
+namespace Obs2Ioda {
+    namespace {
+        void copyString(
+            const std::string &value,
+            char *result,
+            const int resultLen
+        ) {
+            if (resultLen <= 0) {
+                return;
+            }
+            const size_t len = std::min(value.size(), static_cast<size_t>(resultLen - 1));
+            std::memcpy(result, value.data(), len);
+            result[len] = '\0';
+        }
+
+#ifdef OBS2IODA_USE_MPI
+        /// Set when MPI was initialized by netcdfParallelInit, which then also finalizes it.
+        bool ownsMpi = false;
+
+        MPI_Op mpiOp(
+            const int reduceOp
+        ) {
+            switch (reduceOp) {
+                case PARALLEL_MIN:
+                    return MPI_MIN;
+                case PARALLEL_MAX:
+                    return MPI_MAX;
+                default:
+                    return MPI_SUM;
+            }
+        }
+#endif
+    }
+
+    ParallelFile::ParallelFile(
+        const int ncid
+    ) {
+        this->nullObject = false;
+        this->myId = ncid;
+    }
+
+    bool isParallelFile(
+        const netCDF::NcFile &file
+    ) {
+        return dynamic_cast<const ParallelFile *>(&file) != nullptr;
+    }
+
+    int netcdfParallelInit(
+        int *comm,
+        int *rank,
+        int *size
+    ) {
+#ifdef OBS2IODA_USE_MPI
+        int initialized;
+        MPI_Initialized(&initialized);
+        if (!initialized) {
+            MPI_Init(nullptr, nullptr);
+            ownsMpi = true;
+        }
+        *comm = MPI_Comm_c2f(MPI_COMM_WORLD);
+        MPI_Comm_rank(MPI_COMM_WORLD, rank);
+        MPI_Comm_size(MPI_COMM_WORLD, size);
+#else
+        *comm = 0;
+        *rank = 0;
+        *size = 1;
+#endif
+        return 0;
+    }
+
+    int netcdfParallelFinalize() {
+#ifdef OBS2IODA_USE_MPI
+        if (ownsMpi) {
+            MPI_Finalize();
+            ownsMpi = false;
+        }
+#endif
+        return 0;
+    }
+
+    int netcdfParallelExscan(
+        const int comm,
+        const long long localCount,
+        long long *offset,
+        long long *total
+    ) {
+#ifdef OBS2IODA_USE_MPI
+        const MPI_Comm mpiComm = MPI_Comm_f2c(comm);
+        int rank;
+        MPI_Comm_rank(mpiComm, &rank);
+        *offset = 0;
+        MPI_Exscan(&localCount, offset, 1, MPI_LONG_LONG, MPI_SUM, mpiComm);
+        // the receive buffer of rank 0 is undefined after MPI_Exscan
+        if (rank == 0) {
+            *offset = 0;
+        }
+        MPI_Allreduce(&localCount, total, 1, MPI_LONG_LONG, MPI_SUM, mpiComm);
+#else
+        *offset = 0;
+        *total = localCount;
+#endif
+        return 0;
+    }
+
+    int netcdfParallelReduceInt(
+        const int comm,
+        const int value,
+        const int reduceOp,
+        int *result
+    ) {
+#ifdef OBS2IODA_USE_MPI
+        MPI_Allreduce(&value, result, 1, MPI_INT, mpiOp(reduceOp), MPI_Comm_f2c(comm));
+#else
+        *result = value;
+#endif
+        return 0;
+    }
+
+    int netcdfParallelReduceString(
+        const int comm,
+        const char *value,
+        const int reduceOp,
+        char *result,
+        const int resultLen
+    ) {
+#ifdef OBS2IODA_USE_MPI
+        const MPI_Comm mpiComm = MPI_Comm_f2c(comm);
+        int size;
+        MPI_Comm_size(mpiComm, &size);
+        std::vector<char> localValue(resultLen, '\0');
+        copyString(value, localValue.data(), resultLen);
+        std::vector<char> values(static_cast<size_t>(resultLen) * size);
+        MPI_Allgather(localValue.data(), resultLen, MPI_CHAR, values.data(), resultLen, MPI_CHAR, mpiComm);
+        std::string reduced;
+        for (int i = 0; i < size; i++) {
+            const std::string rankValue(values.data() + static_cast<size_t>(i) * resultLen);
+            if (rankValue.empty()) {
+                continue;
+            }
+            if (reduced.empty() || (reduceOp == PARALLEL_MAX ? rankValue > reduced : rankValue < reduced)) {
+                reduced = rankValue;
+            }
+        }
+        copyString(reduced, result, resultLen);
+#else
+        copyString(value, result, resultLen);
+#endif
+        return 0;
+    }
+
+    int netcdfCreatePar(
+        const char *path,
+        int *netcdfID,
+        const int fileMode,
+        const int comm
+    ) {
+        return netcdfCreateParWithOptions(
+            path,
+            netcdfID,
+            fileMode,
+            comm,
+            nullptr
+        );
+    }
+
+    int netcdfCreateParWithOptions(
+        const char *path,
+        int *netcdfID,
+        const int fileMode,
+        const int comm,
+        const NetcdfFileOptions *options
+    ) {
+#ifdef OBS2IODA_USE_MPI
+        try {
+            const MPI_Comm mpiComm = MPI_Comm_f2c(comm);
+            const auto tuning = options ? *options : environmentNetcdfFileOptions();
+            std::unique_ptr<TunedFileAccess> access;
+            auto mode = fileMode;
+            if (isTuned(tuning) || tuning.collectiveMetadataWrite == 0) {
+                access = std::make_unique<TunedFileAccess>(path, fileMode, tuning, mpiComm);
+                mode = access->netcdfFileMode();
+            }
+            int ncid;
+            switch (static_cast<netCDF::NcFile::FileMode>(mode)) {
+                case netCDF::NcFile::read:
+                    netCDF::ncCheck(nc_open_par(path, NC_NOWRITE, mpiComm, MPI_INFO_NULL, &ncid),
+                                    __FILE__, __LINE__);
+                    break;
+                case netCDF::NcFile::write:
+                    netCDF::ncCheck(nc_open_par(path, NC_WRITE, mpiComm, MPI_INFO_NULL, &ncid),
+                                    __FILE__, __LINE__);
+                    break;
+                case netCDF::NcFile::newFile:
+                    netCDF::ncCheck(nc_create_par(path, NC_NETCDF4 | NC_NOCLOBBER, mpiComm, MPI_INFO_NULL, &ncid),
+                                    __FILE__, __LINE__);
+                    break;
+                default:
+                    netCDF::ncCheck(nc_create_par(path, NC_NETCDF4 | NC_CLOBBER, mpiComm, MPI_INFO_NULL, &ncid),
+                                    __FILE__, __LINE__);
+                    break;
+            }
+            // closing the tuned HDF5 handle is collective, like the open
+            access.reset();
+            const auto file = std::make_shared<ParallelFile>(ncid);
+            *netcdfID = ncid;
+            FileMap::getInstance().addFile(
+                *netcdfID,
+                file
+            );
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        } catch (std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << " at " << __FILE__ << ":" << __LINE__ << std::endl;
+            return -1;
+        }
+#else
+        return netcdfCreateWithOptions(
+            path,
+            netcdfID,
+            fileMode,
+            options
+        );
+#endif
+    }
+}
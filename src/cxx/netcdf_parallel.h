@@ -0,0 +1,185 @@
+#ifndef OBS2IODA_NETCDF_PARALLEL_H
+#define OBS2IODA_NETCDF_PARALLEL_H
+
+#include <netcdf>
+#include "netcdf_file_options.h"
+
+namespace Obs2Ioda {
+    /**
+     * @brief Reduction operations of `netcdfParallelReduceInt` and `netcdfParallelReduceString`.
+     */
+    enum ParallelReduceOp {
+        PARALLEL_MIN = 0,
+        PARALLEL_MAX = 1,
+        PARALLEL_SUM = 2
+    };
+
+    /**
+     * @class ParallelFile
+     * @brief A `netCDF::NcFile` opened with the parallel (MPI-IO) NetCDF API.
+     *
+     * netCDF-cxx4 has no parallel constructor, so the file is created with the C API
+     * and adopted by this class, which closes it like any other `netCDF::NcFile`.
+     * Variables of a parallel file are written collectively by all ranks of the
+     * communicator the file was created with.
+     */
+    class ParallelFile : public netCDF::NcFile {
+    public:
+        /**
+         * @brief Adopts a file opened with `nc_create_par` or `nc_open_par`.
+         *
+         * @param ncid The NetCDF ID of the open file.
+         */
+        explicit ParallelFile(
+            int ncid
+        );
+    };
+
+    /**
+     * @brief Checks whether a file was opened with the parallel NetCDF API.
+     *
+     * @param file The file to check.
+     * @return true if `file` is a `ParallelFile`.
+     */
+    bool isParallelFile(
+        const netCDF::NcFile &file
+    );
+
+    extern "C" {
+    /**
+     * @brief Initializes MPI, if it is not already, and returns the world communicator.
+     *
+     * Without MPI support (`OBS2IODA_USE_MPI` undefined) the process is rank 0 of 1.
+     *
+     * @param comm Output parameter that will receive the Fortran handle of `MPI_COMM_WORLD`.
+     * @param rank Output parameter that will receive the rank of this process.
+     * @param size Output parameter that will receive the number of ranks.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfParallelInit(
+        int *comm,
+        int *rank,
+        int *size
+    );
+
+    /**
+     * @brief Finalizes MPI if it was initialized by `netcdfParallelInit`.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfParallelFinalize();
+
+    /**
+     * @brief Computes the offset of the local items in the concatenation of all ranks.
+     *
+     * The offset is the exclusive prefix sum of `localCount` over the ranks of `comm`,
+     * so rank r writes its items starting at the sum of the counts of ranks 0 to r-1.
+     *
+     * @param comm The Fortran handle of the communicator.
+     * @param localCount The number of items held by this rank.
+     * @param offset Output parameter that will receive the zero-based offset of the local items.
+     * @param total Output parameter that will receive the number of items of all ranks.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfParallelExscan(
+        int comm,
+        long long localCount,
+        long long *offset,
+        long long *total
+    );
+
+    /**
+     * @brief Reduces an integer over the ranks of a communicator.
+     *
+     * @param comm The Fortran handle of the communicator.
+     * @param value The value of this rank.
+     * @param reduceOp The reduction, one of `ParallelReduceOp`.
+     * @param result Output parameter that will receive the reduced value on every rank.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfParallelReduceInt(
+        int comm,
+        int value,
+        int reduceOp,
+        int *result
+    );
+
+    /**
+     * @brief Finds the lexicographic minimum or maximum of a string over the ranks of a communicator.
+     *
+     * Empty strings are ignored, so ranks without data do not take part. ISO 8601
+     * date-time strings order chronologically, which is what the `min_datetime` and
+     * `max_datetime` attributes need.
+     *
+     * @param comm The Fortran handle of the communicator.
+     * @param value The null-terminated string of this rank.
+     * @param reduceOp `PARALLEL_MIN` or `PARALLEL_MAX`.
+     * @param result Output buffer that will receive the null-terminated result on every rank.
+     * @param resultLen The size of `result`, including the terminating null character.
+     *     Longer strings are truncated.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfParallelReduceString(
+        int comm,
+        const char *value,
+        int reduceOp,
+        char *result,
+        int resultLen
+    );
+
+    /**
+     * @brief Creates or opens a NetCDF-4 file shared by all ranks of a communicator.
+     *
+     * This is the collective counterpart of `netcdfCreate`: every rank of `comm` must
+     * call it, and then define the same dimensions, groups and variables. Data is
+     * written with the `netcdfPutVarSlab` functions, each rank its own hyperslab.
+     * Without MPI support the communicator is ignored and the file is created as
+     * with `netcdfCreate`.
+     *
+     * @param path The path to the NetCDF file. NCZarr stores are not supported.
+     * @param netcdfID Output parameter that will receive the ID of the file.
+     * @param fileMode The mode for creating the NetCDF file (see `netcdfCreate`).
+     * @param comm The Fortran handle of the communicator.
+     *
+     * HDF5 files are tuned with the options of the `OBS2IODA_HDF5_OPTIONS`
+     * environment variable, if it is set.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfCreatePar(
+        const char *path,
+        int *netcdfID,
+        int fileMode,
+        int comm
+    );
+
+    /**
+     * @brief Collectively creates or opens a NetCDF-4 file for parallel I/O with HDF5 tuning.
+     *
+     * As `netcdfCreatePar`, with the HDF5 file-creation and file-access settings
+     * of `options` instead of those of the environment. The page buffer is not
+     * used for parallel I/O.
+     *
+     * @param path The path to the NetCDF file. NCZarr stores are not supported.
+     * @param netcdfID Output parameter that will receive the ID of the file.
+     * @param fileMode The mode for creating the NetCDF file (see `netcdfCreate`).
+     * @param comm The Fortran handle of the communicator.
+     * @param options The HDF5 tuning, or NULL for the options of the environment.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfCreateParWithOptions(
+        const char *path,
+        int *netcdfID,
+        int fileMode,
+        int comm,
+        const NetcdfFileOptions *options
+    );
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_NETCDF_PARALLEL_H
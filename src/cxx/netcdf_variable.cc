@@ -1,20 +1,26 @@
 #include "netcdf_variable.h"
+#include "ioda_writer.h"
 #include "netcdf_file.h"
 #include "netcdf_error.h"
+#include "netcdf_encoding.h"
+#include "netcdf_dictionary.h"
 #include <algorithm>
 #include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
 
 namespace Obs2Ioda {
 
-    std::vector<char> flattenCharPtrArray(const char *const *values, const int numStrings, const int stringSize) {
-        std::vector<char> contiguousValues(numStrings * stringSize + numStrings, ' ');
-
-        for (int i = 0; i < numStrings; ++i) {
-            int len = std::strlen(values[i]);
-            std::copy_n(values[i], std::min(len, stringSize), contiguousValues.begin() + i * stringSize);
-            contiguousValues[i * stringSize + stringSize] = '\0';
+    namespace {
+        int variableErrorMessage(
+            const std::exception &e,
+            const int lineNumber,
+            const char *fileName
+        ) {
+            std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+            return -1;
         }
-        return contiguousValues;
     }
 
     int netcdfAddVar(
@@ -26,23 +32,11 @@ namespace Obs2Ioda {
         const char **dimNames
     ) {
         try {
-            auto file = FileMap::getInstance().getFile(netcdfID);
-            const auto group = !groupName
-                                   ? file
-                                   : std::make_shared<
-                                       netCDF::NcGroup>(
-                                       file->getGroup(
-                                           iodaSchema.getGroup(groupName)->getValidName()));
-            std::vector<netCDF::NcDim> dims;
-            dims.reserve(numDims);
-            for (int i = 0; i < numDims; i++) {
-                dims.push_back(file->getDim(iodaSchema.getDimension(dimNames[i])->getValidName()));;
-            }
-            auto iodaVarName = iodaSchema.getVariable(varName)->getValidName();
-            auto var = group->addVar(
-                iodaVarName,
-                netCDF::NcType(netcdfDataType),
-                dims
+            IodaWriter(netcdfID).defineVar(
+                groupName ? groupName : "",
+                varName,
+                netcdfDataType,
+                std::vector<std::string>(dimNames, dimNames + numDims)
             );
             return 0;
         } catch (netCDF::exceptions::NcException &e) {
@@ -62,27 +56,8 @@ namespace Obs2Ioda {
         const T *values
     ) {
         try {
-            auto file = FileMap::getInstance().getFile(netcdfID);
-            const auto group = !groupName
-                                   ? file
-                                   : std::make_shared<
-                                       netCDF::NcGroup>(
-                                       file->getGroup(
-                                           iodaSchema.getGroup(groupName)->getValidName()));
-            auto iodaVarName = iodaSchema.getVariable(varName)->getValidName();
-            const auto var = group->getVar(iodaVarName);
-            auto varType = var.getType();
-            // Special handling for char arrays
-            if (varType == netCDF::ncChar) {
-                const auto contiguousValues = flattenCharPtrArray(
-                    reinterpret_cast<const char * const *>(values),
-                    static_cast<int>(var.getDims()[0].getSize()),
-                    static_cast<int>(var.getDims()[1].getSize())
-                );
-                var.putVar(contiguousValues.data());
-                return 0;
-            }
-            var.putVar(values);
+            const auto var = IodaWriter(netcdfID).getVar<T>(groupName ? groupName : "", varName);
+            var.put(Span<const T>(values, var.size()));
             return 0;
         } catch (netCDF::exceptions::NcException &e) {
             return netcdfErrorMessage(
@@ -90,6 +65,8 @@ namespace Obs2Ioda {
                 __LINE__,
                 __FILE__
             );
+        } catch (std::exception &e) {
+            return variableErrorMessage(e, __LINE__, __FILE__);
         }
     }
 
@@ -177,6 +154,138 @@ namespace Obs2Ioda {
         );
     }
 
+    template<typename T>
+    int netcdfPutVarSlab(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const T *values
+    ) {
+        try {
+            size_t numValues = 1;
+            for (int i = 0; i < numDims; i++) {
+                numValues *= count[i];
+            }
+            IodaWriter(netcdfID).getVar<T>(groupName ? groupName : "", varName).put(
+                std::vector<size_t>(start, start + numDims),
+                std::vector<size_t>(count, count + numDims),
+                Span<const T>(values, numValues)
+            );
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        } catch (std::exception &e) {
+            return variableErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int netcdfPutVarSlabInt(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const int *values
+    ) {
+        return netcdfPutVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
+    int netcdfPutVarSlabInt64(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const long long *values
+    ) {
+        return netcdfPutVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
+    int netcdfPutVarSlabReal(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const float *values
+    ) {
+        return netcdfPutVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
+    int netcdfPutVarSlabDouble(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const double *values
+    ) {
+        return netcdfPutVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
+    int netcdfPutVarSlabString(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const char **values
+    ) {
+        return netcdfPutVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
     template<typename T>
     int netcdfSetFill(
         int netcdfID,
@@ -186,19 +295,12 @@ namespace Obs2Ioda {
         T fillValue
     ) {
         try {
-            auto file = FileMap::getInstance().getFile(netcdfID);
-            const auto group = !groupName
-                                   ? file
-                                   : std::make_shared<
-                                       netCDF::NcGroup>(
-                                       file->getGroup(
-                                           iodaSchema.getGroup(groupName)->getValidName()));
-            auto iodaVarName = iodaSchema.getVariable(varName)->getValidName();
-            auto var = group->getVar(iodaVarName);
-            var.setFill(
-                fillMode,
-                fillValue
-            );
+            const auto var = IodaWriter(netcdfID).getVar<T>(groupName ? groupName : "", varName);
+            if (fillMode) {
+                var.setFill(fillValue);
+            } else {
+                var.disableFill();
+            }
             return 0;
         } catch (netCDF::exceptions::NcException &e) {
             return netcdfErrorMessage(
@@ -206,6 +308,8 @@ namespace Obs2Ioda {
                 __LINE__,
                 __FILE__
             );
+        } catch (std::exception &e) {
+            return variableErrorMessage(e, __LINE__, __FILE__);
         }
     }
 
@@ -273,4 +377,313 @@ namespace Obs2Ioda {
 
         );
     }
+
+    namespace {
+        netCDF::NcVar findVar(
+            const int netcdfID,
+            const char *groupName,
+            const char *varName
+        ) {
+            const auto file = FileMap::getInstance().getFile(netcdfID);
+            const auto group = !groupName
+                                   ? static_cast<netCDF::NcGroup>(*file)
+                                   : file->getGroup(iodaSchema.getGroup(groupName)->getValidName());
+            return group.getVar(iodaSchema.getVariable(varName)->getValidName());
+        }
+    }
+
+    int netcdfInqVar(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        nc_type *netcdfDataType,
+        int *numDims,
+        int maxDims,
+        size_t *dimLens
+    ) {
+        try {
+            const auto var = findVar(netcdfID, groupName, varName);
+            const auto dims = var.getDims();
+            *netcdfDataType = var.getType().getId();
+            *numDims = static_cast<int>(dims.size());
+            for (int i = 0; i < std::min(maxDims, *numDims); i++) {
+                dimLens[i] = dims[i].getSize();
+            }
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        }
+    }
+
+    template<typename T>
+    int netcdfGetVar(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        T *values
+    ) {
+        try {
+            const auto var = findVar(netcdfID, groupName, varName);
+            if (isEncoded<T>(var)) {
+                std::vector<size_t> startp(var.getDimCount(), 0);
+                std::vector<size_t> countp;
+                for (const auto &dim: var.getDims()) {
+                    countp.push_back(dim.getSize());
+                }
+                getEncoded(var, startp, countp, values);
+                return 0;
+            }
+            var.getVar(values);
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        } catch (std::exception &e) {
+            return variableErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int netcdfGetVarInt(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int *values
+    ) {
+        return netcdfGetVar(
+            netcdfID,
+            groupName,
+            varName,
+            values
+        );
+    }
+
+    int netcdfGetVarInt64(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        long long *values
+    ) {
+        return netcdfGetVar(
+            netcdfID,
+            groupName,
+            varName,
+            values
+        );
+    }
+
+    int netcdfGetVarReal(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        float *values
+    ) {
+        return netcdfGetVar(
+            netcdfID,
+            groupName,
+            varName,
+            values
+        );
+    }
+
+    int netcdfGetVarDouble(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        double *values
+    ) {
+        return netcdfGetVar(
+            netcdfID,
+            groupName,
+            varName,
+            values
+        );
+    }
+
+    template<typename T>
+    int netcdfGetVarSlab(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        T *values
+    ) {
+        try {
+            const std::vector<size_t> startp(start, start + numDims);
+            const std::vector<size_t> countp(count, count + numDims);
+            const auto var = findVar(netcdfID, groupName, varName);
+            if (isEncoded<T>(var)) {
+                getEncoded(var, startp, countp, values);
+                return 0;
+            }
+            var.getVar(startp, countp, values);
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        } catch (std::exception &e) {
+            return variableErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int netcdfGetVarSlabInt(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        int *values
+    ) {
+        return netcdfGetVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
+    int netcdfGetVarSlabInt64(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        long long *values
+    ) {
+        return netcdfGetVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
+    int netcdfGetVarSlabReal(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        float *values
+    ) {
+        return netcdfGetVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
+    int netcdfGetVarSlabDouble(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        double *values
+    ) {
+        return netcdfGetVarSlab(
+            netcdfID,
+            groupName,
+            varName,
+            numDims,
+            start,
+            count,
+            values
+        );
+    }
+
+    int netcdfGetVarSlabString(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        int stringLen,
+        char *values
+    ) {
+        try {
+            const auto var = findVar(netcdfID, groupName, varName);
+            const int ncid = var.getParentGroup().getId();
+            std::vector<size_t> startp(start, start + numDims);
+            std::vector<size_t> countp(count, count + numDims);
+            size_t numStrings = 1;
+            for (const auto n: countp) {
+                numStrings *= n;
+            }
+            std::fill_n(values, numStrings * stringLen, ' ');
+            if (numStrings == 0) {
+                return 0;
+            }
+            if (var.getType() == netCDF::ncChar) {
+                const size_t charLen = var.getDims().back().getSize();
+                startp.push_back(0);
+                countp.push_back(charLen);
+                std::vector<char> chars(numStrings * charLen);
+                netCDF::ncCheck(nc_get_vara_text(ncid, var.getId(), startp.data(), countp.data(), chars.data()),
+                                __FILE__, __LINE__);
+                for (size_t i = 0; i < numStrings; i++) {
+                    const char *string = chars.data() + i * charLen;
+                    const size_t len = std::find(string, string + charLen, '\0') - string;
+                    std::copy_n(string, std::min<size_t>(len, stringLen), values + i * stringLen);
+                }
+                return 0;
+            }
+            if (isDictionaryEncoded(var)) {
+                // indices outside the table, such as the NetCDF default fill value, are blank
+                std::vector<int> indices(numStrings);
+                var.getVar(startp, countp, indices.data());
+                const auto dictionary = readDictionary(var);
+                for (size_t i = 0; i < numStrings; i++) {
+                    if (indices[i] >= 0 && static_cast<size_t>(indices[i]) < dictionary.size()) {
+                        const auto &string = dictionary[indices[i]];
+                        std::copy_n(string.begin(), std::min<size_t>(string.size(), stringLen), values + i * stringLen);
+                    }
+                }
+                return 0;
+            }
+            std::vector<char *> strings(numStrings);
+            netCDF::ncCheck(nc_get_vara_string(ncid, var.getId(), startp.data(), countp.data(), strings.data()),
+                            __FILE__, __LINE__);
+            for (size_t i = 0; i < numStrings; i++) {
+                if (strings[i] != nullptr) {
+                    const size_t len = std::strlen(strings[i]);
+                    std::copy_n(strings[i], std::min<size_t>(len, stringLen), values + i * stringLen);
+                }
+            }
+            nc_free_string(numStrings, strings.data());
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(
+                e,
+                __LINE__,
+                __FILE__
+            );
+        }
+    }
 }
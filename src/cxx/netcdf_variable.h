@@ -81,6 +81,73 @@ namespace Obs2Ioda {
         const char **values
     );
 
+    /**
+    * @brief Writes a hyperslab of a variable in a NetCDF file.
+    *
+    * In a file created with `netcdfCreatePar` the write is collective: every rank
+    * must call this function for the variable, a rank without data with a zero count.
+    *
+    * @param netcdfID The identifier of the NetCDF file where the data will be written.
+    * @param groupName The name of the group containing the variable. If NULL, the variable is assumed to be a global variable.
+    * @param varName The name of the variable to which data will be written.
+    * @param numDims The number of dimensions of the variable.
+    * @param start The zero-based index of the first element written, per dimension.
+    * @param count The number of elements written, per dimension.
+    * @param values A pointer to the data to be written, in row-major order.
+    * @return int A status code indicating the outcome of the operation:
+    *         - 0: Success.
+    *         - Non-zero: Failure, with an error message logged.
+    */
+    int netcdfPutVarSlabInt(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const int *values
+    );
+
+    int netcdfPutVarSlabInt64(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const long long *values
+    );
+
+    int netcdfPutVarSlabReal(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const float *values
+    );
+
+    int netcdfPutVarSlabDouble(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const double *values
+    );
+
+    int netcdfPutVarSlabString(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        const char **values
+    );
+
     /**
     * @brief Sets the fill mode and fill value for a variable in a NetCDF file.
     *
@@ -126,6 +193,147 @@ namespace Obs2Ioda {
         int fillMode,
         const char *fillValue
     );
+
+    /**
+    * @brief Inquires the type and shape of a variable in a NetCDF file.
+    *
+    * @param netcdfID The identifier of the NetCDF file containing the variable.
+    * @param groupName The name of the group containing the variable. If NULL, the variable is assumed to be a global variable.
+    * @param varName The name of the variable.
+    * @param netcdfDataType Receives the NetCDF data type of the variable (e.g., NC_INT, NC_FLOAT).
+    * @param numDims Receives the number of dimensions of the variable.
+    * @param maxDims The size of `dimLens`.
+    * @param dimLens Receives the current length of each dimension, up to `maxDims` of them.
+    * @return int A status code indicating the outcome of the operation:
+    *         - 0: Success.
+    *         - Non-zero: Failure, with an error message logged.
+    */
+    int netcdfInqVar(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        nc_type *netcdfDataType,
+        int *numDims,
+        int maxDims,
+        size_t *dimLens
+    );
+
+    /**
+    * @brief Reads all values of a variable in a NetCDF file.
+    *
+    * Values are converted to the requested type by the NetCDF library.
+    *
+    * @param netcdfID The identifier of the NetCDF file containing the variable.
+    * @param groupName The name of the group containing the variable. If NULL, the variable is assumed to be a global variable.
+    * @param varName The name of the variable to read.
+    * @param values Receives the values, in row-major order.
+    * @return int A status code indicating the outcome of the operation:
+    *         - 0: Success.
+    *         - Non-zero: Failure, with an error message logged.
+    */
+    int netcdfGetVarInt(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int *values
+    );
+
+    int netcdfGetVarInt64(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        long long *values
+    );
+
+    int netcdfGetVarReal(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        float *values
+    );
+
+    int netcdfGetVarDouble(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        double *values
+    );
+
+    /**
+    * @brief Reads a hyperslab of a variable in a NetCDF file.
+    *
+    * @param netcdfID The identifier of the NetCDF file containing the variable.
+    * @param groupName The name of the group containing the variable. If NULL, the variable is assumed to be a global variable.
+    * @param varName The name of the variable to read.
+    * @param numDims The number of dimensions of the variable.
+    * @param start The zero-based index of the first element read, per dimension.
+    * @param count The number of elements read, per dimension.
+    * @param values Receives the values, in row-major order.
+    * @return int A status code indicating the outcome of the operation:
+    *         - 0: Success.
+    *         - Non-zero: Failure, with an error message logged.
+    */
+    int netcdfGetVarSlabInt(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        int *values
+    );
+
+    int netcdfGetVarSlabInt64(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        long long *values
+    );
+
+    int netcdfGetVarSlabReal(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        float *values
+    );
+
+    int netcdfGetVarSlabDouble(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        double *values
+    );
+
+    /**
+    * @brief Reads a hyperslab of a string variable as blank-padded fixed-length strings.
+    *
+    * `NC_STRING` variables are read element by element. For `NC_CHAR` variables the
+    * last dimension is the string length and is not part of `start` and `count`.
+    * Strings longer than `stringLen` are truncated.
+    *
+    * @param numDims The number of dimensions in `start` and `count`.
+    * @param stringLen The length of each string in `values`.
+    * @param values Receives the strings, `stringLen` characters each, without terminators.
+    */
+    int netcdfGetVarSlabString(
+        int netcdfID,
+        const char *groupName,
+        const char *varName,
+        int numDims,
+        const size_t *start,
+        const size_t *count,
+        int stringLen,
+        char *values
+    );
     }
 }
 
@@ -0,0 +1,149 @@
+#include "obs_order.h"
+#include "run_threads.h"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+namespace Obs2Ioda {
+    namespace {
+        constexpr unsigned radixBits = 8;
+        constexpr size_t radixBuckets = size_t{1} << radixBits;
+
+        /// Maps a signed key to an unsigned one of the same order.
+        unsigned long long orderedBits(
+            const long long value
+        ) {
+            return static_cast<unsigned long long>(value) ^ (1ULL << 63);
+        }
+    } // namespace
+
+    std::vector<size_t> radixSortPermutation(
+        const size_t numKeys,
+        const std::vector<const long long *> &keys,
+        unsigned numThreads
+    ) {
+        std::vector<size_t> order(numKeys);
+        std::iota(order.begin(), order.end(), size_t{0});
+        if (numKeys < 2) {
+            return order;
+        }
+        if (numThreads == 0) {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (numKeys < radixSortParallelThreshold) {
+            numThreads = 1;
+        }
+        const size_t share = (numKeys + numThreads - 1) / numThreads;
+        std::vector<size_t> next(numKeys);
+        // counts[t * radixBuckets + b]: keys of thread t in bucket b, then where they go
+        std::vector<size_t> counts(numThreads * radixBuckets);
+
+        for (auto key = keys.rbegin(); key != keys.rend(); ++key) {
+            const long long *values = *key;
+            unsigned long long varying = 0;
+            const unsigned long long first = orderedBits(values[0]);
+            for (size_t i = 1; i < numKeys; i++) {
+                varying |= orderedBits(values[i]) ^ first;
+            }
+            for (unsigned shift = 0; shift < 64; shift += radixBits) {
+                if (((varying >> shift) & (radixBuckets - 1)) == 0) {
+                    continue;
+                }
+                std::fill(counts.begin(), counts.end(), 0);
+                runThreads(numThreads, [&](const unsigned t) {
+                    size_t *count = &counts[t * radixBuckets];
+                    const size_t end = std::min(numKeys, (t + 1) * share);
+                    for (size_t i = t * share; i < end; i++) {
+                        count[(orderedBits(values[order[i]]) >> shift) & (radixBuckets - 1)]++;
+                    }
+                });
+                size_t offset = 0;
+                for (size_t b = 0; b < radixBuckets; b++) {
+                    for (unsigned t = 0; t < numThreads; t++) {
+                        const size_t count = counts[t * radixBuckets + b];
+                        counts[t * radixBuckets + b] = offset;
+                        offset += count;
+                    }
+                }
+                runThreads(numThreads, [&](const unsigned t) {
+                    size_t *position = &counts[t * radixBuckets];
+                    const size_t end = std::min(numKeys, (t + 1) * share);
+                    for (size_t i = t * share; i < end; i++) {
+                        next[position[(orderedBits(values[order[i]]) >> shift) & (radixBuckets - 1)]++] = order[i];
+                    }
+                });
+                order.swap(next);
+            }
+        }
+        return order;
+    }
+
+    std::vector<long long> stringRanks(
+        const char *strings,
+        const size_t numStrings,
+        const size_t length
+    ) {
+        const auto string = [&](const size_t i) {
+            return std::string_view(strings + i * length, length);
+        };
+        std::vector<size_t> sorted(numStrings);
+        std::iota(sorted.begin(), sorted.end(), 0);
+        std::sort(sorted.begin(), sorted.end(), [&](const size_t a, const size_t b) {
+            return string(a) < string(b);
+        });
+        std::vector<long long> ranks(numStrings);
+        long long rank = -1;
+        for (size_t k = 0; k < numStrings; k++) {
+            if (k == 0 || string(sorted[k]) != string(sorted[k - 1])) {
+                rank++;
+            }
+            ranks[sorted[k]] = rank;
+        }
+        return ranks;
+    }
+
+    static int obsOrderErrorMessage(const std::exception &e, int lineNumber, const char *fileName) {
+        std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+        return -1;
+    }
+
+    int obsOrder(
+        const long long numLocs,
+        const long long *dateTime,
+        const char *stationIds,
+        const int stationIdLen,
+        long long *order,
+        long long *recordNumber,
+        long long *numRecords
+    ) {
+        try {
+            if (numLocs < 0) {
+                throw std::invalid_argument("negative number of locations");
+            }
+            std::vector<const long long *> keys{dateTime};
+            std::vector<long long> stations;
+            if (stationIds != nullptr) {
+                stations = stringRanks(stationIds, numLocs, stationIdLen);
+                keys.push_back(stations.data());
+            }
+            const auto sorted = radixSortPermutation(numLocs, keys);
+            long long record = 0;
+            for (size_t i = 0; i < sorted.size(); i++) {
+                const size_t loc = sorted[i];
+                if (i == 0 || dateTime[loc] != dateTime[sorted[i - 1]] ||
+                    (stationIds != nullptr && stations[loc] != stations[sorted[i - 1]])) {
+                    record++;
+                }
+                order[i] = static_cast<long long>(loc);
+                recordNumber[i] = record;
+            }
+            *numRecords = record;
+            return 0;
+        } catch (std::exception &e) {
+            return obsOrderErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+} // namespace Obs2Ioda
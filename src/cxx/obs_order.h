@@ -0,0 +1,79 @@
+#ifndef OBS2IODA_OBS_ORDER_H
+#define OBS2IODA_OBS_ORDER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Obs2Ioda {
+    /// Number of keys below which `radixSortPermutation` runs on one thread.
+    constexpr size_t radixSortParallelThreshold = 1 << 16;
+
+    /**
+     * @brief Computes the stable order of locations by several 64-bit integer keys.
+     *
+     * The keys are sorted with a least-significant-digit radix sort, one byte per
+     * pass, from the last key to the first. Passes in which all keys share the same
+     * byte (e.g. the high bytes of times within one window) are skipped. With more
+     * than `radixSortParallelThreshold` keys, every pass is split between threads:
+     * each thread counts the bytes of its share of the keys and scatters them to
+     * offsets derived from all counts, so the sort stays stable.
+     *
+     * @param numKeys The number of locations.
+     * @param keys The keys, most significant first; each points to `numKeys` values.
+     * @param numThreads The number of threads, or 0 for the number of hardware threads.
+     * @return The 0-based indices of the locations in sorted order.
+     */
+    std::vector<size_t> radixSortPermutation(
+        size_t numKeys,
+        const std::vector<const long long *> &keys,
+        unsigned numThreads = 0
+    );
+
+    /**
+     * @brief Replaces fixed-width strings by their rank in lexical order.
+     *
+     * Equal strings get the same rank, so the ranks can be sorted as a key.
+     *
+     * @param strings `numStrings` strings of `length` characters each, not null-terminated.
+     * @param numStrings The number of strings.
+     * @param length The width of each string.
+     * @return The 0-based rank of every string.
+     */
+    std::vector<long long> stringRanks(
+        const char *strings,
+        size_t numStrings,
+        size_t length
+    );
+
+    extern "C" {
+    /**
+     * @brief Computes the output order of the locations of an obtype or instrument.
+     *
+     * Locations are ordered by `dateTime` and then by station, and numbered by
+     * record: consecutive locations of the order with the same `dateTime` and
+     * station form one record.
+     *
+     * @param numLocs The number of locations.
+     * @param dateTime The `dateTime` of each location.
+     * @param stationIds `numLocs` station IDs of `stationIdLen` characters each, or
+     * null to order by `dateTime` only.
+     * @param stationIdLen The width of a station ID.
+     * @param order Receives the 0-based indices of the locations in output order.
+     * @param recordNumber Receives the 1-based record number of each location of the
+     * output order.
+     * @param numRecords Receives the number of records.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int obsOrder(
+        long long numLocs,
+        const long long *dateTime,
+        const char *stationIds,
+        int stationIdLen,
+        long long *order,
+        long long *recordNumber,
+        long long *numRecords
+    );
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_OBS_ORDER_H
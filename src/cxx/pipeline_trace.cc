@@ -0,0 +1,247 @@
+#include "pipeline_trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace Obs2Ioda {
+
+    RssSample readRss() {
+        RssSample sample;
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, 6, "VmRSS:") == 0) {
+                sample.current = std::atoll(line.c_str() + 6);
+            } else if (line.compare(0, 6, "VmHWM:") == 0) {
+                sample.highWater = std::atoll(line.c_str() + 6);
+            }
+        }
+        return sample;
+    }
+
+    /**
+     * @brief Resets the high-water resident set size of this process (Linux 4.0 and later).
+     *
+     * Best effort: where `/proc/self/clear_refs` cannot be written the high-water
+     * mark keeps growing over the process lifetime, and stage peaks become upper bounds.
+     */
+    static void resetRssHighWater() {
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        if (clearRefs) {
+            clearRefs << "5";
+        }
+    }
+
+    static std::string jsonEscape(const std::string &s) {
+        std::string escaped;
+        escaped.reserve(s.size());
+        for (const char c: s) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            if (static_cast<unsigned char>(c) >= 0x20) {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    PipelineTrace &PipelineTrace::getInstance() {
+        static PipelineTrace instance;
+        return instance;
+    }
+
+    void PipelineTrace::init(const std::string &path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->path = path;
+        enabled = !path.empty();
+        initPid = static_cast<int>(getpid());
+        clockStart = std::chrono::steady_clock::now();
+        openStages.clear();
+        events.clear();
+    }
+
+    bool PipelineTrace::isEnabled() const {
+        return enabled;
+    }
+
+    long long PipelineTrace::now() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - clockStart).count();
+    }
+
+    void PipelineTrace::begin(const std::string &name) {
+        if (!enabled) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto rss = readRss();
+        // the enclosing stage keeps the peak reached so far before the mark is reset
+        if (!openStages.empty()) {
+            openStages.back().peakRss = std::max(openStages.back().peakRss, rss.highWater);
+        }
+        resetRssHighWater();
+        openStages.push_back({name, now(), rss.current});
+    }
+
+    void PipelineTrace::end(const std::string &name, long long count) {
+        if (!enabled) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (openStages.empty() || openStages.back().name != name) {
+            throw std::logic_error("trace stage " + name + " ended but not the innermost open stage");
+        }
+        const auto rss = readRss();
+        const auto stage = openStages.back();
+        openStages.pop_back();
+        const auto peakRss = std::max(stage.peakRss, rss.highWater);
+        if (!openStages.empty()) {
+            openStages.back().peakRss = std::max(openStages.back().peakRss, peakRss);
+        }
+        events.push_back({
+            stage.name, stage.start, now() - stage.start, count, rss.current, peakRss,
+            static_cast<int>(openStages.size())
+        });
+    }
+
+    const std::vector<PipelineTrace::Event> &PipelineTrace::getEvents() const {
+        return events;
+    }
+
+    void PipelineTrace::writeChromeTrace(const std::string &path) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("unable to write trace file " + path);
+        }
+        const auto pid = static_cast<int>(getpid());
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+                << ",\"args\":{\"name\":\"obs2ioda " << pid << "\"}}";
+        for (const auto &event: events) {
+            out << ",\n{\"name\":\"" << jsonEscape(event.name) << "\",\"cat\":\"obs2ioda\",\"ph\":\"X\""
+                    << ",\"ts\":" << event.start << ",\"dur\":" << event.duration
+                    << ",\"pid\":" << pid << ",\"tid\":0,\"args\":{";
+            if (event.count >= 0) {
+                out << "\"observations\":" << event.count << ",";
+            }
+            out << "\"rss_kb\":" << event.rss << ",\"peak_rss_kb\":" << event.peakRss << "}}";
+            out << ",\n{\"name\":\"rss_kb\",\"ph\":\"C\",\"ts\":" << event.start + event.duration
+                    << ",\"pid\":" << pid << ",\"args\":{\"rss\":" << event.rss << "}}";
+        }
+        out << "\n]}\n";
+        if (!out) {
+            throw std::runtime_error("unable to write trace file " + path);
+        }
+    }
+
+    std::string PipelineTrace::summary() const {
+        struct Totals {
+            long long calls = 0;
+            long long duration = 0;
+            long long count = 0;
+            long long peakRss = 0;
+            size_t firstEvent = 0;
+        };
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<std::string, Totals> totals;
+        for (size_t i = 0; i < events.size(); ++i) {
+            const auto &event = events[i];
+            auto inserted = totals.emplace(event.name, Totals());
+            auto &t = inserted.first->second;
+            if (inserted.second) {
+                t.firstEvent = i;
+            }
+            t.calls++;
+            t.duration += event.duration;
+            t.count += std::max(event.count, 0LL);
+            t.peakRss = std::max(t.peakRss, event.peakRss);
+        }
+        std::vector<std::pair<std::string, Totals> > rows(totals.begin(), totals.end());
+        std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) {
+            return a.second.firstEvent < b.second.firstEvent;
+        });
+
+        std::ostringstream table;
+        table << std::left << std::setw(32) << "stage" << std::right << std::setw(8) << "calls"
+                << std::setw(14) << "wall [s]" << std::setw(16) << "observations"
+                << std::setw(16) << "peak RSS [MB]" << "\n";
+        for (const auto &row: rows) {
+            const auto &t = row.second;
+            table << std::left << std::setw(32) << row.first << std::right << std::setw(8) << t.calls
+                    << std::setw(14) << std::fixed << std::setprecision(3) << t.duration * 1.0e-6
+                    << std::setw(16) << t.count
+                    << std::setw(16) << std::setprecision(1) << t.peakRss / 1024.0 << "\n";
+        }
+        return table.str();
+    }
+
+    void PipelineTrace::finalize() {
+        if (!enabled) {
+            return;
+        }
+        auto tracePath = path;
+        if (static_cast<int>(getpid()) != initPid) {
+            tracePath += "." + std::to_string(getpid());
+        }
+        writeChromeTrace(tracePath);
+        std::cout << "stage trace written to " << tracePath << "\n" << summary() << std::flush;
+        enabled = false;
+    }
+
+    static int traceErrorMessage(const std::exception &e, int lineNumber, const char *fileName) {
+        std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+        return -1;
+    }
+
+    int traceInit(const char *path, int rank) {
+        try {
+            std::string tracePath = path ? path : "";
+            if (tracePath.empty()) {
+                const char *envPath = std::getenv("OBS2IODA_TRACE");
+                tracePath = envPath ? envPath : "";
+            }
+            if (!tracePath.empty() && rank > 0) {
+                tracePath += ".rank" + std::to_string(rank);
+            }
+            PipelineTrace::getInstance().init(tracePath);
+            return 0;
+        } catch (std::exception &e) {
+            return traceErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int traceBegin(const char *name) {
+        try {
+            PipelineTrace::getInstance().begin(name);
+            return 0;
+        } catch (std::exception &e) {
+            return traceErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int traceEnd(const char *name, long long count) {
+        try {
+            PipelineTrace::getInstance().end(name, count);
+            return 0;
+        } catch (std::exception &e) {
+            return traceErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int traceFinalize() {
+        try {
+            PipelineTrace::getInstance().finalize();
+            return 0;
+        } catch (std::exception &e) {
+            return traceErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+}
@@ -0,0 +1,200 @@
+#ifndef OBS2IODA_PIPELINE_TRACE_H
+#define OBS2IODA_PIPELINE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Obs2Ioda {
+    /**
+     * @brief Resident set size of this process, in kB.
+     */
+    struct RssSample {
+        long long current = 0;
+        long long highWater = 0;
+    };
+
+    /**
+     * @brief Reads the current and high-water resident set size from `/proc/self/status`.
+     *
+     * @return The sample, zero where the values are not available.
+     */
+    RssSample readRss();
+
+    /**
+     * @class PipelineTrace
+     * @brief Singleton class recording the stages of a conversion.
+     *
+     * Each stage is a begin/end pair with a name. Stages nest; the peak resident
+     * set size of a stage includes the peaks of the stages nested in it. When the
+     * trace is written, the stages are stored as Chrome/Perfetto trace events
+     * (`chrome://tracing`, `ui.perfetto.dev`), and a summary table per stage
+     * name is printed to standard output.
+     *
+     * The trace is disabled, and all calls are no-ops, until `init` is called
+     * with a non-empty path.
+     */
+    class PipelineTrace {
+    public:
+        /**
+         * @brief One finished stage.
+         */
+        struct Event {
+            std::string name;
+            long long start;     ///< Microseconds since `init`.
+            long long duration;  ///< Microseconds.
+            long long count;     ///< Number of observations, -1 if not given.
+            long long rss;       ///< Resident set size at the end of the stage, in kB.
+            long long peakRss;   ///< Peak resident set size during the stage, in kB.
+            int depth;           ///< Nesting level, 0 for outermost stages.
+        };
+
+        /**
+         * @brief Retrieves the singleton instance of the PipelineTrace.
+         *
+         * @return A reference to the singleton instance of PipelineTrace.
+         */
+        static PipelineTrace &getInstance();
+
+        PipelineTrace(
+            const PipelineTrace &
+        ) = delete;
+
+        PipelineTrace &operator=(
+            const PipelineTrace &
+        ) = delete;
+
+        /**
+         * @brief Enables the trace and starts its clock.
+         *
+         * @param path The trace file. An empty path disables the trace.
+         */
+        void init(
+            const std::string &path
+        );
+
+        /**
+         * @return true if `init` was called with a non-empty path.
+         */
+        bool isEnabled() const;
+
+        /**
+         * @brief Starts a stage.
+         *
+         * @param name The name of the stage.
+         */
+        void begin(
+            const std::string &name
+        );
+
+        /**
+         * @brief Ends the innermost open stage.
+         *
+         * @param name The name of the stage, which must match the innermost `begin`.
+         * @param count The number of observations handled by the stage, or -1.
+         * @throws std::logic_error if no stage with this name is open innermost.
+         */
+        void end(
+            const std::string &name,
+            long long count
+        );
+
+        /**
+         * @return The finished stages, in the order they ended.
+         */
+        const std::vector<Event> &getEvents() const;
+
+        /**
+         * @brief Writes the Chrome trace JSON of the finished stages.
+         *
+         * @param path The output file.
+         * @throws std::runtime_error if the file cannot be written.
+         */
+        void writeChromeTrace(
+            const std::string &path
+        ) const;
+
+        /**
+         * @brief Formats a table of calls, wall time, observations and peak
+         * resident set size per stage name.
+         */
+        std::string summary() const;
+
+        /**
+         * @brief Writes the trace file and the summary and disables the trace.
+         *
+         * A process forked after `init` writes to `<path>.<pid>` so that
+         * concurrent families do not overwrite each other's trace.
+         */
+        void finalize();
+
+    private:
+        PipelineTrace() = default;
+
+        struct OpenStage {
+            std::string name;
+            long long start;
+            long long peakRss;
+        };
+
+        long long now() const;
+
+        /// Read without the mutex by the stages of a disabled trace.
+        std::atomic<bool> enabled{false};
+        std::string path;
+        int initPid = 0;
+        std::chrono::steady_clock::time_point clockStart;
+        std::vector<OpenStage> openStages;
+        std::vector<Event> events;
+        mutable std::mutex mutex;
+    };
+
+    extern "C" {
+    /**
+     * @brief Enables stage tracing.
+     *
+     * @param path The trace file. If NULL or empty, the `OBS2IODA_TRACE`
+     *             environment variable is used; tracing stays off if it is unset too.
+     * @param rank The MPI rank of this process; ranks other than 0 append `.rank<N>` to the file name.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int traceInit(
+        const char *path,
+        int rank
+    );
+
+    /**
+     * @brief Starts a stage. Does nothing if tracing is disabled.
+     *
+     * @param name The name of the stage.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int traceBegin(
+        const char *name
+    );
+
+    /**
+     * @brief Ends the innermost stage. Does nothing if tracing is disabled.
+     *
+     * @param name The name of the stage, as given to `traceBegin`.
+     * @param count The number of observations handled by the stage, or -1.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int traceEnd(
+        const char *name,
+        long long count
+    );
+
+    /**
+     * @brief Writes the trace file and the summary table. Does nothing if tracing is disabled.
+     *
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int traceFinalize();
+    }
+}
+
+#endif //OBS2IODA_PIPELINE_TRACE_H
@@ -0,0 +1,32 @@
+#ifndef OBS2IODA_RUN_THREADS_H
+#define OBS2IODA_RUN_THREADS_H
+
+#include <thread>
+#include <vector>
+
+namespace Obs2Ioda {
+    /// Calls `task(t)` for t = 0 .. numThreads-1, each on its own thread, and waits for all.
+    template<typename Task>
+    void runThreads(
+        const unsigned numThreads,
+        const Task &task
+    ) {
+        std::vector<std::thread> threads;
+        try {
+            for (unsigned t = 1; t < numThreads; t++) {
+                threads.emplace_back(task, t);
+            }
+        } catch (...) {
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            throw;
+        }
+        task(0);
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_RUN_THREADS_H
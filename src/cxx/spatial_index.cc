@@ -0,0 +1,215 @@
+#include "spatial_index.h"
+#include "netcdf_append.h"
+#include "netcdf_error.h"
+#include "netcdf_file.h"
+#include "obs_order.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace Obs2Ioda {
+    namespace {
+        bool validLocation(
+            const float lat,
+            const float lon
+        ) {
+            return std::abs(lat) <= 90.0f && std::abs(lon) <= 360.0f;
+        }
+
+        /// Longitude in 0-360 degrees, the range of the grid of `hilbertIndex`.
+        float eastLongitude(
+            const float lon
+        ) {
+            const float east = std::fmod(lon, 360.0f);
+            return east < 0.0f ? east + 360.0f : east;
+        }
+    } // namespace
+
+    long long hilbertIndex(
+        const double lat,
+        const double lon,
+        const unsigned bits
+    ) {
+        const unsigned long long n = 1ULL << bits;
+        const double east = std::fmod(std::fmod(lon, 360.0) + 360.0, 360.0);
+        auto x = std::min(n - 1, static_cast<unsigned long long>(east / 360.0 * static_cast<double>(n)));
+        auto y = std::min(n - 1, static_cast<unsigned long long>(
+                              std::max(0.0, (lat + 90.0) / 180.0 * static_cast<double>(n))));
+        unsigned long long index = 0;
+        for (unsigned long long s = n / 2; s > 0; s /= 2) {
+            const unsigned long long rx = (x & s) > 0;
+            const unsigned long long ry = (y & s) > 0;
+            index += s * s * ((3 * rx) ^ ry);
+            // rotate the quadrant so that the curve within it starts and ends at the right corners
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return static_cast<long long>(index);
+    }
+
+    std::vector<SpatialBlock> spatialBlocks(
+        const size_t numLocs,
+        const float *lat,
+        const float *lon,
+        const long long *dateTime,
+        const size_t blockLocs
+    ) {
+        std::vector<SpatialBlock> blocks((numLocs + blockLocs - 1) / blockLocs);
+        for (size_t b = 0; b < blocks.size(); b++) {
+            auto &block = blocks[b];
+            bool first = true;
+            const size_t end = std::min(numLocs, (b + 1) * blockLocs);
+            for (size_t i = b * blockLocs; i < end; i++) {
+                if (!validLocation(lat[i], lon[i])) {
+                    continue;
+                }
+                const float east = eastLongitude(lon[i]);
+                if (first) {
+                    block = {lat[i], lat[i], east, east, dateTime[i], dateTime[i]};
+                    first = false;
+                    continue;
+                }
+                block.latitudeMin = std::min(block.latitudeMin, lat[i]);
+                block.latitudeMax = std::max(block.latitudeMax, lat[i]);
+                block.longitudeMin = std::min(block.longitudeMin, east);
+                block.longitudeMax = std::max(block.longitudeMax, east);
+                block.dateTimeMin = std::min(block.dateTimeMin, dateTime[i]);
+                block.dateTimeMax = std::max(block.dateTimeMax, dateTime[i]);
+            }
+        }
+        return blocks;
+    }
+
+    LocationBlocks &LocationBlocks::getInstance() {
+        static LocationBlocks instance;
+        return instance;
+    }
+
+    void LocationBlocks::setBlockLocs(
+        const size_t blockLocs
+    ) {
+        this->blockLocs = blockLocs;
+    }
+
+    size_t LocationBlocks::getBlockLocs() const {
+        return blockLocs;
+    }
+
+    void LocationBlocks::chunk(
+        const netCDF::NcVar &var
+    ) const {
+        const auto dims = var.getDims();
+        if (blockLocs == 0 || dims.empty() || dims[0].isUnlimited() || dims[0].getSize() == 0 ||
+            dims[0].getName() != iodaSchema.getDimension("nlocs")->getValidName()) {
+            return;
+        }
+        size_t valueBytes;
+        netCDF::ncCheck(nc_inq_type(var.getParentGroup().getId(), var.getType().getId(), nullptr, &valueBytes),
+                        __FILE__, __LINE__);
+        std::vector<size_t> chunkSizes(dims.size());
+        chunkSizes[0] = std::min(blockLocs, dims[0].getSize());
+        // split the other dimensions, e.g. the channels, rather than the block
+        size_t budget = std::max<size_t>(1, appendChunkBytes / (chunkSizes[0] * valueBytes));
+        for (size_t i = 1; i < dims.size(); i++) {
+            chunkSizes[i] = std::max<size_t>(1, std::min(dims[i].getSize(), budget));
+            budget = std::max<size_t>(1, budget / chunkSizes[i]);
+        }
+        var.setChunking(netCDF::NcVar::nc_CHUNKED, chunkSizes);
+    }
+
+    static int spatialIndexErrorMessage(const std::exception &e, int lineNumber, const char *fileName) {
+        std::cerr << "Error: " << e.what() << " at " << fileName << ":" << lineNumber << std::endl;
+        return -1;
+    }
+
+    int spatialOrder(
+        const long long numLocs,
+        const float *lat,
+        const float *lon,
+        const long long *dateTime,
+        long long *order
+    ) {
+        try {
+            if (numLocs < 0) {
+                throw std::invalid_argument("negative number of locations");
+            }
+            std::vector<long long> curve(numLocs);
+            for (long long i = 0; i < numLocs; i++) {
+                curve[i] = validLocation(lat[i], lon[i])
+                               ? hilbertIndex(lat[i], lon[i])
+                               : std::numeric_limits<long long>::max();
+            }
+            const auto sorted = radixSortPermutation(numLocs, {curve.data(), dateTime});
+            std::copy(sorted.begin(), sorted.end(), order);
+            return 0;
+        } catch (std::exception &e) {
+            return spatialIndexErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+
+    int netcdfSetLocationBlocks(
+        const int blockLocs
+    ) {
+        LocationBlocks::getInstance().setBlockLocs(std::max(0, blockLocs));
+        return 0;
+    }
+
+    int netcdfPutSpatialIndex(
+        const int netcdfID,
+        const long long numLocs,
+        const float *lat,
+        const float *lon,
+        const long long *dateTime
+    ) {
+        try {
+            if (numLocs < 0) {
+                throw std::invalid_argument("negative number of locations");
+            }
+            const size_t blockLocs = LocationBlocks::getInstance().getBlockLocs();
+            if (blockLocs == 0) {
+                throw std::invalid_argument("the number of locations per block is not set");
+            }
+            const auto blocks = spatialBlocks(static_cast<size_t>(numLocs), lat, lon, dateTime, blockLocs);
+            const auto file = FileMap::getInstance().getFile(netcdfID);
+            const auto group = file->addGroup("SpatialIndex");
+            group.putAtt("locationsPerBlock", netCDF::ncInt, static_cast<int>(blockLocs));
+            const auto dim = group.addDim("Block", blocks.size());
+            const auto putFloat = [&](const char *name, float SpatialBlock::*member) {
+                std::vector<float> values(blocks.size());
+                std::transform(blocks.begin(), blocks.end(), values.begin(),
+                               [&](const SpatialBlock &block) { return block.*member; });
+                const auto var = group.addVar(name, netCDF::ncFloat, std::vector<netCDF::NcDim>{dim});
+                var.putAtt("_FillValue", netCDF::ncFloat, SpatialBlock::missing);
+                var.putVar(values.data());
+            };
+            const auto putInt64 = [&](const char *name, long long SpatialBlock::*member) {
+                std::vector<long long> values(blocks.size());
+                std::transform(blocks.begin(), blocks.end(), values.begin(),
+                               [&](const SpatialBlock &block) { return block.*member; });
+                const auto var = group.addVar(name, netCDF::ncInt64, std::vector<netCDF::NcDim>{dim});
+                var.putAtt("_FillValue", netCDF::ncInt64, -999LL);
+                var.putAtt("units", "seconds since 1970-01-01T00:00:00Z");
+                var.putVar(values.data());
+            };
+            putFloat("latitudeMin", &SpatialBlock::latitudeMin);
+            putFloat("latitudeMax", &SpatialBlock::latitudeMax);
+            putFloat("longitudeMin", &SpatialBlock::longitudeMin);
+            putFloat("longitudeMax", &SpatialBlock::longitudeMax);
+            putInt64("dateTimeMin", &SpatialBlock::dateTimeMin);
+            putInt64("dateTimeMax", &SpatialBlock::dateTimeMax);
+            return 0;
+        } catch (netCDF::exceptions::NcException &e) {
+            return netcdfErrorMessage(e, __LINE__, __FILE__);
+        } catch (std::exception &e) {
+            return spatialIndexErrorMessage(e, __LINE__, __FILE__);
+        }
+    }
+} // namespace Obs2Ioda
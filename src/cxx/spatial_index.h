@@ -0,0 +1,174 @@
+#ifndef OBS2IODA_SPATIAL_INDEX_H
+#define OBS2IODA_SPATIAL_INDEX_H
+
+#include <netcdf>
+#include <cstddef>
+#include <vector>
+
+namespace Obs2Ioda {
+    /// Number of bits of each grid coordinate of `hilbertIndex`.
+    constexpr unsigned hilbertBits = 16;
+
+    /**
+     * @brief Position of a location along a Hilbert curve over the globe.
+     *
+     * Longitude and latitude are mapped to a 2^bits x 2^bits grid (longitude
+     * 0-360 from west to east, latitude -90-90 from south to north), and the cell
+     * is numbered along the Hilbert curve filling the grid. Locations close on the
+     * curve are close on the globe, so sorting by the index keeps neighbouring
+     * locations in neighbouring blocks of a file.
+     *
+     * @param lat Latitude in degrees.
+     * @param lon Longitude in degrees, -180-180 or 0-360.
+     * @param bits Bits per grid coordinate, at most 31.
+     * @return The index, 0 .. 4^bits - 1.
+     */
+    long long hilbertIndex(
+        double lat,
+        double lon,
+        unsigned bits = hilbertBits
+    );
+
+    /**
+     * @brief Bounding box and time range of a block of consecutive locations.
+     *
+     * Locations without a valid latitude and longitude are not part of the box;
+     * a block without any valid location keeps the `missing` values. Longitudes
+     * are normalised to 0-360, the range of the grid of `hilbertIndex`, so that
+     * inputs in -180-180 and 0-360 give the same box and blocks ordered along the
+     * curve never straddle the ends of the range.
+     */
+    struct SpatialBlock {
+        static constexpr float missing = -999.0f;
+        float latitudeMin = missing;
+        float latitudeMax = missing;
+        float longitudeMin = missing;
+        float longitudeMax = missing;
+        long long dateTimeMin = -999;
+        long long dateTimeMax = -999;
+    };
+
+    /**
+     * @brief Computes the bounding box and time range of every block of `blockLocs` locations.
+     *
+     * @return The blocks; the last one may hold fewer locations.
+     */
+    std::vector<SpatialBlock> spatialBlocks(
+        size_t numLocs,
+        const float *lat,
+        const float *lon,
+        const long long *dateTime,
+        size_t blockLocs
+    );
+
+    /**
+     * @class LocationBlocks
+     * @brief Singleton class holding the number of locations per block of the spatial index.
+     *
+     * While the block size is set, variables along the location dimension are
+     * chunked in blocks of that many locations, so that every entry of the spatial
+     * index of a file covers whole chunks and a reader can skip the chunks of
+     * blocks outside its region.
+     */
+    class LocationBlocks {
+    public:
+        /**
+         * @brief Retrieves the singleton instance of the LocationBlocks.
+         *
+         * @return A reference to the singleton instance of LocationBlocks.
+         */
+        static LocationBlocks &getInstance();
+
+        LocationBlocks(
+            const LocationBlocks &
+        ) = delete;
+
+        LocationBlocks &operator=(
+            const LocationBlocks &
+        ) = delete;
+
+        /**
+         * @brief Sets the number of locations per block, or 0 to stop chunking by blocks.
+         */
+        void setBlockLocs(
+            size_t blockLocs
+        );
+
+        size_t getBlockLocs() const;
+
+        /**
+         * @brief Chunks a new variable by blocks of locations, if blocks are set and
+         * the first dimension of the variable is the fixed-size location dimension.
+         *
+         * The other dimensions are chunked so that a chunk holds at most
+         * `appendChunkBytes`.
+         *
+         * @param var The variable, not written yet.
+         */
+        void chunk(
+            const netCDF::NcVar &var
+        ) const;
+
+    private:
+        LocationBlocks() = default;
+
+        size_t blockLocs = 0;
+    };
+
+    extern "C" {
+    /**
+     * @brief Computes the order of locations along the Hilbert curve, and then by `dateTime`.
+     *
+     * Locations without a valid latitude and longitude are put last.
+     *
+     * @param numLocs The number of locations.
+     * @param lat The latitude of each location in degrees.
+     * @param lon The longitude of each location in degrees.
+     * @param dateTime The `dateTime` of each location.
+     * @param order Receives the 0-based indices of the locations in output order.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int spatialOrder(
+        long long numLocs,
+        const float *lat,
+        const float *lon,
+        const long long *dateTime,
+        long long *order
+    );
+
+    /**
+     * @brief Sets the number of locations per block of the spatial index (see `LocationBlocks`).
+     *
+     * @param blockLocs The number of locations per block, or 0 to stop chunking by blocks.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfSetLocationBlocks(
+        int blockLocs
+    );
+
+    /**
+     * @brief Writes the spatial index of a file.
+     *
+     * The group `SpatialIndex` gets a dimension `Block` and the variables
+     * `latitudeMin`, `latitudeMax`, `longitudeMin`, `longitudeMax`, `dateTimeMin`
+     * and `dateTimeMax`, one value per block of `locationsPerBlock` consecutive
+     * locations; `locationsPerBlock` is an attribute of the group.
+     *
+     * @param netcdfID The NetCDF ID of the file.
+     * @param numLocs The number of locations of the file.
+     * @param lat The latitude of each location in degrees.
+     * @param lon The longitude of each location in degrees.
+     * @param dateTime The `dateTime` of each location.
+     * @return 0 on success, or a non-zero error code on failure.
+     */
+    int netcdfPutSpatialIndex(
+        int netcdfID,
+        long long numLocs,
+        const float *lat,
+        const float *lon,
+        const long long *dateTime
+    );
+    }
+} // namespace Obs2Ioda
+
+#endif // OBS2IODA_SPATIAL_INDEX_H
@@ -6,7 +6,7 @@
 !  Author: Hailing Zhang
 
 module gnssro_bufr2ioda
-   use define_mod, only: ndatetime, output_info_type
+   use define_mod, only: ndatetime, output_info_type, output_ext
    implicit none
    private
    public :: read_write_gnssro
@@ -37,7 +37,6 @@ module gnssro_bufr2ioda
       integer(i_kind), allocatable, dimension(:) :: ogce
       real(r_kind), allocatable, dimension(:) :: time
       integer(i_64),allocatable, dimension(:) :: epochtime
-      character(len = ndatetime), allocatable, dimension(:) :: datetime
       real(r_kind), allocatable, dimension(:) :: lat
       real(r_kind), allocatable, dimension(:) :: lon
       real(r_kind), allocatable, dimension(:) :: rfict
@@ -49,7 +48,6 @@ module gnssro_bufr2ioda
       real(r_kind), allocatable, dimension(:) :: bend_ang
       real(r_kind), allocatable, dimension(:) :: impact_para
       real(r_kind), allocatable, dimension(:) :: bndoe_gsi
-      real(r_kind), allocatable, dimension(:) :: gstime
       integer(i_kind), allocatable, dimension(:) :: idx_window
    end type gnssro_type
 
@@ -99,7 +97,7 @@ contains
       call readmg(lnbufr, subset, idate, iret)
       if (iret /= 0) then
          write(6, *) 'READ_GNSSRO: can not open gnssro file!'
-         stop
+         stop 1
       end if
       write(*, fmt = '(a,i10)') input_file_name // ' file date is: ', idate
       iadate5(1) = idate / 1000000
@@ -137,7 +135,6 @@ contains
       allocate(gnssro_data%ogce(maxobs))
       allocate(gnssro_data%time(maxobs))
       allocate(gnssro_data%epochtime(maxobs))
-      allocate(gnssro_data%datetime(maxobs))
       allocate(gnssro_data%lat(maxobs))
       allocate(gnssro_data%lon(maxobs))
       allocate(gnssro_data%rfict(maxobs))
@@ -149,13 +146,12 @@ contains
       allocate(gnssro_data%bend_ang(maxobs))
       allocate(gnssro_data%impact_para(maxobs))
       allocate(gnssro_data%bndoe_gsi(maxobs))
-      allocate(gnssro_data%gstime(maxobs))
       allocate(gnssro_data%idx_window(maxobs))
    end subroutine
 
 
    subroutine read_gnssro_data(input_file_name, gnssro_data, gnssro_bufr_info)
-      use utils_mod, only: get_julian_time
+      use netcdf_cxx_mod, only: timeToEpoch
       character(len = *), intent(in) :: input_file_name
       type(gnssro_type), intent(inout) :: gnssro_data
       type(bufr_info_type), intent(inout) :: gnssro_bufr_info
@@ -166,10 +162,9 @@ contains
       real(r_kind), dimension(n1ahdr) :: bfr1ahdr
       real(r_kind), dimension(1) :: qfro
       integer(i_kind), dimension(6) :: idate5
-      real(r_kind) :: pcc, roc, geoid, timeo, gstime
+      real(r_kind) :: pcc, roc, geoid, timeo
       integer(i_kind) :: said, siid, ptid, sclf, ogce, minobs, nib, asce
       integer(i_64) :: epochtime
-      character(len = ndatetime) :: datetime
       integer :: refflag, bendflag
       integer(i_kind), dimension(mxib) :: ibit
       integer(i_kind) :: i, k, m
@@ -212,9 +207,10 @@ contains
             ogce = bfr1ahdr(13)  ! Identification of originating/generating centre
             call w3fs21(idate5, minobs)
             timeo = real(minobs - gnssro_bufr_info%analysis_epochtime_in_mins, r_kind) / 60.0
-            call get_julian_time(idate5(1), idate5(2), idate5(3), idate5(4), idate5(5), idate5(6), gstime, epochtime)
-            write(datetime, '(i4, a, i2.2, a, i2.2, a, i2.2, a, i2.2, a, i2.2, a)')  &
-               idate5(1), '-', idate5(2), '-', idate5(3), 'T', idate5(4), ':', idate5(5), ':', idate5(6), 'Z'
+            if (timeToEpoch(idate5(1), idate5(2), idate5(3), idate5(4), idate5(5), idate5(6), epochtime) /= 0) then
+               if (verbose) write(6, *) 'READ_GNSSRO: invalid observation time, skip this report'
+               cycle read_loop
+            endif
             ! check if values are in valid range
             ! earth radius of curvature
             if (roc > 6450000.0_r_kind .or. roc < 6250000.0_r_kind .or. geoid > 200_r_kind .or. geoid < -200._r_kind) then
@@ -319,8 +315,6 @@ contains
                   gnssro_data%lon(ndata) = rlon
                   gnssro_data%time(ndata) = timeo
                   gnssro_data%epochtime(ndata) = epochtime
-                  gnssro_data%gstime(ndata) = gstime
-                  gnssro_data%datetime(ndata) = datetime
                   gnssro_data%said(ndata) = said
                   gnssro_data%siid(ndata) = siid
                   gnssro_data%sclf(ndata) = sclf
@@ -359,8 +353,9 @@ contains
 
    subroutine assign_gnssro_data_to_time_window(gnssro_data, gnssro_bufr_info, file_output_info)
       ! Assigns each observation to a time window index in [1, gnssro_bufr_info%n_windows].
-      ! The assignment to a time window is based on the observation time (gnssro_data%gstime).
-      use utils_mod, only: da_advance_time, da_get_time_slots
+      ! The assignment to a time window is based on the observation time (gnssro_data%epochtime).
+      use utils_mod, only: da_advance_time, get_time_slot
+      use netcdf_cxx_mod, only: timeWindowSlots
       use define_mod, only: dtime_min, dtime_max
       type(gnssro_type), intent(inout) :: gnssro_data
       type(bufr_info_type), intent(in) :: gnssro_bufr_info
@@ -369,8 +364,7 @@ contains
       integer(i_kind) :: ndata
       character(:), allocatable :: analysis_time
       character(len = 14) :: tmin_string, tmax_string
-      real(r_kind), dimension(0 : file_output_info%n_windows) :: time_slots
-      real(r_kind) :: obs_time
+      integer(i_64), dimension(0 : file_output_info%n_windows) :: time_slots
       integer :: idx_obs, j
       ndata = gnssro_bufr_info%nobs
       analysis_time = gnssro_bufr_info%analysis_time  ! analysis time based on 6h bufr file
@@ -380,20 +374,16 @@ contains
       if (n_windows > 1) then  ! in case the output is split into time windows
          call da_advance_time(analysis_time, dtime_min, tmin_string)  ! initial time of bufr file
          call da_advance_time(analysis_time, dtime_max, tmax_string)  ! final time of bufr file
-         call da_get_time_slots(n_windows, tmin_string, tmax_string, time_slots)  ! time windows contained in bufr file
+         ! time windows contained in bufr file
+         if (timeWindowSlots(tmin_string, tmax_string, n_windows, time_slots) /= 0) then
+            write(6, *) 'Error: invalid time window ', tmin_string, ' to ', tmax_string
+            stop 2
+         endif
          do idx_obs = 1, ndata
-            ! identify the time window that contains obs_time
-            obs_time = gnssro_data%gstime(idx_obs)  ! julian time format of gstime is identical to time_slots
-            do j = 1, n_windows
-               ! strictly speaking, the logical expression should contain one <= and one < condition (otherwise the assignment
-               ! at window boundaries is ambiguous). The first and last time windows require a <= at the window start and end,
-               ! respectively. The use of two <= statements accommodates this and implies that observations at intermediate
-               ! domain boundaries are assigned to the preceeding window.
-               if (time_slots(j-1) <= obs_time .and. obs_time <= time_slots(j)) then
-                  gnssro_data%idx_window(idx_obs) = j
-                  exit
-               endif
-            enddo
+            ! identify the time window that contains the observation time. Observations at intermediate window
+            ! boundaries are assigned to the preceeding window.
+            j = get_time_slot(gnssro_data%epochtime(idx_obs), time_slots)
+            if (j <= n_windows) gnssro_data%idx_window(idx_obs) = j
          enddo
       else  ! in case the output is not split into time windows
          gnssro_data%idx_window(1 : ndata) = 1  ! all valid obs have the same index
@@ -420,7 +410,7 @@ contains
       else  ! single time window: central time corresponds to 6h bufr file analysis time
          output_file_date = analysis_time
       endif
-      output_file_name = trim(adjustl(file_output_info%output_dir)) // 'gnssro_obs_' // output_file_date // '.h5'
+      output_file_name = trim(adjustl(file_output_info%output_dir)) // 'gnssro_obs_' // output_file_date // trim(output_ext)
    end subroutine
 
 
@@ -428,7 +418,7 @@ contains
       use netcdf, only: NF90_INT, NF90_INT64, NF90_FLOAT
       use kinds, only: r_single, i_llong
       use netcdf_cxx_mod, only: netcdfCreate, netcdfAddDim, netcdfPutAtt, netcdfPutAttArray, &
-         netcdfAddGroup, netcdfAddVar, netcdfPutVar, netcdfClose
+         netcdfAddGroup, netcdfAddVar, netcdfPutVar, netcdfClose, timeEpochToDatetime
       type(gnssro_type), intent(in) :: gnssro_data
       type(bufr_info_type), intent(in) :: gnssro_bufr_info
       type(output_info_type), intent(in) :: file_output_info
@@ -436,6 +426,7 @@ contains
       logical, dimension(gnssro_bufr_info%nobs_max) :: is_in_window
       integer(i_kind) :: ndata
       integer :: idx_min_time, idx_max_time
+      character(len = ndatetime), dimension(2) :: min_max_datetime
       integer :: file_mode
       character(:), allocatable :: dim_name, var_name, group_name
       integer :: ncid, dim_id
@@ -460,8 +451,10 @@ contains
       idx_min_time = minloc(gnssro_data%epochtime, mask = is_in_window, dim = 1)
       idx_max_time = maxloc(gnssro_data%epochtime, mask = is_in_window, dim = 1)
       call check(netcdfPutAtt(ncid, 'ioda_version', 'fortran generated ioda2 file'))
-      call check(netcdfPutAtt(ncid, 'min_datetime', gnssro_data%datetime(idx_min_time)))
-      call check(netcdfPutAtt(ncid, 'max_datetime', gnssro_data%datetime(idx_max_time)))
+      call check(timeEpochToDatetime([gnssro_data%epochtime(idx_min_time), gnssro_data%epochtime(idx_max_time)], &
+         min_max_datetime))
+      call check(netcdfPutAtt(ncid, 'min_datetime', min_max_datetime(1)))
+      call check(netcdfPutAtt(ncid, 'max_datetime', min_max_datetime(2)))
 
       ! Create groups
       call check(netcdfAddGroup(ncid, 'MetaData'))
@@ -635,7 +628,6 @@ contains
       deallocate(gnssro_data%ogce)
       deallocate(gnssro_data%time)
       deallocate(gnssro_data%epochtime)
-      deallocate(gnssro_data%datetime)
       deallocate(gnssro_data%lat)
       deallocate(gnssro_data%lon)
       deallocate(gnssro_data%rfict)
@@ -647,7 +639,6 @@ contains
       deallocate(gnssro_data%bend_ang)
       deallocate(gnssro_data%impact_para)
       deallocate(gnssro_data%bndoe_gsi)
-      deallocate(gnssro_data%gstime)
       deallocate(gnssro_data%idx_window)
    end subroutine
 
@@ -14,10 +14,22 @@ program Goes_ReBroadcast_converter
 !          data_id = 'OR_ABI-L1b-RadC-M3'   ! prefix of the downloaded GRB nc files
 !          sat_id = 'G16'
 !          n_subsample = 1
+!          append_fname = ''                ! (optional) append all scans to this file
+!          watch_mode = .false.             ! (optional) convert scans as they arrive in data_dir
+!          watch_bcm = .false.              ! (optional) in watch_mode, also wait for the clear sky mask
+!          watch_idle_exit = 0              ! (optional) in watch_mode, stop after this many seconds
+!                                           !            without a new file (0: never stop)
+!          encoding_fname = ''              ! (optional) output encoding, e.g. share/OutputEncoding.yaml
 !        /
+!    In watch_mode, nc_list_file is not read. Files are picked up when they are
+!    closed in or moved into data_dir, and a scan is converted as soon as all of
+!    its bands have arrived.
 
    use define_mod, only:  missing_r
    use goes_abi_converter_mod, only: write_iodav3_netcdf, set_goes_abi_out_fname
+   use netcdf_cxx_mod, only: directoryWatchOpen, directoryWatchNext, directoryWatchClose, &
+      geos_projection, geoFixedGridToLatLon, geoSatelliteAngles, geoSolarAngles, netcdfEncodingLoad
+   use iso_c_binding, only: c_int
 
    implicit none
    include 'netcdf.inc'
@@ -60,6 +72,18 @@ program Goes_ReBroadcast_converter
    end type rad_type
    type(rad_type), allocatable  :: rdata(:)  ! (ntime)
 
+   ! files of a scan that arrived in watch_mode
+   type pending_scan_type
+      logical            :: active = .false.
+      integer(i_kind)    :: arrival               ! order of the first file of the scan
+      character(len=22)  :: stime
+      integer(i_kind)    :: jday
+      logical            :: got_band(nband)
+      character(len=256) :: band_fname(nband)
+      logical            :: got_bcm
+      character(len=256) :: bcm_fname
+   end type pending_scan_type
+
    character(len=22), allocatable :: time_start(:)  ! (ntime) 2017-10-01T18:02:19.6Z
 
    integer(i_kind) :: ncid, nf_status
@@ -81,8 +105,14 @@ program Goes_ReBroadcast_converter
    integer(i_kind)                 :: superob_halfwidth
    logical                         :: do_thinning
    logical                         :: write_iodav3
+   character(len=256)              :: append_fname
+   logical                         :: watch_mode
+   logical                         :: watch_bcm
+   integer(i_kind)                 :: watch_idle_exit
+   character(len=256)              :: encoding_fname
 
-   namelist /data_nml/ nc_list_file, data_dir, data_id, sat_id, do_thinning, n_subsample, do_superob, superob_halfwidth
+   namelist /data_nml/ nc_list_file, data_dir, data_id, sat_id, do_thinning, n_subsample, do_superob, superob_halfwidth, &
+                     append_fname, watch_mode, watch_bcm, watch_idle_exit, encoding_fname
 
    real(r_kind)                    :: sdtb ! to be done
    integer(i_kind)                 :: istat
@@ -90,6 +120,7 @@ program Goes_ReBroadcast_converter
    logical                         :: isfile
    logical                         :: found_time
    logical                         :: got_grid_info
+   character(len=16)               :: solzen_time  ! scan time (to the minute) of solzen
    logical, allocatable            :: valid(:), is_BCM(:)
    character(len=256), allocatable :: nc_fnames(:)
    character(len=256)              :: fname
@@ -119,6 +150,11 @@ program Goes_ReBroadcast_converter
    n_subsample       = 1
    do_superob        = .false.
    superob_halfwidth = 1
+   append_fname      = ''
+   watch_mode        = .false.
+   watch_bcm         = .false.
+   watch_idle_exit   = 0
+   encoding_fname    = ''
    !
    write_iodav3      = .true.
    !
@@ -131,6 +167,17 @@ program Goes_ReBroadcast_converter
       write(0,*) 'Error reading namelist data_nml'
       stop
    end if
+   if ( len_trim(encoding_fname) > 0 ) then
+      if ( netcdfEncodingLoad(encoding_fname) /= 0 ) then
+         write(0,*) 'Error reading output encoding '//trim(encoding_fname)
+         stop
+      end if
+   end if
+
+   if ( watch_mode ) then
+      call watch_and_convert
+      stop
+   end if
 
    ! get file names from nc_list_file
    nfile  = 0  ! initialize the number of netcdf files to read
@@ -251,89 +298,11 @@ program Goes_ReBroadcast_converter
 
    got_grid_info = .false.
    file_loop2: do ifile = 1, nfile
-
       if ( valid(ifile) ) then
-
-         fname = trim(data_dir)//'/'//trim(nc_fnames(ifile))
-         nf_status = nf_OPEN(trim(fname), nf_NOWRITE, ncid)
-         if ( nf_status == 0 ) then
-            write(0,*) 'Reading '//trim(fname)
-         else
-            write(0,*) 'ERROR reading '//trim(fname)
-            cycle file_loop2
-         end if
-
-         if ( .not. got_grid_info ) then
-            call read_GRB_dims(ncid, nx, ny)
-            allocate (glat(nx, ny))
-            allocate (glon(nx, ny))
-            allocate (gzen(nx, ny))
-            allocate (solzen(nx, ny))
-            allocate (got_latlon(nx, ny))
-            glat(:,:) = missing_r
-            glon(:,:) = missing_r
-            gzen(:,:) = missing_r
-            solzen(:,:) = missing_r
-            write(0,*) 'Calculating lat/lon from fixed grid x/y...'
-            call read_GRB_grid(ncid, nx, ny, glat, glon, gzen, got_latlon)
-            call calc_solar_zenith_angle(nx, ny, glat, glon, scan_time(ifile), julianday(ifile), solzen, got_latlon)
-            got_grid_info = .true.
-            allocate (rad_2d(nx, ny))
-            allocate (bt_2d(nx, ny))
-            allocate (qf_2d(nx, ny))
-            allocate (cm_2d(nx, ny))
-         end if
-
          it = ftime_id(ifile)
-         ib = fband_id(ifile)
-
-         if ( .not. is_BCM(ifile) ) then
-
-            call read_GRB(ncid, nx, ny, rad_2d, bt_2d, qf_2d, sdtb, band_id, time_start(it))
-
-            if ( band_id /= ib ) then
-               write(0,*) 'ERROR: band_id from the file name and the file content do not match.'
-               cycle file_loop2
-            end if
-
-            if ( time_start(it) /= scan_time(ifile) ) then
-               write(0,*) 'ERROR: scan start time from the file name and the file content do not match.'
-               cycle file_loop2
-            end if
-
-            if ( .not. allocated(rdata(it)%rad) ) allocate (rdata(it)%rad(nband,nx,ny))
-            if ( .not. allocated(rdata(it)%bt) )  allocate (rdata(it)%bt(nband,nx,ny))
-            if ( .not. allocated(rdata(it)%qf) )  allocate (rdata(it)%qf(nband,nx,ny))
-            if ( .not. allocated(rdata(it)%sd) )  allocate (rdata(it)%sd(nband))
-
-            do j = 1, ny
-               do i = 1, nx
-                  ! convert band id 7-16 to array index 1-10
-                  rdata(it)%rad(ib-band_start+1,i,j) = rad_2d(i,j)
-                  rdata(it)%bt(ib-band_start+1,i,j)  = bt_2d(i,j)
-                  rdata(it)%qf(ib-band_start+1,i,j)  = qf_2d(i,j)
-                  rdata(it)%sd(ib-band_start+1)      = sdtb
-               end do
-            end do
-
-         else
-
-            call read_L2_BCM(ncid, nx, ny, cm_2d, time_start(it))
-
-            if ( time_start(it) /= scan_time(ifile) ) then
-               write(0,*) 'ERROR: scan start time from the file name and the file content do not match.'
-               cycle file_loop2
-            end if
-
-            if ( .not. allocated(rdata(it)%cm) )  allocate (rdata(it)%cm(nx,ny))
-            rdata(it)%cm(:,:) = cm_2d(:,:)
-
-         end if
-
-         nf_status = nf_CLOSE(ncid)
-
+         call read_input_file(trim(data_dir)//'/'//trim(nc_fnames(ifile)), is_BCM(ifile), fband_id(ifile), &
+            scan_time(ifile), julianday(ifile), rdata(it), time_start(it))
       end if
-
    end do file_loop2
 
    if ( allocated(rad_2d) ) deallocate(rad_2d)
@@ -343,7 +312,12 @@ program Goes_ReBroadcast_converter
 
    if ( write_iodav3 ) then
       do it = 1, ntime
-         call set_goes_abi_out_fname(out_fname, trim(sat_id), time_start(it))
+         ! with append_fname, every scan extends one rolling file instead of writing its own
+         if ( len_trim(append_fname) > 0 ) then
+            out_fname = append_fname
+         else
+            call set_goes_abi_out_fname(out_fname, trim(sat_id), time_start(it))
+         end if
          write(0,*) 'Writing ', trim(out_fname)
          if ( allocated(rdata(it)%cm) ) then
             call output_iodav3(trim(out_fname), time_start(it), nx, ny, nband, got_latlon, &
@@ -379,6 +353,256 @@ program Goes_ReBroadcast_converter
 
 contains
 
+   ! Reads one band file, or the clear sky mask (BCM) file, of a scan into rd.
+   ! The fixed grid and the solar zenith angle are computed from the first file read
+   ! and kept for the following files.
+   subroutine read_input_file(fname, is_bcm_file, ib, stime, jday, rd, tstart)
+      implicit none
+      character(len=*),  intent(in)    :: fname
+      logical,           intent(in)    :: is_bcm_file
+      integer(i_kind),   intent(in)    :: ib          ! band id from the file name
+      character(len=22), intent(in)    :: stime       ! scan start time from the file name
+      integer(i_kind),   intent(in)    :: jday
+      type(rad_type),    intent(inout) :: rd
+      character(len=22), intent(inout) :: tstart      ! scan start time from the file content
+      integer(i_kind) :: ncid, nf_status, band_id, i, j
+      real(r_kind)    :: sdtb
+
+      nf_status = nf_OPEN(trim(fname), nf_NOWRITE, ncid)
+      if ( nf_status == 0 ) then
+         write(0,*) 'Reading '//trim(fname)
+      else
+         write(0,*) 'ERROR reading '//trim(fname)
+         return
+      end if
+
+      if ( .not. got_grid_info ) then
+         call read_GRB_dims(ncid, nx, ny)
+         allocate (glat(nx, ny))
+         allocate (glon(nx, ny))
+         allocate (gzen(nx, ny))
+         allocate (solzen(nx, ny))
+         allocate (got_latlon(nx, ny))
+         glat(:,:) = missing_r
+         glon(:,:) = missing_r
+         gzen(:,:) = missing_r
+         solzen(:,:) = missing_r
+         write(0,*) 'Calculating lat/lon from fixed grid x/y...'
+         call read_GRB_grid(ncid, nx, ny, glat, glon, gzen, got_latlon)
+         call calc_solar_zenith_angle(nx, ny, glat, glon, stime, jday, solzen)
+         solzen_time = stime(1:16)
+         got_grid_info = .true.
+         allocate (rad_2d(nx, ny))
+         allocate (bt_2d(nx, ny))
+         allocate (qf_2d(nx, ny))
+         allocate (cm_2d(nx, ny))
+      end if
+
+      if ( .not. is_bcm_file ) then
+
+         call read_GRB(ncid, nx, ny, rad_2d, bt_2d, qf_2d, sdtb, band_id, tstart)
+
+         if ( band_id /= ib ) then
+            write(0,*) 'ERROR: band_id from the file name and the file content do not match.'
+            nf_status = nf_CLOSE(ncid)
+            return
+         end if
+
+         if ( tstart /= stime ) then
+            write(0,*) 'ERROR: scan start time from the file name and the file content do not match.'
+            nf_status = nf_CLOSE(ncid)
+            return
+         end if
+
+         if ( .not. allocated(rd%rad) ) allocate (rd%rad(nband,nx,ny))
+         if ( .not. allocated(rd%bt) )  allocate (rd%bt(nband,nx,ny))
+         if ( .not. allocated(rd%qf) )  allocate (rd%qf(nband,nx,ny))
+         if ( .not. allocated(rd%sd) )  allocate (rd%sd(nband))
+
+         do j = 1, ny
+            do i = 1, nx
+               ! convert band id 7-16 to array index 1-10
+               rd%rad(ib-band_start+1,i,j) = rad_2d(i,j)
+               rd%bt(ib-band_start+1,i,j)  = bt_2d(i,j)
+               rd%qf(ib-band_start+1,i,j)  = qf_2d(i,j)
+               rd%sd(ib-band_start+1)      = sdtb
+            end do
+         end do
+
+      else
+
+         call read_L2_BCM(ncid, nx, ny, cm_2d, tstart)
+
+         if ( tstart /= stime ) then
+            write(0,*) 'ERROR: scan start time from the file name and the file content do not match.'
+            nf_status = nf_CLOSE(ncid)
+            return
+         end if
+
+         if ( .not. allocated(rd%cm) )  allocate (rd%cm(nx,ny))
+         rd%cm(:,:) = cm_2d(:,:)
+
+      end if
+
+      nf_status = nf_CLOSE(ncid)
+
+   end subroutine read_input_file
+
+   ! Watches data_dir and converts every scan once all of its band files (and, with
+   ! watch_bcm, its clear sky mask file) have arrived. The fixed grid and the read
+   ! buffers are kept from one scan to the next; only the solar zenith angle is
+   ! recomputed when the scan time moves on.
+   subroutine watch_and_convert
+      implicit none
+      integer(i_kind), parameter :: max_pending = 16  ! scans waiting for files
+      type(pending_scan_type) :: pending(max_pending)
+      integer(c_int)     :: watch_id, timeout_ms, status
+      integer(i_kind)    :: narrival, ip, k, fband, jday
+      logical            :: fis_bcm
+      character(len=256) :: new_fname
+      character(len=22)  :: stime
+
+      nlen = len_trim(data_id)
+      mode_id = data_id(nlen-1:nlen)
+      got_grid_info = .false.
+
+      if ( directoryWatchOpen(trim(data_dir), watch_id) /= 0 ) then
+         write(0,*) 'ERROR: cannot watch '//trim(data_dir)
+         stop
+      end if
+      if ( watch_idle_exit > 0 ) then
+         timeout_ms = watch_idle_exit * 1000
+      else
+         timeout_ms = -1
+      end if
+      write(0,*) 'Watching '//trim(data_dir)//' for new files'
+
+      narrival = 0
+      watch_loop: do
+         status = directoryWatchNext(watch_id, timeout_ms, new_fname)
+         if ( status == 1 ) then
+            write(0,*) 'No new file for ', watch_idle_exit, ' seconds, stopping'
+            exit watch_loop
+         else if ( status == 2 ) then
+            ! the name did not fit in new_fname, so it is not one of an ABI scan
+            cycle watch_loop
+         else if ( status /= 0 ) then
+            write(0,*) 'ERROR: watching '//trim(data_dir)//' failed'
+            exit watch_loop
+         end if
+
+         ! OR_ABI-L1b-RadC-M3C16_G16_s20172741802196_e20172741804580_c20172741805015.nc
+         nlen = len_trim(new_fname)
+         if ( nlen < 44 ) cycle watch_loop
+         if ( new_fname(nlen-2:nlen) /= '.nc' ) cycle watch_loop
+         call decode_nc_fname(trim(new_fname), finfo, scan_mode, fis_bcm, fband, fsat_id, stime, jday)
+         if ( scan_mode /= mode_id ) cycle watch_loop
+         if ( fsat_id /= sat_id ) cycle watch_loop
+         if ( fis_bcm ) then
+            if ( .not. watch_bcm ) cycle watch_loop
+         else
+            if ( finfo /= data_id ) cycle watch_loop
+            if ( fband < band_start .or. fband > band_end ) cycle watch_loop
+         end if
+
+         ! find the pending scan of the file, or start a new one
+         ip = 0
+         do k = 1, max_pending
+            if ( pending(k)%active .and. pending(k)%stime == stime ) then
+               ip = k
+               exit
+            end if
+         end do
+         if ( ip == 0 ) then
+            do k = 1, max_pending
+               if ( .not. pending(k)%active ) then
+                  ip = k
+                  exit
+               end if
+            end do
+            if ( ip == 0 ) then
+               ip = minloc(pending(:)%arrival, dim=1)
+               write(0,*) 'WARNING: dropping incomplete scan '//pending(ip)%stime
+            end if
+            narrival = narrival + 1
+            pending(ip)%active   = .true.
+            pending(ip)%arrival  = narrival
+            pending(ip)%stime    = stime
+            pending(ip)%jday     = jday
+            pending(ip)%got_band = .false.
+            pending(ip)%got_bcm  = .false.
+         end if
+
+         if ( fis_bcm ) then
+            pending(ip)%got_bcm = .true.
+            pending(ip)%bcm_fname = new_fname
+         else
+            pending(ip)%got_band(fband-band_start+1) = .true.
+            pending(ip)%band_fname(fband-band_start+1) = new_fname
+         end if
+
+         if ( all(pending(ip)%got_band) .and. (pending(ip)%got_bcm .or. .not. watch_bcm) ) then
+            call convert_scan(pending(ip))
+            pending(ip)%active = .false.
+         end if
+      end do watch_loop
+
+      status = directoryWatchClose(watch_id)
+
+      if ( allocated(rad_2d) ) deallocate(rad_2d)
+      if ( allocated(bt_2d) )  deallocate(bt_2d)
+      if ( allocated(qf_2d) )  deallocate(qf_2d)
+      if ( allocated(cm_2d) )  deallocate(cm_2d)
+      if ( allocated(glat) )   deallocate(glat)
+      if ( allocated(glon) )   deallocate(glon)
+      if ( allocated(gzen) )   deallocate(gzen)
+      if ( allocated(solzen) ) deallocate(solzen)
+      if ( allocated(got_latlon) ) deallocate(got_latlon)
+
+   end subroutine watch_and_convert
+
+   ! Reads the files of a complete scan and writes it out.
+   subroutine convert_scan(scan)
+      implicit none
+      type(pending_scan_type), intent(in) :: scan
+      type(rad_type)    :: rd
+      character(len=22) :: tstart
+      integer(i_kind)   :: kb
+
+      do kb = 1, nband
+         call read_input_file(trim(data_dir)//'/'//trim(scan%band_fname(kb)), .false., band_start+kb-1, &
+            scan%stime, scan%jday, rd, tstart)
+      end do
+      if ( scan%got_bcm ) then
+         call read_input_file(trim(data_dir)//'/'//trim(scan%bcm_fname), .true., -99, &
+            scan%stime, scan%jday, rd, tstart)
+      end if
+      if ( .not. allocated(rd%bt) ) then
+         write(0,*) 'WARNING: no band could be read for scan '//scan%stime
+         return
+      end if
+
+      if ( solzen_time /= scan%stime(1:16) ) then
+         call calc_solar_zenith_angle(nx, ny, glat, glon, scan%stime, scan%jday, solzen)
+         solzen_time = scan%stime(1:16)
+      end if
+
+      if ( len_trim(append_fname) > 0 ) then
+         out_fname = append_fname
+      else
+         call set_goes_abi_out_fname(out_fname, trim(sat_id), scan%stime)
+      end if
+      write(0,*) 'Writing ', trim(out_fname)
+      if ( allocated(rd%cm) ) then
+         call output_iodav3(trim(out_fname), scan%stime, nx, ny, nband, got_latlon, &
+            glat, glon, gzen, solzen, rd%bt, rd%qf, rd%sd, rd%cm)
+      else
+         call output_iodav3(trim(out_fname), scan%stime, nx, ny, nband, got_latlon, &
+            glat, glon, gzen, solzen, rd%bt, rd%qf, rd%sd)
+      end if
+   end subroutine convert_scan
+
+
 subroutine read_GRB_dims(ncid, nx, ny)
    implicit none
    integer(i_kind), intent(in)  :: ncid
@@ -411,7 +635,7 @@ subroutine read_GRB_grid(ncid, nx, ny, glat, glon, gzen, got_latlon)
    real(r_kind),    intent(inout) :: glon(nx,ny)
    real(r_kind),    intent(inout) :: gzen(nx,ny)
    logical,         intent(inout) :: got_latlon(nx,ny)
-   integer(i_kind)                :: varid, i, j
+   integer(i_kind)                :: varid, i
    integer(i_kind)                :: nf_status
    integer(i_kind)                :: istart(1), icount(1)
    integer(i_short), allocatable  :: itmp_short_1d(:)
@@ -423,8 +647,7 @@ subroutine read_GRB_grid(ncid, nx, ny, glat, glon, gzen, got_latlon)
    real(r_double) :: r_pol   ! GRS80 semi-minor axis of earth = (1-f)*r_eq
    real(r_double) :: lon_sat ! satellite longitude, longitude_of_projection_origin
    real(r_double) :: h_sat   ! satellite height
-   real(r_double) :: a, b, c, rs, sx, sy, sz
-   real(r_kind)   :: rlat, rlon, lon_diff, tmp1, theta1, theta2
+   type(geos_projection) :: proj
    continue
 
 !int goes_imager_projection ;
@@ -446,7 +669,7 @@ subroutine read_GRB_grid(ncid, nx, ny, glat, glon, gzen, got_latlon)
    nf_status = nf_GET_ATT_DOUBLE(ncid, varid, 'perspective_point_height',  dtmp)
    h_sat = dtmp + r_eq  ! perspective_point_height + semi_major_axis
    nf_status = nf_GET_ATT_DOUBLE(ncid, varid, 'longitude_of_projection_origin',  dtmp)
-   lon_sat = dtmp * deg2rad
+   lon_sat = dtmp
 
 !short x(x) ;
 !  x:scale_factor = 5.6e-05f ;
@@ -489,54 +712,20 @@ subroutine read_GRB_grid(ncid, nx, ny, glat, glon, gzen, got_latlon)
    end do
    deallocate(itmp_short_1d)
    ! Product Definition and User's Guide (PUG) Volume 3, pp. 19-21
-   ! from fixed grid x/y to geodetic lat/lon
-   got_latlon(1:nx,1:ny) = .true.
-   do j = 1, ny
-      do i = 1, nx
-         a = sin(x(i))*sin(x(i)) + cos(x(i))*cos(x(i)) * &
-             (cos(y(j))*cos(y(j))+(r_eq/r_pol)*(r_eq/r_pol)*sin(y(j))*sin(y(j)))
-         b = -2.0*h_sat*cos(x(i))*cos(y(j))
-         c = h_sat*h_sat - r_eq*r_eq
-         if ( (b*b-4.0*a*c) < 0.0 ) then
-            got_latlon(i,j) = .false.
-            cycle
-         end if
-         rs = (-1.0*b - sqrt(b*b-4.0*a*c)) / (2.0*a)
-         sx = rs * cos(x(i)) * cos(y(j))
-         sy = -1.0 * rs * sin(x(i))
-         sz = rs * cos(x(i)) * sin(y(j))
-         !glat(i,j) = (atan((r_eq/r_pol)*(r_eq/r_pol)*(sz/sqrt((h_sat-sx)*(h_sat-sx)+sy*sy)))) * rad2deg
-         !glon(i,j) = (lon_sat - atan(sy/(h_sat-sx))) * rad2deg
-         glat(i,j) = atan((r_eq/r_pol)*(r_eq/r_pol)*(sz/sqrt((h_sat-sx)*(h_sat-sx)+sy*sy)))
-         glon(i,j) = lon_sat - atan(sy/(h_sat-sx))
-      end do
-   end do
+   ! from fixed grid x/y to geodetic lat/lon, and the geostationary satellite zenith angle
+   proj = geos_projection(subLon=lon_sat, satDist=h_sat, rEq=r_eq, rPol=r_pol, sweepX=1)
+   nf_status = geoFixedGridToLatLon(proj, real(x, r_double), real(y, r_double), glat, glon, got_latlon)
+   if ( nf_status == 0 ) then
+      nf_status = geoSatelliteAngles(proj, glat, glon, gzen)
+   end if
+   if ( nf_status /= 0 ) then
+      write(0,*) 'Error in read_GRB_grid: the fixed grid could not be navigated'
+      call exit(1)
+   end if
 
    deallocate(x)
    deallocate(y)
 
-   ! calculate geostationary satellite zenith angle
-   do j = 1, ny
-      do i = 1, nx
-         if ( .not. got_latlon(i,j) ) cycle
-         rlat = glat(i,j) ! in radian
-         rlon = glon(i,j) ! in radian
-         lon_diff = abs(rlon-lon_sat)
-!         tmp1 = sqrt((2.0*r_eq*sin(lon_diff/2.)-r_eq*(1.0-cos(rlat))*sin(lon_diff/2.))**2 &
-!           +(2.0*r_eq*sin(rlat/2.))**2-(r_eq*(1.0-cos(rlat))*sin(lon_diff/2.))**2)
-         tmp1 = (2.0*r_eq*sin(lon_diff/2.)-r_eq*(1.0-cos(rlat))*sin(lon_diff/2.))**2 &
-           +(2.0*r_eq*sin(rlat/2.))**2-(r_eq*(1.0-cos(rlat))*sin(lon_diff/2.))**2
-         if ( tmp1 < 0.0 ) cycle
-         tmp1 = sqrt(tmp1)
-         theta1 = 2.0*asin(tmp1/r_eq/2.)
-         theta2 = atan(r_eq*sin(theta1)/((h_sat-r_eq)+r_eq*(1.0-sin(theta1))))
-         gzen(i,j) = (theta1+theta2) * rad2deg
-         !gzen(i,j) = 90.0 - atan((cos(lon_diff)*cos(rlat)-0.1512)/(sqrt(1.0-cos(lon_diff)*cos(lon_diff)*cos(rlat)*cos(rlat)))) * rad2deg
-         glat(i,j) = glat(i,j) * rad2deg
-         glon(i,j) = glon(i,j) * rad2deg
-      end do
-   end do
-
    return
 end subroutine read_GRB_grid
 
@@ -785,7 +974,7 @@ end subroutine read_GRB
    subroutine output_iodav3(fname, time_start, nx, ny, nband, got_latlon, lat, lon, sat_zen, sun_zen, bt, qf, sdtb, cloudmask)
    use define_mod, only: i_kind, r_kind, missing_i, missing_r
    use kinds, only: i_llong, r_double
-   use utils_mod, only: get_julian_time
+   use netcdf_cxx_mod, only: timeToEpoch
    implicit none
 
    character(len=*),   intent(in) :: fname
@@ -821,7 +1010,7 @@ end subroutine read_GRB
    integer(i_kind) :: ncfileid
    character(len=nstring) :: ncname
    real(r_kind), allocatable :: rtmp1d(:)
-   real(r_double) :: gstime
+   integer(i_llong) :: epochtime
 
    character(len=4) :: c4
 
@@ -876,6 +1065,10 @@ end subroutine read_GRB
      read(time_start(12:13), '(i2)') ihour
      read(time_start(15:16), '(i2)') imin
      read(time_start(18:19), '(i2)') isec
+     if ( timeToEpoch(iyear, imonth, iday, ihour, imin, isec, epochtime) /= 0 ) then
+        write(0,*) 'Error: invalid time_coverage_start ', time_start
+        return
+     end if
 
      iloc = 0
      do iline = 1, ny, n_subsample
@@ -886,7 +1079,7 @@ end subroutine read_GRB
            if ( all(bt(:,isample,iline)<0.0) ) cycle
            iloc = iloc + 1
 
-           call get_julian_time(iyear, imonth, iday, ihour, imin, isec, gstime, datetime(iloc))
+           datetime(iloc) = epochtime
            lat_out(iloc) = lat(isample,iline)
            lon_out(iloc) = lon(isample,iline)
            sat_zen_out(iloc) = sat_zen(isample,iline)
@@ -948,6 +1141,10 @@ end subroutine read_GRB
      read(time_start(12:13), '(i2)') ihour
      read(time_start(15:16), '(i2)') imin
      read(time_start(18:19), '(i2)') isec
+     if ( timeToEpoch(iyear, imonth, iday, ihour, imin, isec, epochtime) /= 0 ) then
+        write(0,*) 'Error: invalid time_coverage_start ', time_start
+        return
+     end if
 
       iloc = 0
       scan_loop:     do iy=first_boxcenter, ny, superob_width
@@ -985,7 +1182,7 @@ end subroutine read_GRB
             end if
 
             iloc = iloc + 1
-            call get_julian_time(iyear, imonth, iday, ihour, imin, isec, gstime, datetime(iloc))
+            datetime(iloc) = epochtime
 
             ! Super-ob BT for this channel
             do k = 1, nband
@@ -1022,7 +1219,7 @@ end subroutine read_GRB
 
    call write_iodav3_netcdf(fname, nlocs, nchans, missing_r, missing_i, &
            datetime, lat_out, lon_out, scan_pos_out, sat_zen_out, sat_azi_out, &
-           sun_zen_out, sun_azi_out, bt_out, err_out, qf_out)
+           sun_zen_out, sun_azi_out, bt_out, err_out, qf_out, append=len_trim(append_fname) > 0)
    deallocate (datetime)
    deallocate (lat_out)
    deallocate (lon_out)
@@ -1037,10 +1234,10 @@ end subroutine read_GRB
 
 end subroutine output_iodav3
 
-subroutine calc_solar_zenith_angle(nx, ny, xlat, xlon, xtime, julian, solzen, got_latlon)
+subroutine calc_solar_zenith_angle(nx, ny, xlat, xlon, xtime, julian, solzen)
 
 ! the calulcation is adapted from subroutines radconst and calc_coszen in
-! WRF phys/module_radiation_driver.F
+! WRF phys/module_radiation_driver.F, see geoSolarAngles of obs2ioda_cxx
 
    implicit none
 
@@ -1048,40 +1245,18 @@ subroutine calc_solar_zenith_angle(nx, ny, xlat, xlon, xtime, julian, solzen, go
    real(r_kind),      intent(in)    :: xlat(nx,ny), xlon(nx,ny)
    character(len=22), intent(in)    :: xtime
    real(r_kind),      intent(inout) :: solzen(nx,ny)
-   logical,           intent(in)    :: got_latlon(nx,ny)
-
-   real(r_kind) :: obliq = 23.5
-   real(r_kind) :: deg_per_day = 360.0/365.0
-   real(r_kind) :: slon   ! longitude of the sun
-   real(r_kind) :: declin ! declination of the sun
-   real(r_kind) :: hrang, da, eot, xt, tloctm, rlat
-   integer(i_kind) :: gmt, minute, i, j
 
-   ! calculate longitude of the sun from vernal equinox
-   if ( julian >= 80 ) slon = (julian - 80 ) * deg_per_day
-   if ( julian <  80 ) slon = (julian + 285) * deg_per_day
-
-   declin = asin(sin(obliq*deg2rad)*sin(slon*deg2rad)) ! in radian
+   integer(i_kind) :: gmt, minute, status
 
    read(xtime(12:13), '(i2)') gmt
    read(xtime(15:16), '(i2)') minute
 
-   da = 6.2831853071795862*(julian-1)/365.
-   eot = (0.000075+0.001868*cos(da)-0.032077*sin(da) &
-          -0.014615*cos(2.0*da)-0.04089*sin(2.0*da))*(229.18)
-   xt = gmt + (minute + eot)/60.0
-
-   do j = 1, ny
-      do i = 1, nx
-         if ( .not. got_latlon(i,j) ) cycle
-         tloctm = xt + xlon(i,j)/15.0
-         hrang = 15.0*(tloctm-12.0) * deg2rad
-         rlat = xlat(i,j) * deg2rad
-         solzen(i,j) = acos( sin(rlat)*sin(declin) + &
-                             cos(rlat)*cos(declin)*cos(hrang) )
-         solzen(i,j) = solzen(i,j) * rad2deg
-      enddo
-   enddo
+   ! pixels without lat/lon (got_latlon) have missing xlat and xlon, and get a missing solzen
+   status = geoSolarAngles(julian, gmt, minute, xlat, xlon, solzen)
+   if ( status /= 0 ) then
+      write(0,*) 'Error in calc_solar_zenith_angle: invalid time ', xtime
+      call exit(1)
+   end if
 
    return
 end subroutine calc_solar_zenith_angle
@@ -109,9 +109,15 @@ contains
     !       Observation error estimates.
     !     - qf_out (real(r_kind), dimension(nchans, nlocs), intent(in)):
     !       Pre-quality control flags.
+    !     - append (logical, intent(in), optional):
+    !       If true, the locations are appended to fname: the file is created with an
+    !       unlimited nlocs dimension if it does not exist yet, and otherwise opened
+    !       and extended, so that each scan only costs the time to write its own
+    !       locations. min_datetime and max_datetime are updated when the file is closed.
+    !       Defaults to false, which replaces fname.
     subroutine write_iodav3_netcdf(fname, nlocs, nchans, missing_r, missing_i, &
             datetime, lat_out, lon_out, scan_pos_out, sat_zen_out, sat_azi_out, &
-            sun_zen_out, sun_azi_out, bt_out, err_out, qf_out)
+            sun_zen_out, sun_azi_out, bt_out, err_out, qf_out, append)
 
         use netcdf_cxx_mod
         use define_mod, only: r_kind, i_kind, i_llong
@@ -129,62 +135,87 @@ contains
         real(r_kind), intent(in) :: bt_out(nchans, nlocs)
         real(r_kind), intent(in) :: err_out(nchans, nlocs)
         real(r_kind), intent(in) :: qf_out(nchans, nlocs)
+        logical, intent(in), optional :: append
 
-        integer :: ncid, nlocs_dimid, nchans_dimid
+        integer :: ncid, nlocs_dimid, nchans_dimid, nlocs_dimlen
+        integer :: start1d(1), count1d(1), start2d(2), count2d(2)
+        logical :: do_append, file_exists
         real(r_kind), allocatable :: rtmp1d(:)
 
+        do_append = .false.
+        if ( present(append) ) do_append = append
+        file_exists = .false.
+        if ( do_append ) inquire(file=trim(fname), exist=file_exists)
+
         allocate(rtmp1d(nlocs*nchans))
 
-        call check(netcdfCreate(fname, ncid))
-        call check(netcdfAddGroup(ncid, 'ObsValue'))
-        call check(netcdfAddGroup(ncid, 'ObsError'))
-        call check(netcdfAddGroup(ncid, 'PreQC'))
-        call check(netcdfAddGroup(ncid, 'MetaData'))
-
-        call check(netcdfAddDim(ncid, 'nlocs', nlocs, nlocs_dimid))
-        call check(netcdfAddVar(ncid, 'nlocs', NF90_INT, 1, ['nlocs']))
-
-        call check(netcdfAddDim(ncid, 'nchans', nchans, nchans_dimid))
-        call check(netcdfAddVar(ncid, 'nchans', NF90_INT, 1, ['nchans']))
-
-        ! Define variables
-        call check(netcdfAddVar(ncid, "brightness_temperature", NF90_REAL, 2, ['nlocs ', 'nchans'], 'ObsValue', fillValue=missing_r))
-        call check(netcdfPutAtt(ncid, 'units', 'K', "brightness_temperature", 'ObsValue'))
-        call check(netcdfAddVar(ncid, "brightness_temperature", NF90_REAL, 2, ['nlocs ', 'nchans'], 'ObsError', fillValue=missing_r))
-        call check(netcdfPutAtt(ncid, 'units', 'K', "brightness_temperature", 'ObsError'))
-        call check(netcdfAddVar(ncid, "brightness_temperature", NF90_INT, 2, ['nlocs ', 'nchans'], 'PreQC', fillValue=missing_i))
-
-        call check(netcdfAddVar(ncid, 'latitude', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
-        call check(netcdfAddVar(ncid, 'longitude', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
-        call check(netcdfAddVar(ncid, 'solar_azimuth_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
-        call check(netcdfAddVar(ncid, 'scan_position', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
-        call check(netcdfAddVar(ncid, 'sensor_azimuth_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
-        call check(netcdfAddVar(ncid, 'solar_zenith_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
-        call check(netcdfAddVar(ncid, 'sensor_zenith_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
-        call check(netcdfAddVar(ncid, 'sensor_view_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
-        call check(netcdfAddVar(ncid, 'dateTime', NF90_INT64, 1, ['nlocs'], 'MetaData'))
-        call check(netcdfPutAtt(ncid, "units", "seconds since 1970-01-01T00:00:00Z", 'dateTime', 'MetaData'))
-        call check(netcdfAddVar(ncid, 'sensor_channel', NF90_INT, 1, ['nchans'], 'MetaData', fillValue=missing_i))
-
-        call check(netcdfPutVar(ncid, 'nchans', (/7,8,9,10,11,12,13,14,15,16/)))
+        if ( file_exists ) then
+            ! the groups and variables are those of the scans already in the file
+            call check(netcdfCreate(fname, ncid, 1))
+            call check(netcdfGetDimLen(ncid, 'nlocs', nlocs_dimlen))
+        else
+            call check(netcdfCreate(fname, ncid))
+            call check(netcdfAddGroup(ncid, 'ObsValue'))
+            call check(netcdfAddGroup(ncid, 'ObsError'))
+            call check(netcdfAddGroup(ncid, 'PreQC'))
+            call check(netcdfAddGroup(ncid, 'MetaData'))
+
+            if ( do_append ) then
+                call check(netcdfAddDim(ncid, 'nlocs', netcdf_unlimited, nlocs_dimid))
+            else
+                call check(netcdfAddDim(ncid, 'nlocs', nlocs, nlocs_dimid))
+            end if
+            call check(netcdfAddVar(ncid, 'nlocs', NF90_INT, 1, ['nlocs']))
+
+            call check(netcdfAddDim(ncid, 'nchans', nchans, nchans_dimid))
+            call check(netcdfAddVar(ncid, 'nchans', NF90_INT, 1, ['nchans']))
+
+            ! Define variables
+            call check(netcdfAddVar(ncid, "brightness_temperature", NF90_REAL, 2, ['nlocs ', 'nchans'], 'ObsValue', fillValue=missing_r))
+            call check(netcdfPutAtt(ncid, 'units', 'K', "brightness_temperature", 'ObsValue'))
+            call check(netcdfAddVar(ncid, "brightness_temperature", NF90_REAL, 2, ['nlocs ', 'nchans'], 'ObsError', fillValue=missing_r))
+            call check(netcdfPutAtt(ncid, 'units', 'K', "brightness_temperature", 'ObsError'))
+            call check(netcdfAddVar(ncid, "brightness_temperature", NF90_INT, 2, ['nlocs ', 'nchans'], 'PreQC', fillValue=missing_i))
+
+            call check(netcdfAddVar(ncid, 'latitude', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
+            call check(netcdfAddVar(ncid, 'longitude', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
+            call check(netcdfAddVar(ncid, 'solar_azimuth_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
+            call check(netcdfAddVar(ncid, 'scan_position', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
+            call check(netcdfAddVar(ncid, 'sensor_azimuth_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
+            call check(netcdfAddVar(ncid, 'solar_zenith_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
+            call check(netcdfAddVar(ncid, 'sensor_zenith_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
+            call check(netcdfAddVar(ncid, 'sensor_view_angle', NF90_REAL, 1, ['nlocs'], 'MetaData', fillValue=missing_r))
+            call check(netcdfAddVar(ncid, 'dateTime', NF90_INT64, 1, ['nlocs'], 'MetaData'))
+            call check(netcdfPutAtt(ncid, "units", "seconds since 1970-01-01T00:00:00Z", 'dateTime', 'MetaData'))
+            call check(netcdfAddVar(ncid, 'sensor_channel', NF90_INT, 1, ['nchans'], 'MetaData', fillValue=missing_i))
+
+            call check(netcdfPutVar(ncid, 'nchans', (/7,8,9,10,11,12,13,14,15,16/)))
+            call check(netcdfPutVar(ncid, 'sensor_channel', (/7,8,9,10,11,12,13,14,15,16/), 'MetaData'))
+            nlocs_dimlen = 0
+        end if
+
+        ! the locations of this call follow those already in the file
+        start1d = [nlocs_dimlen + 1]
+        count1d = [nlocs]
+        start2d = [nlocs_dimlen + 1, 1]
+        count2d = [nlocs, nchans]
 
         call transpose_and_flatten(bt_out, rtmp1d)
-        call check(netcdfPutVar(ncid, 'brightness_temperature', rtmp1d, 'ObsValue'))
+        call check(netcdfPutVar(ncid, 'brightness_temperature', rtmp1d, 'ObsValue', start2d, count2d))
         call transpose_and_flatten(err_out, rtmp1d)
-        call check(netcdfPutVar(ncid, 'brightness_temperature', rtmp1d, 'ObsError'))
+        call check(netcdfPutVar(ncid, 'brightness_temperature', rtmp1d, 'ObsError', start2d, count2d))
         call transpose_and_flatten(qf_out, rtmp1d)
-        call check(netcdfPutVar(ncid, 'brightness_temperature', rtmp1d, 'PreQC'))
-
-        call check(netcdfPutVar(ncid, 'latitude', lat_out, 'MetaData'))
-        call check(netcdfPutVar(ncid, 'longitude', lon_out, 'MetaData'))
-        call check(netcdfPutVar(ncid, 'solar_azimuth_angle', sun_azi_out, 'MetaData'))
-        call check(netcdfPutVar(ncid, 'scan_position', scan_pos_out, 'MetaData'))
-        call check(netcdfPutVar(ncid, 'sensor_azimuth_angle', sat_azi_out, 'MetaData'))
-        call check(netcdfPutVar(ncid, 'solar_zenith_angle', sun_zen_out, 'MetaData'))
-        call check(netcdfPutVar(ncid, 'sensor_zenith_angle', sat_zen_out, 'MetaData'))
-        call check(netcdfPutVar(ncid, 'sensor_view_angle', sat_zen_out, 'MetaData'))
-        call check(netcdfPutVar(ncid, 'sensor_channel', (/7,8,9,10,11,12,13,14,15,16/), 'MetaData'))
-        call check(netcdfPutVar(ncid, 'dateTime', datetime, 'MetaData'))
+        call check(netcdfPutVar(ncid, 'brightness_temperature', rtmp1d, 'PreQC', start2d, count2d))
+
+        call check(netcdfPutVar(ncid, 'latitude', lat_out, 'MetaData', start1d, count1d))
+        call check(netcdfPutVar(ncid, 'longitude', lon_out, 'MetaData', start1d, count1d))
+        call check(netcdfPutVar(ncid, 'solar_azimuth_angle', sun_azi_out, 'MetaData', start1d, count1d))
+        call check(netcdfPutVar(ncid, 'scan_position', scan_pos_out, 'MetaData', start1d, count1d))
+        call check(netcdfPutVar(ncid, 'sensor_azimuth_angle', sat_azi_out, 'MetaData', start1d, count1d))
+        call check(netcdfPutVar(ncid, 'solar_zenith_angle', sun_zen_out, 'MetaData', start1d, count1d))
+        call check(netcdfPutVar(ncid, 'sensor_zenith_angle', sat_zen_out, 'MetaData', start1d, count1d))
+        call check(netcdfPutVar(ncid, 'sensor_view_angle', sat_zen_out, 'MetaData', start1d, count1d))
+        call check(netcdfPutVar(ncid, 'dateTime', datetime, 'MetaData', start1d, count1d))
         call check(netcdfClose(ncid))
         deallocate(rtmp1d)
     end subroutine write_iodav3_netcdf
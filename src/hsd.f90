@@ -20,13 +20,10 @@ use define_mod, only: missing_r, missing_i, nstring, ndatetime, &
    nvar_info, name_var_info, type_var_info, nsen_info, type_sen_info, set_brit_obserr, strlen
 use ufo_vars_mod, only: ufo_vars_getindex
 use netcdf, only: nf90_float, nf90_int, nf90_char, nf90_int64
-use utils_mod, only: get_julian_time
 
 implicit none
 
 integer(i_kind) :: mmday(12) = (/31,28,31,30,31,30,31,31,30,31,30,31/)
-character(len=ndatetime)  :: datetime   ! ccyy-mm-ddThh:mm:ssZ
-real(r_double)   :: gstime
 integer(i_llong) :: epochtime
 integer(i_kind)  :: iyear, imonth, iday, ihour, imin, isec
 
@@ -44,7 +41,12 @@ real(r_kind)    :: bt_sup(npixel, nline, nband)   ! superobbed brightness temper
 real(r_single)  :: solzen(npixel, nline)
 real(r_single)  :: satzen(npixel, nline)
 logical         :: valid(npixel, nline)
-real(r_double)  :: rlat, rlon, lon_diff, tmp1, theta1, theta2
+! projection that longitude, latitude, satzen and valid were computed with,
+! they are kept across calls (cycles) as long as the projection is unchanged
+logical         :: nav_ready = .false.
+real(r_double)  :: nav_proj(9)
+! lines whose pixels are navigated for nav_proj
+logical         :: nav_line(nline) = .false.
 integer(i_kind) :: ntotal, npix, nlin
 
 integer(i_kind) :: nfile
@@ -224,7 +226,7 @@ real(r_double), parameter :: rad2deg = 180.0/pi
 contains
 
 subroutine read_HSD(ccyymmddhhnn, inpdir, do_superob, superob_halfwidth)
-use, intrinsic :: ieee_arithmetic, only: ieee_is_nan
+use netcdf_cxx_mod, only: geoSolarAngles, timeToEpoch
 implicit none
 
 character(len=12), intent(in) :: ccyymmddhhnn
@@ -255,24 +257,23 @@ integer(i_kind) :: ierr
 integer(i_kind) :: nlocs, nvars, iloc
 integer(i_kind) :: ihh, imm, idd, jday, flength, rvalue, offset
 integer(i_kind) :: iunit = 21
-real(r_double)  :: lon, lat
 real(r_double)  :: radiance, tbb
-real(r_double)  :: lon_sat, h_sat, r_eq
 integer(i_kind) :: nodivisionsegm = 1
 integer         :: superob_width ! Must be ≥ 0
 integer         :: first_boxcenter, last_boxcenter_x, last_boxcenter_y, box_bottom, box_upper, box_left, box_right
 integer         :: ibox, jbox, nkeep, ix, iy, k
 real(r_kind)    :: temp1 = 0.0
+real(r_double)  :: proj(9)
+logical         :: nav_checked
+logical         :: solzen_line(nline)  ! lines whose solar zenith angles are computed
 ! end of declaration
 continue
 
-longitude(:,:) = missing_r
-latitude(:,:)  = missing_r
 brit(:,:,:)    = missing_r
 bt_sup(:,:,:)  = missing_r
 solzen(:,:)    = missing_r
-satzen(:,:)    = missing_r
-valid(:,:)     = .false.
+solzen_line(:) = .false.
+nav_checked    = .false.
 
 ! construct file names
 nfile = nband * nsegm
@@ -458,53 +459,47 @@ do iband = 1, nband
       startLine = header%segm%startLineNo
       endLine = startLine + header%data%nLin - 1
 !print*,ifile, trim(fnames(ifile)), header%data%nPix, header%data%nLin, startLine, endLine
-      lon_sat = header%proj%subLon * deg2rad
-      h_sat =  header%proj%satDis * 1000.0
-      r_eq = header%proj%eqtrRadius * 1000.0
+      if ( .not. nav_checked ) then
+         ! navigation of an earlier call can be reused for the same projection
+         proj = (/ header%proj%subLon, real(header%proj%cfac, r_double), real(header%proj%lfac, r_double), &
+                   real(header%proj%coff, r_double), real(header%proj%loff, r_double), header%proj%satDis, &
+                   header%proj%eqtrRadius, header%proj%projParam3, header%proj%projParamSd /)
+         if ( .not. nav_ready .or. any(proj /= nav_proj) ) then
+            longitude(:,:) = missing_r
+            latitude(:,:)  = missing_r
+            satzen(:,:)    = missing_r
+            valid(:,:)     = .false.
+            nav_line(:)    = .false.
+            nav_proj  = proj
+            nav_ready = .true.
+         end if
+         nav_checked = .true.
+      end if
+      if ( .not. all(nav_line(startLine:endLine)) ) then
+         call navigate_lines(npix, startLine, endLine)
+      end if
+
+      ! the solar zenith angle depends on the observation time and is
+      ! computed once per call for every navigated pixel
+      if ( .not. all(solzen_line(startLine:endLine)) ) then
+         ierr = geoSolarAngles(jday, ihh, imm, latitude(1:npix, startLine:endLine), &
+                               longitude(1:npix, startLine:endLine), solzen(1:npix, startLine:endLine))
+         if ( ierr /= 0 ) then
+            print *, "ERROR in geoSolarAngles: gmt =", ihh, ", minute =", imm, ", julian =", jday
+            call exit(1)
+         end if
+         solzen_line(startLine:endLine) = .true.
+      end if
+
       do jj = 1, header%data%nLin
          do ii = 1, header%data%nPix
 
             tbb = missing_r
-            lon = missing_r
-            lat = missing_r
 
             ij = ii + (jj-1) * header%data%nPix
             iline = header%segm%startLineNo + jj - 1
             ipixel = ii
 
-            if ( abs(latitude(ipixel, iline)) > 90.0 .or. &
-                 abs(longitude(ipixel, iline)) > 360.0 ) then
-               call pixlin_to_lonlat(ipixel, iline, lon, lat, ierr)
-               if ( ierr == 0 ) then
-                  valid(ipixel, iline) = .true.
-                  latitude(ipixel, iline) = lat
-                  longitude(ipixel, iline) = lon
-                  call calc_solar_zenith_angle( &
-                     latitude(ipixel, iline), &
-                     longitude(ipixel, iline), &
-                     ihh, imm, jday, &
-                     solzen(ipixel, iline))
-                  if (ieee_is_nan(solzen(ipixel, iline))) then
-                      print *, "ERROR in calc_solar_zenith_angle: solzen(", ipixel, ",", iline, ") is NaN."
-                      print *, "       This indicates invalid input to the subroutine."
-                      print *, "       gmt =", ihh, ", minute =", imm, ", julian =", jday
-                      call exit(1)
-                  end if
-                  ! calculate geostationary satellite zenith angle
-                  rlat = lat * deg2rad ! in radian
-                  rlon = lon * deg2rad ! in radian
-                  lon_diff = abs(rlon-lon_sat)
-                  tmp1 = sqrt((2.0*r_eq*sin(lon_diff/2.)-r_eq*(1.0-cos(rlat))*sin(lon_diff/2.))**2 &
-                         +(2.0*r_eq*sin(rlat/2.))**2-(r_eq*(1.0-cos(rlat))*sin(lon_diff/2.))**2)
-                  theta1 = 2.0*asin(tmp1/r_eq/2.)
-                  theta2 = atan(r_eq*sin(theta1)/((h_sat-r_eq)+r_eq*(1.0-sin(theta1))))
-                  satzen(ipixel, iline) = (theta1+theta2) * rad2deg
-                  if ( satzen(ipixel, iline) > 65.0 ) then
-                     valid(ipixel, iline) = .false.
-                  end if
-               end if
-            end if
-
             radcount = idata(ij)
             if ( radcount /= header%calib%outCount .and. &
                  radcount /= header%calib%errorCount .and. &
@@ -519,7 +514,7 @@ do iband = 1, nband
                call hisd_radiance_to_tbb(radiance, tbb)
                ! visible or near infrared band
                !  data->phys[kk] = header[n]->calib->rad2albedo * radiance
-!print*,iband+6, ij, ii, jj, radcount, tbb, lon, lat, solzen(ipixel, iline), satzen(ipixel, iline)
+!print*,iband+6, ij, ii, jj, radcount, tbb, latitude(ipixel, iline), longitude(ipixel, iline), solzen(ipixel, iline), satzen(ipixel, iline)
                brit(ipixel, iline, iband) = tbb
             end if
 
@@ -543,10 +538,12 @@ end do
 deallocate (fexist)
 deallocate (fnames)
 
-datetime = ccyy//'-'//mm//'-'//dd//'T'//hh//':'//nn//':00Z'
 read (ccyymmddhhnn,'(i4,4i2)') iyear, imonth, iday, ihour, imin
 isec = 0
-call get_julian_time(iyear, imonth, iday, ihour, imin, isec, gstime, epochtime)
+if ( timeToEpoch(iyear, imonth, iday, ihour, imin, isec, epochtime) /= 0 ) then
+   write(*,*) 'Error: invalid time ', ccyymmddhhnn
+   stop 1
+end if
 
 ! do superobbing of ahi_himawari observations
 ! npixel => x direction => nx
@@ -658,9 +655,7 @@ if ( do_superob ) then
                  xdata(1,1)%xinfo_float(iloc,i) = longitude(ix,iy)
               end if
            else if ( type_var_info(i) == nf90_char ) then
-              if ( trim(name_var_info(i)) == 'datetime' ) then
-                 xdata(1,1)%xinfo_char(iloc,i) = datetime
-              else if ( trim(name_var_info(i)) == 'station_id' ) then
+              if ( trim(name_var_info(i)) == 'station_id' ) then
                  xdata(1,1)%xinfo_char(iloc,i) = 'ahi_himawari8'
               end if
            else if ( type_var_info(i) == nf90_int64 ) then
@@ -763,9 +758,7 @@ else
                  xdata(1,1)%xinfo_float(iloc,i) = longitude(ii,jj)
               end if
            else if ( type_var_info(i) == nf90_char ) then
-              if ( trim(name_var_info(i)) == 'datetime' ) then
-                 xdata(1,1)%xinfo_char(iloc,i) = datetime
-              else if ( trim(name_var_info(i)) == 'station_id' ) then
+              if ( trim(name_var_info(i)) == 'station_id' ) then
                  xdata(1,1)%xinfo_char(iloc,i) = 'ahi_himawari8'
               end if
            else if ( type_var_info(i) == nf90_int64 ) then
@@ -812,89 +805,61 @@ end if ! if do_superob
 
 end subroutine read_HSD
 
-subroutine pixlin_to_lonlat(pix, lin, lon, lat, ierr)
+!> @brief
+!> Navigates the pixels of a range of lines of the full disk.
+!>
+!> @details
+!> Computes the latitude, longitude and satellite zenith angle of pixels 1 to `npix`
+!> of lines `first` to `last` for the fixed grid of the current header, with the
+!> geometry kernels of obs2ioda_cxx. Pixels off the earth or seen at a satellite
+!> zenith angle above 65 degrees are not valid.
+!>
+!> @param[in] npix   Number of pixels of a line
+!> @param[in] first  First line
+!> @param[in] last   Last line
+subroutine navigate_lines(npix, first, last)
 
+ use netcdf_cxx_mod, only: geos_projection, geoFixedGridToLatLon, geoSatelliteAngles
  implicit none
 
- integer(i_kind), intent(in)  :: pix, lin
- real(r_double),  intent(out) :: lon, lat
- integer(i_kind), intent(out) :: ierr
-
- real(r_double) :: SCLUNIT = 2.0**(-16)
- real(r_double) :: x, y
- real(r_double) :: Sd, Sn, S1, S2, S3, Sxy
- real(r_double) :: c, l
+ integer(i_kind), intent(in) :: npix, first, last
 
- ! initialize
- lon = missing_r
- lat = missing_r
- ierr = 0
+ real(r_double), parameter :: SCLUNIT = 2.0**(-16)
+ type(geos_projection) :: proj
+ real(r_double), allocatable :: x(:), y(:)
+ logical, allocatable :: on_earth(:,:)
+ integer(i_kind) :: i, ierr
 
- ! pix, lin -> c, l
- c = float(pix)
- l = float(lin)
-
- ! intermediate coordinates (x,y)
- ! Global Specification 4.4.4 Scaling Function
+ ! intermediate coordinates (x,y), Global Specification 4.4.4 Scaling Function
  ! https://www.cgms-info.org/wp-content/uploads/2021/10/cgms-lrit-hrit-global-specification-(v2-8-of-30-oct-2013).pdf
- !    c = COFF + nint(x * 2^-16 * CFAC)
- !    l = LOFF + nint(y * 2^-16 * LFAC)
- ! The intermediate coordinates (x,y) are as follows :
  !    x = (c -COFF) / (2^-16 * CFAC)
  !    y = (l -LOFF) / (2^-16 * LFAC)
- !    SCLUNIT = 2^-16
- x = deg2rad * ( c - header%proj%coff) / ( SCLUNIT * header%proj%cfac)
- y = deg2rad * ( l - header%proj%loff) / ( SCLUNIT * header%proj%lfac)
-
- ! longtitude,latitude
- ! Global Specification 4.4.3.2
- ! The invers projection function is as follows :
- !   lon = arctan(S2/S1) + sub_lon
- !   lat = arctan( (Req^2/Rpol^2) * S3 / Sxy )
- !
- ! Thererin the variables S1,S2,S3,Sxy are as follows :
- !    S1  = Rs - Sn * cos(x) * cos(y)
- !    S2  = Sn * sin(x) * cos(y)
- !    S3  =-Sn * sin(y)
- !    Sxy = sqrt(S1^2 + S2^2)
- !    Sn  =(Rs * cos(x) * cos(y) - Sd ) /
- !         (cos(y) * cos(y) + (Req^2/Rpol^2) * sin(y) * sin(y))
- !    Sd  =sqrt( (Rs * cos(x) * cos(y))^2
- !               - ( cos(y) * cos(y) + (Req^2/Rpol^2) * sin(y) * sin(y) )
- !               * (Rs^2 - Req^2)
- ! The variables Rs,Rpol,Req,(Req^2/Rpol^2),(Rs^2 - Req^2) are as follows :
- !    Rs  : distance from Earth center to satellite= head->proj->satDis
- !    Rpol: polar radius of the Earth              = head->proj->polrRadius
- !    Req : equator raidus of the Earth            = head->proj->eqtrRadius
- !    (Req^2/Rpol^2)                               = head->proj->projParam3
- !    (Rs^2 - Req^2)                               = head->proj->projParamSd
- Sd = (header%proj%satDis * cos(x) * cos(y)) * &
-      (header%proj%satDis * cos(x) * cos(y)) - &
-      (cos(y) * cos(y) + header%proj%projParam3 * sin(y) * sin(y)) * &
-       header%proj%projParamSd
- if ( Sd < 0 ) then
-    !write(*,*) 'Error in Sd'
-    ierr = -1
-    return
- else
-    Sd = sqrt(Sd)
+ allocate(x(npix), y(first:last), on_earth(npix, first:last))
+ do i = 1, npix
+    x(i) = deg2rad * (i - header%proj%coff) / (SCLUNIT * header%proj%cfac)
+ end do
+ do i = first, last
+    y(i) = deg2rad * (i - header%proj%loff) / (SCLUNIT * header%proj%lfac)
+ end do
+
+ ! the inverse projection of Global Specification 4.4.3.2
+ proj = geos_projection(subLon=header%proj%subLon, satDist=header%proj%satDis, &
+                        rEq=header%proj%eqtrRadius, rPol=header%proj%polrRadius, sweepX=0)
+ ierr = geoFixedGridToLatLon(proj, x, y, latitude(1:npix, first:last), longitude(1:npix, first:last), on_earth)
+ if ( ierr == 0 ) then
+    ierr = geoSatelliteAngles(proj, latitude(1:npix, first:last), longitude(1:npix, first:last), &
+                              satzen(1:npix, first:last))
  end if
- Sn = (header%proj%satDis * cos(x) * cos(y) -Sd) / &
-      (cos(y) * cos(y) + header%proj%projParam3 * sin(y) * sin(y))
- S1 = header%proj%satDis - (Sn * cos(x) * cos(y))
- S2 = Sn * sin(x) * cos(y)
- S3 =-Sn * sin(y)
- Sxy=sqrt( S1 * S1 + S2 * S2)
-
- lon = rad2deg * atan2(S2,S1) + header%proj%subLon
- lat = rad2deg * atan(header%proj%projParam3 * S3 / Sxy)
+ if ( ierr /= 0 ) then
+    print *, "ERROR in navigate_lines: lines ", first, " to ", last, " could not be navigated."
+    call exit(1)
+ end if
+ valid(1:npix, first:last) = on_earth .and. satzen(1:npix, first:last) <= 65.0
+ nav_line(first:last) = .true.
 
- ! check longtitude
- if ( lon >  180.0 ) lon = lon - 360.0
- if ( lon < -180.0 ) lon = lon + 360.0
+ deallocate(x, y, on_earth)
 
- return
-end subroutine pixlin_to_lonlat
+end subroutine navigate_lines
 
 !> @brief
 !> Computes the solar zenith angle given geolocation and time inputs.
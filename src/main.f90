@@ -1,8 +1,9 @@
 program obs2ioda
 
 use define_mod, only: write_nc_conv, write_nc_radiance, write_nc_radiance_geo, StrLen, xdata, &
-   ninst, output_info_type, set_output_info
-use kinds, only: i_kind
+   ninst, output_info_type, set_output_info, output_ext, par_comm, par_rank, par_size, &
+   sort_output, write_record_number, spatial_order
+use kinds, only: i_kind, i_llong
 use prepbufr_mod, only: read_prepbufr, sort_obs_conv, filter_obs_conv, do_tv_to_ts
 use radiance_mod, only: read_amsua_amsub_mhs, read_airs_colocate_amsua, sort_obs_radiance, &
    read_iasi, read_cris, radiance_to_temperature
@@ -10,7 +11,11 @@ use ncio_mod, only: write_obs
 use gnssro_bufr2ioda, only: read_write_gnssro
 use ahi_hsd_mod, only: read_hsd, subsample
 use satwnd_mod, only: read_satwnd, filter_obs_satwnd, sort_obs_satwnd
-use utils_mod, only: da_advance_time
+use utils_mod, only: da_advance_time, fork_process, wait_process, conversion_jobs
+use netcdf_cxx_mod, only: netcdfParallelInit, netcdfParallelFinalize, traceInit, traceBegin, traceEnd, &
+   traceFinalize, channelSelectionLoad, netcdfEncodingLoad
+use thinning_mod, only: read_thinning_namelist, thin_obs
+use qc_rules_mod, only: read_qc_rules
 
 implicit none
 
@@ -27,6 +32,14 @@ integer(i_kind), parameter :: ftype_airs     =  5
 integer(i_kind), parameter :: ftype_satwnd   =  6
 integer(i_kind), parameter :: ftype_iasi     =  7
 integer(i_kind), parameter :: ftype_cris     =  8
+! input families that are converted independently of each other
+integer(i_kind), parameter :: nfamily          = 5
+integer(i_kind), parameter :: family_unknown   = -1
+integer(i_kind), parameter :: family_gnssro    =  1
+integer(i_kind), parameter :: family_satwnd    =  2
+integer(i_kind), parameter :: family_prepbufr  =  3
+integer(i_kind), parameter :: family_microwave =  4  ! amsua, mhs, airs
+integer(i_kind), parameter :: family_hyperir   =  5  ! iasi, cris
 
 integer(i_kind)            :: ftype(nfile_all)
 character(len=NameLen)     :: flist_all(nfile_all) = &
@@ -55,6 +68,17 @@ integer(i_kind)         :: nfile, ifile
 integer(i_kind)         :: itmp
 integer(i_kind)         :: itime
 integer(i_kind)         :: superob_halfwidth
+integer(i_kind)         :: njobs, nrunning, nfailed, ifam, pid
+integer(i_kind)         :: ncycle, icycle
+integer(i_kind)         :: status
+logical                 :: detect_ftype
+character (len=StrLen)  :: batch_file
+character (len=StrLen)  :: thin_file
+character (len=StrLen)  :: trace_file
+character (len=StrLen)  :: qcrules_file
+character (len=StrLen)  :: channels_file
+character (len=StrLen)  :: encoding_file
+character (len=StrLen), allocatable :: cycle_inpdir(:), cycle_outdir(:), cycle_datetime(:)
 character (len=DateLen14) :: dtime, datetmp
 type(output_info_type) :: file_output_info
 
@@ -66,9 +90,51 @@ do_ahi = .false.
 do_superob = .false.
 apply_gsi_qc = .true. !.false.
 time_split = .false.
+njobs = 1
+batch_file = ''
+thin_file = ''
+trace_file = ''
+qcrules_file = ''
+channels_file = ''
+encoding_file = ''
+
+! rank 0 of 1 unless built with OBS2IODA_ENABLE_MPI and started with mpirun
+status = netcdfParallelInit(par_comm, par_rank, par_size)
 
 call parse_files_to_convert
 
+if ( conversion_jobs(njobs, par_size, len_trim(batch_file) > 0) /= njobs ) then
+   if ( par_size > 1 ) then
+      write(*,*) 'Warning: -j is ignored when running on several MPI ranks'
+   else
+      write(*,*) 'Warning: -j is ignored with -batch, whose caches are kept in one process'
+   end if
+   njobs = conversion_jobs(njobs, par_size, len_trim(batch_file) > 0)
+end if
+! a record could straddle the slices of two ranks, which sort their own slices only
+if ( write_record_number .and. par_size > 1 ) then
+   write(*,*) 'Warning: -records is ignored when running on several MPI ranks'
+   write_record_number = .false.
+end if
+
+if ( len_trim(thin_file) > 0 ) call read_thinning_namelist(thin_file)
+if ( len_trim(qcrules_file) > 0 ) call read_qc_rules(qcrules_file)
+if ( len_trim(channels_file) > 0 ) then
+   if ( channelSelectionLoad(channels_file) /= 0 ) then
+      write(*,*) 'Error: unable to read channel selection ', trim(channels_file)
+      stop 1
+   end if
+end if
+if ( len_trim(encoding_file) > 0 ) then
+   if ( netcdfEncodingLoad(encoding_file) /= 0 ) then
+      write(*,*) 'Error: unable to read output encoding ', trim(encoding_file)
+      stop 1
+   end if
+end if
+
+! stage tracing is off unless -trace or OBS2IODA_TRACE gives a trace file
+status = traceInit(trace_file, par_rank)
+
 if ( time_split ) then
    hour_fgat = 1  ! can also be 3 or 2
    ! corresponding to dtime_min='-3h' and dtime_max='+3h'
@@ -77,214 +143,318 @@ else
    nfgat = 1
 end if
 
-call set_output_info(file_output_info, outdir, nfgat, hour_fgat)
-
-do ifile = 1, nfile
-
-   filename = flist(ifile)
+if ( len_trim(batch_file) > 0 ) then
+   ! several cycles in one process: the IODA schema, the SpcCoeff tables, the
+   ! output file layouts and the AHI navigation stay loaded between cycles
+   call read_batch_manifest(batch_file)
+else
+   ncycle = 1
+   allocate (cycle_inpdir(1), cycle_outdir(1), cycle_datetime(1))
+   cycle_inpdir(1)   = inpdir
+   cycle_outdir(1)   = outdir
+   cycle_datetime(1) = cdatetime
+end if
 
-   if ( ftype(ifile) == ftype_gnssro ) then
-      inquire(file=trim(inpdir)//trim(filename), exist=fexist)
-      if ( .not. fexist ) then
-         write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
-      else
-         write(*,*) '--- processing gnssro.bufr ---'
-         call read_write_gnssro(trim(adjustl(inpdir))//trim(adjustl(filename)), file_output_info)
-      end if
-   end if
+nrunning = 0
+nfailed = 0
+cycle_loop: do icycle = 1, ncycle
 
-   if ( ftype(ifile) == ftype_satwnd ) then
-      inquire(file=trim(inpdir)//trim(filename), exist=fexist)
-      if ( .not. fexist ) then
-         write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
-      else
-         ! read satwnd file and store data in sequential linked list for conv obs
-         call read_satwnd(trim(inpdir)//trim(filename), filedate)
+   call set_cycle(icycle)
 
-         if ( apply_gsi_qc ) then
-            write(*,*) '--- applying some additional QC as in GSI read_satwnd.f90 for the global model ---'
-            call filter_obs_satwnd
+   if ( njobs > 1 ) then
+      ! the input families are independent until output, run each of them in its
+      ! own process, at most njobs at a time
+      do ifam = 1, nfamily
+         if ( .not. any(family_of(ftype(1:nfile)) == ifam) ) cycle
+         if ( nrunning == njobs ) then
+            call wait_family
          end if
-
-         ! transfer info from limked list to arrays grouped by obs/variable types
-         call sort_obs_satwnd(filedate, nfgat)
-
-         ! write out netcdf files
-         if ( nfgat > 1 ) then
-            do itime = 1, nfgat
-               ! corresponding to dtime_min='-3h' and dtime_max='+3h'
-               write(dtime,'(i2,a)')  hour_fgat*(itime-1)-3, 'h'
-               call da_advance_time(filedate, trim(dtime), datetmp)
-               filedate_out = datetmp(1:10)
-               call write_obs(filedate_out, write_nc_conv, outdir, itime)
-            end do
+         pid = fork_process()
+         if ( pid == 0 ) then
+            call convert_family(ifam)
+            status = traceFinalize()
+            stop
+         else if ( pid < 0 ) then
+            write(*,*) 'Warning: unable to start a separate process, converting serially'
+            call convert_family(ifam)
          else
-            call write_obs(filedate, write_nc_conv, outdir, 1)
+            nrunning = nrunning + 1
+         end if
+      end do
+   else
+      do ifam = 1, nfamily
+         ! with several MPI ranks, the radiance families are converted by all ranks
+         ! together into shared files, every other family by a single rank
+         if ( par_size > 1 .and. ifam /= family_microwave .and. ifam /= family_hyperir ) then
+            if ( mod(ifam-1, par_size) /= par_rank ) cycle
          end if
-         if ( allocated(xdata) ) deallocate(xdata)
+         call convert_family(ifam)
+      end do
+   end if
+
+   if ( do_ahi .and. par_rank == 0 ) then
+      if ( len_trim(cdatetime) /= 12 ) then
+         write(*,*) 'Error: -t ccyymmddhhnn not specified for -ahi'
+         stop 1
       end if
+      status = traceBegin('read_HSD')
+      call read_HSD(cdatetime, inpdir, do_superob, superob_halfwidth)
+      status = traceEnd('read_HSD', nobs_sorted())
+      filedate = cdatetime(1:10)
+      call thin_obs(write_nc_radiance_geo, 1)
+      status = traceBegin('write_obs')
+      call write_obs(filedate, write_nc_radiance_geo, outdir, 1)
+      status = traceEnd('write_obs', nobs_sorted())
+      if ( allocated(xdata) ) deallocate(xdata)
    end if
 
-   if ( ftype(ifile) == ftype_prepbufr ) then
-      inquire(file=trim(inpdir)//trim(filename), exist=fexist)
-      if ( .not. fexist ) then
-         write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
-      else
-         ! read prepbufr file and store data in sequential linked list for conv obs
-         call read_prepbufr(trim(inpdir)//trim(filename), filedate)
+end do cycle_loop
 
-         if ( apply_gsi_qc ) then
-            write(*,*) '--- applying some additional QC as in GSI read_prepbufr.f90 for the global model ---'
-            call filter_obs_conv
-         end if
+do while ( nrunning > 0 )
+   call wait_family
+end do
 
-         ! transfer info from limked list to arrays grouped by obs/variable types
-         call sort_obs_conv(filedate, nfgat)
-
-         ! write out netcdf files
-         if ( nfgat > 1 ) then
-            do itime = 1, nfgat
-               ! corresponding to dtime_min='-3h' and dtime_max='+3h'
-               write(dtime,'(i2,a)')  hour_fgat*(itime-1)-3, 'h'
-               call da_advance_time(filedate, trim(dtime), datetmp)
-               filedate_out = datetmp(1:10)
-               call write_obs(filedate_out, write_nc_conv, outdir, itime)
-            end do
-         else
-            call write_obs(filedate, write_nc_conv, outdir, 1)
-         end if
-         if ( allocated(xdata) ) deallocate(xdata)
-      end if
-   end if
+status = traceFinalize()
+status = netcdfParallelFinalize()
 
-   if ( ftype(ifile) == ftype_amsua ) then
-      inquire(file=trim(inpdir)//trim(filename), exist=fexist)
-      if ( .not. fexist ) then
-         write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
-      else
-         do_radiance = .true.
-         ! read bufr file and store data in sequential linked list for radiances
-         call read_amsua_amsub_mhs(trim(inpdir)//trim(filename), filedate)
-      end if
-   end if
+if ( nfailed > 0 ) then
+   write(*,*) 'Error: ', nfailed, ' conversion process(es) failed'
+   stop 1
+end if
 
-   if ( ftype(ifile) == ftype_airs ) then
-      inquire(file=trim(inpdir)//trim(filename), exist=fexist)
-      if ( .not. fexist ) then
-         write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
-      else
-         do_radiance = .true.
-         ! read bufr file and store data in sequential linked list for radiances
-         call read_airs_colocate_amsua(trim(inpdir)//trim(filename), filedate)
-      end if
-   end if
+write(6,*) 'all done!'
 
-   if ( ftype(ifile) == ftype_mhs ) then
-      inquire(file=trim(inpdir)//trim(filename), exist=fexist)
-      if ( .not. fexist ) then
-         write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
-      else
-         do_radiance = .true.
-         ! read bufr file and store data in sequential linked list for radiances
-         call read_amsua_amsub_mhs(trim(inpdir)//trim(filename), filedate)
-      end if
-   end if
+contains
 
-end do ! nfile list
+! Reads, sorts and writes out all input files of one family.
+subroutine convert_family(ifam)
 
-if ( do_radiance ) then
-   ! transfer info linked list to arrays grouped by satellite instrument types
-   call sort_obs_radiance(filedate, nfgat)
+implicit none
 
-   ! write out netcdf files
-   if ( nfgat > 1 ) then
-      do itime = 1, nfgat
-         ! corresponding to dtime_min='-3h' and dtime_max='+3h'
-         write(dtime,'(i2,a)')  hour_fgat*(itime-1)-3, 'h'
-         call da_advance_time(filedate, trim(dtime), datetmp)
-         filedate_out = datetmp(1:10)
-         call write_obs(filedate_out, write_nc_radiance, outdir, itime)
-      end do
-   else
-      call write_obs(filedate, write_nc_radiance, outdir, 1)
-   end if
-   if ( allocated(xdata) ) deallocate(xdata)
-end if
+integer(i_kind), intent(in) :: ifam
+integer(i_kind)             :: ifile
 
 do ifile = 1, nfile
 
+   if ( family_of(ftype(ifile)) /= ifam ) cycle
+
    filename = flist(ifile)
+   inquire(file=trim(inpdir)//trim(filename), exist=fexist)
+   if ( .not. fexist ) then
+      write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
+      cycle
+   end if
 
-   if ( ftype(ifile) == ftype_iasi ) then
-      inquire(file=trim(inpdir)//trim(filename), exist=fexist)
-      if ( .not. fexist ) then
-         write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
-      else
-         do_radiance_hyperIR = .true.
-         ! read bufr file and store data in sequential linked list for radiances
-         call read_iasi(trim(inpdir)//trim(filename), filedate)
+   select case ( ftype(ifile) )
+   case ( ftype_gnssro )
+      write(*,*) '--- processing gnssro.bufr ---'
+      status = traceBegin('read_write_gnssro')
+      call read_write_gnssro(trim(adjustl(inpdir))//trim(adjustl(filename)), file_output_info)
+      status = traceEnd('read_write_gnssro')
+
+   case ( ftype_satwnd )
+      ! read satwnd file and store data in sequential linked list for conv obs
+      status = traceBegin('read_satwnd')
+      call read_satwnd(trim(inpdir)//trim(filename), filedate)
+      status = traceEnd('read_satwnd')
+
+      if ( apply_gsi_qc ) then
+         write(*,*) '--- applying some additional QC as in GSI read_satwnd.f90 for the global model ---'
+         status = traceBegin('filter_obs_satwnd')
+         call filter_obs_satwnd
+         status = traceEnd('filter_obs_satwnd')
       end if
-   end if
 
-   if ( ftype(ifile) == ftype_cris ) then
-      inquire(file=trim(inpdir)//trim(filename), exist=fexist)
-      if ( .not. fexist ) then
-         write(*,*) 'Warning: ', trim(inpdir)//trim(filename), ' not found for decoding...'
-      else
-         do_radiance_hyperIR = .true.
-         ! read bufr file and store data in sequential linked list for radiances
-         call read_cris(trim(inpdir)//trim(filename), filedate)
+      ! transfer info from limked list to arrays grouped by obs/variable types
+      status = traceBegin('sort_obs_satwnd')
+      call sort_obs_satwnd(filedate, nfgat)
+      status = traceEnd('sort_obs_satwnd', nobs_sorted())
+
+      ! write out netcdf files
+      call write_time_windows(write_nc_conv)
+
+   case ( ftype_prepbufr )
+      ! read prepbufr file and store data in sequential linked list for conv obs
+      status = traceBegin('read_prepbufr')
+      call read_prepbufr(trim(inpdir)//trim(filename), filedate)
+      status = traceEnd('read_prepbufr')
+
+      if ( apply_gsi_qc ) then
+         write(*,*) '--- applying some additional QC as in GSI read_prepbufr.f90 for the global model ---'
+         status = traceBegin('filter_obs_conv')
+         call filter_obs_conv
+         status = traceEnd('filter_obs_conv')
       end if
-   end if
 
-end do
+      ! transfer info from limked list to arrays grouped by obs/variable types
+      status = traceBegin('sort_obs_conv')
+      call sort_obs_conv(filedate, nfgat)
+      status = traceEnd('sort_obs_conv', nobs_sorted())
+
+      ! write out netcdf files
+      call write_time_windows(write_nc_conv)
+
+   case ( ftype_amsua, ftype_mhs )
+      do_radiance = .true.
+      ! read bufr file and store data in per-instrument pools for radiances
+      status = traceBegin('read_amsua_amsub_mhs')
+      call read_amsua_amsub_mhs(trim(inpdir)//trim(filename), filedate)
+      status = traceEnd('read_amsua_amsub_mhs')
+
+   case ( ftype_airs )
+      do_radiance = .true.
+      ! read bufr file and store data in per-instrument pools for radiances
+      status = traceBegin('read_airs_colocate_amsua')
+      call read_airs_colocate_amsua(trim(inpdir)//trim(filename), filedate)
+      status = traceEnd('read_airs_colocate_amsua')
+
+   case ( ftype_iasi )
+      do_radiance_hyperIR = .true.
+      ! read bufr file and store data in per-instrument pools for radiances
+      status = traceBegin('read_iasi')
+      call read_iasi(trim(inpdir)//trim(filename), filedate)
+      status = traceEnd('read_iasi')
+
+   case ( ftype_cris )
+      do_radiance_hyperIR = .true.
+      ! read bufr file and store data in per-instrument pools for radiances
+      status = traceBegin('read_cris')
+      call read_cris(trim(inpdir)//trim(filename), filedate)
+      status = traceEnd('read_cris')
+   end select
+
+end do ! nfile list
+
+if ( ifam == family_microwave .and. do_radiance ) then
+   ! transfer info from the pools to arrays grouped by satellite instrument types
+   status = traceBegin('sort_obs_radiance')
+   call sort_obs_radiance(filedate, nfgat)
+   status = traceEnd('sort_obs_radiance', nobs_sorted())
+
+   ! write out netcdf files
+   call write_time_windows(write_nc_radiance)
+end if
 
-if ( do_radiance_hyperIR ) then
-   ! transfer info from linked list to arrays grouped by satellite instrument types
+if ( ifam == family_hyperir .and. do_radiance_hyperIR ) then
+   ! transfer info from the pools to arrays grouped by satellite instrument types
+   status = traceBegin('sort_obs_radiance')
    call sort_obs_radiance(filedate, nfgat)
+   status = traceEnd('sort_obs_radiance', nobs_sorted())
 
+   status = traceBegin('radiance_to_temperature')
    call radiance_to_temperature(ninst, nfgat)
+   status = traceEnd('radiance_to_temperature', nobs_sorted())
 
    ! write out netcdf files
-   if ( nfgat > 1 ) then
-      do itime = 1, nfgat
-         ! corresponding to dtime_min='-3h' and dtime_max='+3h'
-         write(dtime,'(i2,a)')  hour_fgat*(itime-1)-3, 'h'
-         call da_advance_time(filedate, trim(dtime), datetmp)
-         filedate_out = datetmp(1:10)
-         call write_obs(filedate_out, write_nc_radiance, outdir, itime)
-      end do
-   else
-      call write_obs(filedate, write_nc_radiance, outdir, 1)
-   end if
-   if ( allocated(xdata) ) deallocate(xdata)
+   call write_time_windows(write_nc_radiance)
 end if
 
-if ( do_ahi ) then
-   if ( len_trim(cdatetime) /= 12 ) then
-      write(*,*) 'Error: -t ccyymmddhhnn not specified for -ahi'
-      stop
-   end if
-   call read_HSD(cdatetime, inpdir, do_superob, superob_halfwidth)
-   filedate = cdatetime(1:10)
-   call write_obs(filedate, write_nc_radiance_geo, outdir, 1)
-   if ( allocated(xdata) ) deallocate(xdata)
+end subroutine convert_family
+
+! Writes out the sorted observations of every time window and releases them.
+subroutine write_time_windows(write_opt)
+
+implicit none
+
+integer(i_kind), intent(in) :: write_opt
+
+if ( nfgat > 1 ) then
+   do itime = 1, nfgat
+      ! corresponding to dtime_min='-3h' and dtime_max='+3h'
+      write(dtime,'(i2,a)')  hour_fgat*(itime-1)-3, 'h'
+      call da_advance_time(filedate, trim(dtime), datetmp)
+      filedate_out = datetmp(1:10)
+      status = traceBegin('thin_obs')
+      call thin_obs(write_opt, itime)
+      status = traceEnd('thin_obs', nobs_sorted(itime))
+      status = traceBegin('write_obs')
+      call write_obs(filedate_out, write_opt, outdir, itime)
+      status = traceEnd('write_obs', nobs_sorted(itime))
+   end do
+else
+   status = traceBegin('thin_obs')
+   call thin_obs(write_opt, 1)
+   status = traceEnd('thin_obs', nobs_sorted(1))
+   status = traceBegin('write_obs')
+   call write_obs(filedate, write_opt, outdir, 1)
+   status = traceEnd('write_obs', nobs_sorted(1))
 end if
+if ( allocated(xdata) ) deallocate(xdata)
 
-write(6,*) 'all done!'
+end subroutine write_time_windows
 
-contains
+! Number of sorted observations in xdata, of one time window or of all.
+function nobs_sorted(itim) result(nobs)
+
+implicit none
+
+integer(i_kind), intent(in), optional :: itim
+integer(i_llong)                      :: nobs
+
+nobs = 0
+if ( .not. allocated(xdata) ) return
+if ( present(itim) ) then
+   nobs = sum(xdata(:,itim)%nlocs)
+else
+   nobs = sum(xdata(:,:)%nlocs)
+end if
+
+end function nobs_sorted
+
+! Waits for one family process to finish and reports its failure.
+subroutine wait_family
+
+implicit none
+
+integer(i_kind) :: child_pid, exit_status
+
+child_pid = wait_process(-1, exit_status)
+if ( child_pid < 0 ) then
+   nrunning = 0
+   return
+end if
+nrunning = nrunning - 1
+if ( exit_status /= 0 ) then
+   ! remembered for the exit status of the driver
+   nfailed = nfailed + 1
+   write(*,*) 'Error: conversion process ', child_pid, ' exited with status ', exit_status
+end if
+
+end subroutine wait_family
+
+! Maps an input file type to the family it is converted with.
+elemental function family_of(ft) result(ifam)
+
+implicit none
+
+integer(i_kind), intent(in) :: ft
+integer(i_kind)             :: ifam
+
+select case ( ft )
+case ( ftype_gnssro )
+   ifam = family_gnssro
+case ( ftype_satwnd )
+   ifam = family_satwnd
+case ( ftype_prepbufr )
+   ifam = family_prepbufr
+case ( ftype_amsua, ftype_mhs, ftype_airs )
+   ifam = family_microwave
+case ( ftype_iasi, ftype_cris )
+   ifam = family_hyperir
+case default
+   ifam = family_unknown
+end select
+
+end function family_of
 
 subroutine parse_files_to_convert
 
 implicit none
 
-integer(i_kind)       :: iunit = 21
 integer(i_kind)       :: narg, iarg, iarg_inpdir, iarg_outdir, iarg_datetime, iarg_subsample, iarg_superob_halfwidth
-integer(i_kind)       :: itmp
-integer(i_kind)       :: iost, iret, idate
+integer(i_kind)       :: iarg_njobs, iarg_batch, iarg_thin, iarg_trace, iarg_qcrules, iarg_channels, iarg_encoding
+integer(i_kind)       :: iost
 character(len=StrLen) :: strtmp
-character(len=8)      :: subset
 
 narg = command_argument_count()
 ifile = 0
@@ -297,6 +467,13 @@ iarg_outdir = -1
 iarg_datetime = -1
 iarg_subsample = -1
 iarg_superob_halfwidth = -1
+iarg_njobs = -1
+iarg_batch = -1
+iarg_thin = -1
+iarg_trace = -1
+iarg_qcrules = -1
+iarg_channels = -1
+iarg_encoding = -1
 if ( narg > 0 ) then
    do iarg = 1, narg
       call get_command_argument(number=iarg, value=strtmp)
@@ -310,6 +487,15 @@ if ( narg > 0 ) then
          do_ahi = .true.
       else if ( trim(strtmp) == '-split' ) then
          time_split = .true.
+      else if ( trim(strtmp) == '-zarr' ) then
+         output_ext = '.zarr'
+      else if ( trim(strtmp) == '-sort' ) then
+         sort_output = .true.
+      else if ( trim(strtmp) == '-records' ) then
+         sort_output = .true.
+         write_record_number = .true.
+      else if ( trim(strtmp) == '-hilbert' ) then
+         spatial_order = .true.
       else if ( trim(strtmp) == '-i' ) then
          iarg_inpdir = iarg + 1
       else if ( trim(strtmp) == '-o' ) then
@@ -321,6 +507,20 @@ if ( narg > 0 ) then
       else if ( trim(strtmp) == '-superob' ) then
          do_superob = .true.
          iarg_superob_halfwidth = iarg + 1
+      else if ( trim(strtmp) == '-j' ) then
+         iarg_njobs = iarg + 1
+      else if ( trim(strtmp) == '-batch' ) then
+         iarg_batch = iarg + 1
+      else if ( trim(strtmp) == '-thin' ) then
+         iarg_thin = iarg + 1
+      else if ( trim(strtmp) == '-trace' ) then
+         iarg_trace = iarg + 1
+      else if ( trim(strtmp) == '-qcrules' ) then
+         iarg_qcrules = iarg + 1
+      else if ( trim(strtmp) == '-channels' ) then
+         iarg_channels = iarg + 1
+      else if ( trim(strtmp) == '-encoding' ) then
+         iarg_encoding = iarg + 1
       else
          if ( iarg == iarg_inpdir ) then
             call get_command_argument(number=iarg, value=inpdir)
@@ -342,12 +542,30 @@ if ( narg > 0 ) then
             else
               iarg_superob_halfwidth = 1
             end if
+         else if ( iarg == iarg_njobs ) then
+            call get_command_argument(number=iarg, value=strtmp)
+            read(strtmp,*,iostat=iost) njobs
+            if ( iost /= 0 .or. njobs < 1 ) njobs = 1
+         else if ( iarg == iarg_batch ) then
+            call get_command_argument(number=iarg, value=batch_file)
+         else if ( iarg == iarg_thin ) then
+            call get_command_argument(number=iarg, value=thin_file)
+         else if ( iarg == iarg_trace ) then
+            call get_command_argument(number=iarg, value=trace_file)
+         else if ( iarg == iarg_qcrules ) then
+            call get_command_argument(number=iarg, value=qcrules_file)
+         else if ( iarg == iarg_channels ) then
+            call get_command_argument(number=iarg, value=channels_file)
+         else if ( iarg == iarg_encoding ) then
+            call get_command_argument(number=iarg, value=encoding_file)
          else
             ifile = ifile + 1
             call get_command_argument(number=iarg, value=flist(ifile))
          end if
       end if
    end do
+   ! records are runs of the time order, which the spatial order does not keep
+   if ( spatial_order ) write_record_number = .false.
    if ( ifile == 0 ) then
       nfile = nfile_all
       flist(:) = flist_all(:)
@@ -367,13 +585,108 @@ else
                  ftype_iasi, ftype_cris /)
 end if
 
+! the input file types are determined for each cycle if the file names are
+! set in command-line argument, otherwise the default file lists are used
+detect_ftype = ( narg > 0 .and. ifile > 0 )
+
+end subroutine parse_files_to_convert
+
+! Reads the cycles of a batch run, one per line:
+!    input_dir output_dir [ccyymmddhhnn]
+! Blank lines and lines starting with # are skipped.
+subroutine read_batch_manifest(fname)
+
+implicit none
+
+character(len=*), intent(in) :: fname
+
+integer(i_kind)       :: iunit, iost, icycle, itoken, ntoken, ipos, iend
+character(len=StrLen) :: line
+character(len=StrLen) :: token(3)
+
+open(newunit=iunit, file=trim(fname), status='old', action='read', iostat=iost)
+if ( iost /= 0 ) then
+   write(*,*) 'Error: unable to open batch manifest ', trim(fname)
+   stop 1
+end if
+
+! count the cycles first, then read them
+ncycle = 0
+do icycle = 1, 2
+   if ( icycle == 2 ) then
+      allocate (cycle_inpdir(ncycle), cycle_outdir(ncycle), cycle_datetime(ncycle))
+      rewind(iunit)
+      ncycle = 0
+   end if
+   line_loop: do
+      read(iunit, '(a)', iostat=iost) line
+      if ( iost /= 0 ) exit line_loop
+      line = adjustl(line)
+      if ( len_trim(line) == 0 .or. line(1:1) == '#' ) cycle line_loop
+      ! split on blanks, paths are not list-directed safe because of '/'
+      token(:) = ''
+      ntoken = 0
+      ipos = 1
+      do itoken = 1, 3
+         do while ( ipos <= len_trim(line) .and. line(ipos:ipos) == ' ' )
+            ipos = ipos + 1
+         end do
+         if ( ipos > len_trim(line) ) exit
+         iend = index(line(ipos:), ' ') + ipos - 2
+         token(itoken) = line(ipos:iend)
+         ntoken = itoken
+         ipos = iend + 1
+      end do
+      if ( ntoken < 2 ) then
+         write(*,*) 'Warning: skipping batch manifest line ', trim(line)
+         cycle line_loop
+      end if
+      ncycle = ncycle + 1
+      if ( icycle == 2 ) then
+         cycle_inpdir(ncycle)   = token(1)
+         cycle_outdir(ncycle)   = token(2)
+         cycle_datetime(ncycle) = token(3)
+      end if
+   end do line_loop
+end do
+close(iunit)
+
+end subroutine read_batch_manifest
+
+! Prepares the global state for converting one cycle.
+subroutine set_cycle(icycle)
+
+implicit none
+
+integer(i_kind), intent(in) :: icycle
+
+inpdir    = cycle_inpdir(icycle)
+outdir    = cycle_outdir(icycle)
+cdatetime = cycle_datetime(icycle)
+
 itmp = len_trim(inpdir)
 if ( inpdir(itmp:itmp) /= '/' ) inpdir = trim(inpdir)//'/'
 itmp = len_trim(outdir)
 if ( outdir(itmp:itmp) /= '/' ) outdir = trim(outdir)//'/'
 
-! use default file lists if not set in command-line arguemnt
-if ( narg == 0 .or. ifile == 0 ) return
+do_radiance = .false.
+do_radiance_hyperIR = .false.
+
+if ( detect_ftype ) call detect_file_types
+
+call set_output_info(file_output_info, outdir, nfgat, hour_fgat)
+
+end subroutine set_cycle
+
+! Determines the input file types from the first BUFR message of each file.
+subroutine detect_file_types
+
+implicit none
+
+integer(i_kind)       :: iunit = 21
+integer(i_kind)       :: ifile
+integer(i_kind)       :: iost, iret, idate
+character(len=8)      :: subset
 
 ! determine the input file type
 fileloop: do ifile = 1, nfile
@@ -411,6 +724,7 @@ fileloop: do ifile = 1, nfile
    close(iunit)
 end do fileloop
 
-end subroutine parse_files_to_convert
+
+end subroutine detect_file_types
 
 end program obs2ioda
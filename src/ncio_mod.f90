@@ -1,22 +1,38 @@
 module ncio_mod
 
-use kinds, only: i_kind, r_single, r_kind
+use kinds, only: i_kind, r_single, r_kind, i_llong
 use define_mod, only: nobtype, nvar_info, n_ncdim, n_ncgrp, nstring, ndatetime, &
    obtype_list, name_ncdim, name_ncgrp, name_var_met, name_var_info, name_sen_info, &
    xdata, itrue, ifalse, vflag, ninst, inst_list, write_nc_conv, write_nc_radiance, &
    write_nc_radiance_geo, ninst_geo, geoinst_list, &
    var_tb, nsen_info, type_var_info, type_sen_info, dim_var_info, dim_sen_info, &
-   unit_var_met, iflag_conv, iflag_radiance, set_brit_obserr, set_ahi_obserr
+   unit_var_met, iflag_conv, iflag_radiance, set_brit_obserr, set_ahi_obserr, output_ext, &
+   xdata_type, missing_i, missing_r, par_comm, par_rank, par_size, sort_output, write_record_number, &
+   spatial_order, spatial_block_locs
 use netcdf, only: nf90_int, nf90_float, nf90_char, nf90_int64, nf90_string
 use ufo_vars_mod, only: ufo_vars_getindex
 use netcdf_cxx_mod, only: netcdfCreate, netcdfAddDim, netcdfPutAtt, netcdfAddVar, &
-   netcdfSetFill, netcdfAddGroup, netcdfPutVar, netcdfClose
+   netcdfSetFill, netcdfAddGroup, netcdfPutVar, netcdfClose, &
+   netcdfSaveLayout, netcdfCreateFromLayout, netcdfFreeLayout, &
+   netcdfParallelExscan, netcdfParallelReduce, parallel_min, parallel_max, obsOrder, &
+   spatialOrder, netcdfSetLocationBlocks, netcdfPutSpatialIndex, timeEpochToDatetime
 
 implicit none
 
 private
 public :: write_obs
 
+! Layout of the first file written for an obtype/instrument. Later files of the
+! same type (other time windows) are created from it instead of being defined
+! again, as long as they carry the same variables.
+type layout_type
+   integer(i_kind)              :: layoutID = -1
+   integer(i_kind)              :: has_wavenumber
+   integer(i_kind), allocatable :: var_idx(:)
+end type layout_type
+
+type(layout_type), dimension(write_nc_conv:write_nc_radiance_geo, max(nobtype, ninst, ninst_geo)) :: layouts
+
 contains
 
     ! Retrieves the name of a NetCDF dimension based on its ID.
@@ -42,6 +58,150 @@ contains
       end if
    end function get_dim_name
 
+    ! Checks whether a saved layout describes a file with the given variables.
+    !
+    ! Arguments:
+    ! - layout: The saved layout of an obtype/instrument.
+    ! - var_idx: Indices of the variables written for the obtype/instrument.
+    ! - has_wavenumber: itrue if the file carries the channel wavenumbers.
+    !
+    ! Returns:
+    ! - matches: .true. if the layout was saved and can be reused.
+   function layout_matches(layout, var_idx, has_wavenumber) result(matches)
+      type(layout_type), intent(in) :: layout
+      integer(i_kind), allocatable, dimension(:), intent(in) :: var_idx
+      integer(i_kind), intent(in) :: has_wavenumber
+      logical :: matches
+
+      matches = .false.
+      if ( layout%layoutID < 0 .or. .not. allocated(var_idx) ) return
+      if ( layout%has_wavenumber /= has_wavenumber ) return
+      if ( size(layout%var_idx) /= size(var_idx) ) return
+      matches = all(layout%var_idx == var_idx)
+   end function layout_matches
+
+    ! Saves the layout of a fully defined file, replacing any layout saved before.
+    !
+    ! Arguments:
+    ! - netcdfID: The NetCDF file whose layout is saved.
+    ! - layout: The layout slot of the obtype/instrument.
+    ! - var_idx: Indices of the variables written for the obtype/instrument. Nothing
+    !   is saved if it is not allocated.
+    ! - has_wavenumber: itrue if the file carries the channel wavenumbers.
+   subroutine save_layout(netcdfID, layout, var_idx, has_wavenumber)
+      integer(i_kind), intent(in) :: netcdfID
+      type(layout_type), intent(inout) :: layout
+      integer(i_kind), allocatable, dimension(:), intent(in) :: var_idx
+      integer(i_kind), intent(in) :: has_wavenumber
+      integer(i_kind) :: status
+
+      if ( .not. allocated(var_idx) ) return
+      if ( layout%layoutID >= 0 ) then
+         status = netcdfFreeLayout(layout%layoutID)
+         layout%layoutID = -1
+      end if
+      status = netcdfSaveLayout(netcdfID, layout%layoutID)
+      if ( status /= 0 ) then
+         layout%layoutID = -1
+         return
+      end if
+      layout%has_wavenumber = has_wavenumber
+      layout%var_idx = var_idx
+   end subroutine save_layout
+
+    ! Allocates the arrays of an obtype/instrument without observations on this rank,
+    ! so that the rank can take part in the collective writes with empty slices.
+    !
+    ! Arguments:
+    ! - obs: The observations of the obtype/instrument on this rank.
+    ! - nvars: The number of channels of the instrument.
+    ! - has_wavenumber: itrue if the file carries the channel wavenumbers.
+   subroutine allocate_empty_obs(obs, nvars, has_wavenumber)
+      type(xdata_type), intent(inout) :: obs
+      integer(i_kind), intent(in) :: nvars
+      integer(i_kind), intent(in) :: has_wavenumber
+      integer(i_kind) :: iv
+
+      obs%nvars = nvars
+      allocate (obs%xinfo_float(0, nvar_info))
+      allocate (obs%xinfo_int(0, nvar_info))
+      allocate (obs%xinfo_int64(0, nvar_info))
+      allocate (obs%xinfo_char(0, nvar_info))
+      allocate (obs%xseninfo_float(0, nsen_info))
+      allocate (obs%xseninfo_int(nvars, nsen_info))
+      obs%xseninfo_int(:,:) = missing_i
+      allocate (obs%xfield(0, nvars))
+      allocate (obs%var_idx(nvars))
+      do iv = 1, nvars
+         obs%var_idx(iv) = iv
+      end do
+      if ( has_wavenumber == itrue ) then
+         allocate (obs%wavenumber(nvars))
+         obs%wavenumber(:) = missing_r
+      end if
+   end subroutine allocate_empty_obs
+
+    ! Puts the locations of an obtype/instrument in output order: by dateTime and,
+    ! for conventional observations, then by station_id, or with spatial_order along
+    ! a Hilbert curve and then by dateTime. The order is computed once and every
+    ! per-location array is gathered through it. The input order is kept if the
+    ! order cannot be computed.
+    !
+    ! Arguments:
+    ! - obs: The observations of the obtype/instrument.
+    ! - by_station: .true. to order the locations of the same time by station_id.
+    ! - record_number: Receives the record of every location of the new order;
+    !   consecutive locations with the same dateTime (and station_id) are one record.
+    !   In the spatial order every location is its own record.
+    ! - nrecords: Receives the number of records.
+    ! - ordered: Receives .true. if the locations were put in output order, or
+    !   .false. if the input order was kept.
+   subroutine order_obs(obs, by_station, record_number, nrecords, ordered)
+      type(xdata_type), intent(inout) :: obs
+      logical, intent(in) :: by_station
+      integer(i_llong), allocatable, dimension(:), intent(out) :: record_number
+      integer(i_llong), intent(out) :: nrecords
+      logical, intent(out) :: ordered
+      integer(i_llong), allocatable, dimension(:) :: order
+      integer(i_llong) :: ii
+      integer(i_kind) :: status, iv
+
+      allocate (order(obs%nlocs))
+      allocate (record_number(obs%nlocs))
+      iv = ufo_vars_getindex(name_var_info, 'dateTime')
+      if ( spatial_order ) then
+         status = spatialOrder(obs%xinfo_float(:,ufo_vars_getindex(name_var_info, 'latitude')), &
+            obs%xinfo_float(:,ufo_vars_getindex(name_var_info, 'longitude')), obs%xinfo_int64(:,iv), order)
+         do ii = 1, obs%nlocs
+            record_number(ii) = ii
+         end do
+         nrecords = obs%nlocs
+      else if ( by_station ) then
+         status = obsOrder(obs%xinfo_int64(:,iv), order, record_number, nrecords, &
+            obs%xinfo_char(:,ufo_vars_getindex(name_var_info, 'station_id')))
+      else
+         status = obsOrder(obs%xinfo_int64(:,iv), order, record_number, nrecords)
+      end if
+      if ( status /= 0 ) then
+         write(*,*) ' Warning: locations are written unsorted'
+         do ii = 1, obs%nlocs
+            record_number(ii) = ii
+         end do
+         nrecords = obs%nlocs
+         ordered = .false.
+         return
+      end if
+      ordered = .true.
+
+      if ( allocated(obs%xfield) )         obs%xfield         = obs%xfield(order,:)
+      if ( allocated(obs%xinfo_float) )    obs%xinfo_float    = obs%xinfo_float(order,:)
+      if ( allocated(obs%xinfo_int) )      obs%xinfo_int      = obs%xinfo_int(order,:)
+      if ( allocated(obs%xinfo_int64) )    obs%xinfo_int64    = obs%xinfo_int64(order,:)
+      if ( allocated(obs%xinfo_char) )     obs%xinfo_char     = obs%xinfo_char(order,:)
+      if ( allocated(obs%xseninfo_float) ) obs%xseninfo_float = obs%xseninfo_float(order,:)
+      deallocate (order)
+   end subroutine order_obs
+
 subroutine write_obs (filedate, write_opt, outdir, itim)
 
    implicit none
@@ -53,15 +213,15 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
 
    character(len=512)                    :: ncfname  ! netcdf file name
    integer(i_kind), dimension(n_ncdim)   :: ncid_ncdim
-   integer(i_kind), dimension(n_ncdim)   :: val_ncdim
+   integer(i_llong), dimension(n_ncdim)  :: val_ncdim
    character(len=nstring)                :: ncname
    integer(i_kind)                       :: ncfileid
    integer(i_kind)                       :: ntype
-   integer(i_kind)                       :: i, ityp, ivar, ii, iv, jj, scan_position_idx
+   integer(i_kind)                       :: i, ityp, ivar, ii, iv, jj
    integer(i_kind)                       :: idim, dim1, dim2
    character(len=nstring),   allocatable :: str_nstring(:)
    character(len=ndatetime), allocatable :: str_ndatetime(:)
-   character(len=nstring)                :: str_tmp
+   character(len=ndatetime)              :: datetime_tmp
    integer(i_kind)                       :: iflag
    integer(i_kind), allocatable :: ichan(:)
    real(r_kind),    allocatable :: rtmp2d(:,:)
@@ -73,7 +233,13 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
    logical :: nchans_nvars_flag
    character(len = nstring) :: dim1_name
    character(len = nstring) :: dim2_name
-   integer(i_kind), allocatable, dimension(:) :: scan_position_values
+   character(len = nstring), dimension(n_ncdim) :: dim_names
+   logical :: distributed
+   integer(i_kind) :: chan_count, writer_rank, ireduce
+   integer(i_llong) :: nlocs_local, loc_start, loc_offset, nlocs_total
+   integer(i_llong), allocatable, dimension(:) :: record_number
+   integer(i_llong) :: nrecords
+   logical :: time_ordered
 
    if ( write_opt == write_nc_conv ) then
       ntype = nobtype
@@ -86,6 +252,9 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
       return
    end if
 
+   ! with spatial_order, the location variables are chunked by the blocks of the spatial index
+   status = netcdfSetLocationBlocks(merge(spatial_block_locs, 0, spatial_order))
+
    iv = ufo_vars_getindex(name_ncdim, 'nstring')
    if ( iv > 0 ) val_ncdim(iv) = nstring
    iv = ufo_vars_getindex(name_ncdim, 'ndatetime')
@@ -93,21 +262,77 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
 
    obtype_loop: do ityp = 1, ntype
 
-      if ( xdata(ityp,itim)%nlocs == 0 ) cycle obtype_loop
+      ! with several MPI ranks, radiances are decoded on every rank from its share of
+      ! the BUFR messages and written collectively to one file, each rank to its own
+      ! slice of the location dimension
+      distributed = ( par_size > 1 .and. write_opt == write_nc_radiance )
+      nlocs_local = xdata(ityp,itim)%nlocs
+      if ( distributed ) then
+         status = netcdfParallelExscan(par_comm, nlocs_local, loc_offset, nlocs_total)
+      else
+         loc_offset = 0
+         nlocs_total = nlocs_local
+      end if
+      if ( nlocs_total == 0 ) cycle obtype_loop
+
+      nrecords = 0
+      if ( nlocs_local > 0 ) then
+         ! the first and last locations hold the time range only if they were sorted by dateTime
+         time_ordered = .false.
+         if ( sort_output .or. spatial_order ) then
+            call order_obs(xdata(ityp,itim), write_opt == write_nc_conv, record_number, nrecords, time_ordered)
+            time_ordered = time_ordered .and. .not. spatial_order
+         end if
+         if ( time_ordered ) then
+            imin_datetime(1) = 1
+            imax_datetime(1) = int(nlocs_local, i_kind)
+         else
+            iv = ufo_vars_getindex(name_var_info, 'dateTime')
+            imin_datetime = minloc(xdata(ityp,itim)%xinfo_int64(:,iv))
+            imax_datetime = maxloc(xdata(ityp,itim)%xinfo_int64(:,iv))
+         end if
+         iv = ufo_vars_getindex(name_var_info, 'dateTime')
+         allocate(str_ndatetime(2))
+         status = timeEpochToDatetime(xdata(ityp,itim)%xinfo_int64([imin_datetime(1), imax_datetime(1)],iv), &
+            str_ndatetime)
+         xdata(ityp,itim)%min_datetime = str_ndatetime(1)
+         xdata(ityp,itim)%max_datetime = str_ndatetime(2)
+         deallocate(str_ndatetime)
+      else
+         xdata(ityp,itim)%min_datetime = ''
+         xdata(ityp,itim)%max_datetime = ''
+      end if
+
+      if ( allocated(xdata(ityp,itim)%wavenumber) ) then
+         has_wavenumber = itrue
+      else
+         has_wavenumber = ifalse
+      end if
 
-      iv = ufo_vars_getindex(name_var_info, 'dateTime')
-      imin_datetime = minloc(xdata(ityp,itim)%xinfo_int64(:,iv))
-      imax_datetime = maxloc(xdata(ityp,itim)%xinfo_int64(:,iv))
-      iv = ufo_vars_getindex(name_var_info, 'datetime')
-      xdata(ityp,itim)%min_datetime = xdata(ityp,itim)%xinfo_char(imin_datetime(1),iv)
-      xdata(ityp,itim)%max_datetime = xdata(ityp,itim)%xinfo_char(imax_datetime(1),iv)
+      writer_rank = par_rank
+      if ( distributed ) then
+         status = netcdfParallelReduce(par_comm, xdata(ityp,itim)%min_datetime, parallel_min, datetime_tmp)
+         xdata(ityp,itim)%min_datetime = datetime_tmp
+         status = netcdfParallelReduce(par_comm, xdata(ityp,itim)%max_datetime, parallel_max, datetime_tmp)
+         xdata(ityp,itim)%max_datetime = datetime_tmp
+         status = netcdfParallelReduce(par_comm, has_wavenumber, parallel_max, ireduce)
+         has_wavenumber = ireduce
+         ! the channel variables are written by the lowest rank holding observations
+         status = netcdfParallelReduce(par_comm, merge(par_rank, par_size, nlocs_local > 0), &
+            parallel_min, writer_rank)
+         status = netcdfParallelReduce(par_comm, xdata(ityp,itim)%nvars, parallel_max, ireduce)
+         if ( nlocs_local == 0 ) call allocate_empty_obs(xdata(ityp,itim), ireduce, has_wavenumber)
+      end if
+      ! hyperslabs written by this rank: its own locations, and all channels on the writer rank
+      loc_start = loc_offset + 1
+      chan_count = merge(xdata(ityp,itim)%nvars, 0, par_rank == writer_rank)
 
       if ( write_opt == write_nc_conv ) then
-         ncfname = trim(outdir)//trim(obtype_list(ityp))//'_obs_'//trim(filedate)//'.h5'
+         ncfname = trim(outdir)//trim(obtype_list(ityp))//'_obs_'//trim(filedate)//trim(output_ext)
       else if ( write_opt == write_nc_radiance ) then
-         ncfname = trim(outdir)//trim(inst_list(ityp))//'_obs_'//trim(filedate)//'.h5'
+         ncfname = trim(outdir)//trim(inst_list(ityp))//'_obs_'//trim(filedate)//trim(output_ext)
       else if ( write_opt == write_nc_radiance_geo ) then
-         ncfname = trim(outdir)//trim(geoinst_list(ityp))//'_obs_'//trim(filedate)//'.h5'
+         ncfname = trim(outdir)//trim(geoinst_list(ityp))//'_obs_'//trim(filedate)//trim(output_ext)
       end if
       if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
          iv = ufo_vars_getindex(name_sen_info, 'sensor_channel')
@@ -117,17 +342,16 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
          if  ( write_opt == write_nc_radiance_geo ) then
              call set_ahi_obserr(geoinst_list(ityp), xdata(ityp,itim)%nvars, obserr)
          else
-             call set_brit_obserr(inst_list(ityp), xdata(ityp,itim)%nvars, obserr)
+             call set_brit_obserr(inst_list(ityp), xdata(ityp,itim)%nvars, obserr, &
+                                  xdata(ityp,itim)%var_idx)
          end if
       end if
       write(*,*) '--- writing ', trim(ncfname)
-      status = netcdfCreate(trim(ncfname), netcdfID)
       iv = ufo_vars_getindex(name_ncdim, 'nvars')
       val_ncdim(iv) = xdata(ityp,itim)%nvars
       iv = ufo_vars_getindex(name_ncdim, 'nlocs')
-      val_ncdim(iv) = xdata(ityp,itim)%nlocs
+      val_ncdim(iv) = nlocs_total
 
-      ! define netcdf dimensions
       if ( write_opt == write_nc_conv ) then
          ncname = 'nvars'
          nchans_nvars_flag = .false.
@@ -135,142 +359,166 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
          ncname = 'nchans'
          nchans_nvars_flag = .true.
       end if
-
-      status = netcdfAddDim(netcdfID, trim(ncname), val_ncdim(1), ncid_ncdim(1))
-      status = netcdfPutAtt(netcdfID, trim(ncname), val_ncdim(ncid_ncdim(1)))
-      status = netcdfAddVar(netcdfID, trim(ncname), NF90_INT, 1, [trim(ncname)])
-
-      do i = 2, n_ncdim
-         status = netcdfAddDim(netcdfID, trim(name_ncdim(i)), val_ncdim(i), ncid_ncdim(i))
-         status = netcdfPutAtt(netcdfID, trim(name_ncdim(i)), val_ncdim(i))
-         status = netcdfAddVar(netcdfID, trim(name_ncdim(i)), NF90_INT, 1, [trim(name_ncdim(i))])
+      do i = 1, n_ncdim
+         dim_names(i) = get_dim_name(i, nchans_nvars_flag)
       end do
 
-      ! define global attributes
-      status = netcdfPutAtt(netcdfID, "min_datetime", xdata(ityp, itim)%min_datetime)
-      status = netcdfPutAtt(netcdfID, "max_datetime", xdata(ityp, itim)%max_datetime)
-
-      if ( allocated(xdata(ityp,itim)%wavenumber) ) then
-         has_wavenumber = itrue
+      if ( .not. distributed .and. &
+           layout_matches(layouts(write_opt,ityp), xdata(ityp,itim)%var_idx, has_wavenumber) ) then
+         ! same groups, variables and attributes as an earlier file of this type,
+         ! only the dimension lengths differ
+         status = netcdfCreateFromLayout(trim(ncfname), layouts(write_opt,ityp)%layoutID, &
+            dim_names, val_ncdim, netcdfID)
       else
-         has_wavenumber = ifalse
-      end if
-
-      ! define netcdf groups
-      do i = 1, n_ncgrp
-         if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
-            if ( trim(name_ncgrp(i)) == 'ObsType' ) cycle
+         if ( distributed ) then
+            status = netcdfCreate(trim(ncfname), netcdfID, comm = par_comm)
+         else
+            status = netcdfCreate(trim(ncfname), netcdfID)
          end if
-         status = netcdfAddGroup(netcdfID, trim(name_ncgrp(i)))
-      end do
-      if ( has_wavenumber == itrue ) then
-         ! use deprecated VarMetaData group for wavenumber before related code in UFO is updated
-         status = netcdfAddGroup(netcdfID, 'VarMetaData')
-      end if
 
-      ! define netcdf variables
-      if ( write_opt == write_nc_conv ) then
-         do i = 1, xdata(ityp,itim) % nvars
-            ivar = xdata(ityp,itim) % var_idx(i)
-            ncname = trim(name_var_met(ivar))
-            dim1_name = get_dim_name(ncid_ncdim(2), nchans_nvars_flag)
-            status = netcdfAddVar(netcdfID, ncname, NF90_FLOAT, 1, [dim1_name], "ObsValue", fillValue = -999.0)
-            status = netcdfPutAtt(netcdfID, "units", trim(unit_var_met(ivar)), varName = trim(ncname), groupName = "ObsValue")
-            status = netcdfAddVar(netcdfID, ncname, NF90_FLOAT, 1, [dim1_name], "ObsError", fillValue = -999.0)
-            status = netcdfPutAtt(netcdfID, "units", trim(unit_var_met(ivar)), varName = trim(ncname), groupName = "ObsError")
-            status = netcdfAddVar(netcdfID, ncname, NF90_INT, 1, [dim1_name], "PreQC", fillValue = -999)
-            status = netcdfAddVar(netcdfID, ncname, NF90_INT, 1, [dim1_name], "ObsType", fillValue = -999)
+         ! define netcdf dimensions
+         status = netcdfAddDim(netcdfID, trim(ncname), val_ncdim(1), ncid_ncdim(1))
+         status = netcdfAddVar(netcdfID, trim(ncname), NF90_INT, 1, [trim(ncname)])
+
+         do i = 2, n_ncdim
+            status = netcdfAddDim(netcdfID, trim(name_ncdim(i)), val_ncdim(i), ncid_ncdim(i))
+            status = netcdfAddVar(netcdfID, trim(name_ncdim(i)), NF90_INT, 1, [trim(name_ncdim(i))])
          end do
-      else if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
-         ncname = trim(var_tb)
-         idim = ufo_vars_getindex(name_ncdim, 'nvars') ! note that its ncname is actually nchans
-         dim1 = ncid_ncdim(idim)
-         idim = ufo_vars_getindex(name_ncdim, 'nlocs')
-         dim2 = ncid_ncdim(idim)
-         dim1_name = get_dim_name(dim1, nchans_nvars_flag)
-         dim2_name = get_dim_name(dim2, nchans_nvars_flag)
-         status = netcdfAddVar(netcdfID, ncname, NF90_FLOAT, 2, &
-            [dim2_name, dim1_name], "ObsValue", fillValue = -999.0)
-         status = netcdfPutAtt(netcdfID, "units", "K", varName = trim(ncname), groupName = "ObsValue")
-         status = netcdfAddVar(netcdfID, ncname, NF90_FLOAT, 2, &
-            [dim2_name, dim1_name], "ObsError", fillValue = -999.0)
-         status = netcdfPutAtt(netcdfID, "units", "K", varName = trim(ncname), groupName = "ObsError")
-         status = netcdfAddVar(netcdfID, ncname, NF90_INT, 2, &
-            [dim2_name, dim1_name], "PreQC", fillValue = -999)
-      end if
 
-      var_info_def_loop: do i = 1, nvar_info
+         ! define netcdf groups
+         do i = 1, n_ncgrp
+            if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
+               if ( trim(name_ncgrp(i)) == 'ObsType' ) cycle
+            end if
+            status = netcdfAddGroup(netcdfID, trim(name_ncgrp(i)))
+         end do
+         if ( has_wavenumber == itrue ) then
+            ! use deprecated VarMetaData group for wavenumber before related code in UFO is updated
+            status = netcdfAddGroup(netcdfID, 'VarMetaData')
+         end if
+
+         ! define netcdf variables
          if ( write_opt == write_nc_conv ) then
-            iflag = iflag_conv(i,ityp)
+            do i = 1, xdata(ityp,itim) % nvars
+               ivar = xdata(ityp,itim) % var_idx(i)
+               ncname = trim(name_var_met(ivar))
+               dim1_name = get_dim_name(ncid_ncdim(2), nchans_nvars_flag)
+               status = netcdfAddVar(netcdfID, ncname, NF90_FLOAT, 1, [dim1_name], "ObsValue", fillValue = -999.0)
+               status = netcdfPutAtt(netcdfID, "units", trim(unit_var_met(ivar)), varName = trim(ncname), groupName = "ObsValue")
+               status = netcdfAddVar(netcdfID, ncname, NF90_FLOAT, 1, [dim1_name], "ObsError", fillValue = -999.0)
+               status = netcdfPutAtt(netcdfID, "units", trim(unit_var_met(ivar)), varName = trim(ncname), groupName = "ObsError")
+               status = netcdfAddVar(netcdfID, ncname, NF90_INT, 1, [dim1_name], "PreQC", fillValue = -999)
+               status = netcdfAddVar(netcdfID, ncname, NF90_INT, 1, [dim1_name], "ObsType", fillValue = -999)
+            end do
          else if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
-            iflag = iflag_radiance(i)
-         end if
-         if ( iflag /= itrue ) cycle var_info_def_loop
-         ncname = trim(name_var_info(i))
-         idim = ufo_vars_getindex(name_ncdim, dim_var_info(1,i))
-         dim1 = ncid_ncdim(idim)
-         dim1_name = get_dim_name(dim1, nchans_nvars_flag)
-         if (ncname == 'dateTime') then
-            status = netcdfAddVar(netcdfID, ncname, type_var_info(i), 1, &
-               [dim1_name], "MetaData")
-            status = netcdfPutAtt(netcdfID, "units", "seconds since 1970-01-01T00:00:00Z", varName = trim(ncname), &
-               groupName = "MetaData")
-         else
-            if (type_var_info(i) == nf90_char) then
-               idim = ufo_vars_getindex(name_ncdim, dim_var_info(2,i))
-               dim2 = ncid_ncdim(idim)
-               dim2_name = get_dim_name(dim2, nchans_nvars_flag)
-               status = netcdfAddVar(netcdfID, ncname, nf90_string, 1, &
-                  [dim2_name], "MetaData")
-               status = netcdfSetFill(netcdfID, ncname, 1, " ", "MetaData")
-            else
-               status = netcdfAddVar(netcdfID, ncname, type_var_info(i), 1, &
-                  [dim1_name], "MetaData")
-               if (type_var_info(i) == NF90_INT) then
-                  status = netcdfSetFill(netcdfID, ncname, 1, -999, "MetaData")
-               else if (type_var_info(i) == NF90_FLOAT) then
-                  status = netcdfSetFill(netcdfID, ncname, 1, -999.0, "MetaData")
-               end if
-            end if
+            ncname = trim(var_tb)
+            idim = ufo_vars_getindex(name_ncdim, 'nvars') ! note that its ncname is actually nchans
+            dim1 = ncid_ncdim(idim)
+            idim = ufo_vars_getindex(name_ncdim, 'nlocs')
+            dim2 = ncid_ncdim(idim)
+            dim1_name = get_dim_name(dim1, nchans_nvars_flag)
+            dim2_name = get_dim_name(dim2, nchans_nvars_flag)
+            status = netcdfAddVar(netcdfID, ncname, NF90_FLOAT, 2, &
+               [dim2_name, dim1_name], "ObsValue", fillValue = -999.0)
+            status = netcdfPutAtt(netcdfID, "units", "K", varName = trim(ncname), groupName = "ObsValue")
+            status = netcdfAddVar(netcdfID, ncname, NF90_FLOAT, 2, &
+               [dim2_name, dim1_name], "ObsError", fillValue = -999.0)
+            status = netcdfPutAtt(netcdfID, "units", "K", varName = trim(ncname), groupName = "ObsError")
+            status = netcdfAddVar(netcdfID, ncname, NF90_INT, 2, &
+               [dim2_name, dim1_name], "PreQC", fillValue = -999)
          end if
-      end do var_info_def_loop ! nvar_info
 
-      if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
-         do i = 1, nsen_info
-            ncname = trim(name_sen_info(i))
-            idim = ufo_vars_getindex(name_ncdim, dim_sen_info(1,i))
+         var_info_def_loop: do i = 1, nvar_info
+            if ( write_opt == write_nc_conv ) then
+               iflag = iflag_conv(i,ityp)
+            else if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
+               iflag = iflag_radiance(i)
+            end if
+            if ( iflag /= itrue ) cycle var_info_def_loop
+            ncname = trim(name_var_info(i))
+            idim = ufo_vars_getindex(name_ncdim, dim_var_info(1,i))
             dim1 = ncid_ncdim(idim)
             dim1_name = get_dim_name(dim1, nchans_nvars_flag)
-            if ( ufo_vars_getindex(name_ncdim, dim_sen_info(2,i)) > 0 ) then
-               idim = ufo_vars_getindex(name_ncdim, dim_sen_info(2,i))
-               dim2 = ncid_ncdim(idim)
-               dim2_name = get_dim_name(dim2, nchans_nvars_flag)
-               status = netcdfAddVar(netcdfID, ncname, type_sen_info(i), 2, &
-                  [dim2_name, dim1_name], "MetaData")
+            if (ncname == 'dateTime') then
+               status = netcdfAddVar(netcdfID, ncname, type_var_info(i), 1, &
+                  [dim1_name], "MetaData")
+               status = netcdfPutAtt(netcdfID, "units", "seconds since 1970-01-01T00:00:00Z", varName = trim(ncname), &
+                  groupName = "MetaData")
             else
-               if (ncname == 'scan_position') then
-                  status = netcdfAddVar(netcdfID, ncname, nf90_int, 1, &
-                     [dim1_name], "MetaData", fillValue = -999)
+               if (type_var_info(i) == nf90_char) then
+                  idim = ufo_vars_getindex(name_ncdim, dim_var_info(2,i))
+                  dim2 = ncid_ncdim(idim)
+                  dim2_name = get_dim_name(dim2, nchans_nvars_flag)
+                  status = netcdfAddVar(netcdfID, ncname, nf90_string, 1, &
+                     [dim2_name], "MetaData")
+                  status = netcdfSetFill(netcdfID, ncname, 1, " ", "MetaData")
                else
-                  status = netcdfAddVar(netcdfID, ncname, type_sen_info(i), 1, &
+                  status = netcdfAddVar(netcdfID, ncname, type_var_info(i), 1, &
                      [dim1_name], "MetaData")
+                  if (type_var_info(i) == NF90_INT) then
+                     status = netcdfSetFill(netcdfID, ncname, 1, -999, "MetaData")
+                  else if (type_var_info(i) == NF90_FLOAT) then
+                     status = netcdfSetFill(netcdfID, ncname, 1, -999.0, "MetaData")
+                  end if
                end if
             end if
-            if (type_sen_info(i) == NF90_INT) then
-               status = netcdfSetFill(netcdfID, ncname, 1, -999, "MetaData")
-            else if (type_sen_info(i) == NF90_FLOAT .and. ncname /= "scan_position") then
-               status = netcdfSetFill(netcdfID, ncname, 1, -999.0, "MetaData")
+         end do var_info_def_loop ! nvar_info
+
+         if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
+            do i = 1, nsen_info
+               ncname = trim(name_sen_info(i))
+               idim = ufo_vars_getindex(name_ncdim, dim_sen_info(1,i))
+               dim1 = ncid_ncdim(idim)
+               dim1_name = get_dim_name(dim1, nchans_nvars_flag)
+               if ( ufo_vars_getindex(name_ncdim, dim_sen_info(2,i)) > 0 ) then
+                  idim = ufo_vars_getindex(name_ncdim, dim_sen_info(2,i))
+                  dim2 = ncid_ncdim(idim)
+                  dim2_name = get_dim_name(dim2, nchans_nvars_flag)
+                  status = netcdfAddVar(netcdfID, ncname, type_sen_info(i), 2, &
+                     [dim2_name, dim1_name], "MetaData")
+               else
+                  if (ncname == 'scan_position') then
+                     status = netcdfAddVar(netcdfID, ncname, nf90_int, 1, &
+                        [dim1_name], "MetaData", fillValue = -999)
+                  else
+                     status = netcdfAddVar(netcdfID, ncname, type_sen_info(i), 1, &
+                        [dim1_name], "MetaData")
+                  end if
+               end if
+               if (type_sen_info(i) == NF90_INT) then
+                  status = netcdfSetFill(netcdfID, ncname, 1, -999, "MetaData")
+               else if (type_sen_info(i) == NF90_FLOAT .and. ncname /= "scan_position") then
+                  status = netcdfSetFill(netcdfID, ncname, 1, -999.0, "MetaData")
+               end if
+            end do ! nsen_info
+            if ( has_wavenumber == itrue ) then
+               idim = ufo_vars_getindex(name_ncdim, 'nvars')
+               dim1 = ncid_ncdim(idim)
+               dim1_name = get_dim_name(dim1, nchans_nvars_flag)
+               status = netcdfAddVar(netcdfID, 'sensor_band_central_radiation_wavenumber', NF90_FLOAT, 1, &
+                  [dim1_name], "MetaData", fillValue = -999.0)
             end if
-         end do ! nsen_info
-         if ( has_wavenumber == itrue ) then
-            idim = ufo_vars_getindex(name_ncdim, 'nvars')
-            dim1 = ncid_ncdim(idim)
-            dim1_name = get_dim_name(dim1, nchans_nvars_flag)
-            status = netcdfAddVar(netcdfID, 'sensor_band_central_radiation_wavenumber', NF90_FLOAT, 1, &
-               [dim1_name], "MetaData", fillValue = -999.0)
+         end if ! write_nc_radiance
+
+         if ( write_record_number ) then
+            idim = ufo_vars_getindex(name_ncdim, 'nlocs')
+            dim1_name = get_dim_name(ncid_ncdim(idim), nchans_nvars_flag)
+            status = netcdfAddVar(netcdfID, 'sequenceNumber', NF90_INT, 1, [dim1_name], "MetaData", fillValue = -999)
          end if
-      end if ! write_nc_radiance
 
+         if ( .not. distributed ) then
+            call save_layout(netcdfID, layouts(write_opt,ityp), xdata(ityp,itim)%var_idx, has_wavenumber)
+         end if
+
+      end if ! layout_matches
+
+      ! define attributes that differ from file to file
+      ! the dimension attributes are 32-bit; the dimensions themselves hold the full lengths
+      do i = 1, n_ncdim
+         status = netcdfPutAtt(netcdfID, trim(dim_names(i)), int(min(val_ncdim(i), int(huge(i), i_llong)), i_kind))
+      end do
+      status = netcdfPutAtt(netcdfID, "min_datetime", xdata(ityp, itim)%min_datetime)
+      status = netcdfPutAtt(netcdfID, "max_datetime", xdata(ityp, itim)%max_datetime)
 
       ! writing netcdf variables
       if ( write_opt == write_nc_conv ) then
@@ -286,32 +534,32 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
          end do var_loop
       else if ( write_opt == write_nc_radiance .or. write_opt == write_nc_radiance_geo ) then
          ncname = "nchans"
-         status = netcdfPutVar(netcdfID, ncname, ichan(:))
-         allocate(rtmp2d(xdata(ityp,itim)%nvars, xdata(ityp,itim)%nlocs))
+         status = netcdfPutVar(netcdfID, ncname, ichan(:), start = [1], count = [chan_count])
+         allocate(rtmp2d(xdata(ityp,itim)%nvars, nlocs_local))
          ncname = trim(var_tb)
          do jj = 1, xdata(ityp,itim)%nvars
-            do ii = 1, xdata(ityp,itim)%nlocs
+            do ii = 1, nlocs_local
                rtmp2d(jj,ii) = xdata(ityp,itim)%xfield(ii,jj)%val
             end do
          end do
          status = netcdfPutVar(netcdfID, ncname, &
-            reshape(rtmp2d(:,:), [xdata(ityp, itim)%nvars * xdata(ityp, itim)%nlocs]), &
-            "ObsValue")
-         do ii = 1, xdata(ityp,itim)%nlocs
+            reshape(rtmp2d(:,:), [xdata(ityp, itim)%nvars * nlocs_local]), &
+            "ObsValue", start = [loc_start, 1_i_llong], count = [nlocs_local, int(xdata(ityp, itim)%nvars, i_llong)])
+         do ii = 1, nlocs_local
             rtmp2d(:,ii) = obserr(:)
          end do
          status = netcdfPutVar(netcdfID, ncname, &
-            reshape(rtmp2d(:, :), [xdata(ityp, itim)%nvars * xdata(ityp, itim)%nlocs]), &
-            "ObsError")
+            reshape(rtmp2d(:, :), [xdata(ityp, itim)%nvars * nlocs_local]), &
+            "ObsError", start = [loc_start, 1_i_llong], count = [nlocs_local, int(xdata(ityp, itim)%nvars, i_llong)])
          do jj = 1, xdata(ityp, itim)%nvars
-            do ii = 1, xdata(ityp, itim)%nlocs
+            do ii = 1, nlocs_local
                rtmp2d(jj, ii) = xdata(ityp, itim)%xfield(ii, jj)%qm
             end do
          end do
          ! netcdfPutVar expects a 1D variable, but rtmp2d is 2D, so you need to flatten it before passing it to netcdfPutVar.
          status = netcdfPutVar(netcdfID, ncname, &
-            reshape(rtmp2d(:,:), [xdata(ityp, itim)%nvars * xdata(ityp, itim)%nlocs]), &
-            "PreQC")
+            reshape(rtmp2d(:,:), [xdata(ityp, itim)%nvars * nlocs_local]), &
+            "PreQC", start = [loc_start, 1_i_llong], count = [nlocs_local, int(xdata(ityp, itim)%nvars, i_llong)])
          deallocate(rtmp2d)
       end if
 
@@ -324,30 +572,26 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
          if ( iflag /= itrue ) cycle var_info_loop
          ncname = trim(name_var_info(i))
          if ( type_var_info(i) == nf90_int ) then
-            status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xinfo_int(:, i), "MetaData")
+            status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xinfo_int(:, i), "MetaData", &
+               start = [loc_start], count = [nlocs_local])
          else if (type_var_info(i) == nf90_float) then
-            status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xinfo_float(:, i), "MetaData")
+            status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xinfo_float(:, i), "MetaData", &
+               start = [loc_start], count = [nlocs_local])
          else if ( type_var_info(i) == nf90_char ) then
             if ( trim(name_var_info(i)) == 'variable_names' ) then
                if ( write_opt == write_nc_conv ) then
                   status = netcdfPutVar(netcdfID, ncname, name_var_met(xdata(ityp, itim)%var_idx(:)), "MetaData")
                end if
             else if ( trim(name_var_info(i)) == 'station_id' ) then
-               allocate(str_nstring(xdata(ityp,itim)%nlocs))
+               allocate(str_nstring(nlocs_local))
                str_nstring(:) = xdata(ityp,itim)%xinfo_char(:,i)
-               status = netcdfPutVar(netcdfID, ncname, str_nstring, "MetaData")
+               status = netcdfPutVar(netcdfID, ncname, str_nstring, "MetaData", &
+                  start = [loc_start], count = [nlocs_local])
                deallocate(str_nstring)
-            else if ( trim(name_var_info(i)) == 'datetime' ) then
-               allocate(str_ndatetime(xdata(ityp,itim)%nlocs))
-               do ii = 1, xdata(ityp,itim)%nlocs
-                  str_tmp = xdata(ityp,itim)%xinfo_char(ii,i)
-                  str_ndatetime(ii) = str_tmp(1:ndatetime)
-               end do
-               status = netcdfPutVar(netcdfID, ncname, str_ndatetime, "MetaData")
-               deallocate(str_ndatetime)
             end if
          else if (type_var_info(i) == nf90_int64) then
-            status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xinfo_int64(:, i), "MetaData")
+            status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xinfo_int64(:, i), "MetaData", &
+               start = [loc_start], count = [nlocs_local])
          end if
       end do var_info_loop
 
@@ -355,30 +599,43 @@ subroutine write_obs (filedate, write_opt, outdir, itim)
          do i = 1, nsen_info
             ncname = trim(name_sen_info(i))
             if (type_sen_info(i) == nf90_int) then
-               status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xseninfo_int(:, i), "MetaData")
+               status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xseninfo_int(:, i), "MetaData", &
+                  start = [1], count = [chan_count])
             else if (type_sen_info(i) == nf90_float) then
-               if (trim(ncname) == "scan_position") then
-                  allocate(scan_position_values(xdata(ityp, itim)%nlocs))
-                  do scan_position_idx = 1, xdata(ityp, itim)%nlocs
-                     scan_position_values(scan_position_idx) = int(xdata(ityp, itim)%xseninfo_float(scan_position_idx, i), i_kind)
-                  end do
-                  status = netcdfPutVar(netcdfID, ncname, scan_position_values(:), "MetaData")
-                  deallocate(scan_position_values)
-               else
-                  status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xseninfo_float(:, i), "MetaData")
-               end if
+               ! scan_position is stored as an integer; the values are truncated as they are written
+               status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xseninfo_float(:, i), "MetaData", &
+                  start = [loc_start], count = [nlocs_local])
             else if (type_sen_info(i) == nf90_char) then
                status = netcdfPutVar(netcdfID, ncname, xdata(ityp, itim)%xseninfo_char(:, i), "MetaData")
             end if
          end do
          if (has_wavenumber == itrue) then
             status = netcdfPutVar(netcdfID, 'sensor_band_central_radiation_wavenumber', &
-               xdata(ityp, itim)%wavenumber(:), "MetaData")
+               xdata(ityp, itim)%wavenumber(:), "MetaData", start = [1], count = [chan_count])
          end if
          deallocate (ichan)
          deallocate (obserr)
       end if ! write_nc_radiance
 
+      if ( write_record_number ) then
+         ! sequenceNumber is an int in IODA
+         if ( nrecords > huge(1_i_kind) ) then
+            write(*,*) ' Error: too many records for MetaData/sequenceNumber in ', trim(ncfname), ': ', nrecords
+         else
+            status = netcdfPutVar(netcdfID, 'sequenceNumber', int(record_number(:), i_kind), "MetaData", &
+               start = [loc_start], count = [nlocs_local])
+         end if
+      end if
+      if ( allocated(record_number) ) deallocate (record_number)
+
+      ! the spatial index describes blocks of the whole file, which one rank alone does not hold
+      if ( spatial_order .and. .not. distributed ) then
+         status = netcdfPutSpatialIndex(netcdfID, &
+            xdata(ityp,itim)%xinfo_float(:,ufo_vars_getindex(name_var_info, 'latitude')), &
+            xdata(ityp,itim)%xinfo_float(:,ufo_vars_getindex(name_var_info, 'longitude')), &
+            xdata(ityp,itim)%xinfo_int64(:,ufo_vars_getindex(name_var_info, 'dateTime')))
+      end if
+
       status = netcdfClose(netcdfID)
 
    end do obtype_loop
@@ -1,8 +1,31 @@
 module netcdf_cxx_i_mod
-    use iso_c_binding, only: c_int, c_ptr, c_float, c_long
+    use iso_c_binding, only: c_int, c_ptr, c_float, c_double, c_long, c_long_long, c_char, c_size_t
     implicit none
     public
 
+    ! netcdf_file_options:
+    !   HDF5 file-creation and file-access tuning, mirroring `NetcdfFileOptions`
+    !   of netcdf_file_options.h. Sizes are in bytes and 0 keeps the HDF5 default.
+    type, bind(C) :: netcdf_file_options
+        integer(c_long_long) :: metadataCacheSize = 0   ! initial and maximum metadata cache size
+        integer(c_long_long) :: pageSize = 0            ! file-space page size, > 0 for paged aggregation
+        integer(c_long_long) :: pageBufferSize = 0      ! page buffer size, a multiple of pageSize
+        integer(c_long_long) :: alignment = 0           ! alignment of large objects, e.g. the Lustre stripe size
+        integer(c_long_long) :: alignmentThreshold = 0  ! smallest object that is aligned
+        integer(c_int) :: collectiveMetadataWrite = 1   ! parallel files: write metadata collectively
+    end type netcdf_file_options
+
+    ! geos_projection:
+    !   The geostationary projection of a fixed grid, mirroring `GeosProjection`
+    !   of geometry.h. The distances may be in any unit, the same for all.
+    type, bind(C) :: geos_projection
+        real(c_double) :: subLon = 0.0    ! longitude of the sub-satellite point in degrees
+        real(c_double) :: satDist = 0.0   ! distance from the centre of the earth to the satellite
+        real(c_double) :: rEq = 0.0       ! equatorial radius of the earth
+        real(c_double) :: rPol = 0.0      ! polar radius of the earth
+        integer(c_int) :: sweepX = 0      ! 1 if the sweep angle axis is x (GOES-R), 0 if y (Himawari)
+    end type geos_projection
+
     interface
         ! c_netcdfCreate:
         !   Creates a new NetCDF file or opens an existing file in a specified mode.
@@ -44,6 +67,144 @@ module netcdf_cxx_i_mod
             integer(c_int) :: c_netcdfClose
         end function
 
+        ! c_netcdfSaveLayout:
+        !   Captures the dimensions, groups, variables and attributes of an open NetCDF
+        !   file as a reusable layout.
+        !
+        !   Arguments:
+        !     - netcdfID (integer(c_int), intent(in), value): The identifier of the
+        !       NetCDF file whose layout is captured.
+        !     - layoutID (integer(c_int), intent(out)): Receives the identifier of
+        !       the captured layout.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfSaveLayout(netcdfID, layoutID) &
+                bind(C, name = "netcdfSaveLayout")
+            import :: c_int
+            integer(c_int), value, intent(in) :: netcdfID
+            integer(c_int), intent(out) :: layoutID
+            integer(c_int) :: c_netcdfSaveLayout
+        end function c_netcdfSaveLayout
+
+        ! c_netcdfCreateFromLayout:
+        !   Creates a new NetCDF file whose definitions are replayed from a captured
+        !   layout, overriding the lengths of the given dimensions.
+        !
+        !   Arguments:
+        !     - path (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string representing the file path.
+        !     - layoutID (integer(c_int), intent(in), value): The identifier of the layout.
+        !     - numDims (integer(c_int), intent(in), value): The number of dimension
+        !       lengths to override.
+        !     - dimNames (type(c_ptr), intent(in), value): A C pointer to an array of
+        !       null-terminated strings with the names of the dimensions to override.
+        !     - dimLens (integer(c_size_t), dimension(*), intent(in)): The new dimension lengths.
+        !     - netcdfID (integer(c_int), intent(out)): Receives the file identifier
+        !       for the created NetCDF file.
+        !     - fileMode (integer(c_int), intent(in), value): File mode for creating the NetCDF file.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfCreateFromLayout(path, layoutID, numDims, dimNames, dimLens, netcdfID, fileMode) &
+                bind(C, name = "netcdfCreateFromLayout")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            type(c_ptr), value, intent(in) :: path
+            integer(c_int), value, intent(in) :: layoutID
+            integer(c_int), value, intent(in) :: numDims
+            type(c_ptr), value, intent(in) :: dimNames
+            integer(c_size_t), dimension(*), intent(in) :: dimLens
+            integer(c_int), intent(out) :: netcdfID
+            integer(c_int), value, intent(in) :: fileMode
+            integer(c_int) :: c_netcdfCreateFromLayout
+        end function c_netcdfCreateFromLayout
+
+        ! c_netcdfFreeLayout:
+        !   Releases a layout captured by c_netcdfSaveLayout.
+        !
+        !   Arguments:
+        !     - layoutID (integer(c_int), intent(in), value): The identifier of the layout.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfFreeLayout(layoutID) &
+                bind(C, name = "netcdfFreeLayout")
+            import :: c_int
+            integer(c_int), value, intent(in) :: layoutID
+            integer(c_int) :: c_netcdfFreeLayout
+        end function c_netcdfFreeLayout
+
+        ! c_netcdfCopy:
+        !   Copies a NetCDF dataset, definitions and data, to a new file. Paths ending
+        !   in `.zarr` are NCZarr directory stores, all others HDF5 files.
+        !
+        !   Arguments:
+        !     - srcPath (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the path of the dataset to copy.
+        !     - dstPath (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the path of the copy.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfCopy(srcPath, dstPath) &
+                bind(C, name = "netcdfCopy")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: srcPath
+            type(c_ptr), value, intent(in) :: dstPath
+            integer(c_int) :: c_netcdfCopy
+        end function c_netcdfCopy
+
+        ! c_netcdfMerge:
+        !   Concatenates IODA files with the same variables along the location
+        !   dimension, streaming the data block by block.
+        !
+        !   Arguments:
+        !     - numInputs (integer(c_int), intent(in), value): The number of input files.
+        !     - inputPaths (type(c_ptr), intent(in), value): A C pointer to an array of
+        !       pointers to null-terminated strings with the paths of the inputs.
+        !     - outputPath (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the path of the merged file.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfMerge(numInputs, inputPaths, outputPath) &
+                bind(C, name = "netcdfMerge")
+            import :: c_int
+            import :: c_ptr
+            integer(c_int), value, intent(in) :: numInputs
+            type(c_ptr), value, intent(in) :: inputPaths
+            type(c_ptr), value, intent(in) :: outputPath
+            integer(c_int) :: c_netcdfMerge
+        end function c_netcdfMerge
+
+        ! c_netcdfSplit:
+        !   Partitions an IODA file into time windows centred on multiples of
+        !   windowSeconds, one file <outputPrefix><ccyymmddhh><extension> per window.
+        !
+        !   Arguments:
+        !     - inputPath (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the path of the file to split.
+        !     - outputPrefix (type(c_ptr), intent(in), value): A C pointer to a
+        !       null-terminated string with the path of the outputs up to their date.
+        !     - windowSeconds (integer(c_int), intent(in), value): The window length.
+        !     - numOutputs (integer(c_int), intent(out)): The number of files written.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfSplit(inputPath, outputPrefix, windowSeconds, numOutputs) &
+                bind(C, name = "netcdfSplit")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: inputPath
+            type(c_ptr), value, intent(in) :: outputPrefix
+            integer(c_int), value, intent(in) :: windowSeconds
+            integer(c_int), intent(out) :: numOutputs
+            integer(c_int) :: c_netcdfSplit
+        end function c_netcdfSplit
+
         ! c_netcdfAddGroup:
         !   Adds a new group to a NetCDF file under a specified parent group.
         !
@@ -89,8 +250,8 @@ module netcdf_cxx_i_mod
         !       where the dimension will be created. If creating a global dimension, pass `c_null_ptr`.
         !     - dimName (type(c_ptr), intent(in), value):
         !       A C pointer to a null-terminated string specifying the name of the new dimension.
-        !     - len (integer(c_int), intent(in), value):
-        !       The length of the new dimension.
+        !     - len (integer(c_size_t), intent(in), value):
+        !       The length of the new dimension, or 0 for an unlimited dimension.
         !     - dimID (integer(c_int), intent(out)):
         !      Receives the identifier of the newly created dimension.
         !
@@ -108,14 +269,47 @@ module netcdf_cxx_i_mod
                 bind(C, name = "netcdfAddDim")
             import :: c_int
             import :: c_ptr
+            import :: c_size_t
             integer(c_int), value, intent(in) :: netcdfID
             type(c_ptr), value, intent(in) :: groupName
             type(c_ptr), value, intent(in) :: dimName
-            integer(c_int), value, intent(in) :: len
+            integer(c_size_t), value, intent(in) :: len
             integer(c_int), intent(out) :: dimID
             integer(c_int) :: c_netcdfAddDim
         end function c_netcdfAddDim
 
+        ! c_netcdfGetDimLen:
+        !   Retrieves the current length of a dimension, e.g. of an unlimited
+        !   location dimension before locations are appended.
+        !
+        !   Arguments:
+        !     - netcdfID (integer(c_int), intent(in), value):
+        !       The identifier of the NetCDF file.
+        !     - groupName (type(c_ptr), intent(in), value):
+        !       A C pointer to a null-terminated string specifying the name of the group
+        !       of the dimension. For a global dimension, pass `c_null_ptr`.
+        !     - dimName (type(c_ptr), intent(in), value):
+        !       A C pointer to a null-terminated string specifying the name of the dimension.
+        !     - len (integer(c_size_t), intent(out)):
+        !       Receives the length of the dimension.
+        !
+        !   Returns:
+        !     - integer(c_int): Status code indicating the result of the operation:
+        !         - 0: Success.
+        !         - Non-zero: Failure.
+        function c_netcdfGetDimLen(&
+                netcdfID, groupName, dimName, len) &
+                bind(C, name = "netcdfGetDimLen")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: dimName
+            integer(c_size_t), intent(out) :: len
+            integer(c_int) :: c_netcdfGetDimLen
+        end function c_netcdfGetDimLen
+
         ! c_netcdfAddVar:
         !   Adds a new variable to a NetCDF file, specifying its name, type, and associated dimensions.
         !
@@ -251,6 +445,320 @@ module netcdf_cxx_i_mod
             integer(c_int) :: c_netcdfPutVarChar
         end function c_netcdfPutVarChar
 
+        ! c_netcdfPutVarSlab:
+        !   Writes a hyperslab of a NetCDF variable in the specified group or as a global variable.
+        !   In a file created with `c_netcdfCreatePar` the write is collective.
+        !
+        !   Arguments:
+        !     - netcdfID (integer(c_int), intent(in), value):
+        !       The identifier of the NetCDF file.
+        !     - groupName (type(c_ptr), intent(in), value):
+        !       A C pointer to a null-terminated string specifying the group name. If `c_null_ptr`,
+        !       the variable is assumed to be a global variable.
+        !     - varName (type(c_ptr), intent(in), value):
+        !       A C pointer to a null-terminated string specifying the variable name.
+        !     - numDims (integer(c_int), intent(in), value):
+        !       The number of dimensions of the variable.
+        !     - start (integer(c_size_t), dimension(numDims), intent(in)):
+        !       Zero-based index of the first element written, in C dimension order.
+        !     - count (integer(c_size_t), dimension(numDims), intent(in)):
+        !       Number of elements written, in C dimension order.
+        !     - values (type(c_ptr), intent(in), value):
+        !       A C pointer to the array of integer data to be written.
+        !
+        !   Returns:
+        !     - integer(c_int): Status code indicating the result of the operation:
+        !         - 0: Success.
+        !         - Non-zero: Failure.
+        function c_netcdfPutVarSlabInt(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfPutVarSlabInt")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value, intent(in) :: values
+            integer(c_int) :: c_netcdfPutVarSlabInt
+        end function c_netcdfPutVarSlabInt
+
+        ! See documentation for `c_netcdfPutVarSlabInt`.
+        function c_netcdfPutVarSlabInt64(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfPutVarSlabInt64")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value, intent(in) :: values
+            integer(c_int) :: c_netcdfPutVarSlabInt64
+        end function c_netcdfPutVarSlabInt64
+
+        ! See documentation for `c_netcdfPutVarSlabInt`.
+        function c_netcdfPutVarSlabReal(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfPutVarSlabReal")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value, intent(in) :: values
+            integer(c_int) :: c_netcdfPutVarSlabReal
+        end function c_netcdfPutVarSlabReal
+
+        ! See documentation for `c_netcdfPutVarSlabInt`.
+        function c_netcdfPutVarSlabDouble(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfPutVarSlabDouble")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value, intent(in) :: values
+            integer(c_int) :: c_netcdfPutVarSlabDouble
+        end function c_netcdfPutVarSlabDouble
+
+        ! See documentation for `c_netcdfPutVarSlabInt`.
+        function c_netcdfPutVarSlabString(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfPutVarSlabString")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value, intent(in) :: values
+            integer(c_int) :: c_netcdfPutVarSlabString
+        end function c_netcdfPutVarSlabString
+
+        ! c_netcdfInqVar:
+        !   Inquires the type and shape of a variable in a NetCDF file.
+        !
+        !   Arguments:
+        !     - netcdfID (integer(c_int), intent(in), value): The identifier of the NetCDF file.
+        !     - groupName (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the name of the group, or c_null_ptr for a global variable.
+        !     - varName (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the name of the variable.
+        !     - netcdfDataType (integer(c_int), intent(out)): The NetCDF type of the variable.
+        !     - numDims (integer(c_int), intent(out)): The number of dimensions.
+        !     - maxDims (integer(c_int), intent(in), value): The size of dimLens.
+        !     - dimLens (integer(c_size_t), dimension(maxDims), intent(out)): The current
+        !       length of each dimension, in C order, up to maxDims of them.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfInqVar(netcdfID, groupName, varName, netcdfDataType, numDims, maxDims, dimLens) &
+                bind(C, name = "netcdfInqVar")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), intent(out) :: netcdfDataType
+            integer(c_int), intent(out) :: numDims
+            integer(c_int), value, intent(in) :: maxDims
+            integer(c_size_t), dimension(maxDims), intent(out) :: dimLens
+            integer(c_int) :: c_netcdfInqVar
+        end function c_netcdfInqVar
+
+        ! c_netcdfGetVarInt:
+        !   Reads all values of a variable in a NetCDF file, converted to the type of
+        !   the function, in C (row-major) order.
+        !
+        !   Arguments:
+        !     - netcdfID (integer(c_int), intent(in), value): The identifier of the NetCDF file.
+        !     - groupName (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the name of the group, or c_null_ptr for a global variable.
+        !     - varName (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the name of the variable.
+        !     - values (type(c_ptr), value): A C pointer to the array receiving the values.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfGetVarInt(netcdfID, groupName, varName, values) &
+                bind(C, name = "netcdfGetVarInt")
+            import :: c_int
+            import :: c_ptr
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            type(c_ptr), value :: values
+            integer(c_int) :: c_netcdfGetVarInt
+        end function c_netcdfGetVarInt
+
+        ! See documentation for `c_netcdfGetVarInt`.
+        function c_netcdfGetVarInt64(netcdfID, groupName, varName, values) &
+                bind(C, name = "netcdfGetVarInt64")
+            import :: c_int
+            import :: c_ptr
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            type(c_ptr), value :: values
+            integer(c_int) :: c_netcdfGetVarInt64
+        end function c_netcdfGetVarInt64
+
+        ! See documentation for `c_netcdfGetVarInt`.
+        function c_netcdfGetVarReal(netcdfID, groupName, varName, values) &
+                bind(C, name = "netcdfGetVarReal")
+            import :: c_int
+            import :: c_ptr
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            type(c_ptr), value :: values
+            integer(c_int) :: c_netcdfGetVarReal
+        end function c_netcdfGetVarReal
+
+        ! See documentation for `c_netcdfGetVarInt`.
+        function c_netcdfGetVarDouble(netcdfID, groupName, varName, values) &
+                bind(C, name = "netcdfGetVarDouble")
+            import :: c_int
+            import :: c_ptr
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            type(c_ptr), value :: values
+            integer(c_int) :: c_netcdfGetVarDouble
+        end function c_netcdfGetVarDouble
+
+        ! c_netcdfGetVarSlabInt:
+        !   Reads a hyperslab of a variable in a NetCDF file.
+        !
+        !   Arguments:
+        !     - netcdfID, groupName, varName: As for c_netcdfGetVarInt.
+        !     - numDims (integer(c_int), intent(in), value): The number of dimensions.
+        !     - start (integer(c_size_t), dimension(numDims), intent(in)): Zero-based index of
+        !       the first element read, per dimension, in C order.
+        !     - count (integer(c_size_t), dimension(numDims), intent(in)): Number of elements
+        !       read, per dimension.
+        !     - values (type(c_ptr), value): A C pointer to the array receiving the values.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfGetVarSlabInt(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfGetVarSlabInt")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value :: values
+            integer(c_int) :: c_netcdfGetVarSlabInt
+        end function c_netcdfGetVarSlabInt
+
+        ! See documentation for `c_netcdfGetVarSlabInt`.
+        function c_netcdfGetVarSlabInt64(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfGetVarSlabInt64")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value :: values
+            integer(c_int) :: c_netcdfGetVarSlabInt64
+        end function c_netcdfGetVarSlabInt64
+
+        ! See documentation for `c_netcdfGetVarSlabInt`.
+        function c_netcdfGetVarSlabReal(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfGetVarSlabReal")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value :: values
+            integer(c_int) :: c_netcdfGetVarSlabReal
+        end function c_netcdfGetVarSlabReal
+
+        ! See documentation for `c_netcdfGetVarSlabInt`.
+        function c_netcdfGetVarSlabDouble(&
+                netcdfID, groupName, varName, numDims, start, count, values) &
+                bind(C, name = "netcdfGetVarSlabDouble")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            type(c_ptr), value :: values
+            integer(c_int) :: c_netcdfGetVarSlabDouble
+        end function c_netcdfGetVarSlabDouble
+
+        ! c_netcdfGetVarSlabString:
+        !   Reads a hyperslab of a string variable as blank-padded strings of stringLen
+        !   characters. For NC_CHAR variables the last dimension is the string length
+        !   and is not part of start and count.
+        !
+        !   Arguments:
+        !     - netcdfID, groupName, varName, numDims, start, count: As for c_netcdfGetVarSlabInt.
+        !     - stringLen (integer(c_int), intent(in), value): The length of each string.
+        !     - values (character(kind=c_char), dimension(*), intent(out)): The strings,
+        !       one after the other, without terminators.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfGetVarSlabString(&
+                netcdfID, groupName, varName, numDims, start, count, stringLen, values) &
+                bind(C, name = "netcdfGetVarSlabString")
+            import :: c_int
+            import :: c_ptr
+            import :: c_size_t
+            import :: c_char
+            integer(c_int), value, intent(in) :: netcdfID
+            type(c_ptr), value, intent(in) :: groupName
+            type(c_ptr), value, intent(in) :: varName
+            integer(c_int), value, intent(in) :: numDims
+            integer(c_size_t), dimension(numDims), intent(in) :: start
+            integer(c_size_t), dimension(numDims), intent(in) :: count
+            integer(c_int), value, intent(in) :: stringLen
+            character(kind = c_char), dimension(*), intent(out) :: values
+            integer(c_int) :: c_netcdfGetVarSlabString
+        end function c_netcdfGetVarSlabString
+
         ! c_netcdfSetFillInt:
         !   Sets the fill mode and fill value for an NetCDF variable in the specified group
         !   or as a global variable.
@@ -405,6 +913,678 @@ module netcdf_cxx_i_mod
             integer(c_int) :: c_netcdfPutAttString
         end function c_netcdfPutAttString
 
+        ! c_netcdfParallelInit:
+        !   Initializes MPI if needed. Without MPI support the process is rank 0 of 1.
+        !
+        !   Arguments:
+        !     - comm (integer(c_int), intent(out)): Fortran handle of MPI_COMM_WORLD.
+        !     - rank (integer(c_int), intent(out)): Rank of this process.
+        !     - size (integer(c_int), intent(out)): Number of ranks.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfParallelInit(comm, rank, size) &
+                bind(C, name = "netcdfParallelInit")
+            import :: c_int
+            integer(c_int), intent(out) :: comm
+            integer(c_int), intent(out) :: rank
+            integer(c_int), intent(out) :: size
+            integer(c_int) :: c_netcdfParallelInit
+        end function c_netcdfParallelInit
+
+        ! c_netcdfParallelFinalize:
+        !   Finalizes MPI if it was initialized by `c_netcdfParallelInit`.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfParallelFinalize() &
+                bind(C, name = "netcdfParallelFinalize")
+            import :: c_int
+            integer(c_int) :: c_netcdfParallelFinalize
+        end function c_netcdfParallelFinalize
+
+        ! c_netcdfParallelExscan:
+        !   Computes the zero-based offset of the local items in the concatenation of all
+        !   ranks (exclusive prefix sum) and the total number of items.
+        !
+        !   Arguments:
+        !     - comm (integer(c_int), intent(in), value): Fortran handle of the communicator.
+        !     - localCount (integer(c_long_long), intent(in), value): Number of local items.
+        !     - offset (integer(c_long_long), intent(out)): Offset of the local items.
+        !     - total (integer(c_long_long), intent(out)): Number of items of all ranks.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfParallelExscan(comm, localCount, offset, total) &
+                bind(C, name = "netcdfParallelExscan")
+            import :: c_int
+            import :: c_long_long
+            integer(c_int), value, intent(in) :: comm
+            integer(c_long_long), value, intent(in) :: localCount
+            integer(c_long_long), intent(out) :: offset
+            integer(c_long_long), intent(out) :: total
+            integer(c_int) :: c_netcdfParallelExscan
+        end function c_netcdfParallelExscan
+
+        ! c_netcdfParallelReduceInt:
+        !   Reduces an integer over the ranks of a communicator.
+        !
+        !   Arguments:
+        !     - comm (integer(c_int), intent(in), value): Fortran handle of the communicator.
+        !     - value (integer(c_int), intent(in), value): Value of this rank.
+        !     - reduceOp (integer(c_int), intent(in), value): 0 for min, 1 for max, 2 for sum.
+        !     - result (integer(c_int), intent(out)): Reduced value.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfParallelReduceInt(comm, value, reduceOp, result) &
+                bind(C, name = "netcdfParallelReduceInt")
+            import :: c_int
+            integer(c_int), value, intent(in) :: comm
+            integer(c_int), value, intent(in) :: value
+            integer(c_int), value, intent(in) :: reduceOp
+            integer(c_int), intent(out) :: result
+            integer(c_int) :: c_netcdfParallelReduceInt
+        end function c_netcdfParallelReduceInt
+
+        ! c_netcdfParallelReduceString:
+        !   Finds the lexicographic minimum or maximum of the non-empty strings of all ranks.
+        !
+        !   Arguments:
+        !     - comm (integer(c_int), intent(in), value): Fortran handle of the communicator.
+        !     - value (type(c_ptr), intent(in), value): A C pointer to the null-terminated string of this rank.
+        !     - reduceOp (integer(c_int), intent(in), value): 0 for min, 1 for max.
+        !     - result (character(kind=c_char), dimension(resultLen), intent(out)):
+        !       Receives the null-terminated result.
+        !     - resultLen (integer(c_int), intent(in), value): Size of `result`.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfParallelReduceString(comm, value, reduceOp, result, resultLen) &
+                bind(C, name = "netcdfParallelReduceString")
+            import :: c_int
+            import :: c_ptr
+            import :: c_char
+            integer(c_int), value, intent(in) :: comm
+            type(c_ptr), value, intent(in) :: value
+            integer(c_int), value, intent(in) :: reduceOp
+            integer(c_int), value, intent(in) :: resultLen
+            character(kind = c_char), dimension(resultLen), intent(out) :: result
+            integer(c_int) :: c_netcdfParallelReduceString
+        end function c_netcdfParallelReduceString
+
+        ! c_netcdfCreatePar:
+        !   Collectively creates or opens a NetCDF-4 file shared by all ranks of a communicator.
+        !   Without MPI support it behaves as `c_netcdfCreate`.
+        !
+        !   Arguments:
+        !     - path (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string representing the file path.
+        !     - netcdfID (integer(c_int), intent(inout)): Receives the file identifier.
+        !     - fileMode (integer(c_int), intent(in)): File mode for creating the NetCDF file.
+        !     - comm (integer(c_int), intent(in), value): Fortran handle of the communicator.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfCreatePar(path, netcdfID, fileMode, comm) &
+                bind(C, name = "netcdfCreatePar")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: path
+            integer(c_int), intent(inout) :: netcdfID
+            integer(c_int), value, intent(in) :: fileMode
+            integer(c_int), value, intent(in) :: comm
+            integer(c_int) :: c_netcdfCreatePar
+        end function c_netcdfCreatePar
+
+        ! c_netcdfCreateWithOptions:
+        !   As `c_netcdfCreate`, with the HDF5 tuning of `options` instead of the
+        !   OBS2IODA_HDF5_OPTIONS environment variable.
+        !
+        !   Arguments:
+        !     - path (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string representing the file path.
+        !     - netcdfID (integer(c_int), intent(inout)): Receives the file identifier.
+        !     - fileMode (integer(c_int), intent(in)): File mode for creating the NetCDF file.
+        !     - options (type(netcdf_file_options), intent(in)): The HDF5 tuning.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfCreateWithOptions(path, netcdfID, fileMode, options) &
+                bind(C, name = "netcdfCreateWithOptions")
+            import :: c_int
+            import :: c_ptr
+            import :: netcdf_file_options
+            type(c_ptr), value, intent(in) :: path
+            integer(c_int), intent(inout) :: netcdfID
+            integer(c_int), value, intent(in) :: fileMode
+            type(netcdf_file_options), intent(in) :: options
+            integer(c_int) :: c_netcdfCreateWithOptions
+        end function c_netcdfCreateWithOptions
+
+        ! c_netcdfCreateParWithOptions:
+        !   As `c_netcdfCreatePar`, with the HDF5 tuning of `options` instead of the
+        !   OBS2IODA_HDF5_OPTIONS environment variable.
+        !
+        !   Arguments:
+        !     - path (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string representing the file path.
+        !     - netcdfID (integer(c_int), intent(inout)): Receives the file identifier.
+        !     - fileMode (integer(c_int), intent(in)): File mode for creating the NetCDF file.
+        !     - comm (integer(c_int), intent(in), value): Fortran handle of the communicator.
+        !     - options (type(netcdf_file_options), intent(in)): The HDF5 tuning.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfCreateParWithOptions(path, netcdfID, fileMode, comm, options) &
+                bind(C, name = "netcdfCreateParWithOptions")
+            import :: c_int
+            import :: c_ptr
+            import :: netcdf_file_options
+            type(c_ptr), value, intent(in) :: path
+            integer(c_int), intent(inout) :: netcdfID
+            integer(c_int), value, intent(in) :: fileMode
+            integer(c_int), value, intent(in) :: comm
+            type(netcdf_file_options), intent(in) :: options
+            integer(c_int) :: c_netcdfCreateParWithOptions
+        end function c_netcdfCreateParWithOptions
+
+        ! c_traceInit:
+        !   Enables stage tracing. With an empty or null path the OBS2IODA_TRACE
+        !   environment variable is used; tracing stays off if it is unset too.
+        !
+        !   Arguments:
+        !     - path (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the path of the trace file.
+        !     - rank (integer(c_int), intent(in), value): MPI rank of this process.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_traceInit(path, rank) &
+                bind(C, name = "traceInit")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: path
+            integer(c_int), value, intent(in) :: rank
+            integer(c_int) :: c_traceInit
+        end function c_traceInit
+
+        ! c_traceBegin:
+        !   Starts a stage of the trace.
+        !
+        !   Arguments:
+        !     - name (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the name of the stage.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_traceBegin(name) &
+                bind(C, name = "traceBegin")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: name
+            integer(c_int) :: c_traceBegin
+        end function c_traceBegin
+
+        ! c_traceEnd:
+        !   Ends the innermost stage of the trace.
+        !
+        !   Arguments:
+        !     - name (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the name of the stage.
+        !     - count (integer(c_long_long), intent(in), value): Number of observations
+        !       handled by the stage, or -1.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_traceEnd(name, count) &
+                bind(C, name = "traceEnd")
+            import :: c_int
+            import :: c_ptr
+            import :: c_long_long
+            type(c_ptr), value, intent(in) :: name
+            integer(c_long_long), value, intent(in) :: count
+            integer(c_int) :: c_traceEnd
+        end function c_traceEnd
+
+        ! c_traceFinalize:
+        !   Writes the trace file and prints the stage summary.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_traceFinalize() &
+                bind(C, name = "traceFinalize")
+            import :: c_int
+            integer(c_int) :: c_traceFinalize
+        end function c_traceFinalize
+
+        ! c_channelSelectionLoad:
+        !   Loads the channels kept per radiance instrument from a YAML file.
+        !
+        !   Arguments:
+        !     - path (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the path of the YAML file.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_channelSelectionLoad(path) &
+                bind(C, name = "channelSelectionLoad")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: path
+            integer(c_int) :: c_channelSelectionLoad
+        end function c_channelSelectionLoad
+
+        ! c_channelSelectionGet:
+        !   Retrieves the channels kept for a radiance instrument.
+        !
+        !   Arguments:
+        !     - instrument (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the instrument name, eg. iasi_metop-b.
+        !     - channels (integer(c_int), dimension(maxChannels), intent(out)): Receives
+        !       the sorted channel numbers.
+        !     - maxChannels (integer(c_int), intent(in), value): The size of channels.
+        !     - nChannels (integer(c_int), intent(out)): Number of selected channels,
+        !       -1 if all channels are kept.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_channelSelectionGet(instrument, channels, maxChannels, nChannels) &
+                bind(C, name = "channelSelectionGet")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: instrument
+            integer(c_int), value, intent(in) :: maxChannels
+            integer(c_int), dimension(maxChannels), intent(out) :: channels
+            integer(c_int), intent(out) :: nChannels
+            integer(c_int) :: c_channelSelectionGet
+        end function c_channelSelectionGet
+
+        ! c_netcdfEncodingLoad:
+        !   Loads the output encoding policy, the narrower storage types of output
+        !   variables, from a YAML file.
+        !
+        !   Arguments:
+        !     - path (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the path of the YAML file.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfEncodingLoad(path) &
+                bind(C, name = "netcdfEncodingLoad")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: path
+            integer(c_int) :: c_netcdfEncodingLoad
+        end function c_netcdfEncodingLoad
+
+        ! c_directoryWatchOpen:
+        !   Starts watching a directory for files that are closed after writing or
+        !   moved into it.
+        !
+        !   Arguments:
+        !     - path (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the path of the directory.
+        !     - watchID (integer(c_int), intent(out)): Receives the ID of the watch.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_directoryWatchOpen(path, watchID) &
+                bind(C, name = "directoryWatchOpen")
+            import :: c_int
+            import :: c_ptr
+            type(c_ptr), value, intent(in) :: path
+            integer(c_int), intent(out) :: watchID
+            integer(c_int) :: c_directoryWatchOpen
+        end function c_directoryWatchOpen
+
+        ! c_directoryWatchNext:
+        !   Waits for the next file to arrive in a watched directory.
+        !
+        !   Arguments:
+        !     - watchID (integer(c_int), intent(in), value): The ID of the watch.
+        !     - timeoutMs (integer(c_int), intent(in), value): The longest wait in
+        !       milliseconds, or a negative value to wait forever.
+        !     - name (character(kind=c_char), dimension(nameLen), intent(out)): Receives
+        !       the null-terminated file name, relative to the directory.
+        !     - nameLen (integer(c_int), intent(in), value): The size of name.
+        !
+        !   Returns:
+        !     - integer(c_int): 0 if a file arrived, 1 if the wait timed out, 2 if a
+        !       file arrived whose name does not fit in name, -1 on failure.
+        function c_directoryWatchNext(watchID, timeoutMs, name, nameLen) &
+                bind(C, name = "directoryWatchNext")
+            import :: c_int
+            import :: c_char
+            integer(c_int), value, intent(in) :: watchID
+            integer(c_int), value, intent(in) :: timeoutMs
+            integer(c_int), value, intent(in) :: nameLen
+            character(kind = c_char), dimension(nameLen), intent(out) :: name
+            integer(c_int) :: c_directoryWatchNext
+        end function c_directoryWatchNext
+
+        ! c_directoryWatchClose:
+        !   Stops watching a directory.
+        !
+        !   Arguments:
+        !     - watchID (integer(c_int), intent(in), value): The ID of the watch.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_directoryWatchClose(watchID) &
+                bind(C, name = "directoryWatchClose")
+            import :: c_int
+            integer(c_int), value, intent(in) :: watchID
+            integer(c_int) :: c_directoryWatchClose
+        end function c_directoryWatchClose
+
+        ! c_obsOrder:
+        !   Computes the output order of the locations of an obtype or instrument:
+        !   by dateTime and then by station, with consecutive locations of the same
+        !   dateTime and station numbered as one record.
+        !
+        !   Arguments:
+        !     - numLocs (integer(c_long_long), intent(in), value): The number of locations.
+        !     - dateTime (integer(c_long_long), dimension(numLocs), intent(in)): The
+        !       dateTime of each location.
+        !     - stationIds (type(c_ptr), intent(in), value): A C pointer to numLocs
+        !       station IDs of stationIdLen characters each, or c_null_ptr.
+        !     - stationIdLen (integer(c_int), intent(in), value): The width of a station ID.
+        !     - order (integer(c_long_long), dimension(numLocs), intent(out)): Receives the
+        !       0-based indices of the locations in output order.
+        !     - recordNumber (integer(c_long_long), dimension(numLocs), intent(out)): Receives
+        !       the 1-based record number of each location of the output order.
+        !     - numRecords (integer(c_long_long), intent(out)): Receives the number of records.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_obsOrder(numLocs, dateTime, stationIds, stationIdLen, order, recordNumber, numRecords) &
+                bind(C, name = "obsOrder")
+            import :: c_int
+            import :: c_long_long
+            import :: c_ptr
+            integer(c_long_long), value, intent(in) :: numLocs
+            integer(c_long_long), dimension(numLocs), intent(in) :: dateTime
+            type(c_ptr), value, intent(in) :: stationIds
+            integer(c_int), value, intent(in) :: stationIdLen
+            integer(c_long_long), dimension(numLocs), intent(out) :: order
+            integer(c_long_long), dimension(numLocs), intent(out) :: recordNumber
+            integer(c_long_long), intent(out) :: numRecords
+            integer(c_int) :: c_obsOrder
+        end function c_obsOrder
+
+        ! c_spatialOrder:
+        !   Computes the order of locations along a Hilbert curve over the globe,
+        !   and then by dateTime. Locations without a valid latitude and longitude
+        !   are put last.
+        !
+        !   Arguments:
+        !     - numLocs (integer(c_long_long), intent(in), value): The number of locations.
+        !     - lat (real(c_float), dimension(numLocs), intent(in)): Latitudes in degrees.
+        !     - lon (real(c_float), dimension(numLocs), intent(in)): Longitudes in degrees.
+        !     - dateTime (integer(c_long_long), dimension(numLocs), intent(in)): The
+        !       dateTime of each location.
+        !     - order (integer(c_long_long), dimension(numLocs), intent(out)): Receives the
+        !       0-based indices of the locations in output order.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_spatialOrder(numLocs, lat, lon, dateTime, order) &
+                bind(C, name = "spatialOrder")
+            import :: c_int
+            import :: c_float
+            import :: c_long_long
+            integer(c_long_long), value, intent(in) :: numLocs
+            real(c_float), dimension(numLocs), intent(in) :: lat
+            real(c_float), dimension(numLocs), intent(in) :: lon
+            integer(c_long_long), dimension(numLocs), intent(in) :: dateTime
+            integer(c_long_long), dimension(numLocs), intent(out) :: order
+            integer(c_int) :: c_spatialOrder
+        end function c_spatialOrder
+
+        ! c_netcdfSetLocationBlocks:
+        !   Sets the number of locations per block of the spatial index. While it is
+        !   set, variables along the location dimension of new files are chunked by
+        !   blocks of that many locations.
+        !
+        !   Arguments:
+        !     - blockLocs (integer(c_int), intent(in), value): The number of locations
+        !       per block, or 0 to stop chunking by blocks.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfSetLocationBlocks(blockLocs) &
+                bind(C, name = "netcdfSetLocationBlocks")
+            import :: c_int
+            integer(c_int), value, intent(in) :: blockLocs
+            integer(c_int) :: c_netcdfSetLocationBlocks
+        end function c_netcdfSetLocationBlocks
+
+        ! c_netcdfPutSpatialIndex:
+        !   Writes the group SpatialIndex of a file: the latitude, longitude and
+        !   dateTime range of every block of locations.
+        !
+        !   Arguments:
+        !     - netcdfID (integer(c_int), intent(in), value): The NetCDF ID of the file.
+        !     - numLocs (integer(c_long_long), intent(in), value): The number of locations.
+        !     - lat (real(c_float), dimension(numLocs), intent(in)): Latitudes in degrees.
+        !     - lon (real(c_float), dimension(numLocs), intent(in)): Longitudes in degrees.
+        !     - dateTime (integer(c_long_long), dimension(numLocs), intent(in)): The
+        !       dateTime of each location.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_netcdfPutSpatialIndex(netcdfID, numLocs, lat, lon, dateTime) &
+                bind(C, name = "netcdfPutSpatialIndex")
+            import :: c_int
+            import :: c_float
+            import :: c_long_long
+            integer(c_int), value, intent(in) :: netcdfID
+            integer(c_long_long), value, intent(in) :: numLocs
+            real(c_float), dimension(numLocs), intent(in) :: lat
+            real(c_float), dimension(numLocs), intent(in) :: lon
+            integer(c_long_long), dimension(numLocs), intent(in) :: dateTime
+            integer(c_int) :: c_netcdfPutSpatialIndex
+        end function c_netcdfPutSpatialIndex
+
+        ! c_geoFixedGridToLatLon:
+        !   Computes the latitude and longitude of the pixels of a fixed grid.
+        !
+        !   Arguments:
+        !     - proj (type(geos_projection), intent(in)): The projection.
+        !     - nx (integer(c_int), intent(in), value): The number of columns.
+        !     - ny (integer(c_int), intent(in), value): The number of rows.
+        !     - x (real(c_double), dimension(nx), intent(in)): The E/W scan angle of
+        !       each column in radians.
+        !     - y (real(c_double), dimension(ny), intent(in)): The N/S scan angle of
+        !       each row in radians.
+        !     - lat (real(c_float), dimension(nx, ny), intent(out)): Receives the
+        !       latitudes in degrees, missing off the earth.
+        !     - lon (real(c_float), dimension(nx, ny), intent(out)): Receives the
+        !       longitudes in degrees, -180 to 180, missing off the earth.
+        !     - valid (integer(c_int), dimension(nx, ny), intent(out)): Receives 1 for
+        !       pixels on the earth, 0 otherwise.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_geoFixedGridToLatLon(proj, nx, ny, x, y, lat, lon, valid) &
+                bind(C, name = "geoFixedGridToLatLon")
+            import :: c_int
+            import :: c_float
+            import :: c_double
+            import :: geos_projection
+            type(geos_projection), intent(in) :: proj
+            integer(c_int), value, intent(in) :: nx
+            integer(c_int), value, intent(in) :: ny
+            real(c_double), dimension(nx), intent(in) :: x
+            real(c_double), dimension(ny), intent(in) :: y
+            real(c_float), dimension(nx, ny), intent(out) :: lat
+            real(c_float), dimension(nx, ny), intent(out) :: lon
+            integer(c_int), dimension(nx, ny), intent(out) :: valid
+            integer(c_int) :: c_geoFixedGridToLatLon
+        end function c_geoFixedGridToLatLon
+
+        ! c_geoSatelliteAngles:
+        !   Computes the zenith and azimuth angle of a geostationary satellite.
+        !
+        !   Arguments:
+        !     - proj (type(geos_projection), intent(in)): The projection.
+        !     - numLocs (integer(c_int), intent(in), value): The number of locations.
+        !     - lat (real(c_float), dimension(numLocs), intent(in)): Latitudes in degrees.
+        !     - lon (real(c_float), dimension(numLocs), intent(in)): Longitudes in degrees.
+        !     - zenith (real(c_float), dimension(numLocs), intent(out)): Receives the
+        !       zenith angles in degrees, missing for invalid locations.
+        !     - azimuth (type(c_ptr), intent(in), value): A C pointer to numLocs reals
+        !       that receive the azimuth angles in degrees, or c_null_ptr.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_geoSatelliteAngles(proj, numLocs, lat, lon, zenith, azimuth) &
+                bind(C, name = "geoSatelliteAngles")
+            import :: c_int
+            import :: c_float
+            import :: c_ptr
+            import :: geos_projection
+            type(geos_projection), intent(in) :: proj
+            integer(c_int), value, intent(in) :: numLocs
+            real(c_float), dimension(numLocs), intent(in) :: lat
+            real(c_float), dimension(numLocs), intent(in) :: lon
+            real(c_float), dimension(numLocs), intent(out) :: zenith
+            type(c_ptr), value, intent(in) :: azimuth
+            integer(c_int) :: c_geoSatelliteAngles
+        end function c_geoSatelliteAngles
+
+        ! c_geoSolarAngles:
+        !   Computes the solar zenith and azimuth angle at one time, as
+        !   calc_solar_zenith_angle of hsd.f90.
+        !
+        !   Arguments:
+        !     - julian (integer(c_int), intent(in), value): The day of the year, 1 to 366.
+        !     - gmt (integer(c_int), intent(in), value): The hour, 0 to 23.
+        !     - minute (integer(c_int), intent(in), value): The minute, 0 to 59.
+        !     - numLocs (integer(c_int), intent(in), value): The number of locations.
+        !     - lat (real(c_float), dimension(numLocs), intent(in)): Latitudes in degrees.
+        !     - lon (real(c_float), dimension(numLocs), intent(in)): Longitudes in degrees.
+        !     - zenith (real(c_float), dimension(numLocs), intent(out)): Receives the
+        !       solar zenith angles in degrees, missing for invalid locations.
+        !     - azimuth (type(c_ptr), intent(in), value): A C pointer to numLocs reals
+        !       that receive the solar azimuth angles in degrees, or c_null_ptr.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero),
+        !       e.g. for a time out of range.
+        function c_geoSolarAngles(julian, gmt, minute, numLocs, lat, lon, zenith, azimuth) &
+                bind(C, name = "geoSolarAngles")
+            import :: c_int
+            import :: c_float
+            import :: c_ptr
+            integer(c_int), value, intent(in) :: julian
+            integer(c_int), value, intent(in) :: gmt
+            integer(c_int), value, intent(in) :: minute
+            integer(c_int), value, intent(in) :: numLocs
+            real(c_float), dimension(numLocs), intent(in) :: lat
+            real(c_float), dimension(numLocs), intent(in) :: lon
+            real(c_float), dimension(numLocs), intent(out) :: zenith
+            type(c_ptr), value, intent(in) :: azimuth
+            integer(c_int) :: c_geoSolarAngles
+        end function c_geoSolarAngles
+
+        ! c_timeCalendarToEpoch:
+        !   Converts dates and times to seconds since 1970-01-01T00:00:00Z, as the epoch
+        !   argument of get_julian_time in utils_mod.
+        !
+        !   Arguments:
+        !     - numTimes (integer(c_int), intent(in), value): The number of times.
+        !     - year, month, day, hour, minute, second (integer(c_int), dimension(numTimes),
+        !       intent(in)): The dates and times.
+        !     - epoch (integer(c_long_long), dimension(numTimes), intent(out)): Receives
+        !       the times in seconds, or invalid_epoch of netcdf_cxx_mod for those with
+        !       a field out of range.
+        !
+        !   Returns:
+        !     - integer(c_int): 0 on success, the number of invalid times, or -1 on failure.
+        function c_timeCalendarToEpoch(numTimes, year, month, day, hour, minute, second, epoch) &
+                bind(C, name = "timeCalendarToEpoch")
+            import :: c_int
+            import :: c_long_long
+            integer(c_int), value, intent(in) :: numTimes
+            integer(c_int), dimension(numTimes), intent(in) :: year
+            integer(c_int), dimension(numTimes), intent(in) :: month
+            integer(c_int), dimension(numTimes), intent(in) :: day
+            integer(c_int), dimension(numTimes), intent(in) :: hour
+            integer(c_int), dimension(numTimes), intent(in) :: minute
+            integer(c_int), dimension(numTimes), intent(in) :: second
+            integer(c_long_long), dimension(numTimes), intent(out) :: epoch
+            integer(c_int) :: c_timeCalendarToEpoch
+        end function c_timeCalendarToEpoch
+
+        ! c_timeDateToEpoch:
+        !   Parses a date ccyymmddhh[nn[ss]] into seconds since 1970-01-01T00:00:00Z.
+        !
+        !   Arguments:
+        !     - date (type(c_ptr), intent(in), value): A C pointer to a null-terminated
+        !       string with the date.
+        !     - epoch (integer(c_long_long), intent(out)): Receives the time in seconds.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_timeDateToEpoch(date, epoch) &
+                bind(C, name = "timeDateToEpoch")
+            import :: c_int
+            import :: c_ptr
+            import :: c_long_long
+            type(c_ptr), value, intent(in) :: date
+            integer(c_long_long), intent(out) :: epoch
+            integer(c_int) :: c_timeDateToEpoch
+        end function c_timeDateToEpoch
+
+        ! c_timeWindowSlots:
+        !   Computes the boundaries of the time slots of a window, as da_get_time_slots
+        !   of WRFDA, in seconds since 1970-01-01T00:00:00Z.
+        !
+        !   Arguments:
+        !     - windowBegin (integer(c_long_long), intent(in), value): The start of the window.
+        !     - windowEnd (integer(c_long_long), intent(in), value): The end of the window.
+        !     - numSlots (integer(c_int), intent(in), value): The number of slots.
+        !     - slots (integer(c_long_long), dimension(0:numSlots), intent(out)):
+        !       Receives the boundaries.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_timeWindowSlots(windowBegin, windowEnd, numSlots, slots) &
+                bind(C, name = "timeWindowSlots")
+            import :: c_int
+            import :: c_long_long
+            integer(c_long_long), value, intent(in) :: windowBegin
+            integer(c_long_long), value, intent(in) :: windowEnd
+            integer(c_int), value, intent(in) :: numSlots
+            integer(c_long_long), dimension(0:numSlots), intent(out) :: slots
+            integer(c_int) :: c_timeWindowSlots
+        end function c_timeWindowSlots
+
+        ! c_timeEpochToDatetime:
+        !   Formats times as ccyy-mm-ddThh:mm:ssZ strings.
+        !
+        !   Arguments:
+        !     - numTimes (integer(c_int), intent(in), value): The number of times.
+        !     - epoch (integer(c_long_long), dimension(numTimes), intent(in)): The times
+        !       in seconds since 1970-01-01T00:00:00Z.
+        !     - datetimes (character(kind=c_char), dimension(*), intent(out)): Receives
+        !       numTimes strings of 20 characters, one after the other.
+        !
+        !   Returns:
+        !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+        function c_timeEpochToDatetime(numTimes, epoch, datetimes) &
+                bind(C, name = "timeEpochToDatetime")
+            import :: c_int
+            import :: c_long_long
+            import :: c_char
+            integer(c_int), value, intent(in) :: numTimes
+            integer(c_long_long), dimension(numTimes), intent(in) :: epoch
+            character(kind = c_char), dimension(*), intent(out) :: datetimes
+            integer(c_int) :: c_timeEpochToDatetime
+        end function c_timeEpochToDatetime
+
     end interface
 
 end module netcdf_cxx_i_mod
@@ -1,19 +1,58 @@
 module netcdf_cxx_mod
-    use iso_c_binding, only: c_int, c_ptr, c_null_ptr, c_loc, c_float, c_long, c_double
+    use iso_c_binding, only: c_int, c_ptr, c_null_ptr, c_loc, c_float, c_long, c_double, c_long_long, &
+            c_char, c_null_char, c_size_t
     use f_c_string_t_mod, only: f_c_string_t
     use f_c_string_1D_t_mod, only: f_c_string_1D_t
-    use netcdf_cxx_i_mod, only: c_netcdfCreate, c_netcdfClose, c_netcdfAddGroup, c_netcdfAddDim, &
+    use netcdf_cxx_i_mod, only: c_netcdfCreate, c_netcdfClose, c_netcdfAddGroup, c_netcdfAddDim, c_netcdfGetDimLen, &
             c_netcdfAddVar, c_netcdfPutVarInt, c_netcdfPutVarInt64, c_netcdfPutVarReal, c_netcdfPutVarDouble, c_netcdfPutVarChar, &
             c_netcdfSetFillInt, c_netcdfSetFillInt64, c_netcdfSetFillReal, c_netcdfSetFillString, &
-            c_netcdfPutAttInt, c_netcdfPutAttString, c_netcdfPutAttIntArray, c_netcdfPutAttRealArray
+            c_netcdfPutAttInt, c_netcdfPutAttString, c_netcdfPutAttIntArray, c_netcdfPutAttRealArray, &
+            c_netcdfSaveLayout, c_netcdfCreateFromLayout, c_netcdfFreeLayout, c_netcdfCopy, &
+            c_netcdfPutVarSlabInt, c_netcdfPutVarSlabInt64, c_netcdfPutVarSlabReal, c_netcdfPutVarSlabDouble, &
+            c_netcdfPutVarSlabString, c_netcdfParallelInit, c_netcdfParallelFinalize, c_netcdfParallelExscan, &
+            c_netcdfParallelReduceInt, c_netcdfParallelReduceString, c_netcdfCreatePar, &
+            netcdf_file_options, c_netcdfCreateWithOptions, c_netcdfCreateParWithOptions, &
+            c_traceInit, c_traceBegin, c_traceEnd, c_traceFinalize, &
+            c_channelSelectionLoad, c_channelSelectionGet, c_netcdfEncodingLoad, &
+            c_directoryWatchOpen, c_directoryWatchNext, c_directoryWatchClose, &
+            c_obsOrder, c_spatialOrder, c_netcdfSetLocationBlocks, c_netcdfPutSpatialIndex, &
+            c_netcdfInqVar, c_netcdfGetVarInt, c_netcdfGetVarInt64, c_netcdfGetVarReal, c_netcdfGetVarDouble, &
+            c_netcdfGetVarSlabInt, c_netcdfGetVarSlabInt64, c_netcdfGetVarSlabReal, c_netcdfGetVarSlabDouble, &
+            c_netcdfGetVarSlabString, c_netcdfMerge, c_netcdfSplit, &
+            geos_projection, c_geoFixedGridToLatLon, c_geoSatelliteAngles, c_geoSolarAngles, &
+            c_timeCalendarToEpoch, c_timeDateToEpoch, c_timeWindowSlots, c_timeEpochToDatetime
     implicit none
     public
 
+    ! Length passed to netcdfAddDim for an unlimited dimension.
+    integer(c_int), parameter :: netcdf_unlimited = 0
+
+    ! NetCDF type of character variables, as returned by netcdfInqVar (NF90_CHAR).
+    integer(c_int), parameter :: nc_char = 2
+
+    ! Reduction operations of netcdfParallelReduce.
+    integer(c_int), parameter :: parallel_min = 0
+    integer(c_int), parameter :: parallel_max = 1
+    integer(c_int), parameter :: parallel_sum = 2
+
+    ! Time given by timeToEpoch to a date or time with a field out of range.
+    integer(c_long_long), parameter :: invalid_epoch = -huge(0_c_long_long) - 1_c_long_long
+
+    interface netcdfParallelReduce
+        module procedure netcdfParallelReduceInt
+        module procedure netcdfParallelReduceString
+    end interface netcdfParallelReduce
+
     interface netcdfPutAtt
         module procedure netcdfPutAtt
         module procedure netcdfPutAttArray
     end interface netcdfPutAtt
 
+    interface timeToEpoch
+        module procedure timeToEpochScalar
+        module procedure timeToEpochArray
+    end interface timeToEpoch
+
 contains
 
     ! netcdfCreate:
@@ -32,13 +71,22 @@ contains
     !           - 1: Open an existing file for writing.
     !           - 2: Create a new file, overwriting any existing file.
     !           - 3: Create a new file, failing if the file already exists.
+    !     - comm (integer(c_int), intent(in), optional):
+    !         Fortran handle of an MPI communicator. If present, the file is created
+    !         collectively by all ranks of the communicator and written with parallel
+    !         NetCDF (see netcdfPutVar with start and count).
+    !     - options (type(netcdf_file_options), intent(in), optional):
+    !         HDF5 tuning of the file. Defaults to the settings of the
+    !         OBS2IODA_HDF5_OPTIONS environment variable, if it is set.
     !
     !   Returns:
     !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
-    function netcdfCreate(path, netcdfID, fileMode)
+    function netcdfCreate(path, netcdfID, fileMode, comm, options)
         character(len = *), intent(in) :: path
         integer(c_int), intent(inout) :: netcdfID
         integer(c_int), intent(in), optional :: fileMode
+        integer(c_int), intent(in), optional :: comm
+        type(netcdf_file_options), intent(in), optional :: options
         integer(c_int) :: netcdfCreate
         type(f_c_string_t) :: f_c_string_path
         type(c_ptr) :: c_path
@@ -50,7 +98,15 @@ contains
             mode = 2
         end if
         c_path = f_c_string_path%to_c(path)
-        netcdfCreate = c_netcdfCreate(c_path, netcdfID, mode)
+        if (present(comm) .and. present(options)) then
+            netcdfCreate = c_netcdfCreateParWithOptions(c_path, netcdfID, mode, comm, options)
+        else if (present(comm)) then
+            netcdfCreate = c_netcdfCreatePar(c_path, netcdfID, mode, comm)
+        else if (present(options)) then
+            netcdfCreate = c_netcdfCreateWithOptions(c_path, netcdfID, mode, options)
+        else
+            netcdfCreate = c_netcdfCreate(c_path, netcdfID, mode)
+        end if
     end function netcdfCreate
 
     ! netcdfClose:
@@ -68,6 +124,169 @@ contains
         netcdfClose = c_netcdfClose(netcdfID)
     end function netcdfClose
 
+    ! netcdfSaveLayout:
+    !   Captures the dimensions, groups, variables and attributes of an open NetCDF
+    !   file so that files with the same structure can be created without repeating
+    !   the define phase.
+    !
+    !   Arguments:
+    !     - netcdfID (integer(c_int), intent(in), value): The identifier of the
+    !       NetCDF file whose layout is captured.
+    !     - layoutID (integer(c_int), intent(out)): Receives the identifier of the
+    !       captured layout.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfSaveLayout(netcdfID, layoutID)
+        integer(c_int), value, intent(in) :: netcdfID
+        integer(c_int), intent(out) :: layoutID
+        integer(c_int) :: netcdfSaveLayout
+        netcdfSaveLayout = c_netcdfSaveLayout(netcdfID, layoutID)
+    end function netcdfSaveLayout
+
+    ! netcdfCreateFromLayout:
+    !   Creates a new NetCDF file from a layout captured by netcdfSaveLayout. Only
+    !   the lengths of the listed dimensions differ from the captured file.
+    !
+    !   Arguments:
+    !     - path (character(len=*), intent(in)): The file path as a Fortran string.
+    !     - layoutID (integer(c_int), intent(in), value): The identifier of the layout.
+    !     - dimNames (character(len=*), dimension(:), intent(in)): The names of the
+    !       dimensions whose lengths are overridden.
+    !     - dimLens (class(*), dimension(:), intent(in)): The new dimension lengths,
+    !       integer(c_int) or integer(c_long).
+    !     - netcdfID (integer(c_int), intent(inout)): Receives the file identifier
+    !       for the created NetCDF file.
+    !     - fileMode (integer(c_int), intent(in), optional): File mode for creating
+    !       the NetCDF file. Defaults to 2 (replace mode), as in netcdfCreate.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfCreateFromLayout(path, layoutID, dimNames, dimLens, netcdfID, fileMode)
+        character(len = *), intent(in) :: path
+        integer(c_int), value, intent(in) :: layoutID
+        character(len = *), dimension(:), intent(in) :: dimNames
+        class(*), dimension(:), intent(in) :: dimLens
+        integer(c_int), intent(inout) :: netcdfID
+        integer(c_int), intent(in), optional :: fileMode
+        integer(c_int) :: netcdfCreateFromLayout
+        integer(c_size_t), dimension(:), allocatable :: c_dimLens
+        type(f_c_string_t) :: f_c_string_path
+        type(f_c_string_1D_t) :: f_c_string_1D_dimNames
+        type(c_ptr) :: c_path
+        type(c_ptr) :: c_dimNames
+        integer(c_int) :: mode
+
+        if (present(fileMode)) then
+            mode = fileMode
+        else
+            mode = 2
+        end if
+        netcdfCreateFromLayout = toSizes(dimLens, 0, c_dimLens)
+        if (netcdfCreateFromLayout /= 0) return
+        c_path = f_c_string_path%to_c(path)
+        c_dimNames = f_c_string_1D_dimNames%to_c(dimNames)
+        netcdfCreateFromLayout = c_netcdfCreateFromLayout(c_path, layoutID, size(dimNames), &
+                c_dimNames, c_dimLens, netcdfID, mode)
+    end function netcdfCreateFromLayout
+
+    ! netcdfFreeLayout:
+    !   Releases a layout captured by netcdfSaveLayout.
+    !
+    !   Arguments:
+    !     - layoutID (integer(c_int), intent(in), value): The identifier of the layout.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfFreeLayout(layoutID)
+        integer(c_int), value, intent(in) :: layoutID
+        integer(c_int) :: netcdfFreeLayout
+        netcdfFreeLayout = c_netcdfFreeLayout(layoutID)
+    end function netcdfFreeLayout
+
+    ! netcdfCopy:
+    !   Copies a NetCDF dataset, definitions and data, to a new file. Paths ending
+    !   in `.zarr` are NCZarr directory stores, all others HDF5 files, so this
+    !   converts NCZarr output to HDF5 for consumers that need it.
+    !
+    !   Arguments:
+    !     - srcPath (character(len=*), intent(in)): The path of the dataset to copy.
+    !     - dstPath (character(len=*), intent(in)): The path of the copy. An existing
+    !       file is overwritten.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfCopy(srcPath, dstPath)
+        character(len = *), intent(in) :: srcPath
+        character(len = *), intent(in) :: dstPath
+        integer(c_int) :: netcdfCopy
+        type(f_c_string_t) :: f_c_string_srcPath
+        type(f_c_string_t) :: f_c_string_dstPath
+        type(c_ptr) :: c_srcPath
+        type(c_ptr) :: c_dstPath
+
+        c_srcPath = f_c_string_srcPath%to_c(srcPath)
+        c_dstPath = f_c_string_dstPath%to_c(dstPath)
+        netcdfCopy = c_netcdfCopy(c_srcPath, c_dstPath)
+    end function netcdfCopy
+
+    ! netcdfMerge:
+    !   Concatenates IODA files with the same variables along the location dimension.
+    !   The data are streamed block by block, so no file is held in memory; the
+    !   variables without a location dimension are taken from the first input.
+    !
+    !   Arguments:
+    !     - inputPaths (character(len=*), dimension(:), intent(in)): The files to
+    !       merge, in output order.
+    !     - outputPath (character(len=*), intent(in)): The merged file. An existing
+    !       file is overwritten.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfMerge(inputPaths, outputPath)
+        character(len = *), dimension(:), intent(in) :: inputPaths
+        character(len = *), intent(in) :: outputPath
+        integer(c_int) :: netcdfMerge
+        type(f_c_string_1D_t) :: f_c_string_1D_inputPaths
+        type(f_c_string_t) :: f_c_string_outputPath
+        type(c_ptr) :: c_inputPaths
+        type(c_ptr) :: c_outputPath
+
+        c_inputPaths = f_c_string_1D_inputPaths%to_c(inputPaths)
+        c_outputPath = f_c_string_outputPath%to_c(outputPath)
+        netcdfMerge = c_netcdfMerge(size(inputPaths), c_inputPaths, c_outputPath)
+    end function netcdfMerge
+
+    ! netcdfSplit:
+    !   Partitions an IODA file into time windows of windowSeconds centred on
+    !   multiples of windowSeconds since 1970, e.g. hourly windows centred on the
+    !   full hours. Each non-empty window is written to
+    !   <outputPrefix><ccyymmddhh><extension of inputPath>.
+    !
+    !   Arguments:
+    !     - inputPath (character(len=*), intent(in)): The file to split.
+    !     - outputPrefix (character(len=*), intent(in)): The path of the outputs up to their date.
+    !     - windowSeconds (integer(c_int), intent(in), value): The window length in seconds.
+    !     - numOutputs (integer(c_int), intent(out)): The number of files written.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfSplit(inputPath, outputPrefix, windowSeconds, numOutputs)
+        character(len = *), intent(in) :: inputPath
+        character(len = *), intent(in) :: outputPrefix
+        integer(c_int), value, intent(in) :: windowSeconds
+        integer(c_int), intent(out) :: numOutputs
+        integer(c_int) :: netcdfSplit
+        type(f_c_string_t) :: f_c_string_inputPath
+        type(f_c_string_t) :: f_c_string_outputPrefix
+        type(c_ptr) :: c_inputPath
+        type(c_ptr) :: c_outputPrefix
+
+        c_inputPath = f_c_string_inputPath%to_c(inputPath)
+        c_outputPrefix = f_c_string_outputPrefix%to_c(outputPrefix)
+        netcdfSplit = c_netcdfSplit(c_inputPath, c_outputPrefix, windowSeconds, numOutputs)
+    end function netcdfSplit
+
     ! netcdfAddGroup:
     !   Adds a new group to a NetCDF file under a specified parent group.
     !
@@ -112,8 +331,10 @@ contains
     !       Identifier of the NetCDF file.
     !   - dimName (character(len=*), intent(in)):
     !       Name of the new dimension.
-    !   - len (integer(c_int), intent(in), value):
-    !       Length of the dimension.
+    !   - len (class(*), intent(in)):
+    !       Length of the dimension, integer(c_int) or integer(c_long), or
+    !       netcdf_unlimited for an unlimited dimension that grows as locations
+    !       are appended.
     !  - dimID (integer(c_int), intent(out)):
     !       Identifier of the new dimension.
     !   - groupName (character(len=*), intent(in), optional):
@@ -122,11 +343,13 @@ contains
     ! Returns:
     !    - integer(c_int): A status code indicating the outcome of the operation:
     !       - 0: Success.
-    !       - Non-zero: Failure
+    !       - -2: Unsupported type passed for len.
+    !       - -3: Negative len.
+    !       - Other nonzero values: Failure
     function netcdfAddDim(netcdfID, dimName, len, dimID, groupName)
         integer(c_int), value, intent(in) :: netcdfID
         character(len = *), intent(in) :: dimName
-        integer(c_int), value, intent(in) :: len
+        class(*), intent(in) :: len
         integer(c_int), intent(out) :: dimID
         character(len = *), optional, intent(in) :: groupName
         integer(c_int) :: netcdfAddDim
@@ -134,8 +357,21 @@ contains
         type(c_ptr) :: c_dimName
         type(f_c_string_t) :: f_c_string_groupName
         type(f_c_string_t) :: f_c_string_dimName
-        integer(c_int) :: status
+        integer(c_size_t) :: c_len
 
+        select type (len)
+        type is (integer(c_int))
+            c_len = len
+        type is (integer(c_long))
+            c_len = len
+        class default
+            netcdfAddDim = -2
+            return
+        end select
+        if (c_len < 0) then
+            netcdfAddDim = -3
+            return
+        end if
         if (present(groupName)) then
             c_groupName = f_c_string_groupName%to_c(groupName)
         else
@@ -143,10 +379,67 @@ contains
         end if
         c_dimName = f_c_string_dimName%to_c(dimName)
 
-        netcdfAddDim = c_netcdfAddDim(netcdfID, c_groupName, c_dimName, len, dimID)
+        netcdfAddDim = c_netcdfAddDim(netcdfID, c_groupName, c_dimName, c_len, dimID)
         dimID = dimID + 1
     end function netcdfAddDim
 
+    ! netcdfGetDimLen:
+    !   Retrieves the current length of a dimension. In a file opened for append
+    !   (fileMode 1 of netcdfCreate), the length of the unlimited location dimension
+    !   is the number of locations already written, so new locations start after it.
+    !
+    ! Arguments:
+    !   - netcdfID (integer(c_int), intent(in), value):
+    !       Identifier of the NetCDF file.
+    !   - dimName (character(len=*), intent(in)):
+    !       Name of the dimension.
+    !   - len (class(*), intent(out)):
+    !       Length of the dimension, integer(c_int) or integer(c_long).
+    !   - groupName (character(len=*), intent(in), optional):
+    !       Name of the group of the dimension. If absent, the dimension is a global dimension.
+    !
+    ! Returns:
+    !    - integer(c_int): A status code indicating the outcome of the operation:
+    !       - 0: Success.
+    !       - -2: Unsupported type passed for len.
+    !       - -3: The length does not fit an integer(c_int) len.
+    !       - Other nonzero values: Failure
+    function netcdfGetDimLen(netcdfID, dimName, len, groupName)
+        integer(c_int), value, intent(in) :: netcdfID
+        character(len = *), intent(in) :: dimName
+        class(*), intent(out) :: len
+        character(len = *), optional, intent(in) :: groupName
+        integer(c_int) :: netcdfGetDimLen
+        type(c_ptr) :: c_groupName
+        type(c_ptr) :: c_dimName
+        type(f_c_string_t) :: f_c_string_groupName
+        type(f_c_string_t) :: f_c_string_dimName
+        integer(c_size_t) :: c_len
+
+        if (present(groupName)) then
+            c_groupName = f_c_string_groupName%to_c(groupName)
+        else
+            c_groupName = c_null_ptr
+        end if
+        c_dimName = f_c_string_dimName%to_c(dimName)
+
+        c_len = 0
+        netcdfGetDimLen = c_netcdfGetDimLen(netcdfID, c_groupName, c_dimName, c_len)
+        select type (len)
+        type is (integer(c_int))
+            if (c_len > huge(len)) then
+                len = -1
+                if (netcdfGetDimLen == 0) netcdfGetDimLen = -3
+            else
+                len = int(c_len, c_int)
+            end if
+        type is (integer(c_long))
+            len = c_len
+        class default
+            netcdfGetDimLen = -2
+        end select
+    end function netcdfGetDimLen
+
     ! netcdfAddVar:
     !   Adds a new variable to a NetCDF file, specifying its name, type, dimensions, and target group.
     !
@@ -214,18 +507,29 @@ contains
     !     - groupName (character(len=*), intent(in), optional):
     !       The name of the group containing the variable.
     !       If not provided, the variable is assumed to be a global variable.
+    !     - start (class(*), dimension(:), intent(in), optional):
+    !       One-based index of the first element written, per dimension, in the
+    !       dimension order given to netcdfAddVar, integer(c_int) or integer(c_long).
+    !       Must be given together with count.
+    !     - count (class(*), dimension(:), intent(in), optional):
+    !       Number of elements written, per dimension. If start and count are present,
+    !       only this hyperslab is written; in a file created with a communicator all
+    !       ranks must write it, ranks without data with a zero count.
     !
     !   Returns:
     !     - integer(c_int): A status code indicating the outcome of the operation:
     !         -  0: Success.
     !         - -1: NetCDF operation returned an error, but the error code was 0.
-    !         - -2: Unsupported type passed for values.
+    !         - -2: Unsupported type passed for values, start or count.
+    !         - -3: Negative start or count.
     !         - Other nonzero values: Specific NetCDF error codes.
-    function netcdfPutVar(netcdfID, varName, values, groupName)
+    function netcdfPutVar(netcdfID, varName, values, groupName, start, count)
         integer(c_int), value, intent(in) :: netcdfID
         character(len = *), intent(in) :: varName
         class(*), dimension(:), target, intent(in) :: values
         character(len = *), optional, intent(in) :: groupName
+        class(*), dimension(:), optional, intent(in) :: start
+        class(*), dimension(:), optional, intent(in) :: count
         integer(c_int) :: netcdfPutVar
         type(f_c_string_t) :: f_c_string_groupName
         type(f_c_string_t) :: f_c_string_varName
@@ -241,6 +545,11 @@ contains
         end if
         c_varName = f_c_string_varName%to_c(varName)
 
+        if (present(start) .and. present(count)) then
+            netcdfPutVar = netcdfPutVarSlab(c_groupName, c_varName)
+            return
+        end if
+
         select type (values)
         type is (integer(c_int))
             c_values = c_loc(values)
@@ -269,8 +578,231 @@ contains
         class default
             netcdfPutVar = -2
         end select
+
+    contains
+
+        function netcdfPutVarSlab(c_groupName, c_varName)
+            type(c_ptr), intent(in) :: c_groupName
+            type(c_ptr), intent(in) :: c_varName
+            integer(c_int) :: netcdfPutVarSlab
+            integer(c_int) :: numDims
+            integer(c_size_t), dimension(:), allocatable :: c_start
+            integer(c_size_t), dimension(:), allocatable :: c_count
+
+            numDims = size(start)
+            netcdfPutVarSlab = toSizes(start, 1, c_start)
+            if (netcdfPutVarSlab == 0) netcdfPutVarSlab = toSizes(count, 0, c_count)
+            if (netcdfPutVarSlab /= 0) return
+            select type (values)
+            type is (integer(c_int))
+                c_values = c_loc(values)
+                netcdfPutVarSlab = c_netcdfPutVarSlabInt(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_values)
+
+            type is (integer(c_long))
+                c_values = c_loc(values)
+                netcdfPutVarSlab = c_netcdfPutVarSlabInt64(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_values)
+
+            type is (real(c_float))
+                c_values = c_loc(values)
+                netcdfPutVarSlab = c_netcdfPutVarSlabReal(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_values)
+
+            type is (real(c_double))
+                c_values = c_loc(values)
+                netcdfPutVarSlab = c_netcdfPutVarSlabDouble(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_values)
+
+            type is (character(len = *))
+                c_values = f_c_string_1D_values%to_c(values)
+                netcdfPutVarSlab = c_netcdfPutVarSlabString(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_values)
+            class default
+                netcdfPutVarSlab = -2
+            end select
+        end function netcdfPutVarSlab
     end function netcdfPutVar
 
+    ! netcdfInqVar:
+    !   Inquires the type and shape of a variable in a NetCDF file.
+    !
+    !   Arguments:
+    !     - netcdfID (integer(c_int), intent(in), value):
+    !       The identifier of the NetCDF file containing the variable.
+    !     - varName (character(len=*), intent(in)):
+    !       The name of the variable.
+    !     - netcdfDataType (integer(c_int), intent(out)):
+    !       The NetCDF type of the variable, e.g. NF90_FLOAT.
+    !     - dimLens (integer(c_size_t), dimension(:), allocatable, intent(out)):
+    !       The current length of each dimension, in the dimension order given to
+    !       netcdfAddVar.
+    !     - groupName (character(len=*), intent(in), optional):
+    !       The name of the group containing the variable.
+    !       If not provided, the variable is assumed to be a global variable.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfInqVar(netcdfID, varName, netcdfDataType, dimLens, groupName)
+        integer(c_int), value, intent(in) :: netcdfID
+        character(len = *), intent(in) :: varName
+        integer(c_int), intent(out) :: netcdfDataType
+        integer(c_size_t), dimension(:), allocatable, intent(out) :: dimLens
+        character(len = *), optional, intent(in) :: groupName
+        integer(c_int) :: netcdfInqVar
+        integer(c_int), parameter :: max_dims = 16
+        integer(c_size_t), dimension(max_dims) :: c_dimLens
+        integer(c_int) :: numDims
+        type(f_c_string_t) :: f_c_string_groupName
+        type(f_c_string_t) :: f_c_string_varName
+        type(c_ptr) :: c_groupName
+        type(c_ptr) :: c_varName
+
+        if (present(groupName)) then
+            c_groupName = f_c_string_groupName%to_c(groupName)
+        else
+            c_groupName = c_null_ptr
+        end if
+        c_varName = f_c_string_varName%to_c(varName)
+
+        numDims = 0
+        netcdfInqVar = c_netcdfInqVar(netcdfID, c_groupName, c_varName, netcdfDataType, &
+                numDims, max_dims, c_dimLens)
+        dimLens = c_dimLens(1:min(numDims, max_dims))
+    end function netcdfInqVar
+
+    ! netcdfGetVar:
+    !   Reads a variable, or a hyperslab of it, from a NetCDF file.
+    !
+    !   Arguments:
+    !     - netcdfID (integer(c_int), intent(in), value):
+    !       The identifier of the NetCDF file containing the variable.
+    !     - varName (character(len=*), intent(in)):
+    !       The name of the variable to read.
+    !     - values (class(*), dimension(:), intent(inout)):
+    !       Receives the values in C (row-major) order, converted to the type of
+    !       values. Strings are blank-padded to the length of values.
+    !     - groupName (character(len=*), intent(in), optional):
+    !       The name of the group containing the variable.
+    !       If not provided, the variable is assumed to be a global variable.
+    !     - start (class(*), dimension(:), intent(in), optional):
+    !       One-based index of the first element read, per dimension, in the
+    !       dimension order given to netcdfAddVar, integer(c_int) or integer(c_long).
+    !       Must be given together with count.
+    !     - count (class(*), dimension(:), intent(in), optional):
+    !       Number of elements read, per dimension. For character variables the
+    !       string length dimension is not part of start and count.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating the outcome of the operation:
+    !         -  0: Success.
+    !         - -2: Unsupported type passed for values, start or count.
+    !         - -3: Negative start or count.
+    !         - Other nonzero values: Failure.
+    function netcdfGetVar(netcdfID, varName, values, groupName, start, count)
+        integer(c_int), value, intent(in) :: netcdfID
+        character(len = *), intent(in) :: varName
+        class(*), dimension(:), target, intent(inout) :: values
+        character(len = *), optional, intent(in) :: groupName
+        class(*), dimension(:), optional, intent(in) :: start
+        class(*), dimension(:), optional, intent(in) :: count
+        integer(c_int) :: netcdfGetVar
+        integer(c_size_t), dimension(:), allocatable :: c_start
+        integer(c_size_t), dimension(:), allocatable :: c_count
+        type(f_c_string_t) :: f_c_string_groupName
+        type(f_c_string_t) :: f_c_string_varName
+        type(c_ptr) :: c_groupName
+        type(c_ptr) :: c_varName
+
+        if (present(groupName)) then
+            c_groupName = f_c_string_groupName%to_c(groupName)
+        else
+            c_groupName = c_null_ptr
+        end if
+        c_varName = f_c_string_varName%to_c(varName)
+
+        if (present(start) .and. present(count)) then
+            netcdfGetVar = toSizes(start, 1, c_start)
+            if (netcdfGetVar == 0) netcdfGetVar = toSizes(count, 0, c_count)
+            if (netcdfGetVar == 0) netcdfGetVar = netcdfGetVarSlab(c_start, c_count)
+            return
+        end if
+
+        select type (values)
+        type is (integer(c_int))
+            netcdfGetVar = c_netcdfGetVarInt(netcdfID, c_groupName, c_varName, c_loc(values))
+
+        type is (integer(c_long))
+            netcdfGetVar = c_netcdfGetVarInt64(netcdfID, c_groupName, c_varName, c_loc(values))
+
+        type is (real(c_float))
+            netcdfGetVar = c_netcdfGetVarReal(netcdfID, c_groupName, c_varName, c_loc(values))
+
+        type is (real(c_double))
+            netcdfGetVar = c_netcdfGetVarDouble(netcdfID, c_groupName, c_varName, c_loc(values))
+
+        type is (character(len = *))
+            netcdfGetVar = netcdfGetVarStrings()
+        class default
+            netcdfGetVar = -2
+        end select
+
+    contains
+
+        ! All strings of the variable: a hyperslab of its whole shape.
+        function netcdfGetVarStrings()
+            integer(c_int) :: netcdfGetVarStrings
+            integer(c_int) :: netcdfDataType
+            integer(c_size_t), dimension(:), allocatable :: dimLens
+
+            netcdfGetVarStrings = netcdfInqVar(netcdfID, varName, netcdfDataType, dimLens, groupName)
+            if (netcdfGetVarStrings /= 0) return
+            ! the last dimension of a character variable is the string length
+            if (netcdfDataType == nc_char .and. size(dimLens) > 0) dimLens = dimLens(1:size(dimLens) - 1)
+            netcdfGetVarStrings = netcdfGetVarSlab(spread(0_c_size_t, 1, size(dimLens)), dimLens)
+        end function netcdfGetVarStrings
+
+        function netcdfGetVarSlab(c_start, c_count)
+            integer(c_size_t), dimension(:), intent(in) :: c_start
+            integer(c_size_t), dimension(:), intent(in) :: c_count
+            integer(c_int) :: netcdfGetVarSlab
+            integer(c_int) :: numDims
+            integer(c_size_t) :: i
+            integer(c_size_t) :: n
+            character(kind = c_char), dimension(:), allocatable :: c_strings
+
+            numDims = size(c_start)
+            select type (values)
+            type is (integer(c_int))
+                netcdfGetVarSlab = c_netcdfGetVarSlabInt(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_loc(values))
+
+            type is (integer(c_long))
+                netcdfGetVarSlab = c_netcdfGetVarSlabInt64(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_loc(values))
+
+            type is (real(c_float))
+                netcdfGetVarSlab = c_netcdfGetVarSlabReal(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_loc(values))
+
+            type is (real(c_double))
+                netcdfGetVarSlab = c_netcdfGetVarSlabDouble(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, c_loc(values))
+
+            type is (character(len = *))
+                n = len(values, kind = c_size_t)
+                allocate(c_strings(max(1_c_size_t, product(c_count)) * n))
+                netcdfGetVarSlab = c_netcdfGetVarSlabString(netcdfID, c_groupName, &
+                        c_varName, numDims, c_start, c_count, len(values), c_strings)
+                do i = 1, min(size(values, kind = c_size_t), product(c_count))
+                    values(i) = transfer(c_strings((i - 1) * n + 1:i * n), values(i))
+                end do
+            class default
+                netcdfGetVarSlab = -2
+            end select
+        end function netcdfGetVarSlab
+    end function netcdfGetVar
+
     ! netcdfSetFill:
     !   Sets the fill mode and fill value for a variable in a NetCDF file.
     !
@@ -474,4 +1006,665 @@ contains
     end function netcdfPutAttArray
 
 
+    ! netcdfParallelInit:
+    !   Initializes MPI if needed and returns the world communicator. Without MPI
+    !   support the process is rank 0 of 1 and the communicator handle is 0.
+    !
+    !   Arguments:
+    !     - comm (integer(c_int), intent(out)): Fortran handle of MPI_COMM_WORLD.
+    !     - rank (integer(c_int), intent(out)): Rank of this process.
+    !     - size (integer(c_int), intent(out)): Number of ranks.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfParallelInit(comm, rank, size)
+        integer(c_int), intent(out) :: comm
+        integer(c_int), intent(out) :: rank
+        integer(c_int), intent(out) :: size
+        integer(c_int) :: netcdfParallelInit
+
+        netcdfParallelInit = c_netcdfParallelInit(comm, rank, size)
+    end function netcdfParallelInit
+
+    ! netcdfParallelFinalize:
+    !   Finalizes MPI if it was initialized by netcdfParallelInit.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfParallelFinalize()
+        integer(c_int) :: netcdfParallelFinalize
+
+        netcdfParallelFinalize = c_netcdfParallelFinalize()
+    end function netcdfParallelFinalize
+
+    ! netcdfParallelExscan:
+    !   Computes where the items of this rank start in the concatenation of the items
+    !   of all ranks, and how many items there are in total.
+    !
+    !   Arguments:
+    !     - comm (integer(c_int), intent(in)): Fortran handle of the communicator.
+    !     - localCount (integer(c_long_long), intent(in)): Number of items of this rank.
+    !     - offset (integer(c_long_long), intent(out)): Number of items of the lower ranks.
+    !     - total (integer(c_long_long), intent(out)): Number of items of all ranks.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfParallelExscan(comm, localCount, offset, total)
+        integer(c_int), intent(in) :: comm
+        integer(c_long_long), intent(in) :: localCount
+        integer(c_long_long), intent(out) :: offset
+        integer(c_long_long), intent(out) :: total
+        integer(c_int) :: netcdfParallelExscan
+
+        netcdfParallelExscan = c_netcdfParallelExscan(comm, localCount, offset, total)
+    end function netcdfParallelExscan
+
+    ! netcdfParallelReduce:
+    !   Reduces an integer (parallel_min, parallel_max or parallel_sum) or a string
+    !   (parallel_min or parallel_max, empty strings ignored) over the ranks of a
+    !   communicator. Every rank receives the result.
+    !
+    !   Arguments:
+    !     - comm (integer(c_int), intent(in)): Fortran handle of the communicator.
+    !     - value (integer(c_int) or character(len=*), intent(in)): Value of this rank.
+    !     - reduceOp (integer(c_int), intent(in)): The reduction.
+    !     - result (same type as value, intent(out)): The reduced value.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfParallelReduceInt(comm, value, reduceOp, result)
+        integer(c_int), intent(in) :: comm
+        integer(c_int), intent(in) :: value
+        integer(c_int), intent(in) :: reduceOp
+        integer(c_int), intent(out) :: result
+        integer(c_int) :: netcdfParallelReduceInt
+
+        netcdfParallelReduceInt = c_netcdfParallelReduceInt(comm, value, reduceOp, result)
+    end function netcdfParallelReduceInt
+
+    ! See documentation for `netcdfParallelReduceInt`.
+    function netcdfParallelReduceString(comm, value, reduceOp, result)
+        integer(c_int), intent(in) :: comm
+        character(len = *), intent(in) :: value
+        integer(c_int), intent(in) :: reduceOp
+        character(len = *), intent(out) :: result
+        integer(c_int) :: netcdfParallelReduceString
+        type(f_c_string_t) :: f_c_string_value
+        character(kind = c_char), dimension(len(result) + 1) :: c_result
+        integer :: i
+
+        netcdfParallelReduceString = c_netcdfParallelReduceString(comm, &
+                f_c_string_value%to_c(value), reduceOp, c_result, size(c_result))
+        result = ''
+        do i = 1, len(result)
+            if (c_result(i) == c_null_char) exit
+            result(i:i) = c_result(i)
+        end do
+    end function netcdfParallelReduceString
+
+    ! traceInit:
+    !   Enables stage tracing. Stages are written as Chrome/Perfetto trace JSON
+    !   by traceFinalize, which also prints a summary table.
+    !
+    !   Arguments:
+    !     - path (character(len=*), intent(in)): The trace file. If blank, the
+    !       OBS2IODA_TRACE environment variable is used; tracing stays off if it is
+    !       unset too.
+    !     - rank (integer(c_int), intent(in)): MPI rank of this process; ranks other
+    !       than 0 write to <path>.rank<N>.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function traceInit(path, rank)
+        character(len = *), intent(in) :: path
+        integer(c_int), intent(in) :: rank
+        integer(c_int) :: traceInit
+        type(f_c_string_t) :: f_c_string_path
+        type(c_ptr) :: c_path
+
+        c_path = f_c_string_path%to_c(trim(path))
+        traceInit = c_traceInit(c_path, rank)
+    end function traceInit
+
+    ! traceBegin:
+    !   Starts a stage. Does nothing if tracing is disabled.
+    !
+    !   Arguments:
+    !     - name (character(len=*), intent(in)): The name of the stage.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function traceBegin(name)
+        character(len = *), intent(in) :: name
+        integer(c_int) :: traceBegin
+        type(f_c_string_t) :: f_c_string_name
+        type(c_ptr) :: c_name
+
+        c_name = f_c_string_name%to_c(name)
+        traceBegin = c_traceBegin(c_name)
+    end function traceBegin
+
+    ! traceEnd:
+    !   Ends the innermost stage. Does nothing if tracing is disabled.
+    !
+    !   Arguments:
+    !     - name (character(len=*), intent(in)): The name of the stage, as passed to
+    !       traceBegin.
+    !     - count (integer(c_long_long), intent(in), optional): Number of observations
+    !       handled by the stage.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function traceEnd(name, count)
+        character(len = *), intent(in) :: name
+        integer(c_long_long), intent(in), optional :: count
+        integer(c_int) :: traceEnd
+        type(f_c_string_t) :: f_c_string_name
+        type(c_ptr) :: c_name
+        integer(c_long_long) :: c_count
+
+        c_count = -1
+        if (present(count)) c_count = count
+        c_name = f_c_string_name%to_c(name)
+        traceEnd = c_traceEnd(c_name, c_count)
+    end function traceEnd
+
+    ! traceFinalize:
+    !   Writes the trace file and prints the stage summary. Does nothing if
+    !   tracing is disabled.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function traceFinalize()
+        integer(c_int) :: traceFinalize
+
+        traceFinalize = c_traceFinalize()
+    end function traceFinalize
+
+    ! channelSelectionLoad:
+    !   Loads the channels kept per radiance instrument from a YAML file, such as
+    !   share/ChannelSelection.yaml.
+    !
+    !   Arguments:
+    !     - path (character(len=*), intent(in)): The path of the YAML file.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function channelSelectionLoad(path)
+        character(len = *), intent(in) :: path
+        integer(c_int) :: channelSelectionLoad
+        type(f_c_string_t) :: f_c_string_path
+        type(c_ptr) :: c_path
+
+        c_path = f_c_string_path%to_c(trim(path))
+        channelSelectionLoad = c_channelSelectionLoad(c_path)
+    end function channelSelectionLoad
+
+    ! channelSelectionGet:
+    !   Retrieves the channels kept for a radiance instrument.
+    !
+    !   Arguments:
+    !     - instrument (character(len=*), intent(in)): The instrument name, eg. iasi_metop-b.
+    !     - channels (integer(c_int), dimension(:), allocatable, intent(out)):
+    !       Receives the sorted channel numbers; not allocated if all channels are kept.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function channelSelectionGet(instrument, channels)
+        character(len = *), intent(in) :: instrument
+        integer(c_int), dimension(:), allocatable, intent(out) :: channels
+        integer(c_int) :: channelSelectionGet
+        type(f_c_string_t) :: f_c_string_instrument
+        type(c_ptr) :: c_instrument
+        integer(c_int) :: nChannels
+        integer(c_int) :: none(1)
+
+        c_instrument = f_c_string_instrument%to_c(trim(instrument))
+        channelSelectionGet = c_channelSelectionGet(c_instrument, none, 0, nChannels)
+        if (channelSelectionGet /= 0 .or. nChannels < 0) return
+        allocate(channels(nChannels))
+        channelSelectionGet = c_channelSelectionGet(c_instrument, channels, int(size(channels), c_int), nChannels)
+    end function channelSelectionGet
+
+    ! netcdfEncodingLoad:
+    !   Loads the output encoding policy from a YAML file, such as
+    !   share/OutputEncoding.yaml. Variables defined afterwards with an entry in
+    !   the policy are stored in narrower or packed types. A policy with entries
+    !   needs ioda_compatible: false, since the files are then not IODA files.
+    !
+    !   Arguments:
+    !     - path (character(len=*), intent(in)): The path of the YAML file.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfEncodingLoad(path)
+        character(len = *), intent(in) :: path
+        integer(c_int) :: netcdfEncodingLoad
+        type(f_c_string_t) :: f_c_string_path
+        type(c_ptr) :: c_path
+
+        c_path = f_c_string_path%to_c(trim(path))
+        netcdfEncodingLoad = c_netcdfEncodingLoad(c_path)
+    end function netcdfEncodingLoad
+
+    ! directoryWatchOpen:
+    !   Starts watching a directory for arriving files (inotify). A file is reported
+    !   once it is closed after writing or moved into the directory.
+    !
+    !   Arguments:
+    !     - path (character(len=*), intent(in)): The path of the directory.
+    !     - watchID (integer(c_int), intent(out)): Receives the ID of the watch.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function directoryWatchOpen(path, watchID)
+        character(len = *), intent(in) :: path
+        integer(c_int), intent(out) :: watchID
+        integer(c_int) :: directoryWatchOpen
+        type(f_c_string_t) :: f_c_string_path
+        type(c_ptr) :: c_path
+
+        c_path = f_c_string_path%to_c(trim(path))
+        directoryWatchOpen = c_directoryWatchOpen(c_path, watchID)
+    end function directoryWatchOpen
+
+    ! directoryWatchNext:
+    !   Waits for the next file to arrive in a watched directory.
+    !
+    !   Arguments:
+    !     - watchID (integer(c_int), intent(in), value): The ID of the watch.
+    !     - timeoutMs (integer(c_int), intent(in), value): The longest wait in
+    !       milliseconds, or a negative value to wait forever.
+    !     - name (character(len=*), intent(out)): The name of the file, relative to
+    !       the directory; blank if the wait timed out or the name is longer than name.
+    !
+    !   Returns:
+    !     - integer(c_int): 0 if a file arrived, 1 if the wait timed out, 2 if a
+    !       file arrived whose name is longer than name, -1 on failure.
+    function directoryWatchNext(watchID, timeoutMs, name)
+        integer(c_int), value, intent(in) :: watchID
+        integer(c_int), value, intent(in) :: timeoutMs
+        character(len = *), intent(out) :: name
+        integer(c_int) :: directoryWatchNext
+        character(kind = c_char), dimension(len(name) + 1) :: c_name
+        integer :: i
+
+        name = ''
+        directoryWatchNext = c_directoryWatchNext(watchID, timeoutMs, c_name, len(name) + 1)
+        if (directoryWatchNext /= 0) return
+        do i = 1, len(name)
+            if (c_name(i) == c_null_char) exit
+            name(i:i) = c_name(i)
+        end do
+    end function directoryWatchNext
+
+    ! directoryWatchClose:
+    !   Stops watching a directory.
+    !
+    !   Arguments:
+    !     - watchID (integer(c_int), intent(in), value): The ID of the watch.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function directoryWatchClose(watchID)
+        integer(c_int), value, intent(in) :: watchID
+        integer(c_int) :: directoryWatchClose
+        directoryWatchClose = c_directoryWatchClose(watchID)
+    end function directoryWatchClose
+
+    ! obsOrder:
+    !   Computes the output order of the locations of an obtype or instrument:
+    !   by dateTime and then, if stationIds is present, by station ID. Consecutive
+    !   locations of the order with the same dateTime and station form one record.
+    !
+    !   Arguments:
+    !     - dateTime (integer(c_long_long), dimension(:), intent(in)): The dateTime
+    !       of each location.
+    !     - order (integer(c_long_long), dimension(:), intent(out)): Receives the 1-based
+    !       indices of the locations in output order.
+    !     - recordNumber (integer(c_long_long), dimension(:), intent(out)): Receives the
+    !       1-based record number of each location of the output order.
+    !     - numRecords (integer(c_long_long), intent(out)): Receives the number of records.
+    !     - stationIds (character(len=*), dimension(*), intent(in), optional): The
+    !       station ID of each location.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function obsOrder(dateTime, order, recordNumber, numRecords, stationIds)
+        integer(c_long_long), dimension(:), intent(in) :: dateTime
+        integer(c_long_long), dimension(:), intent(out) :: order
+        integer(c_long_long), dimension(:), intent(out) :: recordNumber
+        integer(c_long_long), intent(out) :: numRecords
+        character(len = *), dimension(*), intent(in), optional, target :: stationIds
+        integer(c_int) :: obsOrder
+        type(c_ptr) :: c_stationIds
+        integer(c_int) :: stationIdLen
+
+        c_stationIds = c_null_ptr
+        stationIdLen = 0
+        if (present(stationIds)) then
+            c_stationIds = c_loc(stationIds(1))
+            stationIdLen = len(stationIds)
+        end if
+        obsOrder = c_obsOrder(size(dateTime, kind=c_long_long), dateTime, c_stationIds, stationIdLen, &
+                order, recordNumber, numRecords)
+        if (obsOrder == 0) order = order + 1
+    end function obsOrder
+
+    ! spatialOrder:
+    !   Computes the order of locations along a Hilbert curve over the globe, and
+    !   then by dateTime. Locations without a valid latitude and longitude are put last.
+    !
+    !   Arguments:
+    !     - lat (real(c_float), dimension(:), intent(in)): Latitudes in degrees.
+    !     - lon (real(c_float), dimension(:), intent(in)): Longitudes in degrees.
+    !     - dateTime (integer(c_long_long), dimension(:), intent(in)): The dateTime
+    !       of each location.
+    !     - order (integer(c_long_long), dimension(:), intent(out)): Receives the 1-based
+    !       indices of the locations in output order.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function spatialOrder(lat, lon, dateTime, order)
+        real(c_float), dimension(:), intent(in) :: lat
+        real(c_float), dimension(:), intent(in) :: lon
+        integer(c_long_long), dimension(:), intent(in) :: dateTime
+        integer(c_long_long), dimension(:), intent(out) :: order
+        integer(c_int) :: spatialOrder
+
+        spatialOrder = c_spatialOrder(size(dateTime, kind=c_long_long), lat, lon, dateTime, order)
+        if (spatialOrder == 0) order = order + 1
+    end function spatialOrder
+
+    ! netcdfSetLocationBlocks:
+    !   Sets the number of locations per block of the spatial index. While it is
+    !   set, variables along the location dimension of new files are chunked by
+    !   blocks of that many locations.
+    !
+    !   Arguments:
+    !     - blockLocs (integer(c_int), intent(in), value): The number of locations
+    !       per block, or 0 to stop chunking by blocks.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfSetLocationBlocks(blockLocs)
+        integer(c_int), value, intent(in) :: blockLocs
+        integer(c_int) :: netcdfSetLocationBlocks
+        netcdfSetLocationBlocks = c_netcdfSetLocationBlocks(blockLocs)
+    end function netcdfSetLocationBlocks
+
+    ! netcdfPutSpatialIndex:
+    !   Writes the group SpatialIndex of a file: the latitude, longitude and dateTime
+    !   range of every block of locations, for readers to skip the blocks outside
+    !   their region or time window.
+    !
+    !   Arguments:
+    !     - netcdfID (integer(c_int), intent(in), value): The NetCDF ID of the file.
+    !     - lat (real(c_float), dimension(:), intent(in)): Latitudes in degrees.
+    !     - lon (real(c_float), dimension(:), intent(in)): Longitudes in degrees.
+    !     - dateTime (integer(c_long_long), dimension(:), intent(in)): The dateTime
+    !       of each location.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function netcdfPutSpatialIndex(netcdfID, lat, lon, dateTime)
+        integer(c_int), value, intent(in) :: netcdfID
+        real(c_float), dimension(:), intent(in) :: lat
+        real(c_float), dimension(:), intent(in) :: lon
+        integer(c_long_long), dimension(:), intent(in) :: dateTime
+        integer(c_int) :: netcdfPutSpatialIndex
+        netcdfPutSpatialIndex = c_netcdfPutSpatialIndex(netcdfID, size(dateTime, kind=c_long_long), lat, lon, dateTime)
+    end function netcdfPutSpatialIndex
+
+    ! geoFixedGridToLatLon:
+    !   Computes the latitude and longitude of the pixels of a fixed grid.
+    !
+    !   Arguments:
+    !     - proj (type(geos_projection), intent(in)): The projection.
+    !     - x (real(c_double), dimension(:), intent(in)): The E/W scan angle of each
+    !       column in radians.
+    !     - y (real(c_double), dimension(:), intent(in)): The N/S scan angle of each
+    !       row in radians.
+    !     - lat (real(c_float), dimension(:,:), intent(out)): Receives the latitudes
+    !       of the size(x) x size(y) pixels in degrees, missing off the earth.
+    !     - lon (real(c_float), dimension(:,:), intent(out)): Receives the longitudes
+    !       in degrees, -180 to 180, missing off the earth.
+    !     - valid (logical, dimension(:,:), intent(out)): Receives whether a pixel
+    !       is on the earth.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function geoFixedGridToLatLon(proj, x, y, lat, lon, valid)
+        type(geos_projection), intent(in) :: proj
+        real(c_double), dimension(:), intent(in) :: x
+        real(c_double), dimension(:), intent(in) :: y
+        real(c_float), dimension(:,:), intent(out) :: lat
+        real(c_float), dimension(:,:), intent(out) :: lon
+        logical, dimension(:,:), intent(out) :: valid
+        integer(c_int) :: geoFixedGridToLatLon
+        integer(c_int), dimension(:,:), allocatable :: c_valid
+
+        allocate(c_valid(size(x), size(y)))
+        geoFixedGridToLatLon = c_geoFixedGridToLatLon(proj, size(x), size(y), x, y, lat, lon, c_valid)
+        valid = c_valid /= 0
+        deallocate(c_valid)
+    end function geoFixedGridToLatLon
+
+    ! geoSatelliteAngles:
+    !   Computes the zenith and, if requested, the azimuth angle of a geostationary
+    !   satellite at the pixels of a grid.
+    !
+    !   Arguments:
+    !     - proj (type(geos_projection), intent(in)): The projection.
+    !     - lat (real(c_float), dimension(:,:), intent(in)): Latitudes in degrees.
+    !     - lon (real(c_float), dimension(:,:), intent(in)): Longitudes in degrees.
+    !     - zenith (real(c_float), dimension(:,:), intent(out)): Receives the zenith
+    !       angles in degrees, missing for invalid locations.
+    !     - azimuth (real(c_float), dimension(:,:), intent(out), optional): Receives
+    !       the azimuth angles in degrees clockwise from north.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function geoSatelliteAngles(proj, lat, lon, zenith, azimuth)
+        type(geos_projection), intent(in) :: proj
+        real(c_float), dimension(:,:), intent(in) :: lat
+        real(c_float), dimension(:,:), intent(in) :: lon
+        real(c_float), dimension(:,:), intent(out) :: zenith
+        real(c_float), dimension(:,:), intent(out), optional, contiguous, target :: azimuth
+        integer(c_int) :: geoSatelliteAngles
+        type(c_ptr) :: c_azimuth
+
+        c_azimuth = c_null_ptr
+        if (present(azimuth)) c_azimuth = c_loc(azimuth)
+        geoSatelliteAngles = c_geoSatelliteAngles(proj, size(lat), lat, lon, zenith, c_azimuth)
+    end function geoSatelliteAngles
+
+    ! geoSolarAngles:
+    !   Computes the solar zenith and, if requested, azimuth angle at the pixels of
+    !   a grid at one time, as calc_solar_zenith_angle of hsd.f90 does pixel by pixel.
+    !
+    !   Arguments:
+    !     - julian (integer(c_int), intent(in)): The day of the year, 1 to 366.
+    !     - gmt (integer(c_int), intent(in)): The hour, 0 to 23.
+    !     - minute (integer(c_int), intent(in)): The minute, 0 to 59.
+    !     - lat (real(c_float), dimension(:,:), intent(in)): Latitudes in degrees.
+    !     - lon (real(c_float), dimension(:,:), intent(in)): Longitudes in degrees.
+    !     - zenith (real(c_float), dimension(:,:), intent(out)): Receives the solar
+    !       zenith angles in degrees, missing for invalid locations.
+    !     - azimuth (real(c_float), dimension(:,:), intent(out), optional): Receives
+    !       the solar azimuth angles in degrees clockwise from north.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero),
+    !       e.g. for a time out of range.
+    function geoSolarAngles(julian, gmt, minute, lat, lon, zenith, azimuth)
+        integer(c_int), intent(in) :: julian
+        integer(c_int), intent(in) :: gmt
+        integer(c_int), intent(in) :: minute
+        real(c_float), dimension(:,:), intent(in) :: lat
+        real(c_float), dimension(:,:), intent(in) :: lon
+        real(c_float), dimension(:,:), intent(out) :: zenith
+        real(c_float), dimension(:,:), intent(out), optional, contiguous, target :: azimuth
+        integer(c_int) :: geoSolarAngles
+        type(c_ptr) :: c_azimuth
+
+        c_azimuth = c_null_ptr
+        if (present(azimuth)) c_azimuth = c_loc(azimuth)
+        geoSolarAngles = c_geoSolarAngles(julian, gmt, minute, size(lat), lat, lon, zenith, c_azimuth)
+    end function geoSolarAngles
+
+    ! timeToEpoch:
+    !   Converts a date and time, or arrays of them, to seconds since
+    !   1970-01-01T00:00:00Z, as the epoch argument of get_julian_time in utils_mod.
+    !
+    !   Arguments:
+    !     - year, month, day, hour, minute, second (integer(c_int), intent(in)): The
+    !       date and time, scalars or arrays of the same size.
+    !     - epoch (integer(c_long_long), intent(out)): Receives the time in seconds,
+    !       a scalar or an array of the same size. Times with a field out of range,
+    !       e.g. April 31, receive invalid_epoch.
+    !
+    !   Returns:
+    !     - integer(c_int): 0 on success, the number of invalid times, or -1 on failure.
+    function timeToEpochScalar(year, month, day, hour, minute, second, epoch)
+        integer(c_int), intent(in) :: year
+        integer(c_int), intent(in) :: month
+        integer(c_int), intent(in) :: day
+        integer(c_int), intent(in) :: hour
+        integer(c_int), intent(in) :: minute
+        integer(c_int), intent(in) :: second
+        integer(c_long_long), intent(out) :: epoch
+        integer(c_int) :: timeToEpochScalar
+        integer(c_long_long), dimension(1) :: c_epoch
+
+        timeToEpochScalar = c_timeCalendarToEpoch(1, [year], [month], [day], [hour], [minute], [second], c_epoch)
+        epoch = c_epoch(1)
+    end function timeToEpochScalar
+
+    function timeToEpochArray(year, month, day, hour, minute, second, epoch)
+        integer(c_int), dimension(:), intent(in) :: year
+        integer(c_int), dimension(:), intent(in) :: month
+        integer(c_int), dimension(:), intent(in) :: day
+        integer(c_int), dimension(:), intent(in) :: hour
+        integer(c_int), dimension(:), intent(in) :: minute
+        integer(c_int), dimension(:), intent(in) :: second
+        integer(c_long_long), dimension(:), intent(out) :: epoch
+        integer(c_int) :: timeToEpochArray
+
+        timeToEpochArray = c_timeCalendarToEpoch(size(epoch), year, month, day, hour, minute, second, epoch)
+    end function timeToEpochArray
+
+    ! timeDateToEpoch:
+    !   Parses a date ccyymmddhh[nn[ss]], e.g. a file date, into seconds since
+    !   1970-01-01T00:00:00Z.
+    !
+    !   Arguments:
+    !     - date (character(len=*), intent(in)): The date; trailing blanks are ignored.
+    !     - epoch (integer(c_long_long), intent(out)): Receives the time in seconds.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function timeDateToEpoch(date, epoch)
+        character(len = *), intent(in) :: date
+        integer(c_long_long), intent(out) :: epoch
+        integer(c_int) :: timeDateToEpoch
+        type(f_c_string_t) :: f_c_string_date
+        type(c_ptr) :: c_date
+
+        c_date = f_c_string_date%to_c(trim(date))
+        timeDateToEpoch = c_timeDateToEpoch(c_date, epoch)
+    end function timeDateToEpoch
+
+    ! timeWindowSlots:
+    !   Computes the boundaries of the time slots of a window in seconds since
+    !   1970-01-01T00:00:00Z, replacing da_get_time_slots of WRFDA. The first and
+    !   last slot are half as long as the others.
+    !
+    !   Arguments:
+    !     - tmin (character(len=*), intent(in)): The start of the window, ccyymmddhh[nn[ss]].
+    !     - tmax (character(len=*), intent(in)): The end of the window.
+    !     - numSlots (integer(c_int), intent(in)): The number of slots.
+    !     - slots (integer(c_long_long), dimension(0:numSlots), intent(out)):
+    !       Receives the boundaries, tmin first and tmax last.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function timeWindowSlots(tmin, tmax, numSlots, slots)
+        character(len = *), intent(in) :: tmin
+        character(len = *), intent(in) :: tmax
+        integer(c_int), intent(in) :: numSlots
+        integer(c_long_long), dimension(0:numSlots), intent(out) :: slots
+        integer(c_int) :: timeWindowSlots
+        integer(c_long_long) :: windowBegin
+        integer(c_long_long) :: windowEnd
+
+        timeWindowSlots = timeDateToEpoch(tmin, windowBegin)
+        if (timeWindowSlots == 0) timeWindowSlots = timeDateToEpoch(tmax, windowEnd)
+        if (timeWindowSlots /= 0) return
+        timeWindowSlots = c_timeWindowSlots(windowBegin, windowEnd, numSlots, slots)
+    end function timeWindowSlots
+
+    ! timeEpochToDatetime:
+    !   Formats times as ccyy-mm-ddThh:mm:ssZ strings, all in one call.
+    !
+    !   Arguments:
+    !     - epoch (integer(c_long_long), dimension(:), intent(in)): The times in
+    !       seconds since 1970-01-01T00:00:00Z.
+    !     - datetimes (character(len=*), dimension(:), intent(out)): Receives the
+    !       strings, blank-padded or truncated to the length of datetimes.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating success (0) or failure (non-zero).
+    function timeEpochToDatetime(epoch, datetimes)
+        integer(c_long_long), dimension(:), intent(in) :: epoch
+        character(len = *), dimension(:), intent(out) :: datetimes
+        integer(c_int) :: timeEpochToDatetime
+        integer(c_int), parameter :: datetime_len = 20
+        character(kind = c_char), dimension(:), allocatable :: c_datetimes
+        character(len = datetime_len) :: datetime
+        integer :: i
+
+        allocate(c_datetimes(max(1, size(epoch)) * datetime_len))
+        timeEpochToDatetime = c_timeEpochToDatetime(size(epoch), epoch, c_datetimes)
+        do i = 1, min(size(epoch), size(datetimes))
+            datetime = transfer(c_datetimes((i - 1) * datetime_len + 1:i * datetime_len), datetime)
+            datetimes(i) = datetime
+        end do
+    end function timeEpochToDatetime
+
+    ! toSizes:
+    !   Converts Fortran indices or lengths to the 64-bit sizes of the C++ interface.
+    !
+    !   Arguments:
+    !     - values (class(*), dimension(:), intent(in)): The indices or lengths,
+    !       integer(c_int) or integer(c_long).
+    !     - offset (integer(c_int), intent(in)): Subtracted from each value, 1 for
+    !       one-based indices and 0 for lengths.
+    !     - sizes (integer(c_size_t), dimension(:), allocatable, intent(out)):
+    !       Receives the converted values.
+    !
+    !   Returns:
+    !     - integer(c_int): A status code indicating the outcome of the operation:
+    !         -  0: Success.
+    !         - -2: Unsupported type passed for values.
+    !         - -3: A value less than offset.
+    function toSizes(values, offset, sizes)
+        class(*), dimension(:), intent(in) :: values
+        integer(c_int), intent(in) :: offset
+        integer(c_size_t), dimension(:), allocatable, intent(out) :: sizes
+        integer(c_int) :: toSizes
+
+        select type (values)
+        type is (integer(c_int))
+            sizes = int(values, c_size_t) - offset
+        type is (integer(c_long))
+            sizes = int(values, c_size_t) - offset
+        class default
+            toSizes = -2
+            return
+        end select
+        toSizes = 0
+        if (any(sizes < 0)) toSizes = -3
+    end function toSizes
+
 end module netcdf_cxx_mod
@@ -8,7 +8,9 @@ use define_mod, only: nobtype, set_obtype_conv, obtype_list, xdata, &
    t_kelvin, missing_r, missing_i, vflag, itrue, ifalse, nstring, ndatetime, not_use, &
    dtime_min, dtime_max
 use ufo_vars_mod, only: ufo_vars_getindex, var_prs, var_u, var_v, var_ts, var_tv, var_q, var_ps
-use utils_mod, only: get_julian_time, da_advance_time, da_get_time_slots
+use utils_mod, only: da_advance_time, get_time_slot
+use netcdf_cxx_mod, only: timeDateToEpoch, timeWindowSlots
+use qc_rules_mod, only: qc_evaluate, nqc_check, qc_qm, qc_prs, qc_qi
 use netcdf, only: nf90_int, nf90_float, nf90_char, nf90_int64
 
 implicit none
@@ -40,7 +42,6 @@ type each_level_type
    real(r_kind)       :: dhr          ! obs time minus analysis time in hour
    real(r_kind)       :: pccf         ! percent confidence
    integer(i_llong)   :: epochtime
-   character(len=ndatetime) :: datetime     ! ccyy-mm-ddThh:mm:ssZ
    type (each_level_type), pointer :: next => null()
    contains
      procedure :: init => init_each_level
@@ -53,9 +54,7 @@ type report_conv
    integer(i_kind)           :: satid       ! satellite id
    character(len=nstring)    :: msg_type    ! BUFR message type name
    character(len=nstring)    :: stid        ! station identifier
-   character(len=ndatetime)  :: datetime    ! ccyy-mm-ddThh:mm:ssZ
    integer(i_kind)           :: nlevels     ! number of levels
-   real(r_double)            :: gstime
    integer(i_llong)          :: epochtime
    real(r_kind)              :: lat         ! latitude in degree
    real(r_kind)              :: lon         ! longitude in degree
@@ -78,8 +77,10 @@ end type report_conv
 type(report_conv), pointer :: phead=>null(), plink=>null()
 
 integer(i_kind), parameter :: lim_qm = 4
+! valid report times, 1900-01-01T00:00:00Z to 3000-12-31T23:59:59Z
+integer(i_llong), parameter :: epochtime_1900 = -2208988800_i_llong
+integer(i_llong), parameter :: epochtime_3001 = 32535216000_i_llong
 logical :: do_tv_to_ts
-real(r_double) :: rtmp
 
 contains
 
@@ -109,10 +110,10 @@ subroutine read_prepbufr(filename, filedate)
    real(r_double)    :: satqc(1), satid(1)
    equivalence (r8sid, csid), (r8sid2, csid2)
 
-   character(len=14) :: cdate, dsec, obs_date, cdate_min, cdate_max
-   integer(i_kind)   :: idate, idate2
+   character(len=14) :: cdate
+   integer(i_kind)   :: idate, idate2, epoch_idate
+   integer(i_llong)  :: idate_epochtime, epochtime
    integer(i_kind)   :: nlevels, nlevels2, lv1, lv2
-   integer(i_kind)   :: iyear, imonth, iday, ihour, imin, isec
    integer(i_kind)   :: num_report_infile
    integer(i_kind)   :: iret, iret2, iost, n, i, j, k, i1, i2
    integer(i_kind)   :: kx, t29
@@ -144,6 +145,7 @@ subroutine read_prepbufr(filename, filedate)
    !do_tv_to_ts       = .false. !assignment moved to main.f90
 
    num_report_infile  = 0
+   epoch_idate = -1
 
    iunit = 96
    junit = 97
@@ -430,18 +432,14 @@ subroutine read_prepbufr(filename, filedate)
       ! the following allows reports at the poles
       !if ( abs(hdr(2)-360.0) < 0.01 .or. abs(hdr(3)-90.0) < 0.01 ) cycle reports
 
-      write(dsec,'(i6,a1)') int(hdr(4)*60.0*60.0), 's' ! seconds
-      write(cdate,'(i10)') idate
-      call da_advance_time (cdate(1:10), trim(dsec), obs_date)
-      read (obs_date(1:14),'(i4,5i2)') iyear, imonth, iday, ihour, imin, isec
-      if ( iyear  < 1900 .or. iyear  > 3000 .or. &
-           imonth <    1 .or. imonth >   12 .or. &
-           iday   <    1 .or. iday   >   31 .or. &
-           ihour  <    0 .or. ihour  >=  24 .or. &
-           imin   <    0 .or. imin   >=  60 .or. &
-           isec   <    0 .or. isec   >=  60 ) then
-         cycle reports
+      ! the report time is the message time plus hdr(4) hours
+      if ( idate /= epoch_idate ) then
+         write(cdate,'(i10)') idate
+         if ( timeDateToEpoch(cdate(1:10), idate_epochtime) /= 0 ) cycle reports
+         epoch_idate = idate
       end if
+      epochtime = idate_epochtime + int(hdr(4)*60.0*60.0)
+      if ( epochtime < epochtime_1900 .or. epochtime >= epochtime_3001 ) cycle reports
 
       if (.not. associated(plink)) then
          plink => phead
@@ -466,10 +464,7 @@ subroutine read_prepbufr(filename, filedate)
 
       if ( plink % lon < 360. .and. plink % lon > 180. ) plink % lon = plink % lon - 360.
 
-      write(unit=plink%datetime, fmt='(i4,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a)')  &
-         iyear, '-', imonth, '-', iday, 'T', ihour, ':', imin, ':', isec, 'Z'
-
-      call get_julian_time(iyear, imonth, iday, ihour, imin, isec, plink%gstime, plink%epochtime)
+      plink % epochtime     = epochtime
 
       if ( satid(1) < r8bfms )  then
          plink % satid = nint(satid(1))
@@ -529,12 +524,7 @@ subroutine read_prepbufr(filename, filedate)
             if ( drf(2,k) < r8bfms ) plink % each % lat = drf(2,k)
             if ( drf(3,k) < r8bfms ) then
                plink % each % dhr = drf(3,k)
-               write(dsec,'(i6,a1)') int(drf(3,k)*60.0*60.0), 's' ! seconds
-               call da_advance_time (cdate(1:10), trim(dsec), obs_date)
-               read (obs_date(1:14),'(i4,5i2)') iyear, imonth, iday, ihour, imin, isec
-               write(unit=plink%each%datetime, fmt='(i4,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a)')  &
-                  iyear, '-', imonth, '-', iday, 'T', ihour, ':', imin, ':', isec, 'Z'
-               call get_julian_time(iyear, imonth, iday, ihour, imin, isec, rtmp, plink%each%epochtime)
+               plink % each % epochtime = idate_epochtime + int(drf(3,k)*60.0*60.0)
             end if
 
             if ( plink%each%lon < 360. .and. plink%each%lon > 180. ) plink%each%lon = plink%each%lon-360.
@@ -678,13 +668,16 @@ subroutine sort_obs_conv(filedate, nfgat)
    character(len=12)                     :: obtype
    logical,         dimension(nvar_met)  :: vmask ! for counting available variables for one obtype
    character(len=14) :: cdate_min, cdate_max
-   real(r_double) :: time_slots(0:nfgat)
+   integer(i_llong) :: time_slots(0:nfgat)
 
    write(*,*) '--- sorting conv obs...'
 
    call da_advance_time(filedate, dtime_min, cdate_min)
    call da_advance_time(filedate, dtime_max, cdate_max)
-   call da_get_time_slots(nfgat, cdate_min, cdate_max, time_slots)
+   if ( timeWindowSlots(cdate_min, cdate_max, nfgat, time_slots) /= 0 ) then
+      write(*,*) 'Error: invalid time window ', cdate_min, ' to ', cdate_max
+      stop 1
+   end if
 
    nrecs(:,:) = 0
    nlocs(:,:) = 0
@@ -700,13 +693,7 @@ subroutine sort_obs_conv(filedate, nfgat)
       !call set_obtype_conv(plink%t29, plink%obtype)
 
       ! determine time_slot index
-      do i = 1, nfgat
-         if ( plink%gstime >= time_slots(i-1) .and.  &
-              plink%gstime <= time_slots(i) ) then
-             exit
-         end if
-      end do
-      plink%ifgat = i
+      plink%ifgat = get_time_slot(plink%epochtime, time_slots)
 
       ! find index of obtype in obtype_list
       plink%obtype_idx = ufo_vars_getindex(obtype_list, plink%obtype)
@@ -824,13 +811,7 @@ subroutine sort_obs_conv(filedate, nfgat)
                   xdata(ityp,itim)%xinfo_float(iloc(ityp,itim),i) = plink%each%p%val
                end if
             else if ( type_var_info(i) == nf90_char ) then
-               if ( trim(name_var_info(i)) == 'datetime' ) then
-                  if ( plink%each%dhr > missing_r ) then  ! time drift
-                     xdata(ityp,itim)%xinfo_char(iloc(ityp,itim),i) = plink%each%datetime
-                  else
-                     xdata(ityp,itim)%xinfo_char(iloc(ityp,itim),i) = plink%datetime
-                  end if
-               else if ( trim(name_var_info(i)) == 'station_id' ) then
+               if ( trim(name_var_info(i)) == 'station_id' ) then
                   xdata(ityp,itim)%xinfo_char(iloc(ityp,itim),i) = plink%stid
                end if
             else if ( type_var_info(i) == nf90_int64 ) then
@@ -904,289 +885,206 @@ subroutine filter_obs_conv
 
 ! refer to GSI/read_prepbufr.f90
 !
-! iuse information is extracted from global_convinfo.txt
-! to do: come up with a better way to handle iuse
+! the use flags, quality marker limits and pressure bounds of each report
+! type are the rules of qc_rules_mod (from global_convinfo.txt unless replaced
+! with -qcrules). The levels are gathered into columns, checked with one vector
+! pass per variable, and the updated quality markers and errors are scattered
+! back to the linked list.
 
    implicit none
 
-   logical         :: adjust_obserr
-   integer(i_kind) :: zqm
-   integer(i_kind) :: k
-   integer(i_kind) :: iuse_ps
-   integer(i_kind) :: iuse_uv
-   integer(i_kind) :: iuse_t
-   integer(i_kind) :: iuse_tv
-   integer(i_kind) :: iuse_q
-   real(r_kind)    :: hpa500 = 50000.0
-   real(r_kind)    :: hpa100 = 10000.0
-   real(r_kind)    :: inflate_factor = 1.2
-
-   adjust_obserr = .false.
+   integer(i_kind), parameter :: ips = 1, iu = 2, iv = 3, it = 4, itv = 5, iq = 6, nqc = 6
+   integer(i_kind)              :: n, i
+   integer(i_kind), allocatable :: rptype(:), satid(:), qm(:,:), zqm(:), pqm(:)
+   real(r_kind),    allocatable :: err(:,:), prs(:), psval(:), pccf(:)
+   real(r_kind),    allocatable :: cols(:,:), inflate_qm(:), inflate_ptop(:)
+   logical,         allocatable :: has_ps(:), used(:), listed(:)
 
    write(*,*) '--- filtering conv obs ---'
-   plink => phead
-   link_loop: do while ( associated(plink) )
 
+   n = 0
+   plink => phead
+   do while ( associated(plink) )
       plink % each => plink % first
+      do while ( associated(plink % each) )
+         n = n + 1
+         plink % each => plink % each % next
+      end do
+      plink => plink % next
+   end do
+   if ( n == 0 ) return
+
+   allocate (rptype(n), satid(n), qm(n,nqc), zqm(n), pqm(n), err(n,nqc), prs(n), psval(n), pccf(n))
+   allocate (cols(n,nqc_check), inflate_qm(n), inflate_ptop(n), has_ps(n), used(n), listed(n))
 
+   ! gather the levels into columns
+   i = 0
+   plink => phead
+   gather_loop: do while ( associated(plink) )
+
+      plink % each => plink % first
       do while ( associated(plink % each) )
+         i = i + 1
+
+         call adjust_wind_height
+
+         rptype(i) = plink % rptype
+         satid(i)  = plink % satid
+         ! surface pressure is checked once per sfc report
+         has_ps(i) = trim(plink%obtype) == 'sfc' .and. associated(plink % each, plink % first)
+         qm(i,ips) = plink % ps % qm
+         qm(i,iu)  = plink % each % u  % qm
+         qm(i,iv)  = plink % each % v  % qm
+         qm(i,it)  = plink % each % t  % qm
+         qm(i,itv) = plink % each % tv % qm
+         qm(i,iq)  = plink % each % q  % qm
+         err(i,ips) = plink % ps % err
+         err(i,iu)  = plink % each % u  % err
+         err(i,iv)  = plink % each % v  % err
+         err(i,it)  = plink % each % t  % err
+         err(i,itv) = plink % each % tv % err
+         err(i,iq)  = plink % each % q  % err
+         zqm(i)   = plink % each % h % qm
+         pqm(i)   = plink % each % p % qm
+         prs(i)   = plink % each % p % val
+         psval(i) = plink % ps % val
+         pccf(i)  = plink % each % pccf
 
-         if ( trim(plink%obtype) == 'sfc' ) then
+         plink % each => plink % each % next
+      end do
 
-            ! initialize as not used
-            iuse_ps = ifalse
+      plink => plink%next
+   end do gather_loop
+
+   cols(:,:) = missing_r
+   cols(:,qc_qi) = pccf
+
+   ! surface pressure, also not used with a bad height quality marker
+   cols(:,qc_qm)  = real(max(qm(:,ips), zqm), r_kind)
+   cols(:,qc_prs) = psval
+   call qc_evaluate('ps', n, rptype, satid, cols, .false., used, listed=listed, inflate_qm=inflate_qm)
+   where ( has_ps .and. listed .and. zqm >= lim_qm .and. zqm /= 15 .and. zqm /= 9 )
+      qm(:,ips) = 9
+   end where
+   call apply_qc(used, inflate_qm, qm(:,ips), err(:,ips), mask=has_ps)
+
+   ! level variables are not used with a bad pressure quality marker
+   cols(:,qc_prs) = prs
+
+   cols(:,qc_qm) = real(max(qm(:,iu), qm(:,iv), pqm), r_kind)
+   call qc_evaluate('uv', n, rptype, satid, cols, .false., used, inflate_qm=inflate_qm, inflate_ptop=inflate_ptop)
+   call apply_qc(used, inflate_qm, qm(:,iu), err(:,iu), inflate_ptop)
+   call apply_qc(used, inflate_qm, qm(:,iv), err(:,iv), inflate_ptop)
+
+   cols(:,qc_qm) = real(max(qm(:,it), pqm), r_kind)
+   call qc_evaluate('t', n, rptype, satid, cols, .false., used, inflate_qm=inflate_qm, inflate_ptop=inflate_ptop)
+   call apply_qc(used, inflate_qm, qm(:,it), err(:,it), inflate_ptop)
+
+   cols(:,qc_qm) = real(max(qm(:,itv), pqm), r_kind)
+   call qc_evaluate('tv', n, rptype, satid, cols, .false., used, inflate_qm=inflate_qm, inflate_ptop=inflate_ptop)
+   call apply_qc(used, inflate_qm, qm(:,itv), err(:,itv), inflate_ptop)
+
+   cols(:,qc_qm) = real(max(qm(:,iq), pqm), r_kind)
+   call qc_evaluate('q', n, rptype, satid, cols, .false., used, inflate_qm=inflate_qm, inflate_ptop=inflate_ptop)
+   call apply_qc(used, inflate_qm, qm(:,iq), err(:,iq), inflate_ptop)
+
+   ! scatter the quality markers and errors back
+   i = 0
+   plink => phead
+   scatter_loop: do while ( associated(plink) )
 
-            if ( plink%rptype == 120 .or. &
-                 plink%rptype == 180 .or. &
-                 plink%rptype == 181 .or. &
-                 plink%rptype == 182 .or. &
-                 plink%rptype == 187 ) then
+      plink % each => plink % first
+      do while ( associated(plink % each) )
+         i = i + 1
+         if ( has_ps(i) ) then
+            plink % ps % qm  = qm(i,ips)
+            plink % ps % err = err(i,ips)
+         end if
+         plink % each % u  % qm = qm(i,iu)
+         plink % each % v  % qm = qm(i,iv)
+         plink % each % t  % qm = qm(i,it)
+         plink % each % tv % qm = qm(i,itv)
+         plink % each % q  % qm = qm(i,iq)
+         plink % each % u  % err = err(i,iu)
+         plink % each % v  % err = err(i,iv)
+         plink % each % t  % err = err(i,it)
+         plink % each % tv % err = err(i,itv)
+         plink % each % q  % err = err(i,iq)
 
-               iuse_ps = itrue
+         plink % each => plink % each % next
+      end do
 
-               zqm = plink % each % h % qm
-               if ( zqm >= lim_qm .and. zqm /= 15 .and. zqm /= 9 ) then
-                  plink % ps % qm = 9
-               end if
+      plink => plink%next
+   end do scatter_loop
 
-               if ( plink % ps % val < hpa500 .or. plink % ps % qm >= lim_qm .or. &
-                    zqm >= lim_qm ) then
-                  iuse_ps = ifalse
-               end if
+   deallocate (rptype, satid, qm, zqm, pqm, err, prs, psval, pccf)
+   deallocate (cols, inflate_qm, inflate_ptop, has_ps, used, listed)
 
-               if ( adjust_obserr ) then
-                  if ( plink % ps % qm == 3 .or. plink % ps % qm == 7 ) then
-                     plink % ps % err = plink % ps % err * inflate_factor
-                  end if
-               end if
-            end if
+contains
 
-            if ( iuse_ps == ifalse .and. plink % ps % qm /= missing_i ) then
-               plink % ps % qm = plink % ps % qm + not_use
-            end if
-         end if
+   ! adjust observation height for wind reports
+   subroutine adjust_wind_height
 
-         ! initialize as not used
-         iuse_uv = ifalse
-         iuse_t  = ifalse
-         iuse_tv = ifalse
-         iuse_q  = ifalse
-
-         ! adjust observation height for wind reports
-         if ( plink % rptype >= 280 .and. plink % rptype < 300 ) then
-            plink % each % h % val = plink % elv + 10.0
-            if ( plink % rptype == 280 ) then
-               if ( plink % t29 == 522 .or. &
-                    plink % t29 == 523 .or. &
-                    plink % t29 == 531 ) then
-                  plink % each % h % val = 20.0
-               end if
-            end if
-            if ( plink % rptype == 282 ) then
-               plink % each % h % val = plink % elv + 20.0
-            end if
-            if ( plink % rptype == 285 .or. &
-                 plink % rptype == 286 .or. &
-                 plink % rptype == 289 .or. &
-                 plink % rptype == 290 ) then
-               plink % each % h % val = plink % elv
-               plink % elv = 0.0
-            end if
-         else
-            if ( plink % rptype >= 221 .and. plink % rptype <= 229 ) then
-               if ( abs(plink % each % h % val - missing_r) > 0.01 ) then
-                  if ( plink % elv >= plink % each % h % val ) then
-                     plink % each % h % val = plink % elv + 10.0
-                  end if
-               end if
+      if ( plink % rptype >= 280 .and. plink % rptype < 300 ) then
+         plink % each % h % val = plink % elv + 10.0
+         if ( plink % rptype == 280 ) then
+            if ( plink % t29 == 522 .or. &
+                 plink % t29 == 523 .or. &
+                 plink % t29 == 531 ) then
+               plink % each % h % val = 20.0
             end if
-         end if ! wind types
-
-         if ( plink%rptype == 120 .or. &
-              plink%rptype == 132 .or. &
-              plink%rptype == 133 .or. &
-              plink%rptype == 180 .or. &
-              plink%rptype == 182 ) then
-            if ( plink % each % q % qm < lim_qm ) iuse_q = itrue
          end if
-
-         if ( plink%rptype == 120 .or. &
-              plink%rptype == 130 .or. &
-              plink%rptype == 132 .or. &
-              plink%rptype == 133 .or. &
-              plink%rptype == 180 .or. &
-              plink%rptype == 182 ) then
-            if ( plink % each % t  % qm < lim_qm ) iuse_t  = itrue
-            if ( plink % each % tv % qm < lim_qm ) iuse_tv = itrue
+         if ( plink % rptype == 282 ) then
+            plink % each % h % val = plink % elv + 20.0
          end if
-
-         if ( plink%rptype == 220 .or. &
-              plink%rptype == 221 .or. &
-              plink%rptype == 223 .or. &
-              plink%rptype == 224 .or. &
-              plink%rptype == 229 .or. &
-              plink%rptype == 230 .or. &
-              plink%rptype == 231 .or. &
-              plink%rptype == 232 .or. &
-              plink%rptype == 233 .or. &
-              plink%rptype == 280 .or. &
-              plink%rptype == 282 .or. &
-              plink%rptype == 289 .or. &
-              plink%rptype == 290 ) then
-            if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-         else if ( plink%rptype >= 241 .and. plink%rptype <= 260 ) then
-            if ( plink%rptype == 242 ) then
-               if ( plink % satid == 171 .or. &
-                    plink % satid == 172 .or. &
-                    plink % satid == 173 .or. &
-                    plink % satid == 174 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 243 ) then
-               if ( plink % satid ==  55 .or. &
-                    plink % satid ==  70 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 244 ) then
-               if ( plink % satid ==   3 .or. &
-                    plink % satid ==   4 .or. &
-                    plink % satid == 206 .or. &
-                    plink % satid == 207 .or. &
-                    plink % satid == 209 .or. &
-                    plink % satid == 223 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 245 ) then
-               if ( plink % satid == 259 .or. &
-                    plink % satid == 270 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 246 ) then
-               if ( plink % satid == 259 .or. &
-                    plink % satid == 270 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 247 ) then
-               if ( plink % satid == 259 .or. &
-                    plink % satid == 270 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 250 ) then
-               if ( plink % satid == 171 .or. &
-                    plink % satid == 172 .or. &
-                    plink % satid == 173 .or. &
-                    plink % satid == 174 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 252 ) then
-               if ( plink % satid == 171 .or. &
-                    plink % satid == 172 .or. &
-                    plink % satid == 173 .or. &
-                    plink % satid == 174 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 253 ) then
-               if ( plink % satid ==  55 .or. &
-                    plink % satid ==  70 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 254 ) then
-               if ( plink % satid ==  55 .or. &
-                    plink % satid ==  70 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 257 ) then
-               if ( plink % satid == 783 .or. &
-                    plink % satid == 784 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 258 ) then
-               if ( plink % satid == 783 .or. &
-                    plink % satid == 784 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 259 ) then
-               if ( plink % satid == 783 .or. &
-                    plink % satid == 784 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
-               end if
-            else if ( plink%rptype == 260 ) then
-               if ( plink % satid == 224 ) then
-                  if ( plink % each % u % qm < lim_qm .and. plink % each % v % qm < lim_qm ) iuse_uv = itrue
+         if ( plink % rptype == 285 .or. &
+              plink % rptype == 286 .or. &
+              plink % rptype == 289 .or. &
+              plink % rptype == 290 ) then
+            plink % each % h % val = plink % elv
+            plink % elv = 0.0
+         end if
+      else
+         if ( plink % rptype >= 221 .and. plink % rptype <= 229 ) then
+            if ( abs(plink % each % h % val - missing_r) > 0.01 ) then
+               if ( plink % elv >= plink % each % h % val ) then
+                  plink % each % h % val = plink % elv + 10.0
                end if
             end if
          end if
+      end if ! wind types
 
-         if ( plink%rptype == 243 .or. &
-              plink%rptype == 253 .or. &
-              plink%rptype == 254 ) then
-            if ( iuse_uv == itrue .and. plink % each % pccf < 85.0 ) then
-               iuse_uv = ifalse
-            end if
-         end if
+   end subroutine adjust_wind_height
 
-         if ( plink % each % p % qm >= lim_qm ) then
-            iuse_uv = ifalse
-            iuse_t  = ifalse
-            iuse_tv = ifalse
-            iuse_q  = ifalse
-         end if
+end subroutine filter_obs_conv
 
-         if ( iuse_uv == ifalse .and. plink % each % u  % qm /= missing_i ) then
-            plink % each % u % qm = plink % each % u % qm + not_use
-         end if
-         if ( iuse_uv == ifalse .and. plink % each % v  % qm /= missing_i ) then
-            plink % each % v % qm = plink % each % v % qm + not_use
-         end if
-         if ( iuse_t  == ifalse .and. plink % each % t  % qm /= missing_i ) then
-            plink % each % t % qm = plink % each % t % qm + not_use
-         end if
-         if ( iuse_tv == ifalse .and. plink % each % tv % qm /= missing_i ) then
-            plink % each % tv % qm = plink % each % tv % qm + not_use
-         end if
-         if ( iuse_q  == ifalse .and. plink % each % q  % qm /= missing_i ) then
-            plink % each % q % qm = plink % each % q % qm + not_use
-         end if
+!--------------------------------------------------------------
 
-         if ( adjust_obserr ) then
-            if ( plink % each % p % val < hpa100 ) then
-               if ( abs(plink % each%t%err - missing_r) > 0.01 ) then
-                  plink % each % t  % err = plink % each % t  % err * inflate_factor
-               end if
-               if ( abs(plink % each%tv%err - missing_r) > 0.01 ) then
-                  plink % each % tv % err = plink % each % tv % err * inflate_factor
-               end if
-            end if
-            if ( plink % each % t % qm == 3 .or. &
-                 plink % each % t % qm == 7  ) then
-               plink % each % t % err = plink % each % t % err * inflate_factor
-            end if
-            if ( plink % each % tv % qm == 3 .or. &
-                 plink % each % tv % qm == 7  ) then
-               plink % each % tv % err = plink % each % tv % err * inflate_factor
-            end if
-            if ( plink % each % u % qm == 3 .or. &
-                 plink % each % u % qm == 7  ) then
-               plink % each % u % err = plink % each % u % err * inflate_factor
-            end if
-            if ( plink % each % v % qm == 3 .or. &
-                 plink % each % v % qm == 7  ) then
-               plink % each % v % err = plink % each % v % err * inflate_factor
-            end if
-            if ( plink % each % q % qm == 3 .or. &
-                 plink % each % q % qm == 7  ) then
-               plink % each % q % err = plink % each % q % err * inflate_factor
-            end if
-         end if
+subroutine apply_qc(used, inflate_qm, qm, err, inflate_ptop, mask)
 
-         plink % each => plink % each%next
+! mark the observations that are not used and inflate the errors of the used ones
 
-      end do ! nlevels
+   implicit none
 
-      plink => plink%next
-   end do link_loop
+   logical,         dimension(:),           intent(in)    :: used
+   real(r_kind),    dimension(:),           intent(in)    :: inflate_qm
+   integer(i_kind), dimension(:),           intent(inout) :: qm
+   real(r_kind),    dimension(:),           intent(inout) :: err
+   real(r_kind),    dimension(:), optional, intent(in)    :: inflate_ptop
+   logical,         dimension(:), optional, intent(in)    :: mask
 
-end subroutine filter_obs_conv
+   logical, dimension(size(qm)) :: apply
+
+   apply(:) = .true.
+   if ( present(mask) ) apply(:) = mask(:)
+
+   if ( present(inflate_ptop) ) then
+      where ( apply .and. abs(err - missing_r) > 0.01 ) err = err * inflate_ptop
+   end if
+   where ( apply .and. .not. used .and. qm /= missing_i ) qm = qm + not_use
+   where ( apply .and. (qm == 3 .or. qm == 7) .and. abs(err - missing_r) > 0.01 ) err = err * inflate_qm
+
+end subroutine apply_qc
 
 !--------------------------------------------------------------
 
@@ -1219,7 +1117,6 @@ subroutine init_each_level(self)
   self % lon  = rfill
   self % dhr  = rfill
   self % pccf = rfill
-  self % datetime = ''
   call self % h  % init()
   call self % u  % init()
   call self % v  % init()
@@ -1243,7 +1140,6 @@ subroutine init_report(self)
 
    self % msg_type  = ''
    self % stid      = ''
-   self % datetime  = ''
    self % lon       = rfill
    self % lat       = rfill
    self % dhr       = rfill
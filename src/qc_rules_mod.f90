@@ -0,0 +1,497 @@
+module qc_rules_mod
+
+! Table-driven quality control of conventional observations and AMVs.
+!
+! The rules follow GSI global_convinfo.txt: for a variable, a report type
+! (rptype, 0 for all) and a satellite (satid, 0 for all), a row either sets
+! the use flag or bounds one quantity of the observation:
+!
+!    ! var  rptype  satid  check      min     max
+!      uv   243     55     use        1       -
+!      uv   243     0      qi         85.     -
+!      ps   0       0      prs        50000.  -
+!
+! check is one of
+!    use           min > 0: used, min <= 0: not used
+!    qm            quality marker
+!    prs           pressure in Pa
+!    qi            quality indicator (percent confidence)
+!    satzen        satellite zenith angle in degree
+!    experr        AMV expected error over wind speed
+!    cvwd          AMV coefficient of variation
+!    prs_land      pressure in Pa over land (-999. elsewhere)
+!    inflate       multiply the error of quality markers 3 and 7 by min
+!    inflate_ptop  multiply the error of observations above max (Pa) by min
+! and - leaves a bound open. Values outside [min,max] are rejected; missing
+! values (-999.) are compared like any other value.
+!
+! Rows for rptype 0 apply to every report type, rows for satid 0 to every
+! satellite of the report type; more specific rows add to them and their use
+! flag replaces the less specific one. The rows of a variable are compiled into
+! one group of bounds per (rptype, satid) and a lookup table, so a check is a
+! gather of the bounds and a vector comparison per quantity.
+!
+! read_qc_rules replaces the built-in default_rules, which are the rules of
+! filter_obs_conv and filter_obs_satwnd from GSI read_prepbufr.f90 and
+! read_satwnd.f90 (with EC AMV QC).
+
+use kinds, only: r_kind, i_kind
+use define_mod, only: StrLen
+
+implicit none
+private
+public :: read_qc_rules
+public :: qc_evaluate
+public :: nqc_check, qc_qm, qc_prs, qc_qi, qc_satzen, qc_experr, qc_cvwd, qc_prs_land
+
+! quantities that can be bounded, columns of the cols argument of qc_evaluate
+integer(i_kind), parameter :: nqc_check   = 7
+integer(i_kind), parameter :: qc_qm       = 1
+integer(i_kind), parameter :: qc_prs      = 2
+integer(i_kind), parameter :: qc_qi       = 3
+integer(i_kind), parameter :: qc_satzen   = 4
+integer(i_kind), parameter :: qc_experr   = 5
+integer(i_kind), parameter :: qc_cvwd     = 6
+integer(i_kind), parameter :: qc_prs_land = 7
+character(len=12), parameter :: check_names(nqc_check) = &
+   (/ 'qm          ', 'prs         ', 'qi          ', 'satzen      ', &
+      'experr      ', 'cvwd        ', 'prs_land    ' /)
+
+integer(i_kind), parameter :: max_qc_rules = 1000
+real(r_kind),    parameter :: no_bound     = huge(1.0_r_kind)
+
+character(len=48), parameter :: default_rules(*) = [character(len=48) :: &
+   ! var  rptype  satid  check      min     max
+   ! prepbufr: quality markers of 4 and above and of the level pressure are not used
+   'ps    0    0    qm         -       3     ', &
+   'uv    0    0    qm         -       3     ', &
+   't     0    0    qm         -       3     ', &
+   'tv    0    0    qm         -       3     ', &
+   'q     0    0    qm         -       3     ', &
+   'ps    0    0    prs        50000.  -     ', &
+   'ps    120  0    use        1       -     ', &
+   'ps    180  0    use        1       -     ', &
+   'ps    181  0    use        1       -     ', &
+   'ps    182  0    use        1       -     ', &
+   'ps    187  0    use        1       -     ', &
+   'q     120  0    use        1       -     ', &
+   'q     132  0    use        1       -     ', &
+   'q     133  0    use        1       -     ', &
+   'q     180  0    use        1       -     ', &
+   'q     182  0    use        1       -     ', &
+   't     120  0    use        1       -     ', &
+   't     130  0    use        1       -     ', &
+   't     132  0    use        1       -     ', &
+   't     133  0    use        1       -     ', &
+   't     180  0    use        1       -     ', &
+   't     182  0    use        1       -     ', &
+   'tv    120  0    use        1       -     ', &
+   'tv    130  0    use        1       -     ', &
+   'tv    132  0    use        1       -     ', &
+   'tv    133  0    use        1       -     ', &
+   'tv    180  0    use        1       -     ', &
+   'tv    182  0    use        1       -     ', &
+   'uv    220  0    use        1       -     ', &
+   'uv    221  0    use        1       -     ', &
+   'uv    223  0    use        1       -     ', &
+   'uv    224  0    use        1       -     ', &
+   'uv    229  0    use        1       -     ', &
+   'uv    230  0    use        1       -     ', &
+   'uv    231  0    use        1       -     ', &
+   'uv    232  0    use        1       -     ', &
+   'uv    233  0    use        1       -     ', &
+   'uv    280  0    use        1       -     ', &
+   'uv    282  0    use        1       -     ', &
+   'uv    289  0    use        1       -     ', &
+   'uv    290  0    use        1       -     ', &
+   'uv    242  171  use        1       -     ', &
+   'uv    242  172  use        1       -     ', &
+   'uv    242  173  use        1       -     ', &
+   'uv    242  174  use        1       -     ', &
+   'uv    243  55   use        1       -     ', &
+   'uv    243  70   use        1       -     ', &
+   'uv    243  0    qi         85.     -     ', &
+   'uv    244  3    use        1       -     ', &
+   'uv    244  4    use        1       -     ', &
+   'uv    244  206  use        1       -     ', &
+   'uv    244  207  use        1       -     ', &
+   'uv    244  209  use        1       -     ', &
+   'uv    244  223  use        1       -     ', &
+   'uv    245  259  use        1       -     ', &
+   'uv    245  270  use        1       -     ', &
+   'uv    246  259  use        1       -     ', &
+   'uv    246  270  use        1       -     ', &
+   'uv    247  259  use        1       -     ', &
+   'uv    247  270  use        1       -     ', &
+   'uv    250  171  use        1       -     ', &
+   'uv    250  172  use        1       -     ', &
+   'uv    250  173  use        1       -     ', &
+   'uv    250  174  use        1       -     ', &
+   'uv    252  171  use        1       -     ', &
+   'uv    252  172  use        1       -     ', &
+   'uv    252  173  use        1       -     ', &
+   'uv    252  174  use        1       -     ', &
+   'uv    253  55   use        1       -     ', &
+   'uv    253  70   use        1       -     ', &
+   'uv    253  0    qi         85.     -     ', &
+   'uv    254  55   use        1       -     ', &
+   'uv    254  70   use        1       -     ', &
+   'uv    254  0    qi         85.     -     ', &
+   'uv    257  783  use        1       -     ', &
+   'uv    257  784  use        1       -     ', &
+   'uv    258  783  use        1       -     ', &
+   'uv    258  784  use        1       -     ', &
+   'uv    259  783  use        1       -     ', &
+   'uv    259  784  use        1       -     ', &
+   'uv    260  224  use        1       -     ', &
+   ! satwnd: AMVs are used unless rejected
+   'amv   0    0    satzen     -       68.   ', &
+   'amv   260  0    qi         85.     -     ', &
+   'amv   240  0    qi         90.     100.  ', &
+   'amv   245  0    qi         90.     100.  ', &
+   'amv   246  0    qi         90.     100.  ', &
+   'amv   247  0    qi         90.     100.  ', &
+   'amv   251  0    qi         90.     100.  ', &
+   'amv   240  0    prs        15000.  -     ', &
+   'amv   245  0    prs        15000.  -     ', &
+   'amv   246  0    prs        15000.  30000.', &
+   'amv   247  0    prs        15000.  -     ', &
+   'amv   251  0    prs        70000.  -     ', &
+   'amv   240  0    experr     -       0.9   ', &
+   'amv   245  0    experr     -       0.9   ', &
+   'amv   246  0    experr     -       0.9   ', &
+   'amv   247  0    experr     -       0.9   ', &
+   'amv   251  0    experr     -       0.9   ', &
+   'amv   240  0    cvwd       0.04    0.5   ', &
+   'amv   245  0    cvwd       0.04    0.5   ', &
+   'amv   246  0    cvwd       0.04    0.5   ', &
+   'amv   251  0    cvwd       0.04    0.5   ', &
+   'amv   240  0    prs_land   -       85000.', &
+   'amv   245  0    prs_land   -       85000.', &
+   'amv   246  0    prs_land   -       85000.', &
+   'amv   247  0    prs_land   -       85000.', &
+   'amv   251  0    prs_land   -       85000.'  &
+   ]
+
+type qc_rule_type
+   character(len=8)  :: var
+   integer(i_kind)   :: rptype
+   integer(i_kind)   :: satid
+   character(len=12) :: check
+   real(r_kind)      :: vmin
+   real(r_kind)      :: vmax
+end type qc_rule_type
+
+! the rules of one variable compiled for lookup by (rptype, satid)
+type qc_groups_type
+   integer(i_kind)                 :: rmin, rmax, smax
+   integer(i_kind),    allocatable :: gtab(:,:)        ! (rmin:rmax,0:smax), group of each (rptype, satid)
+   logical,            allocatable :: use(:)           ! (0:ngroup), group 0 is for unlisted rptypes
+   real(r_kind),       allocatable :: vmin(:,:), vmax(:,:)  ! (nqc_check,0:ngroup)
+   real(r_kind),       allocatable :: inflate(:), ptop_factor(:), ptop_prs(:)
+   logical, dimension(nqc_check)   :: active
+end type qc_groups_type
+
+integer(i_kind)                                 :: nrules = 0
+logical                                         :: rules_loaded = .false.
+type(qc_rule_type), dimension(max_qc_rules)     :: rules
+
+contains
+
+!--------------------------------------------------------------
+
+subroutine read_qc_rules(fname)
+
+! replace the default rules with those of a table file
+
+   implicit none
+
+   character(len=*), intent(in) :: fname
+
+   character(len=StrLen) :: line
+   integer(i_kind)       :: iunit, iost
+
+   open(newunit=iunit, file=trim(fname), status='old', form='formatted', iostat=iost)
+   if ( iost /= 0 ) then
+      write(*,*) 'Error: unable to open QC rules ', trim(fname)
+      stop 1
+   end if
+
+   nrules = 0
+   do
+      read(iunit, '(a)', iostat=iost) line
+      if ( iost /= 0 ) exit
+      call add_rule(line, fname)
+   end do
+   close(iunit)
+   rules_loaded = .true.
+
+   write(*,'(1x,a,i5,a,a)') 'read ', nrules, ' QC rules from ', trim(fname)
+
+end subroutine read_qc_rules
+
+!--------------------------------------------------------------
+
+subroutine add_rule(line, source)
+
+   implicit none
+
+   character(len=*), intent(in) :: line
+   character(len=*), intent(in) :: source
+
+   character(len=len(line)) :: text
+   character(len=16)        :: cmin, cmax
+   type(qc_rule_type)       :: rule
+   integer(i_kind)          :: icomment, iost
+
+   text = line
+   icomment = index(text, '!')
+   if ( icomment > 0 ) text(icomment:) = ''
+   if ( len_trim(text) == 0 ) return
+
+   read(text, *, iostat=iost) rule%var, rule%rptype, rule%satid, rule%check, cmin, cmax
+   if ( iost == 0 ) rule%vmin = parse_bound(cmin, -no_bound, iost)
+   if ( iost == 0 ) rule%vmax = parse_bound(cmax, no_bound, iost)
+   if ( iost /= 0 ) then
+      write(*,*) 'Error: invalid QC rule in ', trim(source), ': ', trim(line)
+      stop 1
+   end if
+   if ( all(check_names /= rule%check) .and. rule%check /= 'use' .and. &
+        rule%check /= 'inflate' .and. rule%check /= 'inflate_ptop' ) then
+      write(*,*) 'Error: unknown QC check ', trim(rule%check), ' in ', trim(source)
+      stop 1
+   end if
+   if ( nrules == max_qc_rules ) then
+      write(*,*) 'Error: more than ', max_qc_rules, ' QC rules in ', trim(source)
+      stop 1
+   end if
+   nrules = nrules + 1
+   rules(nrules) = rule
+
+end subroutine add_rule
+
+!--------------------------------------------------------------
+
+function parse_bound(str, open_value, iost) result(bound)
+
+   implicit none
+
+   character(len=*), intent(in)  :: str
+   real(r_kind),     intent(in)  :: open_value
+   integer(i_kind),  intent(out) :: iost
+   real(r_kind)                  :: bound
+
+   iost = 0
+   if ( trim(str) == '-' ) then
+      bound = open_value
+   else
+      read(str, *, iostat=iost) bound
+   end if
+
+end function parse_bound
+
+!--------------------------------------------------------------
+
+subroutine load_default_rules
+
+   implicit none
+
+   integer(i_kind) :: i
+
+   nrules = 0
+   do i = 1, size(default_rules)
+      call add_rule(default_rules(i), 'default_rules')
+   end do
+   rules_loaded = .true.
+
+end subroutine load_default_rules
+
+!--------------------------------------------------------------
+
+subroutine qc_evaluate(var, n, rptype, satid, cols, default_use, used, listed, inflate_qm, inflate_ptop)
+
+! evaluate the rules of one variable for n observations
+!
+! cols holds the quantities bounded by the rules (columns qc_qm ... qc_prs_land),
+! columns that no rule of var bounds are not read. used is true for the
+! observations that pass all checks of their group; listed is the use flag of
+! the group alone. inflate_qm is the error factor of quality markers 3 and 7
+! and inflate_ptop the error factor from the pressure of the observation.
+
+   implicit none
+
+   character(len=*),                        intent(in)  :: var
+   integer(i_kind),                         intent(in)  :: n
+   integer(i_kind), dimension(n),           intent(in)  :: rptype
+   integer(i_kind), dimension(n),           intent(in)  :: satid
+   real(r_kind),    dimension(n,nqc_check), intent(in)  :: cols
+   logical,                                 intent(in)  :: default_use  ! use flag of rptypes without rules
+   logical,         dimension(n),           intent(out) :: used
+   logical,         dimension(n), optional, intent(out) :: listed
+   real(r_kind),    dimension(n), optional, intent(out) :: inflate_qm
+   real(r_kind),    dimension(n), optional, intent(out) :: inflate_ptop
+
+   type(qc_groups_type)         :: tab
+   integer(i_kind), allocatable :: grp(:)
+   integer(i_kind)              :: i, k
+
+   if ( .not. rules_loaded ) call load_default_rules
+   call compile_rules(var, default_use, tab)
+
+   allocate (grp(n))
+   do concurrent ( i = 1:n )
+      if ( rptype(i) < tab%rmin .or. rptype(i) > tab%rmax ) then
+         grp(i) = 0
+      else if ( satid(i) < 0 .or. satid(i) > tab%smax ) then
+         grp(i) = tab%gtab(rptype(i), 0)
+      else
+         grp(i) = tab%gtab(rptype(i), satid(i))
+      end if
+   end do
+
+   used(:) = tab%use(grp)
+   if ( present(listed) ) listed(:) = used(:)
+   do k = 1, nqc_check
+      if ( .not. tab%active(k) ) cycle
+      used(:) = used(:) .and. cols(:,k) >= tab%vmin(k,grp) .and. cols(:,k) <= tab%vmax(k,grp)
+   end do
+
+   if ( present(inflate_qm) ) inflate_qm(:) = tab%inflate(grp)
+   if ( present(inflate_ptop) ) then
+      inflate_ptop(:) = merge(tab%ptop_factor(grp), 1.0_r_kind, cols(:,qc_prs) < tab%ptop_prs(grp))
+   end if
+
+   deallocate (grp)
+
+end subroutine qc_evaluate
+
+!--------------------------------------------------------------
+
+subroutine compile_rules(var, default_use, tab)
+
+   implicit none
+
+   character(len=*),     intent(in)  :: var
+   logical,              intent(in)  :: default_use
+   type(qc_groups_type), intent(out) :: tab
+
+   integer(i_kind), allocatable :: parent(:), grp_rptype(:), grp_satid(:)
+   integer(i_kind)              :: i, ig, ngroup, r, s
+
+   tab%rmin = huge(1)
+   tab%rmax = -huge(1)
+   tab%smax = 0
+   do i = 1, nrules
+      if ( rules(i)%var /= var .or. rules(i)%rptype <= 0 ) cycle
+      tab%rmin = min(tab%rmin, rules(i)%rptype)
+      tab%rmax = max(tab%rmax, rules(i)%rptype)
+      tab%smax = max(tab%smax, rules(i)%satid)
+   end do
+   if ( tab%rmin > tab%rmax ) then
+      tab%rmin = 1
+      tab%rmax = 0
+   end if
+
+   allocate (tab%gtab(tab%rmin:tab%rmax, 0:tab%smax))
+   allocate (parent(0:nrules), grp_rptype(0:nrules), grp_satid(0:nrules))
+   tab%gtab(:,:) = -1
+
+   ! group 0 holds the rows for all rptypes, then one group per rptype and one
+   ! per (rptype, satid), each starting from the less specific one
+   ngroup = 0
+   grp_rptype(0) = 0
+   grp_satid(0) = 0
+   parent(0) = -1
+   do i = 1, nrules
+      if ( rules(i)%var /= var .or. rules(i)%rptype <= 0 ) cycle
+      r = rules(i)%rptype
+      if ( tab%gtab(r,0) < 0 ) then
+         ngroup = ngroup + 1
+         tab%gtab(r,0) = ngroup
+         grp_rptype(ngroup) = r
+         grp_satid(ngroup) = 0
+         parent(ngroup) = 0
+      end if
+   end do
+   do i = 1, nrules
+      if ( rules(i)%var /= var .or. rules(i)%rptype <= 0 .or. rules(i)%satid <= 0 ) cycle
+      r = rules(i)%rptype
+      s = rules(i)%satid
+      if ( tab%gtab(r,s) < 0 ) then
+         ngroup = ngroup + 1
+         tab%gtab(r,s) = ngroup
+         grp_rptype(ngroup) = r
+         grp_satid(ngroup) = s
+         parent(ngroup) = tab%gtab(r,0)
+      end if
+   end do
+   ! rptypes between those with rules but without any of their own use group 0
+   where ( tab%gtab(:,0) < 0 ) tab%gtab(:,0) = 0
+   do s = 1, tab%smax
+      where ( tab%gtab(:,s) < 0 ) tab%gtab(:,s) = tab%gtab(:,0)
+   end do
+
+   allocate (tab%use(0:ngroup), tab%vmin(nqc_check,0:ngroup), tab%vmax(nqc_check,0:ngroup))
+   allocate (tab%inflate(0:ngroup), tab%ptop_factor(0:ngroup), tab%ptop_prs(0:ngroup))
+   tab%active(:) = .false.
+
+   do ig = 0, ngroup
+      if ( parent(ig) < 0 ) then
+         tab%use(ig)         = default_use
+         tab%vmin(:,ig)      = -no_bound
+         tab%vmax(:,ig)      = no_bound
+         tab%inflate(ig)     = 1.0_r_kind
+         tab%ptop_factor(ig) = 1.0_r_kind
+         tab%ptop_prs(ig)    = -no_bound
+      else
+         tab%use(ig)         = tab%use(parent(ig))
+         tab%vmin(:,ig)      = tab%vmin(:,parent(ig))
+         tab%vmax(:,ig)      = tab%vmax(:,parent(ig))
+         tab%inflate(ig)     = tab%inflate(parent(ig))
+         tab%ptop_factor(ig) = tab%ptop_factor(parent(ig))
+         tab%ptop_prs(ig)    = tab%ptop_prs(parent(ig))
+      end if
+      do i = 1, nrules
+         if ( rules(i)%var /= var ) cycle
+         if ( rules(i)%rptype /= grp_rptype(ig) ) cycle
+         if ( grp_rptype(ig) > 0 .and. rules(i)%satid /= grp_satid(ig) ) cycle
+         call apply_rule(rules(i), tab, ig)
+      end do
+   end do
+
+   deallocate (parent, grp_rptype, grp_satid)
+
+end subroutine compile_rules
+
+!--------------------------------------------------------------
+
+subroutine apply_rule(rule, tab, ig)
+
+   implicit none
+
+   type(qc_rule_type),   intent(in)    :: rule
+   type(qc_groups_type), intent(inout) :: tab
+   integer(i_kind),      intent(in)    :: ig
+
+   integer(i_kind) :: k
+
+   select case ( trim(rule%check) )
+   case ( 'use' )
+      tab%use(ig) = rule%vmin > 0.0
+   case ( 'inflate' )
+      tab%inflate(ig) = rule%vmin
+   case ( 'inflate_ptop' )
+      tab%ptop_factor(ig) = rule%vmin
+      tab%ptop_prs(ig)    = rule%vmax
+   case default
+      do k = 1, nqc_check
+         if ( check_names(k) /= rule%check ) cycle
+         tab%vmin(k,ig) = max(tab%vmin(k,ig), rule%vmin)
+         tab%vmax(k,ig) = min(tab%vmax(k,ig), rule%vmax)
+         tab%active(k) = .true.
+      end do
+   end select
+
+end subroutine apply_rule
+
+end module qc_rules_mod
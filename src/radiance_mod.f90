@@ -4,10 +4,12 @@ use kinds, only: r_kind,i_kind,r_double,i_llong
 use define_mod, only: missing_r, missing_i, nstring, ndatetime, &
    ninst, inst_list, set_name_satellite, set_name_sensor, xdata, name_sen_info, &
    nvar_info, name_var_info, type_var_info, nsen_info, type_sen_info, &
-   dtime_min, dtime_max, strlen
+   dtime_min, dtime_max, strlen, par_rank, par_size
 use ufo_vars_mod, only: ufo_vars_getindex
 use netcdf, only: nf90_float, nf90_int, nf90_char, nf90_int64
-use utils_mod, only: get_julian_time, da_advance_time, da_get_time_slots
+use utils_mod, only: da_advance_time, get_time_slot
+use bufr_index_mod, only: bufr_index_type, bufr_index_build, bufr_index_range, bufr_index_matches
+use netcdf_cxx_mod, only: channelSelectionGet, timeToEpoch, timeWindowSlots, invalid_epoch
 
 implicit none
 private
@@ -17,24 +19,37 @@ public  :: read_iasi
 public  :: read_cris
 public  :: sort_obs_radiance
 public  :: radiance_to_temperature
+public  :: planck_radiance_to_bt
 
 real(r_kind), parameter  :: r8bfms = 9.0E08  ! threshold to check for BUFR missing value
 
-type datalink_radiance
-   character(len=nstring)    :: msg_type   ! BUFR message type name
+! number of locations converted per block in radiance_to_temperature
+integer(i_kind), parameter :: nloc_block = 4096
+
+! parsed CRTM SpcCoeff coefficients of one instrument
+type spc_coeff_type
+   logical                     :: loaded = .false.  ! read_spc has been attempted
+   integer(i_kind)             :: iret   = 0        ! return status of read_spc
+   integer(i_kind)             :: nchan  = 0
+   real(r_double), allocatable :: planck_c1(:)
+   real(r_double), allocatable :: planck_c2(:)
+   real(r_double), allocatable :: band_c1(:)
+   real(r_double), allocatable :: band_c2(:)
+   real(r_double), allocatable :: wavenumber(:)
+end type spc_coeff_type
+
+! process-wide cache of SpcCoeff tables, indexed as inst_list
+type(spc_coeff_type), dimension(ninst), target :: spc_cache
+
+! one decoded report, filled by the readers and copied into the pool of its instrument
+type report_radiance
    integer(i_kind)           :: satid      ! satellite identifier
    integer(i_kind)           :: instid     ! instrument identifier
-   character(len=nstring)    :: inst       ! instrument name eg. amsua-n15
-   character(len=ndatetime)  :: datetime   ! ccyy-mm-ddThh:mm:ssZ
    integer(i_kind)           :: nchan      ! number of channels
    real(r_kind)              :: lat        ! latitude in degree
    real(r_kind)              :: lon        ! longitude in degree
    real(r_kind)              :: elv        ! elevation in m
-   real(r_kind)              :: dhr        ! obs time minus analysis time in hour
-   real(r_double)            :: gstime
-   integer(i_llong)          :: epochtime
-   integer(i_kind)           :: ifgat
-   integer(i_kind)           :: inst_idx   ! index of inst in inst_list
+   integer(i_kind)           :: idate(6)   ! year, month, day, hour, minute and second
    integer(i_kind)           :: landsea
    integer(i_kind)           :: scanpos
    integer(i_kind)           :: scanline
@@ -42,12 +57,71 @@ type datalink_radiance
    real(r_kind)              :: satazi
    real(r_kind)              :: solzen
    real(r_kind)              :: solazi
-   real(r_kind), allocatable :: tb(:)
-   real(r_kind), allocatable :: ch(:)
-   type (datalink_radiance), pointer :: next ! pointer to next data
-end type datalink_radiance
-
-type(datalink_radiance), pointer :: rhead=>null(), rlink=>null()
+   real(r_kind),    allocatable :: tb(:)   ! allocated once per reader to the max nchan
+   real(r_kind),    allocatable :: ch(:)
+   integer(i_kind), allocatable :: pos(:)  ! position of each channel in the BUFR report, 0 if absent
+end type report_radiance
+
+! number of reports per block of a radiance pool
+integer(i_kind), parameter :: nrep_block = 4096
+
+! a block of reports of one instrument; the channel data are stored
+! channel-major, so all reports of one channel are adjacent
+type radiance_block
+   integer(i_kind)                       :: nrep = 0
+   integer(i_kind),          allocatable :: irec(:)      ! report number in reading order
+   integer(i_kind),          allocatable :: ifgat(:)     ! time slot, set by sort_obs_radiance
+   real(r_kind),             allocatable :: lat(:)
+   real(r_kind),             allocatable :: lon(:)
+   real(r_kind),             allocatable :: elv(:)
+   integer(i_kind),          allocatable :: idate(:,:)   ! (nrep_block, 6), the idate of the reports
+   integer(i_llong),         allocatable :: epochtime(:) ! converted from idate by sort_obs_radiance
+   integer(i_kind),          allocatable :: scanpos(:)
+   real(r_kind),             allocatable :: satzen(:)
+   real(r_kind),             allocatable :: satazi(:)
+   real(r_kind),             allocatable :: solzen(:)
+   real(r_kind),             allocatable :: solazi(:)
+   real(r_kind),             allocatable :: tb(:,:)      ! (nrep_block, nchan)
+   type(radiance_block),     pointer     :: next => null()
+end type radiance_block
+
+! the reports of one instrument of inst_list, in reading order
+type radiance_pool
+   integer(i_kind)                       :: nchan = 0    ! nchan of the first report
+   integer(i_kind),          allocatable :: ch(:)        ! channel numbers of the last report
+   integer(i_kind),          allocatable :: pos(:)       ! BUFR positions of the channels
+   type(radiance_block),     pointer     :: head => null()
+   type(radiance_block),     pointer     :: tail => null()
+end type radiance_pool
+
+type(radiance_pool), dimension(ninst), target :: rad_pool
+integer(i_kind) :: nrep_read = 0  ! number of reports pooled so far, including unknown instruments
+
+! instrument index in inst_list of each BUFR SAID (0-01-007, 10 bits) and
+! SIID (0-02-019, 11 bits) pair, through the distinct satellite and sensor
+! names of set_name_satellite and set_name_sensor; built on first use
+integer(i_kind), parameter :: max_said = 1023
+integer(i_kind), parameter :: max_siid = 2047
+logical                      :: inst_table_built = .false.
+integer(i_kind)              :: sat_slot(0:max_said)
+integer(i_kind)              :: sen_slot(0:max_siid)
+integer(i_kind), allocatable :: inst_table(:,:)
+
+! channels kept per instrument of inst_list, from the channel selection
+! loaded with channelSelectionLoad; looked up on first use
+type channel_subset_type
+   logical                      :: loaded = .false.
+   integer(i_kind)              :: nsel = -1   ! number of kept channels, -1 if all are kept
+   integer(i_kind), allocatable :: chan(:)     ! kept channel numbers, sorted
+   integer(i_kind), allocatable :: slot(:)     ! slot(ichan): index of channel ichan in chan, 0 if dropped
+end type channel_subset_type
+
+type(channel_subset_type), dimension(ninst), target :: chan_subset
+
+! message index of the BUFR file being read and the messages of this rank
+type(bufr_index_type) :: bindex
+logical               :: use_index = .false.
+integer(i_kind)       :: imsg_first, imsg_last
 
 contains
 
@@ -106,14 +180,16 @@ subroutine read_amsua_amsub_mhs (filename, filedate)
    character(len=8)  :: subset
    character(len=10) :: cdate
 
+   type(report_radiance) :: rep  ! the report being decoded
+
    integer(i_kind) :: iunit, iost, iret, i
    integer(i_kind) :: nchan
    integer(i_kind) :: idate
    integer(i_kind) :: num_report_infile
+   integer(i_kind) :: imsg
    integer(i_kind) :: ireadmg, ireadsb
 
    integer(i_kind) :: iyear, imonth, iday, ihour, imin, isec
-   real(r_double)  :: ref_time, obs_time
 
    write(*,*) '--- reading '//trim(filename)//' ---'
 
@@ -123,6 +199,7 @@ subroutine read_amsua_amsub_mhs (filename, filedate)
    britstr = 'CHNM TMBR'
 
    num_report_infile  = 0
+   imsg = 0
 
    iunit = 96
 
@@ -149,24 +226,16 @@ subroutine read_amsua_amsub_mhs (filename, filedate)
 
    write(unit=*,fmt='(1x,a,i10)') trim(filename)//' file date is: ', idate
    write(unit=filedate, fmt='(i10)') idate
-   read (filedate(1:10),'(i4,3i2)') iyear, imonth, iday, ihour
-   call get_julian_time (iyear,imonth,iday,ihour,0,0,ref_time)
 
-   if ( .not. associated(rhead) ) then
-      nullify ( rhead )
-      allocate ( rhead )
-      nullify ( rhead%next )
-   end if
+   allocate ( rep % tb(maxchan) )
+   allocate ( rep % ch(maxchan) )
+   allocate ( rep % pos(maxchan) )
 
-   if ( .not. associated(rlink) ) then
-      rlink => rhead
-   else
-      allocate ( rlink%next )
-      rlink => rlink%next
-      nullify ( rlink%next )
-   end if
+   call split_messages(filename)
 
    msg_loop: do while (ireadmg(iunit,subset,idate)==0)
+      imsg = imsg + 1
+      if ( skip_message(filename, imsg, subset) ) cycle msg_loop
 !print*,subset
       subset_loop: do while (ireadsb(iunit)==0)
 
@@ -188,11 +257,7 @@ subroutine read_amsua_amsub_mhs (filename, filedate)
               ihour  >=   0 .and. ihour  <   24 .and. &
               imin   >=   0 .and. imin   <   60 .and. &
               isec   >=   0 .and. isec   <   60 ) then
-            write(unit=rlink%datetime, fmt='(i4,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a)')  &
-               iyear, '-', imonth, '-', iday, 'T', ihour, ':', imin, ':', isec, 'Z'
-            call get_julian_time (iyear,imonth,iday,ihour,imin,isec,obs_time,rlink%epochtime)
-            rlink%dhr = (obs_time + (isec/60.0) - ref_time)/60.0
-            rlink%gstime = obs_time
+            rep%idate = [iyear, imonth, iday, ihour, imin, isec]
          else
             cycle subset_loop
          end if
@@ -203,39 +268,33 @@ subroutine read_amsua_amsub_mhs (filename, filedate)
          call ufbint(iunit,infodat,ninfo,1,iret,infostr)
          call ufbrep(iunit,data1b8,2,maxchan,nchan,britstr)
 
-         rlink % nchan = nchan
-         if ( nchan > 0 ) then
-            allocate ( rlink % tb(nchan) )   ! brightness temperature
-            allocate ( rlink % ch(nchan) )   ! channel number
-         end if
+         rep % nchan = nchan
 
-         call fill_datalink(rlink, missing_r, missing_i)
+         call fill_report(rep, missing_r, missing_i)
 
-         if ( lalodat(1) < r8bfms ) rlink % lat = lalodat(1)
-         if ( lalodat(2) < r8bfms ) rlink % lon = lalodat(2)
-         if ( rlink % lon < 360. .and.rlink % lon > 180. ) rlink % lon = rlink % lon - 360.
+         if ( lalodat(1) < r8bfms ) rep % lat = lalodat(1)
+         if ( lalodat(2) < r8bfms ) rep % lon = lalodat(2)
+         if ( rep % lon < 360. .and.rep % lon > 180. ) rep % lon = rep % lon - 360.
 
-         rlink % satid  = nint(infodat(1))  ! SAID satellite identifier
-         rlink % instid = nint(infodat(2))  ! SIID instrument identifier
+         rep % satid  = nint(infodat(1))  ! SAID satellite identifier
+         rep % instid = nint(infodat(2))  ! SIID instrument identifier
 
-         if ( infodat(3)  < r8bfms ) rlink % scanpos = nint(infodat(3)) ! FOVN field of view number
-         if ( infodat(4)  < r8bfms ) rlink % landsea = infodat(4)       ! LSQL land sea qualifier 0:land, 1:sea, 2:coast
-         if ( infodat(5)  < r8bfms ) rlink % satzen  = infodat(5)       ! SAZA satellite zenith angle (degree)
-         if ( infodat(10) < r8bfms ) rlink % satazi  = infodat(10)      ! BEARAZ satellite azimuth (degree true)
-         if ( infodat(6)  < r8bfms ) rlink % solzen  = infodat(6)       ! SOZA solar zenith angle (degree)
-         if ( infodat(9)  < r8bfms ) rlink % solazi  = infodat(9)       ! SOLAZI solar azimuth (degree true)
-         if ( infodat(7)  < r8bfms ) rlink % elv     = infodat(7)       ! HOLS height of land surface (m)
+         if ( infodat(3)  < r8bfms ) rep % scanpos = nint(infodat(3)) ! FOVN field of view number
+         if ( infodat(4)  < r8bfms ) rep % landsea = infodat(4)       ! LSQL land sea qualifier 0:land, 1:sea, 2:coast
+         if ( infodat(5)  < r8bfms ) rep % satzen  = infodat(5)       ! SAZA satellite zenith angle (degree)
+         if ( infodat(10) < r8bfms ) rep % satazi  = infodat(10)      ! BEARAZ satellite azimuth (degree true)
+         if ( infodat(6)  < r8bfms ) rep % solzen  = infodat(6)       ! SOZA solar zenith angle (degree)
+         if ( infodat(9)  < r8bfms ) rep % solazi  = infodat(9)       ! SOLAZI solar azimuth (degree true)
+         if ( infodat(7)  < r8bfms ) rep % elv     = infodat(7)       ! HOLS height of land surface (m)
 
          if ( nchan > 0 ) then
             do i = 1, nchan
-               if ( data1b8(1,i) < r8bfms ) rlink % ch(i) = nint(data1b8(1,i))
-               if ( data1b8(2,i) < r8bfms ) rlink % tb(i) = data1b8(2,i)
+               if ( data1b8(1,i) < r8bfms ) rep % ch(i) = nint(data1b8(1,i))
+               if ( data1b8(2,i) < r8bfms ) rep % tb(i) = data1b8(2,i)
             end do
          end if
 
-         allocate ( rlink%next )
-         rlink => rlink%next
-         nullify ( rlink%next )
+         call pool_report(rep)
 
       end do subset_loop ! ireadsb
    end do msg_loop ! ireadmg
@@ -341,14 +400,16 @@ subroutine read_airs_colocate_amsua (filename, filedate)
   ! Work variables for time
   integer(i_kind)   :: idate
   integer(i_kind)   :: iyear, imonth, iday, ihour, imin, isec
-  real(r_double)    :: ref_time, obs_time
 
   ! Other work variables
   integer(i_kind)  :: i, ich
   integer(i_kind)  :: iost, iunit
   integer(i_kind)  :: num_report_infile
+  integer(i_kind)  :: imsg
   logical          :: decode_airs, decode_amsua
 
+  type(report_radiance) :: rep  ! the report being decoded
+
 
   write(*,*) '--- reading '//trim(filename)//' ---'
 
@@ -358,6 +419,7 @@ subroutine read_airs_colocate_amsua (filename, filedate)
   if ( ufo_vars_getindex(inst_list, 'airs_aqua')  > 0 ) decode_airs  = .true.
 
   num_report_infile  = 0
+  imsg = 0
 
   iunit = 97
 
@@ -384,24 +446,16 @@ subroutine read_airs_colocate_amsua (filename, filedate)
 
   write(unit=*,fmt='(1x,a,i10)') trim(filename)//' file date is: ', idate
   write(unit=filedate, fmt='(i10)') idate
-  read (filedate(1:10),'(i4,3i2)') iyear, imonth, iday, ihour
-  call get_julian_time (iyear,imonth,iday,ihour,0,0,ref_time)
 
-  if ( .not. associated(rhead) ) then
-     nullify ( rhead )
-     allocate ( rhead )
-     nullify ( rhead%next )
-  end if
+  allocate ( rep % tb(N_MAXCHAN) )
+  allocate ( rep % ch(N_MAXCHAN) )
+  allocate ( rep % pos(N_MAXCHAN) )
 
-  if (.not. associated(rlink)) then
-     rlink => rhead
-  else
-     allocate ( rlink%next )
-     rlink => rlink%next
-     nullify ( rlink%next )
-  end if
+  call split_messages(filename)
 
   msg_loop: do while ( ireadmg(iunit,subset,idate)==0 )
+     imsg = imsg + 1
+     if ( skip_message(filename, imsg, subset) ) cycle msg_loop
 
      subset_loop: do while ( ireadsb(iunit)==0 )
 
@@ -464,11 +518,7 @@ subroutine read_airs_colocate_amsua (filename, filedate)
                 ihour  >=   0 .and. ihour  <   24 .and. &
                 imin   >=   0 .and. imin   <   60 .and. &
                 isec   >=   0 .and. isec   <   60 ) then
-              write(unit=rlink%datetime, fmt='(i4,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a)')  &
-               iyear, '-', imonth, '-', iday, 'T', ihour, ':', imin, ':', isec, 'Z'
-              call get_julian_time (iyear,imonth,iday,ihour,imin,isec,obs_time,rlink%epochtime)
-              rlink%dhr = (obs_time + (isec/60.0) - ref_time)/60.0
-              rlink%gstime = obs_time
+              rep%idate = [iyear, imonth, iday, ihour, imin, isec]
            else
               cycle subset_loop
            end if
@@ -478,39 +528,33 @@ subroutine read_airs_colocate_amsua (filename, filedate)
            ! Read SCBTSEQN or AMSUCHAN
            call ufbseq(iunit,sensorchan_list_array,N_sensorchan_LIST,N_MAXCHAN,nchan,channame)
 
-           rlink % nchan = nchan
-           if ( nchan > 0 ) then
-              allocate ( rlink % tb(1:nchan) )
-              allocate ( rlink % ch(1:nchan) )
-           end if
+           rep % nchan = nchan
 
-           call fill_datalink(rlink, missing_r, missing_i)
+           call fill_report(rep, missing_r, missing_i)
 
            do ich = 1 , nchan
               sensorchan(ich) = sensorchan_list( sensorchan_list_array(1,ich), &
                                                  sensorchan_list_array(2,ich), &
                                                  sensorchan_list_array(3,ich), &
                                                  sensorchan_list_array(4,ich) )
-              if ( sensorchan(ich) % tmbr < r8bfms ) rlink % tb(ich) = sensorchan(ich) % tmbr
-              if ( sensorchan(ich) % chnm < r8bfms ) rlink % ch(ich) = sensorchan(ich) % chnm
+              if ( sensorchan(ich) % tmbr < r8bfms ) rep % tb(ich) = sensorchan(ich) % tmbr
+              if ( sensorchan(ich) % chnm < r8bfms ) rep % ch(ich) = sensorchan(ich) % chnm
            end do
 
-           if ( sensorspot%clath < r8bfms ) rlink % lat  = sensorspot%clath
-           if ( sensorspot%clonh < r8bfms ) rlink % lon  = sensorspot%clonh
+           if ( sensorspot%clath < r8bfms ) rep % lat  = sensorspot%clath
+           if ( sensorspot%clonh < r8bfms ) rep % lon  = sensorspot%clonh
 
-           if ( sensorspot%fovn      < r8bfms ) rlink % scanpos  = nint( sensorspot%fovn )
-           if ( sensorspot%saza      < r8bfms ) rlink % satzen   = sensorspot%saza
-           if ( satellitespot%slnm   < r8bfms ) rlink % scanline = nint(satellitespot%slnm)
-           if ( sensorspot%bearaz    < r8bfms ) rlink % satazi   = sensorspot%bearaz
-           if ( satellitespot%soza   < r8bfms ) rlink % solzen   = satellitespot%soza
-           if ( satellitespot%solazi < r8bfms ) rlink % solazi   = satellitespot%solazi
+           if ( sensorspot%fovn      < r8bfms ) rep % scanpos  = nint( sensorspot%fovn )
+           if ( sensorspot%saza      < r8bfms ) rep % satzen   = sensorspot%saza
+           if ( satellitespot%slnm   < r8bfms ) rep % scanline = nint(satellitespot%slnm)
+           if ( sensorspot%bearaz    < r8bfms ) rep % satazi   = sensorspot%bearaz
+           if ( satellitespot%soza   < r8bfms ) rep % solzen   = satellitespot%soza
+           if ( satellitespot%solazi < r8bfms ) rep % solazi   = satellitespot%solazi
 
-           rlink % satid = nint(satellitespot % said)
-           rlink % instid = nint(sensorspot % siid)
+           rep % satid = nint(satellitespot % said)
+           rep % instid = nint(sensorspot % siid)
 
-           allocate ( rlink%next )
-           rlink => rlink%next
-           nullify ( rlink%next )
+           call pool_report(rep)
 
         end do loop_sensor
      end do subset_loop ! ireadsb
@@ -572,14 +616,17 @@ subroutine read_iasi (filename, filedate)
    character(len=8)  :: subset
    character(len=10) :: cdate
 
-   integer(i_kind) :: iunit, iost, iret, i, j, jstart
+   type(report_radiance) :: rep  ! the report being decoded
+   type(channel_subset_type), pointer :: sub  ! channel selection of its instrument
+
+   integer(i_kind) :: iunit, iost, iret, i, j, k, jstart
    integer(i_kind) :: nchan
    integer(i_kind) :: idate
    integer(i_kind) :: num_report_infile
+   integer(i_kind) :: imsg
    integer(i_kind) :: ireadmg, ireadsb
 
    integer(i_kind) :: iyear, imonth, iday, ihour, imin, isec
-   real(r_double)  :: ref_time, obs_time
 
    ! for scale factors for radiance
    integer(i_kind) :: chan_range1, chan_range2, ichan
@@ -595,6 +642,7 @@ subroutine read_iasi (filename, filedate)
    lalostr = 'CLATH CLONH'
 
    num_report_infile  = 0
+   imsg = 0
 
    iunit = 96
 
@@ -621,24 +669,16 @@ subroutine read_iasi (filename, filedate)
 
    write(unit=*,fmt='(1x,a,i10)') trim(filename)//' file date is: ', idate
    write(unit=filedate, fmt='(i10)') idate
-   read (filedate(1:10),'(i4,3i2)') iyear, imonth, iday, ihour
-   call get_julian_time (iyear,imonth,iday,ihour,0,0,ref_time)
 
-   if ( .not. associated(rhead) ) then
-      nullify ( rhead )
-      allocate ( rhead )
-      nullify ( rhead%next )
-   end if
+   allocate ( rep % tb(nchan_bufr) )
+   allocate ( rep % ch(nchan_bufr) )
+   allocate ( rep % pos(nchan_bufr) )
 
-   if ( .not. associated(rlink) ) then
-      rlink => rhead
-   else
-      allocate ( rlink%next )
-      rlink => rlink%next
-      nullify ( rlink%next )
-   end if
+   call split_messages(filename)
 
    msg_loop: do while (ireadmg(iunit,subset,idate)==0)
+      imsg = imsg + 1
+      if ( skip_message(filename, imsg, subset) ) cycle msg_loop
 !print*,subset
       subset_loop: do while (ireadsb(iunit)==0)
 
@@ -660,11 +700,7 @@ subroutine read_iasi (filename, filedate)
               ihour  >=   0 .and. ihour  <   24 .and. &
               imin   >=   0 .and. imin   <   60 .and. &
               isec   >=   0 .and. isec   <   60 ) then
-            write(unit=rlink%datetime, fmt='(i4,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a)')  &
-               iyear, '-', imonth, '-', iday, 'T', ihour, ':', imin, ':', isec, 'Z'
-            call get_julian_time (iyear,imonth,iday,ihour,imin,isec,obs_time,rlink%epochtime)
-            rlink%dhr = (obs_time + (isec/60.0) - ref_time)/60.0
-            rlink%gstime = obs_time
+            rep%idate = [iyear, imonth, iday, ihour, imin, isec]
          else
             cycle subset_loop
          end if
@@ -685,30 +721,36 @@ subroutine read_iasi (filename, filedate)
          if ( iret /= nchan_bufr ) cycle subset_loop
 
          nchan = nchan_bufr
-         rlink % nchan = nchan_bufr
-         allocate ( rlink % tb(nchan) )   ! radiance for now
-         allocate ( rlink % ch(nchan) )   ! channel number
+         rep % nchan = nchan_bufr
 
-         call fill_datalink(rlink, missing_r, missing_i)
+         call fill_report(rep, missing_r, missing_i)
 
-         if ( lalodat(1) < r8bfms ) rlink % lat = lalodat(1)
-         if ( lalodat(2) < r8bfms ) rlink % lon = lalodat(2)
+         if ( lalodat(1) < r8bfms ) rep % lat = lalodat(1)
+         if ( lalodat(2) < r8bfms ) rep % lon = lalodat(2)
 
-         rlink % satid  = nint(infodat(1))  ! SAID satellite identifier
-         rlink % instid = nint(infodat(2))  ! SIID instrument identifier
+         rep % satid  = nint(infodat(1))  ! SAID satellite identifier
+         rep % instid = nint(infodat(2))  ! SIID instrument identifier
 
-         if ( infodat(3)  < r8bfms ) rlink % satzen  = infodat(3)        ! SAZA satellite zenith angle (degree)
-         if ( infodat(4)  < r8bfms ) rlink % satazi  = infodat(4)        ! BEARAZ satellite azimuth (degree true)
-         if ( infodat(5)  < r8bfms ) rlink % solzen  = infodat(5)        ! SOZA solar zenith angle (degree)
-         if ( infodat(6)  < r8bfms ) rlink % solazi  = infodat(6)        ! SOLAZI solar azimuth (degree true)
-         if ( infodat(7)  < r8bfms ) rlink % scanpos = nint(infodat(7))  ! FOVN field of view number
-         if ( infodat(8)  < r8bfms ) rlink % scanline = nint(infodat(8)) ! SLNM scan line number
-         if ( infodat(9)  < r8bfms ) rlink % elv = infodat(9)            ! SELV height of station (eg. 828400.0 m)
+         if ( infodat(3)  < r8bfms ) rep % satzen  = infodat(3)        ! SAZA satellite zenith angle (degree)
+         if ( infodat(4)  < r8bfms ) rep % satazi  = infodat(4)        ! BEARAZ satellite azimuth (degree true)
+         if ( infodat(5)  < r8bfms ) rep % solzen  = infodat(5)        ! SOZA solar zenith angle (degree)
+         if ( infodat(6)  < r8bfms ) rep % solazi  = infodat(6)        ! SOLAZI solar azimuth (degree true)
+         if ( infodat(7)  < r8bfms ) rep % scanpos = nint(infodat(7))  ! FOVN field of view number
+         if ( infodat(8)  < r8bfms ) rep % scanline = nint(infodat(8)) ! SLNM scan line number
+         if ( infodat(9)  < r8bfms ) rep % elv = infodat(9)            ! SELV height of station (eg. 828400.0 m)
+
+         ! with a channel selection, only the kept channels are scaled and stored
+         sub => report_subset(rep)
 
          jstart = 1
          chan_loop: do i = 1, nchan
             if ( data1b8(1,i) > r8bfms .or. data1b8(2,i) > r8bfms ) cycle chan_loop
             ichan = nint(data1b8(1,i))
+            k = i
+            if ( associated(sub) ) then
+               k = channel_slot(sub, ichan)
+               if ( k < 1 ) cycle chan_loop
+            end if
             radiance = data1b8(2,i)
             ! scale factors are stored in 10 channel groups
             iscale = 0  ! initialize
@@ -723,13 +765,12 @@ subroutine read_iasi (filename, filedate)
             end do range_loop
             if ( iscale /= 0 ) iscale = -1*(iscale-5)
             radiance = radiance * 10.0**iscale
-            rlink % tb(i) = radiance
-            rlink % ch(i) = ichan
+            rep % tb(k)  = radiance
+            rep % ch(k)  = ichan
+            rep % pos(k) = i
          end do chan_loop
 
-         allocate ( rlink%next )
-         rlink => rlink%next
-         nullify ( rlink%next )
+         call pool_report(rep)
 
       end do subset_loop ! ireadsb
    end do msg_loop ! ireadmg
@@ -799,14 +840,17 @@ subroutine read_cris (filename, filedate)
    character(len=8)  :: subset
    character(len=10) :: cdate
 
-   integer(i_kind) :: iunit, iost, iret, i
+   type(report_radiance) :: rep  ! the report being decoded
+   type(channel_subset_type), pointer :: sub  ! channel selection of its instrument
+
+   integer(i_kind) :: iunit, iost, iret, i, k
    integer(i_kind) :: nchan
    integer(i_kind) :: idate
    integer(i_kind) :: num_report_infile
+   integer(i_kind) :: imsg
    integer(i_kind) :: ireadmg, ireadsb
 
    integer(i_kind) :: iyear, imonth, iday, ihour, imin, isec
-   real(r_double)  :: ref_time, obs_time
 
    character(len=3) :: cmtyp
    real(r_double) :: r8mtyp(1)
@@ -819,6 +863,7 @@ subroutine read_cris (filename, filedate)
    lalostr = 'CLATH CLONH'
 
    num_report_infile  = 0
+   imsg = 0
 
    iunit = 96
 
@@ -857,24 +902,16 @@ subroutine read_cris (filename, filedate)
 
    write(unit=*,fmt='(1x,a,i10)') trim(filename)//' file date is: ', idate
    write(unit=filedate, fmt='(i10)') idate
-   read (filedate(1:10),'(i4,3i2)') iyear, imonth, iday, ihour
-   call get_julian_time (iyear,imonth,iday,ihour,0,0,ref_time)
 
-   if ( .not. associated(rhead) ) then
-      nullify ( rhead )
-      allocate ( rhead )
-      nullify ( rhead%next )
-   end if
+   allocate ( rep % tb(nchan_bufr) )
+   allocate ( rep % ch(nchan_bufr) )
+   allocate ( rep % pos(nchan_bufr) )
 
-   if ( .not. associated(rlink) ) then
-      rlink => rhead
-   else
-      allocate ( rlink%next )
-      rlink => rlink%next
-      nullify ( rlink%next )
-   end if
+   call split_messages(filename)
 
    msg_loop: do while (ireadmg(iunit,subset,idate)==0)
+      imsg = imsg + 1
+      if ( skip_message(filename, imsg, subset) ) cycle msg_loop
 !print*,subset
       subset_loop: do while (ireadsb(iunit)==0)
 
@@ -896,11 +933,7 @@ subroutine read_cris (filename, filedate)
               ihour  >=   0 .and. ihour  <   24 .and. &
               imin   >=   0 .and. imin   <   60 .and. &
               isec   >=   0 .and. isec   <   60 ) then
-            write(unit=rlink%datetime, fmt='(i4,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a)')  &
-               iyear, '-', imonth, '-', iday, 'T', ihour, ':', imin, ':', isec, 'Z'
-            call get_julian_time (iyear,imonth,iday,ihour,imin,isec,obs_time,rlink%epochtime)
-            rlink%dhr = (obs_time + (isec/60.0) - ref_time)/60.0
-            rlink%gstime = obs_time
+            rep%idate = [iyear, imonth, iday, ihour, imin, isec]
          else
             cycle subset_loop
          end if
@@ -923,36 +956,41 @@ subroutine read_cris (filename, filedate)
          if ( iret /= nchan_bufr ) cycle subset_loop
 
          nchan = nchan_bufr
-         rlink % nchan = nchan_bufr
-         allocate ( rlink % tb(nchan) )   ! radiance for now
-         allocate ( rlink % ch(nchan) )   ! channel number
+         rep % nchan = nchan_bufr
+
+         call fill_report(rep, missing_r, missing_i)
 
-         call fill_datalink(rlink, missing_r, missing_i)
+         if ( lalodat(1) < r8bfms ) rep % lat = lalodat(1)
+         if ( lalodat(2) < r8bfms ) rep % lon = lalodat(2)
 
-         if ( lalodat(1) < r8bfms ) rlink % lat = lalodat(1)
-         if ( lalodat(2) < r8bfms ) rlink % lon = lalodat(2)
+         rep % satid  = nint(infodat(1))  ! SAID satellite identifier
+         rep % instid = nint(infodat(2))  ! SIID instrument identifier
 
-         rlink % satid  = nint(infodat(1))  ! SAID satellite identifier
-         rlink % instid = nint(infodat(2))  ! SIID instrument identifier
+         if ( infodat(3)  < r8bfms ) rep % satzen  = infodat(3)        ! SAZA satellite zenith angle (degree)
+         if ( infodat(4)  < r8bfms ) rep % satazi  = infodat(4)        ! BEARAZ satellite azimuth (degree true)
+         if ( infodat(5)  < r8bfms ) rep % solzen  = infodat(5)        ! SOZA solar zenith angle (degree)
+         if ( infodat(6)  < r8bfms ) rep % solazi  = infodat(6)        ! SOLAZI solar azimuth (degree true)
+         if ( infodat(7)  < r8bfms ) rep % scanline = nint(infodat(7)) ! SLNM scan line number
+         if ( infodat(8)  < r8bfms ) rep % scanpos = nint(infodat(8))  ! FORN field of regard number 1-30
+         !if ( infodat(9)  < r8bfms ) rep % scanpos = nint(infodat(9))  ! FOVN field of view number 1-9
+         if ( infodat(10) < r8bfms ) rep % elv = infodat(10)           ! HMSL height or altitude (eg. 836410.0 m)
 
-         if ( infodat(3)  < r8bfms ) rlink % satzen  = infodat(3)        ! SAZA satellite zenith angle (degree)
-         if ( infodat(4)  < r8bfms ) rlink % satazi  = infodat(4)        ! BEARAZ satellite azimuth (degree true)
-         if ( infodat(5)  < r8bfms ) rlink % solzen  = infodat(5)        ! SOZA solar zenith angle (degree)
-         if ( infodat(6)  < r8bfms ) rlink % solazi  = infodat(6)        ! SOLAZI solar azimuth (degree true)
-         if ( infodat(7)  < r8bfms ) rlink % scanline = nint(infodat(7)) ! SLNM scan line number
-         if ( infodat(8)  < r8bfms ) rlink % scanpos = nint(infodat(8))  ! FORN field of regard number 1-30
-         !if ( infodat(9)  < r8bfms ) rlink % scanpos = nint(infodat(9))  ! FOVN field of view number 1-9
-         if ( infodat(10) < r8bfms ) rlink % elv = infodat(10)           ! HMSL height or altitude (eg. 836410.0 m)
+         ! with a channel selection, only the kept channels are stored
+         sub => report_subset(rep)
 
          chan_loop: do i = 1, nchan
             if ( data1b8(1,i) > r8bfms .or. data1b8(2,i) > r8bfms ) cycle chan_loop
-            rlink % ch(i) = nint(data1b8(1,i))
-            rlink % tb(i) = data1b8(2,i) * 1000.0  ! radiance for now
+            k = i
+            if ( associated(sub) ) then
+               k = channel_slot(sub, nint(data1b8(1,i)))
+               if ( k < 1 ) cycle chan_loop
+            end if
+            rep % ch(k)  = nint(data1b8(1,i))
+            rep % tb(k)  = data1b8(2,i) * 1000.0  ! radiance for now
+            rep % pos(k) = i
          end do chan_loop
 
-         allocate ( rlink%next )
-         rlink => rlink%next
-         nullify ( rlink%next )
+         call pool_report(rep)
 
       end do subset_loop ! ireadsb
    end do msg_loop ! ireadmg
@@ -974,62 +1012,66 @@ subroutine sort_obs_radiance(filedate, nfgat)
    character(len=*), intent(in) :: filedate
    integer(i_kind),  intent(in) :: nfgat
 
-   integer(i_kind)                   :: i, iv, k, ii
-   integer(i_kind)                   :: ityp, irec, itim
+   integer(i_kind)                   :: i, iv, k, ii, ich
+   integer(i_kind)                   :: ityp, iloc_rep
+   integer(i_kind)                   :: n, ninvalid, ninvalid_all
    integer(i_kind), dimension(ninst,nfgat) :: nrecs
    integer(i_kind), dimension(ninst,nfgat) :: nlocs
    integer(i_kind), dimension(ninst,nfgat) :: iloc
    integer(i_kind), dimension(ninst) :: nvars
-   character(len=nstring)            :: satellite
-   character(len=nstring)            :: sensor
+   integer(i_kind), dimension(nrep_block) :: loc  ! xdata location of each report of a block
+   type(radiance_block), pointer     :: blk
    character(len=14) :: cdate_min, cdate_max
-   real(r_double) :: time_slots(0:nfgat)
+   integer(i_llong) :: time_slots(0:nfgat)
 
    call da_advance_time(filedate, dtime_min, cdate_min)
    call da_advance_time(filedate, dtime_max, cdate_max)
-   call da_get_time_slots(nfgat, cdate_min, cdate_max, time_slots)
+   if ( timeWindowSlots(cdate_min, cdate_max, nfgat, time_slots) /= 0 ) then
+      write(*,*) 'Error: invalid time window ', cdate_min, ' to ', cdate_max
+      stop 1
+   end if
 
    nrecs(:,:) = 0
    nlocs(:,:) = 0
    nvars(:) = 0
+   ninvalid_all = 0
 
    write(*,*) '--- sorting radiance obs...'
 
-   ! set inst type from satellite id and sensor id
-   ! and count the numbers
-   rlink => rhead
-   set_inst_loop: do while ( associated(rlink) )
-
-      if (  rlink%nchan < 1 ) then
-         rlink => rlink%next
-         cycle set_inst_loop
-      end if
-
-      ! determine time_slot index
-      do i = 1, nfgat
-         if ( rlink%gstime >= time_slots(i-1) .and.  &
-              rlink%gstime <= time_slots(i) ) then
-             exit
+   ! the reports are already grouped by instrument by pool_report,
+   ! set their time slots and count the numbers
+   do ityp = 1, ninst
+      nvars(ityp) = rad_pool(ityp) % nchan
+      blk => rad_pool(ityp) % head
+      do while ( associated(blk) )
+         ! convert the times of the block in one call
+         n = blk % nrep
+         ninvalid = timeToEpoch(blk%idate(1:n,1), blk%idate(1:n,2), blk%idate(1:n,3), &
+                                blk%idate(1:n,4), blk%idate(1:n,5), blk%idate(1:n,6), blk%epochtime(1:n))
+         if ( ninvalid < 0 ) then
+            write(*,*) 'Error: converting the times of ', trim(inst_list(ityp))
+            stop 1
          end if
+         ninvalid_all = ninvalid_all + ninvalid
+         do k = 1, n
+            ! determine time_slot index; reports with invalid times and
+            ! outside of all time slots are not sorted
+            if ( blk%epochtime(k) == invalid_epoch ) then
+               i = 0
+            else
+               i = get_time_slot(blk%epochtime(k), time_slots)
+               if ( i > nfgat ) i = 0
+            end if
+            blk % ifgat(k) = i
+            if ( i > 0 ) then
+               nrecs(ityp,i) = nrecs(ityp,i) + 1
+               nlocs(ityp,i) = nlocs(ityp,i) + 1
+            end if
+         end do
+         blk => blk % next
       end do
-      rlink%ifgat = i
-
-      call set_name_satellite(rlink%satid,  satellite)
-      call set_name_sensor   (rlink%instid, sensor)
-      rlink % inst = trim(sensor)//'_'//trim(satellite)
-!print*, rlink%inst, rlink % nchan
-
-      ! find index of inst in inst_list
-      rlink%inst_idx = ufo_vars_getindex(inst_list, rlink%inst)
-      if ( rlink % inst_idx > 0 ) then
-         ! obtype assigned, advance ob counts
-         nrecs(rlink%inst_idx,rlink%ifgat) = nrecs(rlink%inst_idx,rlink%ifgat) + 1
-         nlocs(rlink%inst_idx,rlink%ifgat) = nlocs(rlink%inst_idx,rlink%ifgat) + 1
-         nvars(rlink%inst_idx) = rlink % nchan
-      end if
-
-      rlink => rlink%next
-   end do set_inst_loop
+   end do
+   if ( ninvalid_all > 0 ) write(*,*) 'Warning: skipping ', ninvalid_all, ' reports with invalid times'
 
    do ii = 1, nfgat
       if ( nfgat > 1 ) then
@@ -1075,142 +1117,395 @@ subroutine sort_obs_radiance(filedate, nfgat)
             xdata(i,ii)%xfield(:,:)%val = missing_r
             xdata(i,ii)%xfield(:,:)%qm  = missing_i
             xdata(i,ii)%xfield(:,:)%err = missing_r
+            ! var_idx holds the BUFR position of each channel, which differs
+            ! from the channel index when a channel selection is applied
             allocate (xdata(i,ii)%var_idx(nvars(i)))
-            do iv = 1, nvars(i)
-               xdata(i,ii)%var_idx(iv) = iv
-            end do
+            xdata(i,ii)%var_idx(:) = rad_pool(i)%pos(:)
+            iv = ufo_vars_getindex(name_sen_info, 'sensor_channel')
+            xdata(i,ii)%xseninfo_int(:,iv) = rad_pool(i)%ch(:)
          end if
       end if
    end do ! ninst
    end do ! nfgat
 
-   ! transfer data from rlink to xdata
+   ! transfer data from the pools to xdata, one block at a time
 
    iloc(:,:) = 0
-   irec = 0
-
-   rlink => rhead
-   reports: do while ( associated(rlink) )
-      irec = irec + 1
-      ityp = rlink%inst_idx
-      itim = rlink%ifgat
-      if ( ityp < 0 ) then
-         rlink => rlink%next
-         cycle reports
-      end if
-      if (  rlink%nchan < 1 ) then
-         rlink => rlink%next
-         cycle reports
-      end if
 
-      iloc(ityp,itim) = iloc(ityp,itim) + 1
+   pools: do ityp = 1, ninst
+      blk => rad_pool(ityp) % head
+      blocks: do while ( associated(blk) )
 
-      do i = 1, nvar_info
-         if ( type_var_info(i) == nf90_int ) then
-            if ( trim(name_var_info(i)) == 'record_number' ) then
-               xdata(ityp,itim)%xinfo_int(iloc(ityp,itim),i) = irec
+         reports: do k = 1, blk % nrep
+            ii = blk % ifgat(k)
+            if ( ii < 1 ) then
+               loc(k) = 0
+               cycle reports
             end if
-         else if ( type_var_info(i) == nf90_float ) then
-            if ( name_var_info(i) == 'time' ) then
-               xdata(ityp,itim)%xinfo_float(iloc(ityp,itim),i) = rlink%dhr
-            else if ( trim(name_var_info(i)) == 'station_elevation' ) then
-               xdata(ityp,itim)%xinfo_float(iloc(ityp,itim),i) = rlink%elv
-            else if ( trim(name_var_info(i)) == 'latitude' ) then
-               xdata(ityp,itim)%xinfo_float(iloc(ityp,itim),i) = rlink%lat
-            else if ( trim(name_var_info(i)) == 'longitude' ) then
-               xdata(ityp,itim)%xinfo_float(iloc(ityp,itim),i) = rlink%lon
-            end if
-         else if ( type_var_info(i) == nf90_char ) then
-            if ( trim(name_var_info(i)) == 'datetime' ) then
-               xdata(ityp,itim)%xinfo_char(iloc(ityp,itim),i) = rlink%datetime
-            else if ( trim(name_var_info(i)) == 'station_id' ) then
-               xdata(ityp,itim)%xinfo_char(iloc(ityp,itim),i) = rlink%inst
-            end if
-         else if ( type_var_info(i) == nf90_int64 ) then
-            if ( trim(name_var_info(i)) == 'dateTime' ) then
-               xdata(ityp,itim)%xinfo_int64(iloc(ityp,itim),i) = rlink%epochtime
-            end if
-         end if
-      end do
+            iloc(ityp,ii) = iloc(ityp,ii) + 1
+            iloc_rep = iloc(ityp,ii)
+            loc(k) = iloc_rep
+
+            do i = 1, nvar_info
+               if ( type_var_info(i) == nf90_int ) then
+                  if ( trim(name_var_info(i)) == 'record_number' ) then
+                     xdata(ityp,ii)%xinfo_int(iloc_rep,i) = blk%irec(k)
+                  end if
+               else if ( type_var_info(i) == nf90_float ) then
+                  if ( trim(name_var_info(i)) == 'station_elevation' ) then
+                     xdata(ityp,ii)%xinfo_float(iloc_rep,i) = blk%elv(k)
+                  else if ( trim(name_var_info(i)) == 'latitude' ) then
+                     xdata(ityp,ii)%xinfo_float(iloc_rep,i) = blk%lat(k)
+                  else if ( trim(name_var_info(i)) == 'longitude' ) then
+                     xdata(ityp,ii)%xinfo_float(iloc_rep,i) = blk%lon(k)
+                  end if
+               else if ( type_var_info(i) == nf90_char ) then
+                  if ( trim(name_var_info(i)) == 'station_id' ) then
+                     xdata(ityp,ii)%xinfo_char(iloc_rep,i) = inst_list(ityp)
+                  end if
+               else if ( type_var_info(i) == nf90_int64 ) then
+                  if ( trim(name_var_info(i)) == 'dateTime' ) then
+                     xdata(ityp,ii)%xinfo_int64(iloc_rep,i) = blk%epochtime(k)
+                  end if
+               end if
+            end do
 
-      do i = 1, nsen_info
-         if ( type_sen_info(i) == nf90_float ) then
-            if ( trim(name_sen_info(i)) == 'scan_position' ) then
-               xdata(ityp,itim)%xseninfo_float(iloc(ityp,itim),i) = rlink%scanpos
-            else if ( trim(name_sen_info(i)) == 'sensor_zenith_angle' ) then
-               xdata(ityp,itim)%xseninfo_float(iloc(ityp,itim),i) = rlink%satzen
-            else if ( trim(name_sen_info(i)) == 'sensor_azimuth_angle' ) then
-               xdata(ityp,itim)%xseninfo_float(iloc(ityp,itim),i) = rlink%satazi
-            else if ( trim(name_sen_info(i)) == 'solar_zenith_angle' ) then
-               xdata(ityp,itim)%xseninfo_float(iloc(ityp,itim),i) = rlink%solzen
-            else if ( trim(name_sen_info(i)) == 'solar_azimuth_angle' ) then
-               xdata(ityp,itim)%xseninfo_float(iloc(ityp,itim),i) = rlink%solazi
-            else if ( trim(name_sen_info(i)) == 'sensor_view_angle' ) then
-               call calc_sensor_view_angle(trim(rlink%inst), rlink%scanpos, xdata(ityp,itim)%xseninfo_float(iloc(ityp,itim),i))
-            end if
-!         else if ( type_sen_info(i) == nf90_int ) then
-!         else if ( type_sen_info(i) == nf90_char ) then
-         end if
+            do i = 1, nsen_info
+               if ( type_sen_info(i) == nf90_float ) then
+                  if ( trim(name_sen_info(i)) == 'scan_position' ) then
+                     xdata(ityp,ii)%xseninfo_float(iloc_rep,i) = blk%scanpos(k)
+                  else if ( trim(name_sen_info(i)) == 'sensor_zenith_angle' ) then
+                     xdata(ityp,ii)%xseninfo_float(iloc_rep,i) = blk%satzen(k)
+                  else if ( trim(name_sen_info(i)) == 'sensor_azimuth_angle' ) then
+                     xdata(ityp,ii)%xseninfo_float(iloc_rep,i) = blk%satazi(k)
+                  else if ( trim(name_sen_info(i)) == 'solar_zenith_angle' ) then
+                     xdata(ityp,ii)%xseninfo_float(iloc_rep,i) = blk%solzen(k)
+                  else if ( trim(name_sen_info(i)) == 'solar_azimuth_angle' ) then
+                     xdata(ityp,ii)%xseninfo_float(iloc_rep,i) = blk%solazi(k)
+                  else if ( trim(name_sen_info(i)) == 'sensor_view_angle' ) then
+                     call calc_sensor_view_angle(trim(inst_list(ityp)), blk%scanpos(k), xdata(ityp,ii)%xseninfo_float(iloc_rep,i))
+                  end if
+!               else if ( type_sen_info(i) == nf90_int ) then
+!               else if ( type_sen_info(i) == nf90_char ) then
+               end if
+            end do
+         end do reports
+
+         ! the channel data of the block are copied channel by channel,
+         ! reading all reports of a channel contiguously
+         do ich = 1, nvars(ityp)
+            do k = 1, blk % nrep
+               if ( loc(k) < 1 ) cycle
+               ii = blk % ifgat(k)
+               xdata(ityp,ii)%xfield(loc(k),ich)%val = blk%tb(k,ich)
+               ! tb errors set in subroutine write_obs of ncio_mod.f90
+               !xdata(ityp,ii)%xfield(loc(k),ich)%err = 1.0
+               xdata(ityp,ii)%xfield(loc(k),ich)%qm  = 0
+            end do
+         end do
+
+         blk => blk % next
+      end do blocks
+   end do pools
+
+   ! done with the pools
+   call release_pools()
+
+end subroutine sort_obs_radiance
+
+!--------------------------------------------------------------
+
+subroutine pool_report(rep)
+
+! appends a decoded report to the pool of its instrument;
+! reports of instruments not in inst_list and without channels are dropped
+
+   implicit none
+
+   type(report_radiance), intent(in) :: rep
+
+   type(radiance_pool),  pointer :: pool
+   type(radiance_block), pointer :: blk
+   integer(i_kind)               :: ityp, k, n
+
+   nrep_read = nrep_read + 1
+
+   if ( rep % nchan < 1 ) return
+   ityp = inst_index(rep%satid, rep%instid)
+   if ( ityp < 1 ) return
+
+   pool => rad_pool(ityp)
+   if ( pool % nchan == 0 ) then
+      pool % nchan = rep % nchan
+      allocate ( pool % ch(pool%nchan) )
+      allocate ( pool % pos(pool%nchan) )
+      pool % pos(:) = rep % pos(1:pool%nchan)
+   end if
+
+   if ( .not. associated(pool%tail) ) then
+      pool % head => new_block(pool%nchan)
+      pool % tail => pool % head
+   else if ( pool % tail % nrep == nrep_block ) then
+      pool % tail % next => new_block(pool%nchan)
+      pool % tail => pool % tail % next
+   end if
+   blk => pool % tail
+
+   blk % nrep = blk % nrep + 1
+   k = blk % nrep
+   blk % irec(k)      = nrep_read
+   blk % ifgat(k)     = 0
+   blk % lat(k)       = rep % lat
+   blk % lon(k)       = rep % lon
+   blk % elv(k)       = rep % elv
+   blk % idate(k,:)   = rep % idate
+   blk % scanpos(k)   = rep % scanpos
+   blk % satzen(k)    = rep % satzen
+   blk % satazi(k)    = rep % satazi
+   blk % solzen(k)    = rep % solzen
+   blk % solazi(k)    = rep % solazi
+
+   n = min(rep%nchan, pool%nchan)
+   blk % tb(k,1:n) = rep % tb(1:n)
+   if ( n < pool % nchan ) blk % tb(k,n+1:pool%nchan) = missing_r
+   pool % ch(1:n) = nint(rep % ch(1:n))
+   where ( rep % pos(1:n) > 0 ) pool % pos(1:n) = rep % pos(1:n)
+
+end subroutine pool_report
+
+!--------------------------------------------------------------
+
+function new_block(nchan) result(blk)
+
+   implicit none
+
+   integer(i_kind), intent(in)   :: nchan
+   type(radiance_block), pointer :: blk
+
+   allocate ( blk )
+   allocate ( blk % irec(nrep_block) )
+   allocate ( blk % ifgat(nrep_block) )
+   allocate ( blk % lat(nrep_block) )
+   allocate ( blk % lon(nrep_block) )
+   allocate ( blk % elv(nrep_block) )
+   allocate ( blk % idate(nrep_block, 6) )
+   allocate ( blk % epochtime(nrep_block) )
+   allocate ( blk % scanpos(nrep_block) )
+   allocate ( blk % satzen(nrep_block) )
+   allocate ( blk % satazi(nrep_block) )
+   allocate ( blk % solzen(nrep_block) )
+   allocate ( blk % solazi(nrep_block) )
+   allocate ( blk % tb(nrep_block, nchan) )
+
+end function new_block
+
+!--------------------------------------------------------------
+
+subroutine release_pools()
+
+   implicit none
+
+   type(radiance_block), pointer :: blk, next
+   integer(i_kind)               :: ityp
+
+   do ityp = 1, ninst
+      blk => rad_pool(ityp) % head
+      do while ( associated(blk) )
+         next => blk % next
+         deallocate ( blk )  ! also deallocates the allocatable components
+         blk => next
       end do
+      nullify ( rad_pool(ityp) % head )
+      nullify ( rad_pool(ityp) % tail )
+      rad_pool(ityp) % nchan = 0
+      if ( allocated(rad_pool(ityp) % ch) ) deallocate ( rad_pool(ityp) % ch )
+      if ( allocated(rad_pool(ityp) % pos) ) deallocate ( rad_pool(ityp) % pos )
+   end do
+   nrep_read = 0
+
+end subroutine release_pools
+
+!--------------------------------------------------------------
+
+integer(i_kind) function inst_index(satid, instid)
+
+! index in inst_list of the instrument of a BUFR SAID and SIID pair, -1 if none
+
+   implicit none
+
+   integer(i_kind), intent(in) :: satid   ! SAID satellite identifier
+   integer(i_kind), intent(in) :: instid  ! SIID instrument identifier
+
+   inst_index = -1
+   if ( .not. inst_table_built ) call build_inst_table()
+   if ( satid  < 0 .or. satid  > max_said ) return
+   if ( instid < 0 .or. instid > max_siid ) return
+   if ( sat_slot(satid) < 1 .or. sen_slot(instid) < 1 ) return
+   inst_index = inst_table(sat_slot(satid), sen_slot(instid))
+
+end function inst_index
+
+!--------------------------------------------------------------
+
+subroutine build_inst_table()
+
+! numbers the distinct satellite and sensor names of all SAID and SIID codes
+! and looks up each sensor_satellite combination in inst_list once
+
+   implicit none
+
+   character(len=nstring), allocatable :: sat_names(:), sen_names(:)
+   character(len=nstring)              :: name
+   integer(i_kind)                     :: nsat, nsen, code, i, j
+
+   allocate ( sat_names(max_said+1), sen_names(max_siid+1) )
+   nsat = 0
+   sat_slot(:) = 0
+   do code = 0, max_said
+      call set_name_satellite(code, name)
+      if ( trim(name) == 'unknown' ) cycle
+      sat_slot(code) = ufo_vars_getindex(sat_names(1:nsat), name)
+      if ( sat_slot(code) < 1 ) then
+         nsat = nsat + 1
+         sat_names(nsat) = name
+         sat_slot(code) = nsat
+      end if
+   end do
 
-      iv = ufo_vars_getindex(name_sen_info, 'sensor_channel')
-      xdata(ityp,itim)%xseninfo_int(:,iv) = rlink%ch(:)
+   nsen = 0
+   sen_slot(:) = 0
+   do code = 0, max_siid
+      call set_name_sensor(code, name)
+      if ( trim(name) == 'unknown' ) cycle
+      sen_slot(code) = ufo_vars_getindex(sen_names(1:nsen), name)
+      if ( sen_slot(code) < 1 ) then
+         nsen = nsen + 1
+         sen_names(nsen) = name
+         sen_slot(code) = nsen
+      end if
+   end do
 
-      do i = 1, nvars(ityp)
-         xdata(ityp,itim)%xfield(iloc(ityp,itim),i)%val = rlink%tb(i)
-         ! tb errors set in subroutine write_obs of ncio_mod.f90
-         !xdata(ityp,itim)%xfield(iloc(ityp,itim),i)%err = 1.0
-         xdata(ityp,itim)%xfield(iloc(ityp,itim),i)%qm  = 0
+   allocate ( inst_table(nsat, nsen) )
+   do j = 1, nsen
+      do i = 1, nsat
+         inst_table(i,j) = ufo_vars_getindex(inst_list, trim(sen_names(j))//'_'//trim(sat_names(i)))
       end do
-      rlink => rlink%next
-   end do reports
-
-   ! done with rlink
-   ! release the linked list
-   rlink => rhead
-   do while ( associated(rlink) )
-      rhead => rlink%next
-      if ( allocated (rlink%tb) ) deallocate (rlink%tb)
-      if ( allocated (rlink%ch) ) deallocate (rlink%ch)
-      if ( associated (rlink) ) deallocate (rlink)
-      rlink => rhead
    end do
-   nullify (rhead)
+   inst_table_built = .true.
+   deallocate ( sat_names, sen_names )
 
-end subroutine sort_obs_radiance
+end subroutine build_inst_table
 
 !--------------------------------------------------------------
 
-subroutine fill_datalink (datalink, rfill, ifill)
+subroutine fill_report (rep, rfill, ifill)
 
    implicit none
 
-   type (datalink_radiance), intent(inout) :: datalink
-   real(r_kind),             intent(in)    :: rfill    ! fill value in real
-   integer(i_kind),          intent(in)    :: ifill    ! fill value in integer
+   type (report_radiance), intent(inout) :: rep
+   real(r_kind),           intent(in)    :: rfill    ! fill value in real
+   integer(i_kind),        intent(in)    :: ifill    ! fill value in integer
 
    integer(i_kind) :: i
 
-   !datalink % datetime = ''
-   datalink % lat      = rfill
-   datalink % lon      = rfill
-   datalink % satid    = ifill
-   datalink % instid   = ifill
-   datalink % scanpos  = rfill
-   datalink % landsea  = rfill
-   datalink % satzen   = rfill
-   datalink % satazi   = rfill
-   datalink % solzen   = rfill
-   datalink % solazi   = rfill
-   datalink % elv      = rfill
-   if ( allocated (datalink % tb) ) then
-      datalink % tb(:) = rfill
-   end if
-   if ( allocated (datalink % ch) ) then
-      datalink % ch(:) = ifill
+   rep % lat      = rfill
+   rep % lon      = rfill
+   rep % satid    = ifill
+   rep % instid   = ifill
+   rep % scanpos  = ifill
+   rep % scanline = ifill
+   rep % landsea  = ifill
+   rep % satzen   = rfill
+   rep % satazi   = rfill
+   rep % solzen   = rfill
+   rep % solazi   = rfill
+   rep % elv      = rfill
+   rep % tb(:)    = rfill
+   rep % ch(:)    = ifill
+   do i = 1, size(rep % pos)
+      rep % pos(i) = i
+   end do
+
+end subroutine fill_report
+
+!--------------------------------------------------------------
+
+function report_subset(rep) result(sub)
+
+! the channel selection of the instrument of a report, null if all its
+! channels are kept. With a selection, the report is reset to hold the
+! kept channels, in the order of the selection.
+
+   implicit none
+
+   type(report_radiance), intent(inout) :: rep
+   type(channel_subset_type), pointer   :: sub
+
+   integer(i_kind) :: ityp, i
+
+   nullify ( sub )
+   ityp = inst_index(rep%satid, rep%instid)
+   if ( ityp < 1 ) return
+   if ( .not. chan_subset(ityp) % loaded ) call load_channel_subset(ityp)
+   if ( chan_subset(ityp) % nsel < 0 ) return
+   sub => chan_subset(ityp)
+
+   if ( size(rep % tb) < sub % nsel ) then
+      deallocate ( rep % tb, rep % ch, rep % pos )
+      allocate ( rep % tb(sub%nsel), rep % ch(sub%nsel), rep % pos(sub%nsel) )
    end if
+   rep % nchan = sub % nsel
+   rep % tb(:) = missing_r
+   do i = 1, sub % nsel
+      rep % ch(i) = sub % chan(i)
+   end do
+   rep % pos(:) = 0
+
+end function report_subset
+
+!--------------------------------------------------------------
 
-end subroutine fill_datalink
+subroutine load_channel_subset(ityp)
+
+   implicit none
+
+   integer(i_kind), intent(in) :: ityp
+
+   type(channel_subset_type), pointer :: sub
+   integer(i_kind), allocatable       :: channels(:)
+   integer(i_kind)                    :: i
+
+   sub => chan_subset(ityp)
+   sub % loaded = .true.
+   if ( channelSelectionGet(inst_list(ityp), channels) /= 0 ) return
+   if ( .not. allocated(channels) ) return
+
+   sub % nsel = size(channels)
+   sub % chan = channels
+   allocate ( sub % slot(0:maxval([0, channels])) )
+   sub % slot(:) = 0
+   do i = 1, sub % nsel
+      sub % slot(channels(i)) = i
+   end do
+   write(*,'(1x,a,i6,a)') trim(inst_list(ityp))//': keeping ', sub % nsel, ' selected channels'
+
+end subroutine load_channel_subset
+
+!--------------------------------------------------------------
+
+integer(i_kind) function channel_slot(sub, ichan)
+
+! index of channel number ichan among the kept channels, 0 if it is dropped
+
+   implicit none
+
+   type(channel_subset_type), intent(in) :: sub
+   integer(i_kind),           intent(in) :: ichan
+
+   channel_slot = 0
+   if ( ichan >= 0 .and. ichan <= ubound(sub % slot, 1) ) channel_slot = sub % slot(ichan)
+
+end function channel_slot
 
 subroutine calc_sensor_view_angle(name_inst, ifov, view_angle)
 
@@ -1260,16 +1555,11 @@ subroutine radiance_to_temperature(ninst, nfgat)
 implicit none
 integer(i_kind),  intent(in) :: ninst ! first dim of xdata
 integer(i_kind),  intent(in) :: nfgat ! second dim of xdata
-real(r_double), allocatable :: planck_c1(:)
-real(r_double), allocatable :: planck_c2(:)
-real(r_double), allocatable :: band_c1(:)
-real(r_double), allocatable :: band_c2(:)
-real(r_double), allocatable :: wavenumber(:)
+type(spc_coeff_type), pointer :: spc
 integer(i_kind) :: ierr
-integer(i_kind) :: i, ii, iloc, ichan, nchan, nlocs
-real(r_double) :: radiance
-real(r_double) :: effective_temperature
-real(r_double) :: temperature
+integer(i_kind) :: i, ii, iv, ichan, nchan, nlocs
+integer(i_kind) :: iloc_start, iloc_end, nblock
+real(r_double)  :: rad_block(nloc_block)
 
 fgat_loop: do ii = 1, nfgat
   inst_loop: do i = 1, ninst
@@ -1289,71 +1579,138 @@ fgat_loop: do ii = 1, nfgat
     nchan = xdata(i,ii) % nvars
     if ( nchan <= 0 ) cycle inst_loop
 
-    allocate(planck_c1(nchan))
-    allocate(planck_c2(nchan))
-    allocate(band_c1(nchan))
-    allocate(band_c2(nchan))
-    allocate(wavenumber(nchan))
-
-    call read_spc(trim(inst_list(i)), nchan, planck_c1, planck_c2, band_c1, band_c2, wavenumber, ierr)
-    if ( ierr /= 0 ) then
-      deallocate(planck_c1)
-      deallocate(planck_c2)
-      deallocate(band_c1)
-      deallocate(band_c2)
-      deallocate(wavenumber)
-      cycle inst_loop
-    end if
+    iv = ufo_vars_getindex(name_sen_info, 'sensor_channel')
+    call get_spc(i, nchan, xdata(i,ii)%xseninfo_int(:,iv), spc, ierr)
+    if ( ierr /= 0 ) cycle inst_loop
 
     write(*,*) '--- converting radiance to brightness temperature... '
+    ! xfield is stored channel-major, but %val is a strided component of its
+    ! (val, qm, err) elements, so each block of locations of a channel is copied
+    ! into the contiguous rad_block, converted there and copied back
     do ichan = 1, nchan
-      do iloc = 1, nlocs
-        radiance = xdata(i,ii)%xfield(iloc,ichan)%val
-        if ( radiance <= 0.0 ) cycle
-        effective_temperature = planck_c2(ichan)  / &
-                                LOG( ( planck_c1(ichan) / radiance ) + 1.0_r_double )
-        temperature = ( effective_temperature - band_c1(ichan) ) / &
-                      band_c2(ichan)
-        xdata(i,ii)%xfield(iloc,ichan)%val = temperature
+      do iloc_start = 1, nlocs, nloc_block
+        iloc_end = min(iloc_start + nloc_block - 1, nlocs)
+        nblock = iloc_end - iloc_start + 1
+        rad_block(1:nblock) = xdata(i,ii)%xfield(iloc_start:iloc_end,ichan)%val
+        call planck_radiance_to_bt(nblock, rad_block, spc%planck_c1(ichan), spc%planck_c2(ichan), &
+                                   spc%band_c1(ichan), spc%band_c2(ichan))
+        xdata(i,ii)%xfield(iloc_start:iloc_end,ichan)%val = real(rad_block(1:nblock), r_kind)
       end do
     end do
 
     if ( allocated(xdata(i,ii)%wavenumber) ) then
-       xdata(i,ii)%wavenumber(1:nchan) = wavenumber(1:nchan)
+       xdata(i,ii)%wavenumber(1:nchan) = spc%wavenumber(1:nchan)
     end if
 
-    deallocate(planck_c1)
-    deallocate(planck_c2)
-    deallocate(band_c1)
-    deallocate(band_c2)
-    deallocate(wavenumber)
-
   end do inst_loop
 end do fgat_loop
 
 end subroutine radiance_to_temperature
 
-subroutine read_spc(inst_id, nchan, planck_c1, planck_c2, band_c1, band_c2, wavenumber, iret)
+subroutine planck_radiance_to_bt(n, rad, planck_c1, planck_c2, band_c1, band_c2)
+
+! in-place inverse Planck function for one channel:
+! converts n radiances to brightness temperatures.
+! Non-positive radiances are left unchanged. The loop is branch-free so that it vectorizes.
+
+implicit none
+integer(i_kind), intent(in)    :: n
+real(r_double),  intent(inout) :: rad(n)
+real(r_double),  intent(in)    :: planck_c1, planck_c2  ! Planck function coefficients
+real(r_double),  intent(in)    :: band_c1, band_c2      ! band correction offset and slope
+
+integer(i_kind) :: iloc
+real(r_double)  :: radiance, effective_temperature
+logical         :: valid
+
+!$omp simd private(radiance, effective_temperature, valid)
+do iloc = 1, n
+  valid = rad(iloc) > 0.0_r_double
+  ! evaluate invalid radiances at 1.0 and discard the result below
+  radiance = merge(rad(iloc), 1.0_r_double, valid)
+  effective_temperature = planck_c2 / &
+                          LOG( ( planck_c1 / radiance ) + 1.0_r_double )
+  rad(iloc) = merge(( effective_temperature - band_c1 ) / band_c2, rad(iloc), valid)
+end do
+
+end subroutine planck_radiance_to_bt
+
+subroutine get_spc(inst_idx, nchan, channels, spc, iret)
+
+! returns the SpcCoeff table of inst_list(inst_idx) from spc_cache.
+! The SpcCoeff file is read only on the first request for an instrument;
+! the outcome (including a missing file) is remembered for the rest of the run.
+
+implicit none
+integer(i_kind),               intent(in)  :: inst_idx
+integer(i_kind),               intent(in)  :: nchan
+integer(i_kind),               intent(in)  :: channels(nchan)  ! sensor channel numbers
+type(spc_coeff_type), pointer, intent(out) :: spc
+integer(i_kind),               intent(out) :: iret
+
+spc => spc_cache(inst_idx)
+
+if ( spc%loaded .and. spc%iret == 0 .and. spc%nchan /= nchan ) then
+   write(*,*) 'mismatch nchannel ', spc%nchan, nchan
+   iret = -2
+   return
+end if
+
+if ( .not. spc%loaded ) then
+   allocate(spc%planck_c1(nchan))
+   allocate(spc%planck_c2(nchan))
+   allocate(spc%band_c1(nchan))
+   allocate(spc%band_c2(nchan))
+   allocate(spc%wavenumber(nchan))
+   call read_spc(trim(inst_list(inst_idx)), nchan, channels, spc%planck_c1, spc%planck_c2, &
+                 spc%band_c1, spc%band_c2, spc%wavenumber, spc%iret)
+   spc%loaded = .true.
+   spc%nchan  = nchan
+   if ( spc%iret /= 0 ) then
+      deallocate(spc%planck_c1)
+      deallocate(spc%planck_c2)
+      deallocate(spc%band_c1)
+      deallocate(spc%band_c2)
+      deallocate(spc%wavenumber)
+   end if
+end if
+
+iret = spc%iret
+
+end subroutine get_spc
+
+subroutine read_spc(inst_id, nchan, channels, planck_c1, planck_c2, band_c1, band_c2, wavenumber, iret)
+
+! reads the coefficients of the given channels from a SpcCoeff file.
+! The channels are matched by sensor channel number; when some are not found,
+! a file with exactly nchan channels is used in its own order.
 
 implicit none
 
 character(len=*), intent(in) :: inst_id
 integer(i_kind), intent(in) :: nchan
+integer(i_kind), intent(in) :: channels(nchan)
 real(r_double), intent(out) :: planck_c1(nchan)
 real(r_double), intent(out) :: planck_c2(nchan)
 real(r_double), intent(out) :: band_c1(nchan)
 real(r_double), intent(out) :: band_c2(nchan)
+real(r_double), intent(out) :: wavenumber(nchan)
 integer(i_kind), intent(out) :: iret
 
-integer(i_kind) :: sensor_channel(nchan)
-integer(i_kind) :: polarization(nchan)
-integer(i_kind) :: channel_flag(nchan)
-real(r_double) :: frequency(nchan)
-real(r_double) :: wavenumber(nchan)
+integer(i_kind), allocatable :: sensor_channel(:)
+integer(i_kind), allocatable :: polarization(:)
+integer(i_kind), allocatable :: channel_flag(:)
+real(r_double), allocatable :: frequency(:)
+real(r_double), allocatable :: file_wavenumber(:)
+real(r_double), allocatable :: file_planck_c1(:)
+real(r_double), allocatable :: file_planck_c2(:)
+real(r_double), allocatable :: file_band_c1(:)
+real(r_double), allocatable :: file_band_c2(:)
+integer(i_kind) :: idx(nchan)
 
 character(len=StrLen) :: coefdir, coefname
 logical :: fexist
-integer(i_kind) :: fid, status, magic_number, i
+integer(i_kind) :: fid, status, magic_number, i, j
 integer(i_kind) :: sensor_type
 integer(i_kind) :: release, version, nchannel, nfov, wmo_satellite_id, wmo_sensor_id
 character(len=20) :: sensor_id
@@ -1379,7 +1736,7 @@ read(fid,iostat=status) release, version
 !write(0,*) release, version
 read(fid,iostat=status) nchannel, nfov
 !write(0,*) nchannel, nfov
-if ( nchannel /= nchan ) then
+if ( status /= 0 .or. nchannel < 1 ) then
    iret = -2
    write(*,*) 'mismatch nchannel ', nchannel, nchan
    close(fid)
@@ -1387,18 +1744,100 @@ if ( nchannel /= nchan ) then
 end if
 read(fid,iostat=status) sensor_id, sensor_type, wmo_satellite_id, wmo_sensor_id
 !write(0,*) sensor_id, sensor_type, wmo_satellite_id, wmo_sensor_id
+allocate(sensor_channel(nchannel), polarization(nchannel), channel_flag(nchannel))
+allocate(frequency(nchannel), file_wavenumber(nchannel))
+allocate(file_planck_c1(nchannel), file_planck_c2(nchannel), file_band_c1(nchannel), file_band_c2(nchannel))
 read(fid,iostat=status) sensor_channel, &
                         polarization, &
                         channel_flag, &
                         frequency, &
-                        wavenumber, &
-                        planck_c1, &
-                        planck_c2, &
-                        band_c1, &
-                        band_c2
+                        file_wavenumber, &
+                        file_planck_c1, &
+                        file_planck_c2, &
+                        file_band_c1, &
+                        file_band_c2
 iret = status
 close(fid)
+if ( iret /= 0 ) return
+
+! position of each requested channel in the file
+idx(:) = 0
+do i = 1, nchan
+   do j = 1, nchannel
+      if ( sensor_channel(j) == channels(i) ) then
+         idx(i) = j
+         exit
+      end if
+   end do
+end do
+if ( any(idx == 0) ) then
+   if ( nchannel /= nchan ) then
+      iret = -2
+      write(*,*) 'mismatch nchannel ', nchannel, nchan
+      return
+   end if
+   do i = 1, nchan
+      idx(i) = i
+   end do
+end if
+
+planck_c1(:)  = file_planck_c1(idx)
+planck_c2(:)  = file_planck_c2(idx)
+band_c1(:)    = file_band_c1(idx)
+band_c2(:)    = file_band_c2(idx)
+wavenumber(:) = file_wavenumber(idx)
 
 end subroutine read_spc
 
+!--------------------------------------------------------------
+
+subroutine split_messages(filename)
+
+! index the messages of filename and find the contiguous range of
+! messages this rank decodes; without an index, each rank decodes
+! every par_size-th message
+
+   implicit none
+
+   character(len=*), intent(in) :: filename
+   integer(i_kind)              :: iret
+
+   call bufr_index_build(filename, bindex, iret, write_cache=(par_rank == 0))
+   use_index = iret == 0
+   if ( use_index ) then
+      call bufr_index_range(bindex, par_rank, par_size, imsg_first, imsg_last)
+   end if
+
+end subroutine split_messages
+
+!--------------------------------------------------------------
+
+logical function skip_message(filename, imsg, subset)
+
+! whether message imsg of filename, as returned by ireadmg, is left to another rank
+
+   implicit none
+
+   character(len=*), intent(in) :: filename
+   integer(i_kind),  intent(in) :: imsg
+   character(len=*), intent(in) :: subset
+
+   ! every rank reads the same messages and stops trusting the index at the
+   ! same message, so the remaining messages are still decoded exactly once
+   if ( use_index ) then
+      if ( .not. bufr_index_matches(bindex, imsg, subset) ) then
+         write(*,*) 'Warning: message index does not match '//trim(filename)// &
+                    ', splitting the remaining messages round-robin'
+         use_index = .false.
+      end if
+   end if
+
+   if ( use_index ) then
+      skip_message = imsg < imsg_first .or. imsg > imsg_last
+   else
+      skip_message = mod(imsg-1, par_size) /= par_rank
+   end if
+
+end function skip_message
+
 end module radiance_mod
@@ -6,7 +6,10 @@ use define_mod, only: nobtype, set_obtype_conv, obtype_list, xdata, &
    missing_r, missing_i, vflag, itrue, ifalse, nstring, ndatetime,  &
    dtime_min, dtime_max
 use ufo_vars_mod, only: ufo_vars_getindex, var_prs, var_u, var_v
-use utils_mod, only: get_julian_time, da_advance_time, da_get_time_slots
+use utils_mod, only: da_advance_time, get_time_slot
+use netcdf_cxx_mod, only: timeToEpoch, timeWindowSlots, invalid_epoch
+use bufr_index_mod, only: bufr_index_type, bufr_index_build, bufr_index_range, bufr_index_matches
+use qc_rules_mod, only: qc_evaluate, nqc_check, qc_prs, qc_qi, qc_satzen, qc_experr, qc_cvwd, qc_prs_land
 use netcdf, only: nf90_int, nf90_float, nf90_char, nf90_int64
 
 implicit none
@@ -18,15 +21,14 @@ public  :: sort_obs_satwnd
 type datalink_satwnd
    character(len=nstring)    :: msg_type   ! BUFR message type name
    character(len=nstring)    :: stid       ! station identifier
-   character(len=ndatetime)  :: datetime   ! ccyy-mm-ddThh:mm:ssZ
    character(len=nstring)    :: obtype     ! ob type, eg satwnd
    integer(i_kind)           :: satid      ! satellite identifier
    integer(i_kind)           :: rptype     ! prepbufr report type
    integer(i_kind)           :: obtype_idx ! index of obtype in obtype_list
    integer(i_kind)           :: ifgat
    integer(i_kind)           :: qm         ! quality marker
-   real(r_double)            :: gstime
-   integer(i_llong)          :: epochtime
+   integer(i_kind)           :: idate(6)   ! year, month, day, hour, minute and second
+   integer(i_llong)          :: epochtime  ! converted from idate by sort_obs_satwnd
    real(r_kind)              :: err        ! ob error
    real(r_kind)              :: lat        ! latitude in degree
    real(r_kind)              :: lon        ! longitude in degree
@@ -99,6 +101,9 @@ subroutine read_satwnd(filename, filedate)
    integer(i_kind) :: idate
    integer(i_kind) :: num_report_infile
    integer(i_kind) :: ireadmg, ireadsb
+   integer(i_kind) :: imsg, imsg_first, imsg_last
+   type(bufr_index_type) :: bindex
+   logical         :: use_index
 
    integer(i_kind) :: iyear, imonth, iday, ihour, imin, isec
 
@@ -189,8 +194,27 @@ subroutine read_satwnd(filename, filedate)
       nullify ( rlink%next )
    end if
 
+   ! most messages of a satwnd file are AMV types that are included in prepbufr;
+   ! the message index tells where the last wanted message is, so that reading
+   ! stops there (or right away if the file has none)
+   call bufr_index_build(filename, bindex, iret)
+   use_index = iret == 0
+   if ( use_index ) then
+      call bufr_index_range(bindex, 0, 1, imsg_first, imsg_last, wanted=message_types)
+   end if
+
+   imsg = 0
    msg_loop: do while (ireadmg(iunit,subset,idate)==0)
 !print*,subset
+      imsg = imsg + 1
+      if ( use_index ) then
+         use_index = bufr_index_matches(bindex, imsg, subset)
+         if ( .not. use_index ) then
+            write(*,*) 'Warning: message index does not match '//trim(filename)
+         else if ( imsg > imsg_last ) then
+            exit msg_loop
+         end if
+      end if
       if ( ufo_vars_getindex(message_types, subset) <= 0 ) then
          ! skip types other than GOES-16/17, AVHRR (METOP/NOAA), VIIRS (NPP/NOAA-20) AMVs
          ! that are included in prepbufr
@@ -216,9 +240,7 @@ subroutine read_satwnd(filename, filedate)
               ihour  >=   0 .and. ihour  <   24 .and. &
               imin   >=   0 .and. imin   <   60 .and. &
               isec   >=   0 .and. isec   <   60 ) then
-            write(unit=rlink%datetime, fmt='(i4,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a,i2.2,a)')  &
-               iyear, '-', imonth, '-', iday, 'T', ihour, ':', imin, ':', isec, 'Z'
-            call get_julian_time(iyear, imonth, iday, ihour, imin, isec, rlink%gstime, rlink%epochtime)
+            rlink%idate = [iyear, imonth, iday, ihour, imin, isec]
          else
             cycle subset_loop
          end if
@@ -279,7 +301,7 @@ subroutine read_satwnd(filename, filedate)
          end if
 
 !write(333,*) subset, rlink%satid, rlink%stid
-!write(333,*) rlink%datetime,'/', rlink % lat, '/',rlink % lon,'/', rlink % prs,'/',rlink % wdir,'/',rlink % wspd
+!write(333,*) rlink%epochtime,'/', rlink % lat, '/',rlink % lon,'/', rlink % prs,'/',rlink % wdir,'/',rlink % wspd
 !write(333,*) rlink % cvwd,'/',rlink % pccf1 ,'/',rlink % pccf2
          allocate ( rlink%next )
          rlink => rlink%next
@@ -299,63 +321,64 @@ end subroutine read_satwnd
 subroutine filter_obs_satwnd
 
 ! refer to GSI/read_satwnd.f90
+!
+! the AMV checks are the 'amv' rules of qc_rules_mod, evaluated as one vector
+! pass over the columns of all AMVs: rejected AMVs get quality marker 15,
+! the others 2 (neutral or not checked).
 
    implicit none
 
-   real(r_kind) :: experr_norm
-   logical :: EC_AMV_QC = .true.
-   integer(i_kind) :: iland = 0
+   integer(i_kind), parameter   :: iland = 0
+   integer(i_kind)              :: n, i
+   integer(i_kind), allocatable :: rptype(:), satid(:)
+   real(r_kind),    allocatable :: cols(:,:)
+   logical,         allocatable :: used(:)
+   real(r_kind)                 :: experr_norm
 
+   n = 0
    rlink => rhead
    do while ( associated(rlink) )
+      n = n + 1
+      rlink => rlink%next
+   end do
+   if ( n == 0 ) return
 
-      rlink%qm = 2  ! neutral or not checked
-
-      if ( rlink%satzen > 68.0_r_kind ) rlink%qm = 15
+   allocate (rptype(n), satid(n), cols(n,nqc_check), used(n))
+   cols(:,:) = missing_r
 
-      if ( rlink%rptype == 260 ) then
-         if ( rlink%pccf1 < 85.0_r_kind ) rlink%qm = 15
+   i = 0
+   rlink => rhead
+   do while ( associated(rlink) )
+      i = i + 1
+      rptype(i) = rlink%rptype
+      satid(i)  = rlink%satid
+      cols(i,qc_prs)    = rlink%prs
+      cols(i,qc_qi)     = rlink%pccf1
+      cols(i,qc_satzen) = rlink%satzen
+      cols(i,qc_cvwd)   = rlink%cvwd
+      if ( nint(rlink%landsea) == iland ) cols(i,qc_prs_land) = rlink%prs
+      experr_norm = 10.0_r_kind - 0.1_r_kind * rlink%pccf2
+      if ( rlink%wspd > 0.1_r_kind ) then
+         experr_norm = experr_norm / rlink%wspd
+      else
+         experr_norm = 100.0_r_kind
       end if
+      cols(i,qc_experr) = experr_norm
+      rlink => rlink%next
+   end do
 
-      if ( rlink%rptype == 240 .or. &
-           rlink%rptype == 245 .or. &
-           rlink%rptype == 246 .or. &
-           rlink%rptype == 247 .or. &
-           rlink%rptype == 251 ) then
-
-         if ( rlink%pccf1 < 80.0_r_kind .or. rlink%pccf1 > 100.0_r_kind ) rlink%qm = 15 ! reject data with low QI
-
-         if ( rlink%prs < 12500.0_r_kind ) rlink%qm = 15 ! reject data above 125hPa
-
-         experr_norm = 10.0_r_kind - 0.1_r_kind * rlink%pccf2
-         if ( rlink%wspd > 0.1_r_kind ) then
-            experr_norm = experr_norm / rlink%wspd
-         else
-            experr_norm = 100.0_r_kind
-         end if
-         if ( experr_norm > 0.9_r_kind ) rlink%qm = 15 ! reject data with estimated error/spd>0.9
-
-         if ( rlink%rptype == 240 .or. &
-              rlink%rptype == 245 .or. &
-              rlink%rptype == 246 .or. &
-              rlink%rptype == 251 ) then
-            if ( rlink%cvwd < 0.04_r_kind ) rlink%qm = 15
-            if ( rlink%cvwd > 0.50_r_kind ) rlink%qm = 15
-         end if
-
-         if ( EC_AMV_QC ) then
-            if ( rlink%pccf1 < 90_r_kind .or. rlink%pccf1 > 100.0_r_kind ) rlink%qm = 15 ! stricter QI
-            if ( rlink%prs < 15000.0_r_kind) rlink%qm = 15 ! all high level
-            if ( rlink%rptype == 251 .and. rlink%prs < 70000.0_r_kind ) rlink%qm = 15  ! VIS
-            if ( rlink%rptype == 246 .and. rlink%prs > 30000.0_r_kind ) rlink%qm = 15  ! WVCA
-            if ( nint(rlink%landsea) == iland .and. rlink%prs > 85000.0_r_kind) rlink%qm = 15  ! low over land
-         end if
-      end if  ! rptype 240, 245, 246, 247, 251
+   call qc_evaluate('amv', n, rptype, satid, cols, .true., used)
 
+   i = 0
+   rlink => rhead
+   do while ( associated(rlink) )
+      i = i + 1
+      rlink%qm = merge(2, 15, used(i))
       rlink => rlink%next
-
    end do
 
+   deallocate (rptype, satid, cols, used)
+
 end subroutine filter_obs_satwnd
 
 !--------------------------------------------------------------
@@ -375,32 +398,58 @@ subroutine sort_obs_satwnd(filedate, nfgat)
    character(len=12)                     :: obtype
    logical,         dimension(nvar_met)  :: vmask ! for counting available variables for one obtype
    character(len=14) :: cdate_min, cdate_max
-   real(r_double) :: time_slots(0:nfgat)
+   integer(i_llong) :: time_slots(0:nfgat)
+   integer(i_kind)                       :: nrep, ninvalid
+   integer(i_kind),  allocatable         :: idate(:,:)
+   integer(i_llong), allocatable         :: epochtime(:)
 
    call da_advance_time(filedate, dtime_min, cdate_min)
    call da_advance_time(filedate, dtime_max, cdate_max)
-   call da_get_time_slots(nfgat, cdate_min, cdate_max, time_slots)
+   if ( timeWindowSlots(cdate_min, cdate_max, nfgat, time_slots) /= 0 ) then
+      write(*,*) 'Error: invalid time window ', cdate_min, ' to ', cdate_max
+      stop 1
+   end if
 
    nlocs(:,:) = 0
    nvars(:) = 0
 
    write(*,*) '--- sorting satwnd obs...'
 
+   ! convert the times of all reports in one call
+   nrep = 0
+   rlink => rhead
+   do while ( associated(rlink) )
+      nrep = nrep + 1
+      rlink => rlink%next
+   end do
+   allocate (idate(nrep,6))
+   allocate (epochtime(nrep))
+   irec = 0
+   rlink => rhead
+   do while ( associated(rlink) )
+      irec = irec + 1
+      idate(irec,:) = rlink%idate
+      rlink => rlink%next
+   end do
+   ninvalid = timeToEpoch(idate(:,1), idate(:,2), idate(:,3), idate(:,4), idate(:,5), idate(:,6), epochtime)
+   if ( ninvalid < 0 ) then
+      write(*,*) 'Error: converting the times of satwnd obs'
+      stop 1
+   end if
+
    ! count the numbers
+   irec = 0
    rlink => rhead
    set_obtype_loop: do while ( associated(rlink) )
+      irec = irec + 1
+      rlink%epochtime = epochtime(irec)
 
       ! determine time_slot index
-      do i = 1, nfgat
-         if ( rlink%gstime >= time_slots(i-1) .and.  &
-              rlink%gstime <= time_slots(i) ) then
-             exit
-         end if
-      end do
-      rlink%ifgat = i
+      rlink%ifgat = get_time_slot(rlink%epochtime, time_slots)
 
-      ! find index of obtype in obtype_list
+      ! find index of obtype in obtype_list; reports with invalid times are not sorted
       rlink%obtype_idx = ufo_vars_getindex(obtype_list, rlink%obtype)
+      if ( rlink%epochtime == invalid_epoch ) rlink%obtype_idx = -1
       if ( rlink % obtype_idx > 0 ) then
          ! obtype assigned, advance ob counts
          nlocs(rlink%obtype_idx,rlink%ifgat) = nlocs(rlink%obtype_idx,rlink%ifgat) + 1
@@ -408,6 +457,8 @@ subroutine sort_obs_satwnd(filedate, nfgat)
 
       rlink => rlink%next
    end do set_obtype_loop
+   deallocate (idate)
+   deallocate (epochtime)
 
    do ii = 1, nfgat
       if ( nfgat > 1 ) then
@@ -488,9 +539,7 @@ subroutine sort_obs_satwnd(filedate, nfgat)
                   xdata(ityp,itim)%xinfo_float(iloc(ityp,itim),i) = rlink%prs
                end if
             else if ( type_var_info(i) == nf90_char ) then
-               if ( trim(name_var_info(i)) == 'datetime' ) then
-                  xdata(ityp,itim)%xinfo_char(iloc(ityp,itim),i) = rlink%datetime
-               else if ( trim(name_var_info(i)) == 'station_id' ) then
+               if ( trim(name_var_info(i)) == 'station_id' ) then
                   xdata(ityp,itim)%xinfo_char(iloc(ityp,itim),i) = rlink%stid
                end if
             else if ( type_var_info(i) == nf90_int64 ) then
@@ -540,7 +589,6 @@ subroutine fill_datalink (datalink, rfill, ifill)
 
    integer(i_kind) :: i
 
-   !datalink % datetime = ''
    datalink % lat      = rfill
    datalink % lon      = rfill
    datalink % satid    = ifill
@@ -0,0 +1,379 @@
+module thinning_mod
+
+! Thinning of the sorted observations before they are written out.
+!
+! Locations are binned into boxes of a lat/lon mesh of roughly equal area,
+! optionally split further by pressure and by time, and only the best
+! location of every box is kept. Boxes are looked up in a hash table, so
+! thinning takes linear time in the number of locations.
+!
+! The obtypes/instruments to thin are configured in a namelist file:
+!
+!    &thinning
+!       thin_types = 'satwnd', 'amsua_n15', 'iasi_metop-b'
+!       mesh_km    = 145.0
+!       mesh_hpa   = 100.0, 0.0, 0.0
+!       mesh_min   = 0.0
+!       criterion  = 'qc', 'centre', 'centre'
+!    /
+!
+! thin_types are names of obtype_list, inst_list or geoinst_list. mesh_hpa
+! and mesh_min of 0 disable the pressure and time bins. criterion selects the
+! location kept in a box: 'centre' (closest to the box centre), 'time'
+! (closest to the centre of the time bin, or of the data window without time
+! bins) or 'qc' (best quality marker, then closest to the centre). Entries not
+! set for a type are taken from the first type.
+
+use kinds, only: i_kind, i_llong, r_kind
+use define_mod, only: nstring, missing_r, missing_i, nobtype, ninst, ninst_geo, &
+   obtype_list, inst_list, geoinst_list, xdata, xdata_type, name_var_info, &
+   write_nc_conv, write_nc_radiance, write_nc_radiance_geo
+use ufo_vars_mod, only: ufo_vars_getindex
+
+implicit none
+private
+public :: read_thinning_namelist
+public :: thin_obs
+public :: thin_select
+public :: thin_centre, thin_time, thin_qc
+
+! selection criteria of the location kept in a box
+integer(i_kind), parameter :: thin_centre = 1
+integer(i_kind), parameter :: thin_time   = 2
+integer(i_kind), parameter :: thin_qc     = 3
+
+integer(i_kind), parameter :: max_thin_types = 50
+real(r_kind),    parameter :: km_per_deg     = 111.19492_r_kind
+real(r_kind),    parameter :: deg2rad        = 0.017453293_r_kind
+! quality marker of locations without a valid one, ranked after all valid ones
+integer(i_kind), parameter :: qm_none        = 999
+
+type thin_config_type
+   character(len=nstring) :: name
+   real(r_kind)           :: mesh_km
+   real(r_kind)           :: mesh_hpa
+   real(r_kind)           :: mesh_min
+   integer(i_kind)        :: criterion
+end type thin_config_type
+
+integer(i_kind)                                    :: nthin = 0
+type(thin_config_type), dimension(max_thin_types) :: thin_config
+
+contains
+
+!--------------------------------------------------------------
+
+subroutine read_thinning_namelist(fname)
+
+   implicit none
+
+   character(len=*), intent(in) :: fname
+
+   character(len=nstring), dimension(max_thin_types) :: thin_types
+   real(r_kind),           dimension(max_thin_types) :: mesh_km, mesh_hpa, mesh_min
+   character(len=8),       dimension(max_thin_types) :: criterion
+   integer(i_kind) :: iunit, iost, i
+
+   namelist /thinning/ thin_types, mesh_km, mesh_hpa, mesh_min, criterion
+
+   thin_types(:) = ''
+   mesh_km(:)    = -1.0
+   mesh_hpa(:)   = -1.0
+   mesh_min(:)   = -1.0
+   criterion(:)  = ''
+
+   open(newunit=iunit, file=trim(fname), status='old', form='formatted', iostat=iost)
+   if ( iost /= 0 ) then
+      write(*,*) 'Error: unable to open thinning namelist ', trim(fname)
+      stop 1
+   end if
+   read(unit=iunit, nml=thinning, iostat=iost)
+   close(iunit)
+   if ( iost /= 0 ) then
+      write(*,*) 'Error reading namelist thinning from ', trim(fname)
+      stop 1
+   end if
+
+   if ( mesh_hpa(1) < 0.0 ) mesh_hpa(1) = 0.0
+   if ( mesh_min(1) < 0.0 ) mesh_min(1) = 0.0
+   if ( len_trim(criterion(1)) == 0 ) criterion(1) = 'centre'
+
+   nthin = 0
+   do i = 1, max_thin_types
+      if ( len_trim(thin_types(i)) == 0 ) cycle
+      nthin = nthin + 1
+      thin_config(nthin)%name     = thin_types(i)
+      thin_config(nthin)%mesh_km  = merge(mesh_km(i),  mesh_km(1),  mesh_km(i)  >= 0.0)
+      thin_config(nthin)%mesh_hpa = merge(mesh_hpa(i), mesh_hpa(1), mesh_hpa(i) >= 0.0)
+      thin_config(nthin)%mesh_min = merge(mesh_min(i), mesh_min(1), mesh_min(i) >= 0.0)
+      if ( len_trim(criterion(i)) == 0 ) criterion(i) = criterion(1)
+      select case ( trim(criterion(i)) )
+      case ( 'centre', 'center' )
+         thin_config(nthin)%criterion = thin_centre
+      case ( 'time' )
+         thin_config(nthin)%criterion = thin_time
+      case ( 'qc' )
+         thin_config(nthin)%criterion = thin_qc
+      case default
+         write(*,*) 'Error: unknown thinning criterion ', trim(criterion(i))
+         stop 1
+      end select
+      if ( thin_config(nthin)%mesh_km <= 0.0 ) then
+         write(*,*) 'Error: mesh_km not set for thinning ', trim(thin_types(i))
+         stop 1
+      end if
+   end do
+
+end subroutine read_thinning_namelist
+
+!--------------------------------------------------------------
+
+subroutine thin_obs(write_opt, itim)
+
+! thin the observations of one time window of all configured types in xdata
+
+   implicit none
+
+   integer(i_kind), intent(in) :: write_opt
+   integer(i_kind), intent(in) :: itim
+
+   integer(i_kind) :: ntype, ityp, ic, i, n
+   integer(i_kind) :: ilat, ilon, iprs, itime
+   character(len=nstring)        :: name
+   real(r_kind),     allocatable :: lat(:), lon(:), prs(:)
+   integer(i_llong), allocatable :: tim(:)
+   integer(i_kind),  allocatable :: qm(:)
+   logical,          allocatable :: keep(:)
+
+   if ( nthin == 0 ) return
+   if ( .not. allocated(xdata) ) return
+
+   if ( write_opt == write_nc_conv ) then
+      ntype = nobtype
+   else if ( write_opt == write_nc_radiance ) then
+      ntype = ninst
+   else if ( write_opt == write_nc_radiance_geo ) then
+      ntype = ninst_geo
+   else
+      return
+   end if
+
+   ilat  = ufo_vars_getindex(name_var_info, 'latitude')
+   ilon  = ufo_vars_getindex(name_var_info, 'longitude')
+   iprs  = ufo_vars_getindex(name_var_info, 'air_pressure')
+   itime = ufo_vars_getindex(name_var_info, 'dateTime')
+
+   type_loop: do ityp = 1, ntype
+
+      if ( write_opt == write_nc_conv ) then
+         name = obtype_list(ityp)
+      else if ( write_opt == write_nc_radiance ) then
+         name = inst_list(ityp)
+      else
+         name = geoinst_list(ityp)
+      end if
+      ic = 0
+      do i = 1, nthin
+         if ( thin_config(i)%name == name ) ic = i
+      end do
+      if ( ic == 0 ) cycle type_loop
+
+      n = xdata(ityp,itim)%nlocs
+      if ( n == 0 ) cycle type_loop
+
+      allocate (lat(n), lon(n), prs(n), tim(n), qm(n), keep(n))
+      lat(:) = xdata(ityp,itim)%xinfo_float(:,ilat)
+      lon(:) = xdata(ityp,itim)%xinfo_float(:,ilon)
+      prs(:) = xdata(ityp,itim)%xinfo_float(:,iprs)
+      tim(:) = xdata(ityp,itim)%xinfo_int64(:,itime)
+      qm(:)  = qm_none
+      if ( allocated(xdata(ityp,itim)%xfield) ) then
+         do i = 1, n
+            qm(i) = minval(xdata(ityp,itim)%xfield(i,:)%qm, &
+                           mask=xdata(ityp,itim)%xfield(i,:)%qm >= 0)
+            qm(i) = min(qm(i), qm_none)
+         end do
+      end if
+
+      call thin_select(n, lat, lon, prs, tim, qm, thin_config(ic)%mesh_km, &
+         thin_config(ic)%mesh_hpa, thin_config(ic)%mesh_min, thin_config(ic)%criterion, keep)
+
+      write(*,'(1x,a,a20,i10,a,i10)') 'thinning ', name, n, ' ->', count(keep)
+      call compact_obs(xdata(ityp,itim), keep)
+
+      deallocate (lat, lon, prs, tim, qm, keep)
+
+   end do type_loop
+
+end subroutine thin_obs
+
+!--------------------------------------------------------------
+
+subroutine thin_select(n, lat, lon, prs, tim, qm, mesh_km, mesh_hpa, mesh_min, criterion, keep)
+
+! select the best location of every box
+!
+! lat/lon in degrees, prs in Pa, tim in seconds, qm quality markers (lower
+! is better). Locations with missing lat/lon are always kept; locations with
+! missing pressure share one pressure bin.
+
+   implicit none
+
+   integer(i_kind),                 intent(in)  :: n
+   real(r_kind),     dimension(n),  intent(in)  :: lat, lon, prs
+   integer(i_llong), dimension(n),  intent(in)  :: tim
+   integer(i_kind),  dimension(n),  intent(in)  :: qm
+   real(r_kind),                    intent(in)  :: mesh_km   ! horizontal box size
+   real(r_kind),                    intent(in)  :: mesh_hpa  ! pressure bin, 0 for none
+   real(r_kind),                    intent(in)  :: mesh_min  ! time bin in minutes, 0 for none
+   integer(i_kind),                 intent(in)  :: criterion
+   logical,          dimension(n),  intent(out) :: keep
+
+   integer(i_kind)                 :: nlat, j, i
+   integer(i_kind),  allocatable   :: nlon(:)
+   integer(i_llong), allocatable   :: band_start(:)
+   integer(i_llong)                :: nbox, nlev, tmin, tmax, tsize, h
+   integer(i_llong), allocatable   :: key(:), ilev(:), itbin(:), table_key(:)
+   integer(i_kind),  allocatable   :: table_loc(:)
+   real(r_kind),     allocatable   :: score(:)
+   real(r_kind)                    :: dlat, dp, dt, tcentre
+
+   keep(:) = .false.
+   if ( n == 0 ) return
+
+   ! latitude bands of equal width, each split into boxes of about mesh_km
+   nlat = max(1, ceiling(180.0_r_kind * km_per_deg / mesh_km))
+   dlat = 180.0_r_kind / nlat
+   allocate (nlon(nlat), band_start(nlat))
+   nbox = 0
+   do j = 1, nlat
+      nlon(j) = max(1, nint(360.0_r_kind * cos((-90.0_r_kind + (j - 0.5_r_kind) * dlat) * deg2rad) / dlat))
+      band_start(j) = nbox
+      nbox = nbox + nlon(j)
+   end do
+
+   dp = mesh_hpa * 100.0_r_kind
+   dt = mesh_min * 60.0_r_kind
+   tmin = minval(tim)
+   tmax = maxval(tim)
+   tcentre = 0.5_r_kind * real(tmax - tmin, r_kind)
+
+   ! pressure and time bins; bin 0 holds missing pressures
+   allocate (ilev(n), itbin(n))
+   ilev(:) = 0
+   if ( dp > 0.0 ) then
+      where ( prs /= missing_r .and. prs >= 0.0 ) ilev = int(prs / dp, i_llong) + 1
+   end if
+   itbin(:) = 0
+   if ( dt > 0.0 ) itbin(:) = int(real(tim - tmin, r_kind) / dt, i_llong)
+   nlev = maxval(ilev) + 1
+
+   allocate (key(n), score(n))
+   do concurrent (i = 1:n)
+      block
+         integer(i_kind) :: jlat, jlon
+         real(r_kind)    :: lon360, dlon, dx, dy, dz, dtime, dist2
+         if ( lat(i) == missing_r .or. lon(i) == missing_r ) then
+            key(i) = -1
+            score(i) = 0.0
+         else
+            jlat = min(nlat, max(1, int((lat(i) + 90.0_r_kind) / dlat) + 1))
+            lon360 = modulo(lon(i), 360.0_r_kind)
+            dlon = 360.0_r_kind / nlon(jlat)
+            jlon = min(nlon(jlat) - 1, int(lon360 / dlon))
+            key(i) = band_start(jlat) + jlon + nbox * (ilev(i) + nlev * itbin(i))
+
+            ! offsets from the box centre in units of the box size
+            dy = (lat(i) + 90.0_r_kind) / dlat - (jlat - 0.5_r_kind)
+            dx = lon360 / dlon - (jlon + 0.5_r_kind)
+            dz = 0.0
+            if ( ilev(i) > 0 ) dz = prs(i) / dp - (ilev(i) - 0.5_r_kind)
+            dtime = 0.0
+            if ( dt > 0.0 ) dtime = real(tim(i) - tmin, r_kind) / dt - (itbin(i) + 0.5_r_kind)
+            dist2 = dx * dx + dy * dy + dz * dz + dtime * dtime
+
+            select case ( criterion )
+            case ( thin_time )
+               if ( dt > 0.0 ) then
+                  score(i) = abs(dtime)
+               else
+                  score(i) = abs(real(tim(i) - tmin, r_kind) - tcentre)
+               end if
+            case ( thin_qc )
+               ! dist2 / 4 < 1, so the quality marker always decides first
+               score(i) = real(qm(i), r_kind) + 0.25_r_kind * dist2
+            case default
+               score(i) = dist2
+            end select
+         end if
+      end block
+   end do
+
+   ! single pass over the locations: the hash table maps each box to its best location so far
+   tsize = 2
+   do while ( tsize < 2 * int(n, i_llong) )
+      tsize = 2 * tsize
+   end do
+   allocate (table_key(0:tsize-1), table_loc(0:tsize-1))
+   table_key(:) = -1
+
+   do i = 1, n
+      if ( key(i) < 0 ) then
+         keep(i) = .true.
+         cycle
+      end if
+      h = iand(ieor(key(i), ishft(key(i), -16)), tsize - 1)
+      do
+         if ( table_key(h) < 0 ) then
+            table_key(h) = key(i)
+            table_loc(h) = i
+            exit
+         else if ( table_key(h) == key(i) ) then
+            if ( score(i) < score(table_loc(h)) ) table_loc(h) = i
+            exit
+         end if
+         h = iand(h + 1, tsize - 1)
+      end do
+   end do
+
+   do h = 0, tsize - 1
+      if ( table_key(h) >= 0 ) keep(table_loc(h)) = .true.
+   end do
+
+   deallocate (nlon, band_start, ilev, itbin, key, score, table_key, table_loc)
+
+end subroutine thin_select
+
+!--------------------------------------------------------------
+
+subroutine compact_obs(obs, keep)
+
+! drop the locations that are not kept from all location-dimensioned arrays
+
+   implicit none
+
+   type(xdata_type),      intent(inout) :: obs
+   logical, dimension(:), intent(in)    :: keep
+
+   integer(i_kind), allocatable :: idx(:)
+   integer(i_kind)              :: i, n
+
+   n = obs%nlocs
+   idx = pack([(i, i = 1, n)], keep)
+
+   if ( allocated(obs%xinfo_float) )    obs%xinfo_float    = obs%xinfo_float(idx,:)
+   if ( allocated(obs%xinfo_int) )      obs%xinfo_int      = obs%xinfo_int(idx,:)
+   if ( allocated(obs%xinfo_int64) )    obs%xinfo_int64    = obs%xinfo_int64(idx,:)
+   if ( allocated(obs%xinfo_char) )     obs%xinfo_char     = obs%xinfo_char(idx,:)
+   if ( allocated(obs%xseninfo_float) ) obs%xseninfo_float = obs%xseninfo_float(idx,:)
+   if ( allocated(obs%xfield) )         obs%xfield         = obs%xfield(idx,:)
+   if ( allocated(obs%xseninfo_char) ) then
+      if ( size(obs%xseninfo_char, 1) == n ) obs%xseninfo_char = obs%xseninfo_char(idx,:)
+   end if
+
+   obs%nlocs = size(idx)
+   obs%nrecs = min(obs%nrecs, obs%nlocs)
+
+end subroutine compact_obs
+
+end module thinning_mod
@@ -3,13 +3,34 @@ module utils_mod
 ! adapated from WRFDA/var/da/da_tools/da_advance_time.inc
 
 use kinds, only: r_kind,i_kind,r_double, i_llong
+use iso_c_binding, only: c_int
 
 implicit none
 private
 public :: da_advance_time
 public :: get_julian_time
-public :: da_get_time_slots
+public :: get_time_slot
 public :: to_lower
+public :: fork_process
+public :: wait_process
+public :: conversion_jobs
+
+interface
+   ! POSIX process control from the C library, used to run independent
+   ! conversion pipelines concurrently (pid_t is a C int on supported platforms).
+   function c_fork() bind(C, name="fork")
+      import :: c_int
+      integer(c_int) :: c_fork
+   end function c_fork
+
+   function c_waitpid(pid, wstatus, options) bind(C, name="waitpid")
+      import :: c_int
+      integer(c_int), value, intent(in) :: pid
+      integer(c_int), intent(out) :: wstatus
+      integer(c_int), value, intent(in) :: options
+      integer(c_int) :: c_waitpid
+   end function c_waitpid
+end interface
 
 contains
 subroutine da_advance_time (date_in, dtime, date_out)
@@ -304,40 +325,28 @@ subroutine get_julian_time(year,month,day,hour,minute,second,gstime,epoch)
 
 end subroutine get_julian_time
 
-subroutine da_get_time_slots(nt,tmin,tmax,time_slots)
+function get_time_slot(epochtime, time_slots) result(islot)
 
-! adapted from WRFDA/var/da/da_tools/da_get_time_slots.inc
+! time slot of an observation time, with the boundaries of timeWindowSlots in netcdf_cxx_mod;
+! as with the minutes of get_julian_time, the seconds are not used
 
    implicit none
 
-   integer,           intent (in)      :: nt    ! number of time slots
-   character(len=14), intent (in)      :: tmin  ! begin of time window
-   character(len=14), intent (in)      :: tmax  ! end of time window
-   real(r_double),    intent (out)     :: time_slots(0:nt)
-
-   integer   :: min_yyyy,min_mm,min_dd,min_hh,min_mn,min_ss
-   integer   :: max_yyyy,max_mm,max_dd,max_hh,max_mn,max_ss
-   real      :: dt
-   integer   :: it
-
-   read(unit=tmin,fmt='(i4,5i2)') min_yyyy, min_mm, min_dd, min_hh, min_mn, min_ss
-   read(unit=tmax,fmt='(i4,5i2)') max_yyyy, max_mm, max_dd, max_hh, max_mn, max_ss
-
-   call get_julian_time(min_yyyy,min_mm,min_dd,min_hh,min_mn,min_ss,time_slots(0))
-   call get_julian_time(max_yyyy,max_mm,max_dd,max_hh,max_mn,max_ss,time_slots(nt))
-
-   ! dt/2 between time_slots 0 and 1
-   ! dt/2 between time_slots nt-1 and nt
-   ! dt   between time_slots 1 and 2, 2 and 3, ..., nt-2 and nt-1
-   if (nt > 1) then
-      dt = (time_slots(nt)-time_slots(0))/float(nt-1)
-      time_slots(1)  = time_slots(0)+dt*0.5
-      do it=2,nt-1
-         time_slots(it) = time_slots(it-1)+dt
-      end do
-   end if
+   integer(i_llong), intent(in) :: epochtime        ! seconds since 1970-01-01T00:00:00Z
+   integer(i_llong), intent(in) :: time_slots(0:)   ! boundaries of the time slots
+   integer(i_kind)              :: islot            ! first slot containing the time, or ubound(time_slots)+1
+
+   integer(i_llong) :: obs_time
+
+   obs_time = epochtime - modulo(epochtime, 60_i_llong)
+   do islot = 1, ubound(time_slots, 1)
+      if ( obs_time >= time_slots(islot-1) .and. &
+           obs_time <= time_slots(islot) ) then
+         exit
+      end if
+   end do
 
-end subroutine da_get_time_slots
+end function get_time_slot
 
    ! @brief Converts a string to lowercase.
    !
@@ -369,4 +378,71 @@ end subroutine da_get_time_slots
       end do
    end function to_lower
 
+   ! @brief Forks the current process.
+   !
+   ! Pending output on the standard units is flushed first so that it is not
+   ! written a second time by the child.
+   !
+   ! @return The process ID of the child in the parent, 0 in the child, and a
+   !         negative value if the process could not be forked.
+   !
+   function fork_process() result(pid)
+      use iso_fortran_env, only: output_unit, error_unit
+      integer(i_kind) :: pid
+
+      flush(output_unit)
+      flush(error_unit)
+      pid = c_fork()
+   end function fork_process
+
+   ! @brief Waits for a child process to terminate.
+   !
+   ! @param pid The process ID to wait for, or -1 to wait for any child.
+   ! @param exit_status The exit code of the child, or -1 if it was
+   !                    terminated by a signal.
+   !
+   ! @return The process ID of the terminated child, or a negative value if
+   !         there is no child left to wait for.
+   !
+   function wait_process(pid, exit_status) result(child_pid)
+      integer(i_kind), intent(in)  :: pid
+      integer(i_kind), intent(out) :: exit_status
+      integer(i_kind) :: child_pid
+      integer(c_int)  :: wstatus
+
+      wstatus = 0
+      child_pid = c_waitpid(pid, wstatus, 0)
+      ! low 7 bits hold the terminating signal, next 8 bits the exit code
+      if ( ibits(wstatus, 0, 7) == 0 ) then
+         exit_status = ibits(wstatus, 8, 8)
+      else
+         exit_status = -1
+      end if
+   end function wait_process
+
+   ! @brief The number of conversion processes run at a time for -j njobs.
+   !
+   ! The caches of a forked process are lost when it exits, and -batch keeps its
+   ! caches (SpcCoeff tables, output layouts) between cycles in one process, so
+   ! -j does not combine with -batch. Neither does it with several MPI ranks.
+   !
+   ! @param njobs The number of processes requested with -j.
+   ! @param nranks The number of MPI ranks.
+   ! @param batch Whether several cycles are converted with -batch.
+   !
+   ! @return njobs, or 1 if -j does not apply.
+   !
+   pure function conversion_jobs(njobs, nranks, batch) result(njobs_used)
+      integer(i_kind), intent(in) :: njobs
+      integer(i_kind), intent(in) :: nranks
+      logical,         intent(in) :: batch
+      integer(i_kind) :: njobs_used
+
+      if ( nranks > 1 .or. batch ) then
+         njobs_used = 1
+      else
+         njobs_used = max(1, njobs)
+      end if
+   end function conversion_jobs
+
 end module utils_mod
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "channel_selection.h"
+
+/**
+ * @brief Tests parsing and lookup of the channel selection.
+ *
+ * This test ensures:
+ * - Channel numbers and ranges are merged into sorted, unique lists.
+ * - An instrument entry takes precedence over the entry of its sensor.
+ * - Instruments without an entry keep all their channels.
+ */
+TEST(ChannelSelection, Find) {
+    auto &selection = Obs2Ioda::ChannelSelection::getInstance();
+    selection.load(YAML::Load(
+        "channels:\n"
+        "  iasi: [38, 16, \"35-38\", 29]\n"
+        "  iasi_metop-c: [100]\n"
+    ));
+
+    const std::vector<int> iasi = {16, 29, 35, 36, 37, 38};
+    ASSERT_NE(selection.find("iasi_metop-b"), nullptr);
+    EXPECT_EQ(*selection.find("iasi_metop-b"), iasi);
+    EXPECT_EQ(*selection.find("iasi_metop-c"), std::vector<int>{100});
+    EXPECT_EQ(selection.find("cris_n20"), nullptr);
+
+    int channels[4];
+    int nChannels = 0;
+    EXPECT_EQ(Obs2Ioda::channelSelectionGet("iasi_metop-a", channels, 4, &nChannels), 0);
+    EXPECT_EQ(nChannels, 6);
+    EXPECT_EQ(channels[3], 36);
+    EXPECT_EQ(Obs2Ioda::channelSelectionGet("cris_npp", channels, 4, &nChannels), 0);
+    EXPECT_EQ(nChannels, -1);
+
+    selection.clear();
+    EXPECT_EQ(selection.find("iasi_metop-b"), nullptr);
+}
+
+TEST(ChannelSelection, Invalid) {
+    auto &selection = Obs2Ioda::ChannelSelection::getInstance();
+    EXPECT_THROW(selection.load(YAML::Load("channels:\n  iasi: [\"38-16\"]\n")), std::invalid_argument);
+    EXPECT_THROW(selection.load(YAML::Load("channels:\n  iasi: [ch16]\n")), std::invalid_argument);
+    EXPECT_THROW(selection.load(YAML::Load("channels: [16]\n")), std::invalid_argument);
+    // an empty map, as in the shipped share/ChannelSelection.yaml, keeps all channels
+    EXPECT_NO_THROW(selection.load(YAML::Load("channels:\n#  iasi: [16]\n")));
+    EXPECT_EQ(selection.find("iasi_metop-b"), nullptr);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include "directory_watch.h"
+
+/**
+ * @brief Tests the reporting of files arriving in a watched directory.
+ *
+ * This test ensures:
+ * - A file is reported when its writer closes it.
+ * - A file moved into the directory is reported under its new name.
+ * - The wait times out when no file arrives.
+ * - A name that does not fit in the buffer is reported as an error, not truncated.
+ */
+TEST(DirectoryWatch, Arrivals) {
+    const auto dir = std::filesystem::temp_directory_path() / "obs2ioda_directory_watch_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "staging");
+
+    int watchID;
+    ASSERT_EQ(Obs2Ioda::directoryWatchOpen(dir.c_str(), &watchID), 0);
+    char name[64];
+    EXPECT_EQ(Obs2Ioda::directoryWatchNext(watchID, 0, name, sizeof(name)), 1);
+
+    std::ofstream(dir / "band07.nc") << "band 7";
+    ASSERT_EQ(Obs2Ioda::directoryWatchNext(watchID, 1000, name, sizeof(name)), 0);
+    EXPECT_EQ(std::string(name), "band07.nc");
+
+    std::ofstream(dir / "staging" / "part") << "band 8";
+    std::filesystem::rename(dir / "staging" / "part", dir / "band08.nc");
+    ASSERT_EQ(Obs2Ioda::directoryWatchNext(watchID, 1000, name, sizeof(name)), 0);
+    EXPECT_EQ(std::string(name), "band08.nc");
+    EXPECT_EQ(Obs2Ioda::directoryWatchNext(watchID, 10, name, sizeof(name)), 1);
+
+    std::ofstream(dir / "band09.nc") << "band 9";
+    EXPECT_EQ(Obs2Ioda::directoryWatchNext(watchID, 1000, name, 9), 2);
+    std::ofstream(dir / "band10.nc") << "band 10";
+    ASSERT_EQ(Obs2Ioda::directoryWatchNext(watchID, 1000, name, 10), 0);
+    EXPECT_EQ(std::string(name), "band10.nc");
+
+    EXPECT_EQ(Obs2Ioda::directoryWatchClose(watchID), 0);
+    EXPECT_NE(Obs2Ioda::directoryWatchClose(watchID), 0);
+    std::filesystem::remove_all(dir);
+}
+
+/**
+ * @brief Tests the rescan of a watched directory when events are lost.
+ *
+ * More files arrive than the kernel queues events for, so the queue overflows.
+ *
+ * This test ensures:
+ * - Every `.nc` file that arrived is reported exactly once.
+ * - Files present when the watch started, and files other than `.nc`, are not
+ *   reported by the rescan.
+ */
+TEST(DirectoryWatch, Overflow) {
+    int maxQueuedEvents = 0;
+    std::ifstream("/proc/sys/fs/inotify/max_queued_events") >> maxQueuedEvents;
+    if (maxQueuedEvents <= 0 || maxQueuedEvents > 100000) {
+        GTEST_SKIP() << "max_queued_events is " << maxQueuedEvents;
+    }
+    const auto dir = std::filesystem::temp_directory_path() / "obs2ioda_directory_watch_overflow_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "before.nc") << "before";
+
+    int watchID;
+    ASSERT_EQ(Obs2Ioda::directoryWatchOpen(dir.c_str(), &watchID), 0);
+    const int numFiles = maxQueuedEvents + 100;
+    for (int i = 0; i < numFiles; i++) {
+        std::ofstream(dir / ("scan" + std::to_string(i) + ".nc")) << i;
+    }
+    std::ofstream(dir / "scan.txt") << "not a scan";
+
+    std::set<std::string> reported;
+    char name[64];
+    int status;
+    while ((status = Obs2Ioda::directoryWatchNext(watchID, 100, name, sizeof(name))) == 0) {
+        EXPECT_TRUE(reported.insert(name).second) << name << " is reported twice";
+    }
+    EXPECT_EQ(status, 1);
+    EXPECT_EQ(reported.size(), static_cast<size_t>(numFiles));
+    EXPECT_EQ(reported.count("before.nc"), 0u);
+    EXPECT_EQ(reported.count("scan.txt"), 0u);
+
+    EXPECT_EQ(Obs2Ioda::directoryWatchClose(watchID), 0);
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "epoch_time.h"
+
+/**
+ * @brief Tests the conversions between dates and seconds since 1970-01-01T00:00:00Z.
+ *
+ * This test ensures:
+ * - Dates before and after 1970 convert to the same seconds as `get_julian_time`.
+ * - Days beyond the end of a month carry over into the next month.
+ * - Fields out of range, such as February 29 outside of leap years, are invalid.
+ * - Dates `ccyymmddhh[nn[ss]]` are parsed, and other strings and invalid dates
+ *   are rejected.
+ * - Times are formatted as `ccyy-mm-ddThh:mm:ssZ`, also before 1970.
+ */
+TEST(EpochTime, Conversions) {
+    EXPECT_EQ(Obs2Ioda::calendarToEpoch(1970, 1, 1, 0, 0, 0), 0);
+    EXPECT_EQ(Obs2Ioda::calendarToEpoch(2018, 4, 15, 0, 0, 41), 1523750441);
+    EXPECT_EQ(Obs2Ioda::calendarToEpoch(1900, 1, 1, 0, 0, 0), -2208988800LL);
+    EXPECT_EQ(Obs2Ioda::calendarToEpoch(2018, 2, 29, 0, 0, 0), Obs2Ioda::calendarToEpoch(2018, 3, 1, 0, 0, 0));
+
+    EXPECT_EQ(Obs2Ioda::dateToEpoch("2018041500"), 1523750400);
+    EXPECT_EQ(Obs2Ioda::dateToEpoch("201804150001"), 1523750460);
+    EXPECT_EQ(Obs2Ioda::dateToEpoch("20180415000041"), 1523750441);
+    EXPECT_THROW(Obs2Ioda::dateToEpoch("2018-04-15"), std::invalid_argument);
+    EXPECT_THROW(Obs2Ioda::dateToEpoch("20180415"), std::invalid_argument);
+    EXPECT_THROW(Obs2Ioda::dateToEpoch("2018022900"), std::invalid_argument);
+
+    EXPECT_TRUE(Obs2Ioda::validCalendar(2016, 2, 29, 23, 59, 59));
+    EXPECT_TRUE(Obs2Ioda::validCalendar(2000, 2, 29, 0, 0, 0));
+    EXPECT_FALSE(Obs2Ioda::validCalendar(1900, 2, 29, 0, 0, 0));
+    EXPECT_FALSE(Obs2Ioda::validCalendar(2018, 4, 31, 0, 0, 0));
+    EXPECT_FALSE(Obs2Ioda::validCalendar(2018, 13, 1, 0, 0, 0));
+    EXPECT_FALSE(Obs2Ioda::validCalendar(2018, 4, 0, 0, 0, 0));
+    EXPECT_FALSE(Obs2Ioda::validCalendar(2018, 4, 15, 24, 0, 0));
+    EXPECT_FALSE(Obs2Ioda::validCalendar(2018, 4, 15, 0, 60, 0));
+    EXPECT_FALSE(Obs2Ioda::validCalendar(2018, 4, 15, 0, 0, -1));
+
+    EXPECT_EQ(Obs2Ioda::epochToDatetime(1523750441), "2018-04-15T00:00:41Z");
+    EXPECT_EQ(Obs2Ioda::epochToDatetime(0), "1970-01-01T00:00:00Z");
+    EXPECT_EQ(Obs2Ioda::epochToDatetime(-1), "1969-12-31T23:59:59Z");
+    EXPECT_EQ(Obs2Ioda::epochToDatetime(-2208988800LL), "1900-01-01T00:00:00Z");
+    EXPECT_EQ(Obs2Ioda::epochToDatetime(1519862399), "2018-02-28T23:59:59Z");
+    EXPECT_THROW(Obs2Ioda::epochToDatetime(Obs2Ioda::calendarToEpoch(10000, 1, 1, 0, 0, 0)), std::out_of_range);
+}
+
+/**
+ * @brief Tests the time slot boundaries of a window.
+ *
+ * This test ensures:
+ * - A single slot covers the whole window.
+ * - Interior slots are centred on the hours of a 6-hour window split into 7
+ *   slots, and the first and last slot are half as long.
+ * - Fewer than one slot is rejected.
+ */
+TEST(EpochTime, TimeSlots) {
+    const long long begin = Obs2Ioda::dateToEpoch("2018041421");
+    const long long end = Obs2Ioda::dateToEpoch("2018041503");
+    EXPECT_EQ(Obs2Ioda::timeSlots(begin, end, 1), (std::vector<long long>{begin, end}));
+    const auto slots = Obs2Ioda::timeSlots(begin, end, 7);
+    ASSERT_EQ(slots.size(), 8u);
+    EXPECT_EQ(slots.front(), begin);
+    EXPECT_EQ(slots[1], begin + 1800);
+    EXPECT_EQ(slots[4], Obs2Ioda::dateToEpoch("201804150030"));
+    EXPECT_EQ(slots[6], end - 1800);
+    EXPECT_EQ(slots.back(), end);
+    EXPECT_THROW(Obs2Ioda::timeSlots(begin, end, 0), std::invalid_argument);
+}
+
+/**
+ * @brief Tests the C interface used by the Fortran readers and writers.
+ *
+ * This test ensures:
+ * - Batches of dates convert correctly when the date changes within the batch.
+ * - Invalid times receive `invalidEpoch` and are counted, and the others of the
+ *   batch are still converted.
+ * - Window slots and batch formatting match the C++ functions.
+ * - Invalid input returns a non-zero status.
+ */
+TEST(EpochTime, CInterface) {
+    const int year[] = {2018, 2018, 2018, 2017};
+    const int month[] = {4, 4, 4, 12};
+    const int day[] = {15, 15, 16, 31};
+    const int hour[] = {0, 23, 0, 23};
+    const int minute[] = {0, 59, 0, 59};
+    const int second[] = {41, 59, 0, 59};
+    std::vector<long long> epoch(4);
+    ASSERT_EQ(Obs2Ioda::timeCalendarToEpoch(4, year, month, day, hour, minute, second, epoch.data()), 0);
+    EXPECT_EQ(epoch, (std::vector<long long>{1523750441, 1523836799, 1523836800, 1514764799}));
+
+    const int invalidMonth[] = {4, 4, 2, 12};
+    const int invalidDay[] = {15, 31, 29, 31};
+    std::vector<long long> invalidEpochs(4);
+    EXPECT_EQ(Obs2Ioda::timeCalendarToEpoch(4, year, invalidMonth, invalidDay, hour, minute, second,
+                                            invalidEpochs.data()), 2);
+    EXPECT_EQ(invalidEpochs, (std::vector<long long>{1523750441, Obs2Ioda::invalidEpoch, Obs2Ioda::invalidEpoch,
+                                                      1514764799}));
+
+    char datetimes[4 * Obs2Ioda::datetimeLength];
+    ASSERT_EQ(Obs2Ioda::timeEpochToDatetime(4, epoch.data(), datetimes), 0);
+    EXPECT_EQ(std::string(datetimes + 2 * Obs2Ioda::datetimeLength, Obs2Ioda::datetimeLength),
+              "2018-04-16T00:00:00Z");
+    EXPECT_EQ(std::string(datetimes + 3 * Obs2Ioda::datetimeLength, Obs2Ioda::datetimeLength),
+              "2017-12-31T23:59:59Z");
+
+    long long date = 0;
+    ASSERT_EQ(Obs2Ioda::timeDateToEpoch("2018041500", &date), 0);
+    EXPECT_EQ(date, 1523750400);
+    EXPECT_NE(Obs2Ioda::timeDateToEpoch("not a date", &date), 0);
+
+    std::vector<long long> slots(4);
+    ASSERT_EQ(Obs2Ioda::timeWindowSlots(0, 7200, 3, slots.data()), 0);
+    EXPECT_EQ(slots, (std::vector<long long>{0, 1800, 5400, 7200}));
+    EXPECT_NE(Obs2Ioda::timeWindowSlots(0, 7200, 0, slots.data()), 0);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "geometry.h"
+
+namespace {
+    /// GOES-16 ABI fixed grid, as in the example of the GOES-R PUG Vol. 3, 4.2.8.1.
+    const Obs2Ioda::GeosProjection goesEast{-75.0, 42164160.0, 6378137.0, 6356752.31414, 1};
+
+    /// Himawari-8 AHI fixed grid of the Himawari Standard Data, in km.
+    const Obs2Ioda::GeosProjection himawari{140.7, 42164.0, 6378.137, 6356.7523, 0};
+}
+
+/**
+ * @brief Tests the latitude and longitude of the pixels of a fixed grid.
+ *
+ * This test ensures:
+ * - Sweep x reproduces the example of the GOES-R PUG.
+ * - Sweep y puts the sub-satellite point at the centre, positive x to the east
+ *   and positive y to the south, as the CGMS scan angles.
+ * - Pixels off the earth are invalid and missing.
+ */
+TEST(Geometry, FixedGridToLatLon) {
+    const double x[] = {-0.024052, 0.2};
+    const double y[] = {0.095340, 0.0};
+    float lat[4];
+    float lon[4];
+    int valid[4];
+    ASSERT_EQ(Obs2Ioda::geoFixedGridToLatLon(&goesEast, 2, 2, x, y, lat, lon, valid), 0);
+    EXPECT_NEAR(lat[0], 33.846162, 1e-4);
+    EXPECT_NEAR(lon[0], -84.690932, 1e-4);
+    EXPECT_EQ(valid[0], 1);
+    EXPECT_EQ(valid[1], 0);
+    EXPECT_EQ(lat[1], Obs2Ioda::geometryMissing);
+    EXPECT_EQ(lon[1], Obs2Ioda::geometryMissing);
+
+    const double xs[] = {0.0, 0.05};
+    const double ys[] = {0.0, 0.05};
+    ASSERT_EQ(Obs2Ioda::geoFixedGridToLatLon(&himawari, 2, 2, xs, ys, lat, lon, valid), 0);
+    EXPECT_NEAR(lat[0], 0.0, 1e-4);
+    EXPECT_NEAR(lon[0], 140.7, 1e-4);
+    EXPECT_GT(lon[1], 140.7f);
+    EXPECT_LT(lat[2], 0.0f);
+    EXPECT_EQ(valid[3], 1);
+    EXPECT_NE(Obs2Ioda::geoFixedGridToLatLon(nullptr, 2, 2, xs, ys, lat, lon, valid), 0);
+}
+
+/**
+ * @brief Tests the zenith and azimuth angle of a geostationary satellite.
+ *
+ * This test ensures:
+ * - The zenith angle is 0 at the sub-satellite point and the great-circle angle
+ *   plus the parallax elsewhere.
+ * - The azimuth points to the sub-satellite point.
+ * - Locations without a valid latitude and longitude are missing.
+ */
+TEST(Geometry, SatelliteAngles) {
+    const float lat[] = {0.0f, 30.0f, 0.0f, -999.0f};
+    const float lon[] = {140.7f, 140.7f, -159.3f, 0.0f};
+    float zenith[4];
+    float azimuth[4];
+    ASSERT_EQ(Obs2Ioda::geoSatelliteAngles(&himawari, 4, lat, lon, zenith, azimuth), 0);
+    EXPECT_NEAR(zenith[0], 0.0, 1e-3);
+    const double theta1 = 60.0 * M_PI / 180.0;
+    const double theta2 = std::atan(himawari.rEq * std::sin(theta1) /
+                                    (himawari.satDist - himawari.rEq * std::sin(theta1)));
+    EXPECT_NEAR(zenith[2], (theta1 + theta2) * 180.0 / M_PI, 1e-3);
+    EXPECT_NEAR(azimuth[1], 180.0, 1e-3);
+    EXPECT_NEAR(azimuth[2], 270.0, 1e-3);
+    EXPECT_EQ(zenith[3], Obs2Ioda::geometryMissing);
+    EXPECT_EQ(azimuth[3], Obs2Ioda::geometryMissing);
+    EXPECT_EQ(Obs2Ioda::geoSatelliteAngles(&himawari, 4, lat, lon, zenith, nullptr), 0);
+}
+
+/**
+ * @brief Tests the solar zenith and azimuth angle.
+ *
+ * This test ensures:
+ * - At noon of the winter solstice the sun is 23.5 degrees from the zenith at
+ *   the equator and due south.
+ * - The sun rises in the east and sets in the west.
+ * - Lists of several tiles, computed on several threads, give the same angles
+ *   as single locations.
+ * - An invalid time is an error.
+ */
+TEST(Geometry, SolarAngles) {
+    const float lat[] = {0.0f, 40.0f, 40.0f, 0.0f};
+    const float lon[] = {0.0f, 0.0f, -90.0f, 90.0f};
+    float zenith[4];
+    float azimuth[4];
+    ASSERT_EQ(Obs2Ioda::geoSolarAngles(355, 12, 0, 4, lat, lon, zenith, azimuth), 0);
+    EXPECT_NEAR(zenith[0], 23.5, 0.1);
+    EXPECT_NEAR(zenith[1], 63.5, 0.1);
+    EXPECT_NEAR(azimuth[0], 180.0, 2.0);
+    EXPECT_GT(azimuth[2], 0.0f);
+    EXPECT_LT(azimuth[2], 180.0f);
+    EXPECT_GT(azimuth[3], 180.0f);
+    EXPECT_LT(azimuth[3], 360.0f);
+
+    const size_t numLocs = 3 * Obs2Ioda::geometryTileSize + 1;
+    const std::vector<float> lats(numLocs, 40.0f);
+    const std::vector<float> lons(numLocs, -90.0f);
+    std::vector<float> zeniths(numLocs);
+    ASSERT_EQ(Obs2Ioda::geoSolarAngles(355, 12, 0, static_cast<int>(numLocs), lats.data(), lons.data(),
+                                       zeniths.data(), nullptr), 0);
+    EXPECT_NEAR(zeniths.front(), zenith[2], 1e-4);
+    EXPECT_NEAR(zeniths.back(), zenith[2], 1e-4);
+    EXPECT_NE(Obs2Ioda::geoSolarAngles(80, 24, 0, 4, lat, lon, zenith, azimuth), 0);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ioda_writer.h"
+#include "netcdf_file.h"
+#include "netcdf_variable.h"
+
+/**
+ * @brief Tests writing a file with the C++ writer.
+ *
+ * This test ensures:
+ * - Groups, dimensions and variables are defined through the IODA schema.
+ * - Whole variables are written from containers and hyperslabs from spans.
+ * - Unwritten values are filled, and the file is closed when the writer goes
+ *   out of scope.
+ */
+TEST(IodaWriter, Write) {
+    const char *path = "ioda_writer_test.nc";
+    {
+        Obs2Ioda::IodaWriter writer(path, 2);
+        writer.addGroup("MetaData");
+        writer.addGroup("ObsValue");
+        writer.addDim("nlocs", 3);
+        writer.addDim("nchans", 2);
+        const auto dateTime = writer.addVar<long long, 1>("MetaData", "dateTime", {"nlocs"});
+        const auto stationIds = writer.addVar<const char *, 1>("MetaData", "station_id", {"nlocs"});
+        const auto bt = writer.addVar<float, 2>("ObsValue", "brightnessTemperature", {"nlocs", "nchans"});
+        bt.setFill(-999.0f);
+        EXPECT_EQ(bt.size(), 6u);
+
+        dateTime.put(std::vector<long long>{1523750400, 1523750460, 1523750520});
+        const std::array<const char *, 3> ids = {"72469", "1", "72451"};
+        stationIds.put(ids);
+        const float values[] = {200, 201, 202, 203};
+        bt.put({0, 0}, {2, 2}, values);
+        EXPECT_THROW(bt.put({2, 0}, {1, 2}, values), std::invalid_argument);
+    }
+
+    const netCDF::NcFile file(path, netCDF::NcFile::read);
+    std::vector<long long> dateTime(3);
+    file.getGroup("MetaData").getVar("dateTime").getVar(dateTime.data());
+    EXPECT_EQ(dateTime, (std::vector<long long>{1523750400, 1523750460, 1523750520}));
+    std::vector<char *> stationIds(3);
+    file.getGroup("MetaData").getVar("stationIdentification").getVar(stationIds.data());
+    EXPECT_EQ(std::string(stationIds[2]), "72451");
+    nc_free_string(3, stationIds.data());
+    std::vector<float> bt(6);
+    file.getGroup("ObsValue").getVar("brightnessTemperature").getVar(bt.data());
+    EXPECT_EQ(bt, (std::vector<float>{200, 201, 202, 203, -999, -999}));
+    std::remove(path);
+}
+
+/**
+ * @brief Tests that the C interface and the C++ writer share files and checks.
+ *
+ * This test ensures:
+ * - A file released to the C interface is written and closed by it.
+ * - Variables defined by the C interface are found by the writer.
+ * - Variables of another rank are rejected.
+ */
+TEST(IodaWriter, CInterface) {
+    const char *path = "ioda_writer_c_test.nc";
+    const char *dimNames[] = {"nlocs"};
+    int netcdfID;
+    {
+        Obs2Ioda::IodaWriter writer(path, 2);
+        writer.addGroup("MetaData");
+        writer.addDim("nlocs", 2);
+        netcdfID = writer.release();
+    }
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "latitude", NC_FLOAT, 1, dimNames), 0);
+    {
+        const Obs2Ioda::IodaWriter writer(netcdfID);
+        const auto latitude = writer.getVar<float, 1>("MetaData", "latitude");
+        const std::vector<float> values = {10.5f, -20.25f};
+        latitude.put(values);
+        EXPECT_THROW((writer.getVar<float, 2>("MetaData", "latitude")), std::invalid_argument);
+    }
+    const float longitude[] = {100.0f, 200.0f};
+    EXPECT_NE(Obs2Ioda::netcdfPutVarReal(netcdfID, "MetaData", "longitude", longitude), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    const netCDF::NcFile file(path, netCDF::NcFile::read);
+    std::vector<float> latitude(2);
+    file.getGroup("MetaData").getVar("latitude").getVar(latitude.data());
+    EXPECT_EQ(latitude, (std::vector<float>{10.5f, -20.25f}));
+    std::remove(path);
+}
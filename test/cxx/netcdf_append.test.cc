@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "netcdf_append.h"
+#include "netcdf_dimension.h"
+#include "netcdf_file.h"
+#include "netcdf_group.h"
+#include "netcdf_variable.h"
+
+/**
+ * @brief Tests the helpers of files with an unlimited location dimension.
+ *
+ * This test ensures:
+ * - Chunks hold about `appendChunkBytes` and at least one row.
+ * - Epoch seconds are formatted like the `min_datetime` attribute.
+ */
+TEST(NetcdfAppend, Helpers) {
+    EXPECT_EQ(Obs2Ioda::appendChunkRows(4), Obs2Ioda::appendChunkBytes / 4);
+    EXPECT_EQ(Obs2Ioda::appendChunkRows(40), Obs2Ioda::appendChunkBytes / 40);
+    EXPECT_EQ(Obs2Ioda::appendChunkRows(2 * Obs2Ioda::appendChunkBytes), 1);
+
+    EXPECT_EQ(Obs2Ioda::epochToDatetime(0), "1970-01-01T00:00:00Z");
+    EXPECT_EQ(Obs2Ioda::epochToDatetime(1523750441), "2018-04-15T00:00:41Z");
+}
+
+/**
+ * @brief Tests appending locations to an existing file.
+ *
+ * This test ensures:
+ * - The unlimited location dimension grows by the appended locations.
+ * - Appended locations that are not written get the fill value at close.
+ * - `min_datetime` and `max_datetime` cover the `dateTime` values of all appends.
+ */
+TEST(NetcdfAppend, Append) {
+    const char *path = "netcdf_append_test.nc";
+    const char *dimNames[] = {"nlocs"};
+    int netcdfID;
+    int dimID;
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "MetaData"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", 0, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "dateTime", NC_INT64, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "latitude", NC_FLOAT, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillReal(netcdfID, "MetaData", "latitude", 1, -999.0f), 0);
+    const size_t start0[] = {0};
+    const size_t count[] = {2};
+    const long long datetime0[] = {1523750441, 1523750400};
+    const float latitude0[] = {10.0f, 20.0f};
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabInt64(netcdfID, "MetaData", "dateTime", 1, start0, count, datetime0), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabReal(netcdfID, "MetaData", "latitude", 1, start0, count, latitude0), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    // the second scan only writes dateTime
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 1), 0);
+    size_t nlocs = 0;
+    ASSERT_EQ(Obs2Ioda::netcdfGetDimLen(netcdfID, nullptr, "nlocs", &nlocs), 0);
+    EXPECT_EQ(nlocs, 2u);
+    const size_t start1[] = {nlocs};
+    const long long datetime1[] = {1523751000, 1523751300};
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabInt64(netcdfID, "MetaData", "dateTime", 1, start1, count, datetime1), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    {
+        const netCDF::NcFile file(path, netCDF::NcFile::read);
+        EXPECT_EQ(file.getDim("Location").getSize(), 4);
+        std::vector<float> latitude(4);
+        file.getGroup("MetaData").getVar("latitude").getVar(latitude.data());
+        EXPECT_EQ(latitude, (std::vector<float>{10.0f, 20.0f, -999.0f, -999.0f}));
+        std::string minDatetime;
+        std::string maxDatetime;
+        file.getAtt("min_datetime").getValues(minDatetime);
+        file.getAtt("max_datetime").getValues(maxDatetime);
+        EXPECT_EQ(minDatetime, "2018-04-15T00:00:00Z");
+        EXPECT_EQ(maxDatetime, "2018-04-15T00:15:00Z");
+    }
+    std::remove(path);
+}
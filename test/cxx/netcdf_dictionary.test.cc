@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "netcdf_dictionary.h"
+#include "netcdf_dimension.h"
+#include "netcdf_encoding.h"
+#include "netcdf_file.h"
+#include "netcdf_group.h"
+#include "netcdf_variable.h"
+
+/**
+ * @brief Tests parsing and lookup of string entries of the output encoding policy.
+ *
+ * This test ensures:
+ * - `dictionary` and `char` entries apply to string variables only.
+ * - Numeric entries, also by `*`, do not apply to string variables.
+ * - `char` entries need a positive length and string entries cannot be packed.
+ */
+TEST(StringDictionary, Find) {
+    auto &encoding = Obs2Ioda::OutputEncoding::getInstance();
+    encoding.load(YAML::Load(
+        "ioda_compatible: false\n"
+        "encodings:\n"
+        "  \"MetaData/*\": {type: float}\n"
+        "  \"MetaData/station_id\": {type: dictionary}\n"
+        "  \"MetaData/datetime\": {type: char, length: 20}\n"
+    ));
+
+    const auto *stationId = encoding.find("MetaData", "stationIdentification", NC_STRING);
+    ASSERT_NE(stationId, nullptr);
+    EXPECT_TRUE(stationId->dictionary);
+    EXPECT_EQ(stationId->type, NC_INT);
+    const auto *datetime = encoding.find("MetaData", "datetime", NC_STRING);
+    ASSERT_NE(datetime, nullptr);
+    EXPECT_EQ(datetime->type, NC_CHAR);
+    EXPECT_EQ(datetime->stringLength, 20u);
+    EXPECT_EQ(encoding.find("MetaData", "stationIdentification", NC_INT), nullptr);
+    EXPECT_EQ(encoding.find("MetaData", "variable_names", NC_STRING), nullptr);
+    EXPECT_EQ(encoding.find("MetaData", "latitude", NC_DOUBLE)->type, NC_FLOAT);
+
+    EXPECT_THROW(encoding.load(YAML::Load("ioda_compatible: false\n"
+                                          "encodings: {\"MetaData/datetime\": {type: char, length: 0}}")),
+                 std::invalid_argument);
+    EXPECT_THROW(encoding.load(YAML::Load("ioda_compatible: false\n"
+                                          "encodings: {\"MetaData/x\": {type: dictionary, scale_factor: 0.1}}")),
+                 std::invalid_argument);
+    encoding.clear();
+}
+
+/**
+ * @brief Tests writing and reading string variables stored as a dictionary or as chars.
+ *
+ * This test ensures:
+ * - A dictionary-encoded variable holds `NC_INT` indices into a table of the
+ *   distinct strings, written when the file is closed.
+ * - A `char` variable holds the strings in a shared string length dimension.
+ * - Both are written by hyperslab and read back as blank-padded strings, with
+ *   the unwritten values filled.
+ */
+TEST(StringDictionary, File) {
+    const char *path = "netcdf_dictionary_test.nc";
+    const char *dimNames[] = {"nlocs"};
+    auto &encoding = Obs2Ioda::OutputEncoding::getInstance();
+    encoding.load(YAML::Load(
+        "ioda_compatible: false\n"
+        "encodings:\n"
+        "  \"MetaData/station_id\": {type: dictionary}\n"
+        "  \"MetaData/datetime\": {type: char, length: 20}\n"
+    ));
+    int netcdfID;
+    int dimID;
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "MetaData"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", 5, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "station_id", NC_STRING, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillString(netcdfID, "MetaData", "station_id", 1, " "), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "datetime", NC_STRING, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillString(netcdfID, "MetaData", "datetime", 1, " "), 0);
+
+    const char *stationIds[] = {"72469", "72451", "72469", "72469"};
+    const char *datetimes[] = {"2018-04-15T00:00:00Z", "2018-04-15T00:01:00Z"};
+    const size_t start[] = {0};
+    const size_t count[] = {4};
+    const size_t datetimeCount[] = {2};
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabString(netcdfID, "MetaData", "station_id", 1, start, count, stationIds), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabString(netcdfID, "MetaData", "datetime", 1, start, datetimeCount,
+                                               datetimes), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+    encoding.clear();
+
+    {
+        const netCDF::NcFile file(path, netCDF::NcFile::read);
+        const auto stationVar = file.getGroup("MetaData").getVar("stationIdentification");
+        EXPECT_EQ(stationVar.getType(), netCDF::ncInt);
+        EXPECT_TRUE(Obs2Ioda::isDictionaryEncoded(stationVar));
+        std::vector<int> indices(5);
+        stationVar.getVar(indices.data());
+        EXPECT_EQ(indices, (std::vector<int>{1, 2, 1, 1, 0}));
+        EXPECT_EQ(Obs2Ioda::readDictionary(stationVar), (std::vector<std::string>{" ", "72469", "72451"}));
+        const auto datetimeVar = file.getGroup("MetaData").getVar("datetime");
+        EXPECT_EQ(datetimeVar.getType(), netCDF::ncChar);
+        EXPECT_EQ(datetimeVar.getDims().back().getSize(), 20u);
+    }
+
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 0), 0);
+    const size_t readCount[] = {5};
+    std::string stationValues(5 * 8, '?');
+    ASSERT_EQ(Obs2Ioda::netcdfGetVarSlabString(netcdfID, "MetaData", "station_id", 1, start, readCount, 8,
+                                               stationValues.data()), 0);
+    EXPECT_EQ(stationValues, "72469   72451   72469   72469           ");
+    std::string datetimeValues(5 * 20, '?');
+    ASSERT_EQ(Obs2Ioda::netcdfGetVarSlabString(netcdfID, "MetaData", "datetime", 1, start, readCount, 20,
+                                               datetimeValues.data()), 0);
+    EXPECT_EQ(datetimeValues.substr(20, 20), "2018-04-15T00:01:00Z");
+    EXPECT_EQ(datetimeValues.substr(40), std::string(60, ' '));
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+    std::remove(path);
+}
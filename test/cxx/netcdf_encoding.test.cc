@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "netcdf_dimension.h"
+#include "netcdf_encoding.h"
+#include "netcdf_file.h"
+#include "netcdf_group.h"
+#include "netcdf_variable.h"
+
+/**
+ * @brief Tests parsing and lookup of the output encoding policy.
+ *
+ * This test ensures:
+ * - Keys are matched by valid IODA name, also when given by deprecated name.
+ * - A variable entry takes precedence over the `*` entry of its group.
+ * - Entries only apply to variables defined with a wider type, and packed
+ *   entries only to floating point variables.
+ * - Entries, which change what IODA reads, are rejected unless the policy
+ *   sets `ioda_compatible: false`.
+ */
+TEST(OutputEncoding, Find) {
+    auto &encoding = Obs2Ioda::OutputEncoding::getInstance();
+    encoding.load(YAML::Load(
+        "ioda_compatible: false\n"
+        "encodings:\n"
+        "  \"MetaData/*\": {type: short}\n"
+        "  \"MetaData/scan_position\": {type: byte}\n"
+        "  \"ObsValue/brightness_temperature\": {type: short, scale_factor: 0.01, add_offset: 300}\n"
+    ));
+
+    const auto *scanPosition = encoding.find("MetaData", "sensorScanPosition", NC_INT);
+    ASSERT_NE(scanPosition, nullptr);
+    EXPECT_EQ(scanPosition->type, NC_BYTE);
+    EXPECT_FALSE(scanPosition->packed());
+    EXPECT_EQ(encoding.find("MetaData", "dateTime", NC_INT64)->type, NC_SHORT);
+    const auto *bt = encoding.find("ObsValue", "brightnessTemperature", NC_FLOAT);
+    ASSERT_NE(bt, nullptr);
+    EXPECT_EQ(bt->type, NC_SHORT);
+    EXPECT_DOUBLE_EQ(bt->addOffset, 300.0);
+    EXPECT_EQ(encoding.find("ObsValue", "brightnessTemperature", NC_INT), nullptr);
+    EXPECT_EQ(encoding.find("ObsValue", "airTemperature", NC_FLOAT), nullptr);
+    EXPECT_DOUBLE_EQ(encoding.missingValue("ObsValue", "airTemperature"), Obs2Ioda::encodingMissingValue);
+
+    EXPECT_THROW(encoding.load(YAML::Load("ioda_compatible: false\n"
+                                          "encodings: {\"MetaData/*\": {type: char}}")),
+                 std::invalid_argument);
+    EXPECT_THROW(encoding.load(YAML::Load("encodings: {\"MetaData/*\": {type: short}}")), std::invalid_argument);
+    EXPECT_THROW(encoding.load(YAML::Load("ioda_compatible: true\nencodings: {\"PreQC/*\": {type: byte}}")),
+                 std::invalid_argument);
+    EXPECT_NO_THROW(encoding.load(YAML::Load("ioda_compatible: true\nencodings:\n")));
+    EXPECT_THROW(encoding.load(YAML::Load("ioda_compatible: false\n"
+                                          "encodings: {\"ObsValue/x\": {type: float, scale_factor: 0.1}}")),
+                 std::invalid_argument);
+    encoding.clear();
+    EXPECT_EQ(encoding.find("MetaData", "sensorScanPosition", NC_INT), nullptr);
+}
+
+/**
+ * @brief Tests writing and reading variables stored in narrower types.
+ *
+ * This test ensures:
+ * - Encoded variables are stored in their narrower type, with `scale_factor`,
+ *   `add_offset` and a `_FillValue` that readers unpack to the written values.
+ * - Missing values are written as the fill value of the storage type.
+ * - Values outside the range of the storage type are rejected.
+ * - Floating point values written to an integer variable without an entry are
+ *   converted by netCDF-C, which truncates them.
+ */
+TEST(OutputEncoding, File) {
+    const char *path = "netcdf_encoding_test.nc";
+    const char *dimNames[] = {"nlocs"};
+    auto &encoding = Obs2Ioda::OutputEncoding::getInstance();
+    encoding.load(YAML::Load(
+        "ioda_compatible: false\n"
+        "encodings:\n"
+        "  \"ObsType/*\": {type: byte}\n"
+        "  \"ObsValue/brightnessTemperature\": {type: short, scale_factor: 0.01, add_offset: 300}\n"
+    ));
+    int netcdfID;
+    int dimID;
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "ObsType"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "ObsValue"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "MetaData"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", 3, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "ObsType", "brightness_temperature", NC_INT, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillInt(netcdfID, "ObsType", "brightness_temperature", 1, -999), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "ObsValue", "brightness_temperature", NC_FLOAT, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillReal(netcdfID, "ObsValue", "brightness_temperature", 1, -999.0f), 0);
+    EXPECT_NE(Obs2Ioda::netcdfSetFillReal(netcdfID, "ObsValue", "brightness_temperature", 1, 1.0e20f), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "scan_position", NC_INT, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillInt(netcdfID, "MetaData", "scan_position", 1, -999), 0);
+
+    const int obsType[] = {0, -999, 12};
+    const float bt[] = {215.37f, -999.0f, 301.2f};
+    const float scanPosition[] = {1.0f, -999.0f, 56.9f};
+    const float tooWarm[] = {700.0f, 200.0f, 200.0f};
+    const int tooLarge[] = {128, 0, 0};
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarInt(netcdfID, "ObsType", "brightness_temperature", obsType), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarReal(netcdfID, "ObsValue", "brightness_temperature", bt), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarReal(netcdfID, "MetaData", "scan_position", scanPosition), 0);
+    EXPECT_NE(Obs2Ioda::netcdfPutVarReal(netcdfID, "ObsValue", "brightness_temperature", tooWarm), 0);
+    EXPECT_NE(Obs2Ioda::netcdfPutVarInt(netcdfID, "ObsType", "brightness_temperature", tooLarge), 0);
+
+    std::vector<float> unpacked(3);
+    ASSERT_EQ(Obs2Ioda::netcdfGetVarReal(netcdfID, "ObsValue", "brightness_temperature", unpacked.data()), 0);
+    EXPECT_NEAR(unpacked[0], 215.37f, 0.005f);
+    EXPECT_EQ(unpacked[1], -999.0f);
+    EXPECT_NEAR(unpacked[2], 301.2f, 0.005f);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+    encoding.clear();
+
+    {
+        const netCDF::NcFile file(path, netCDF::NcFile::read);
+        const auto obsTypeVar = file.getGroup("ObsType").getVar("brightnessTemperature");
+        EXPECT_EQ(obsTypeVar.getType(), netCDF::ncByte);
+        std::vector<signed char> obsTypeValues(3);
+        obsTypeVar.getVar(obsTypeValues.data());
+        EXPECT_EQ(obsTypeValues, (std::vector<signed char>{0, -128, 12}));
+        signed char obsTypeFill = 0;
+        obsTypeVar.getAtt("_FillValue").getValues(&obsTypeFill);
+        EXPECT_EQ(obsTypeFill, -128);
+
+        const auto btVar = file.getGroup("ObsValue").getVar("brightnessTemperature");
+        EXPECT_EQ(btVar.getType(), netCDF::ncShort);
+        EXPECT_EQ(btVar.getAtt("scale_factor").getType(), netCDF::ncFloat);
+        std::vector<short> btValues(3);
+        btVar.getVar(btValues.data());
+        EXPECT_EQ(btValues, (std::vector<short>{-8463, -32768, 120}));
+
+        const auto scanVar = file.getGroup("MetaData").getVar("sensorScanPosition");
+        EXPECT_EQ(scanVar.getType(), netCDF::ncInt);
+        std::vector<int> scanValues(3);
+        scanVar.getVar(scanValues.data());
+        EXPECT_EQ(scanValues, (std::vector<int>{1, -999, 56}));
+    }
+    std::remove(path);
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "netcdf_file.h"
+
+/**
+ * @brief Tests the mapping of output paths to NetCDF dataset paths.
+ *
+ * This test ensures:
+ * - Paths ending in ".zarr" map to an absolute NCZarr local directory store URL.
+ * - HDF5 paths and paths that already are URLs are passed through unchanged.
+ */
+TEST(NetcdfDatasetPath, Zarr) {
+    const auto absolutePath = std::filesystem::absolute("out/sondes_obs_2024010100.zarr")
+            .lexically_normal().string();
+    EXPECT_EQ(
+        Obs2Ioda::netcdfDatasetPath("out/sondes_obs_2024010100.zarr"),
+        "file://" + absolutePath + "#mode=nczarr,file"
+    );
+    EXPECT_EQ(
+        Obs2Ioda::netcdfDatasetPath("/data/out/./sondes_obs_2024010100.zarr"),
+        "file:///data/out/sondes_obs_2024010100.zarr#mode=nczarr,file"
+    );
+}
+
+TEST(NetcdfDatasetPath, PassThrough) {
+    EXPECT_EQ(
+        Obs2Ioda::netcdfDatasetPath("out/sondes_obs_2024010100.h5"),
+        "out/sondes_obs_2024010100.h5"
+    );
+    EXPECT_EQ(
+        Obs2Ioda::netcdfDatasetPath("file:///data/sondes.zarr#mode=nczarr,s3"),
+        "file:///data/sondes.zarr#mode=nczarr,s3"
+    );
+    EXPECT_EQ(
+        Obs2Ioda::netcdfDatasetPath(".zarr"),
+        ".zarr"
+    );
+}
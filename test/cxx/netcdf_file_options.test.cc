@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include "netcdf_file.h"
+#include "netcdf_file_options.h"
+
+#ifdef OBS2IODA_USE_HDF5
+#include <hdf5.h>
+#endif
+
+/**
+ * @brief Tests parsing of the HDF5 options.
+ *
+ * This test ensures:
+ * - Sizes accept the K, M and G suffixes.
+ * - Keys that are not given keep their HDF5 defaults.
+ */
+TEST(NetcdfFileOptions, Parse) {
+    const auto options = Obs2Ioda::parseNetcdfFileOptions(
+        "metadata_cache=32M, page_size=4M,page_buffer=64M,alignment=1M,alignment_threshold=64k"
+    );
+    EXPECT_EQ(options.metadataCacheSize, 32LL << 20);
+    EXPECT_EQ(options.pageSize, 4LL << 20);
+    EXPECT_EQ(options.pageBufferSize, 64LL << 20);
+    EXPECT_EQ(options.alignment, 1LL << 20);
+    EXPECT_EQ(options.alignmentThreshold, 64LL << 10);
+    EXPECT_EQ(options.collectiveMetadataWrite, 1);
+    EXPECT_TRUE(Obs2Ioda::isTuned(options));
+
+    const auto defaults = Obs2Ioda::parseNetcdfFileOptions("collective_metadata=0");
+    EXPECT_EQ(defaults.pageSize, 0);
+    EXPECT_EQ(defaults.collectiveMetadataWrite, 0);
+    EXPECT_FALSE(Obs2Ioda::isTuned(Obs2Ioda::parseNetcdfFileOptions("")));
+}
+
+TEST(NetcdfFileOptions, Invalid) {
+    EXPECT_THROW(Obs2Ioda::parseNetcdfFileOptions("page_size=4X"), std::invalid_argument);
+    EXPECT_THROW(Obs2Ioda::parseNetcdfFileOptions("page_size"), std::invalid_argument);
+    EXPECT_THROW(Obs2Ioda::parseNetcdfFileOptions("stripe_size=1M"), std::invalid_argument);
+    EXPECT_THROW(Obs2Ioda::parseNetcdfFileOptions("page_size=4M,page_buffer=6M"), std::invalid_argument);
+}
+
+TEST(NetcdfFileOptions, Environment) {
+    setenv("OBS2IODA_HDF5_OPTIONS", "alignment=1M", 1);
+    EXPECT_EQ(Obs2Ioda::environmentNetcdfFileOptions().alignment, 1LL << 20);
+    unsetenv("OBS2IODA_HDF5_OPTIONS");
+    EXPECT_FALSE(Obs2Ioda::isTuned(Obs2Ioda::environmentNetcdfFileOptions()));
+}
+
+#ifdef OBS2IODA_USE_HDF5
+/**
+ * @brief Tests that a tuned file keeps its file-space page size once the NetCDF library wrote it.
+ */
+TEST(NetcdfFileOptions, PagedFile) {
+    const char *path = "netcdf_file_options_paged.h5";
+    auto options = Obs2Ioda::defaultNetcdfFileOptions();
+    options.pageSize = 65536;
+    options.pageBufferSize = 4 * 65536;
+    options.metadataCacheSize = 8 << 20;
+    int netcdfID = -1;
+    ASSERT_EQ(Obs2Ioda::netcdfCreateWithOptions(path, &netcdfID, 2, &options), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    const hid_t file = H5Fopen(path, H5F_ACC_RDONLY, H5P_DEFAULT);
+    ASSERT_GE(file, 0);
+    const hid_t fcpl = H5Fget_create_plist(file);
+    H5F_fspace_strategy_t strategy;
+    hbool_t persist;
+    hsize_t threshold, pageSize;
+    H5Pget_file_space_strategy(fcpl, &strategy, &persist, &threshold);
+    H5Pget_file_space_page_size(fcpl, &pageSize);
+    EXPECT_EQ(strategy, H5F_FSPACE_STRATEGY_PAGE);
+    EXPECT_EQ(pageSize, 65536u);
+    H5Pclose(fcpl);
+    H5Fclose(file);
+    std::remove(path);
+}
+#endif
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "netcdf_fill.h"
+
+/**
+ * @brief Tests merging of written row ranges.
+ *
+ * This test ensures:
+ * - Overlapping and adjacent ranges merge.
+ * - The gaps are the complement of the written ranges, in order.
+ */
+TEST(RowCoverage, Gaps) {
+    Obs2Ioda::RowCoverage coverage;
+    coverage.add(2, 4);
+    coverage.add(6, 8);
+    coverage.add(4, 5);
+    coverage.add(7, 7);
+
+    EXPECT_TRUE(coverage.covers(2, 5));
+    EXPECT_FALSE(coverage.covers(2, 6));
+    EXPECT_FALSE(coverage.covers(0, 1));
+    EXPECT_TRUE(coverage.covers(3, 3));
+
+    const std::vector<std::pair<size_t, size_t> > gaps = {{0, 2}, {5, 6}, {8, 10}};
+    EXPECT_EQ(coverage.gaps(0, 10), gaps);
+    const std::vector<std::pair<size_t, size_t> > innerGaps = {{5, 6}};
+    EXPECT_EQ(coverage.gaps(3, 7), innerGaps);
+
+    coverage.add(0, 10);
+    EXPECT_TRUE(coverage.gaps(0, 10).empty());
+}
+
+/**
+ * @brief Tests that only the unwritten rows of a tracked variable are filled at close.
+ */
+TEST(FillTracker, FillGaps) {
+    const char *path = "netcdf_fill_test.nc";
+    int netcdfID;
+    {
+        netCDF::NcFile file(path, netCDF::NcFile::replace);
+        netcdfID = file.getId();
+        const auto dimLocs = file.addDim("Location", 10);
+        const auto dimChans = file.addDim("Channel", 2);
+        const auto var1d = file.addVar("var1d", netCDF::ncInt, dimLocs);
+        const auto var2d = file.addVar("var2d", netCDF::ncFloat, {dimLocs, dimChans});
+        auto &tracker = Obs2Ioda::FillTracker::getInstance();
+        tracker.track(netcdfID, var1d);
+        tracker.track(netcdfID, var2d);
+        var1d.putAtt("_FillValue", netCDF::ncInt, -999);
+        var2d.putAtt("_FillValue", netCDF::ncFloat, -999.0f);
+
+        const std::vector<int> rows = {1, 2, 3};
+        tracker.markWritten(netcdfID, var1d, {2}, {3});
+        var1d.putVar({2}, {3}, rows.data());
+        // the second channel of rows 4 and 5 only; their first channel is filled first
+        const std::vector<float> channel = {4.0f, 5.0f};
+        tracker.markWritten(netcdfID, var2d, {4, 1}, {2, 1});
+        var2d.putVar({4, 1}, {2, 1}, channel.data());
+
+        tracker.fillGaps(netcdfID);
+        file.close();
+    }
+
+    const netCDF::NcFile file(path, netCDF::NcFile::read);
+    std::vector<int> values1d(10);
+    file.getVar("var1d").getVar(values1d.data());
+    EXPECT_EQ(values1d, (std::vector<int>{-999, -999, 1, 2, 3, -999, -999, -999, -999, -999}));
+    std::vector<float> values2d(20);
+    file.getVar("var2d").getVar(values2d.data());
+    EXPECT_EQ(values2d[8], -999.0f);
+    EXPECT_EQ(values2d[9], 4.0f);
+    EXPECT_EQ(values2d[11], 5.0f);
+    EXPECT_EQ(values2d[0], -999.0f);
+    EXPECT_EQ(values2d[19], -999.0f);
+    std::remove(path);
+}
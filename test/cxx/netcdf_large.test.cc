@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "ioda_writer.h"
+#include "netcdf_dimension.h"
+#include "netcdf_file.h"
+#include "netcdf_group.h"
+#include "netcdf_variable.h"
+
+/**
+ * @brief Tests dimensions and variables with more than 2^31 elements.
+ *
+ * Only the hyperslabs written are allocated, and the variables are chunked, so
+ * that only the chunks written are stored and the file stays small.
+ *
+ * This test ensures:
+ * - Dimension lengths above 2^31 are defined and reported in full.
+ * - Hyperslabs starting beyond 2^31 are written and read back, in a 1D variable
+ *   and in a 2D variable of more than 2^32 elements.
+ */
+TEST(NetcdfLarge, Sizes) {
+    const char *path = "netcdf_large_test.nc";
+    const char *dimNames[] = {"nlocs", "nchans"};
+    const size_t nlocs = (size_t{1} << 31) + 1000;
+    const size_t nchans = 3;
+    int netcdfID;
+    int dimID;
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "MetaData"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "ObsValue"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", nlocs, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nchans", nchans, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "dateTime", NC_INT64, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillInt64(netcdfID, "MetaData", "dateTime", 0, 0), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "ObsValue", "brightnessTemperature", NC_FLOAT, 2, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillReal(netcdfID, "ObsValue", "brightnessTemperature", 0, 0.0f), 0);
+    {
+        const Obs2Ioda::IodaWriter writer(netcdfID);
+        std::vector<size_t> dateTimeChunks = {size_t{1} << 16};
+        writer.findVar("MetaData", "dateTime").setChunking(netCDF::NcVar::nc_CHUNKED, dateTimeChunks);
+        std::vector<size_t> btChunks = {size_t{1} << 16, nchans};
+        writer.findVar("ObsValue", "brightnessTemperature").setChunking(netCDF::NcVar::nc_CHUNKED, btChunks);
+    }
+
+    size_t len = 0;
+    ASSERT_EQ(Obs2Ioda::netcdfGetDimLen(netcdfID, nullptr, "nlocs", &len), 0);
+    EXPECT_EQ(len, nlocs);
+
+    const size_t start1[] = {(size_t{1} << 31) - 1};
+    const size_t count1[] = {2};
+    const long long dateTime[] = {1523750400, 1523750401};
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabInt64(netcdfID, "MetaData", "dateTime", 1, start1, count1, dateTime), 0);
+    const size_t start2[] = {nlocs - 2, 0};
+    const size_t count2[] = {2, nchans};
+    const float bt[] = {200, 201, 202, 203, 204, 205};
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabReal(netcdfID, "ObsValue", "brightnessTemperature", 2, start2, count2,
+                                             bt), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 0), 0);
+    nc_type type;
+    int numDims;
+    size_t dimLens[2];
+    ASSERT_EQ(Obs2Ioda::netcdfInqVar(netcdfID, "ObsValue", "brightnessTemperature", &type, &numDims, 2, dimLens), 0);
+    EXPECT_EQ(dimLens[0], nlocs);
+    EXPECT_EQ(dimLens[1], nchans);
+    std::vector<long long> dateTimeRead(2);
+    ASSERT_EQ(Obs2Ioda::netcdfGetVarSlabInt64(netcdfID, "MetaData", "dateTime", 1, start1, count1,
+                                              dateTimeRead.data()), 0);
+    EXPECT_EQ(dateTimeRead, (std::vector<long long>{1523750400, 1523750401}));
+    const size_t start3[] = {nlocs - 1, 1};
+    const size_t count3[] = {1, 2};
+    std::vector<float> btRead(2);
+    ASSERT_EQ(Obs2Ioda::netcdfGetVarSlabReal(netcdfID, "ObsValue", "brightnessTemperature", 2, start3, count3,
+                                             btRead.data()), 0);
+    EXPECT_EQ(btRead, (std::vector<float>{204, 205}));
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+    std::remove(path);
+}
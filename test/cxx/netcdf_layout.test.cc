@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <netcdf_meta.h>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "ioda_writer.h"
+#include "netcdf_dimension.h"
+#include "netcdf_file.h"
+#include "netcdf_group.h"
+#include "netcdf_layout.h"
+#include "netcdf_variable.h"
+
+/**
+ * @brief Tests the output layout of files created from a captured layout.
+ *
+ * This test ensures:
+ * - Variables are defined with their type, dimensions and fill value.
+ * - The chunk sizes of a variable are replayed, and cut to a shorter location
+ *   dimension.
+ * - The shuffle and deflate filters and the deflate level are replayed.
+ */
+TEST(NetcdfLayout, Storage) {
+    const char *templatePath = "netcdf_layout_template_test.nc";
+    const char *path = "netcdf_layout_test.nc";
+    const char *dimNames[] = {"nlocs", "nchans"};
+    int netcdfID;
+    int dimID;
+    int layoutID;
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(templatePath, &netcdfID, 2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "ObsValue"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", 100, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nchans", 3, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "ObsValue", "brightness_temperature", NC_FLOAT, 2, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetFillReal(netcdfID, "ObsValue", "brightness_temperature", 1, -999.0f), 0);
+    {
+        const Obs2Ioda::IodaWriter writer(netcdfID);
+        const auto var = writer.findVar("ObsValue", "brightness_temperature");
+        std::vector<size_t> chunkSizes = {50, 3};
+        var.setChunking(netCDF::NcVar::nc_CHUNKED, chunkSizes);
+        var.setCompression(true, true, 4);
+    }
+    ASSERT_EQ(Obs2Ioda::netcdfSaveLayout(netcdfID, &layoutID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    const char *overriddenDims[] = {"nlocs"};
+    const size_t dimLens[] = {20};
+    ASSERT_EQ(Obs2Ioda::netcdfCreateFromLayout(path, layoutID, 1, overriddenDims, dimLens, &netcdfID, 2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfFreeLayout(layoutID), 0);
+
+    {
+        const netCDF::NcFile file(path, netCDF::NcFile::read);
+        const auto var = file.getGroup("ObsValue").getVar("brightnessTemperature");
+        EXPECT_EQ(var.getType(), netCDF::ncFloat);
+        EXPECT_EQ(var.getDim(0).getSize(), 20u);
+        float fillValue = 0.0f;
+        var.getAtt("_FillValue").getValues(&fillValue);
+        EXPECT_EQ(fillValue, -999.0f);
+
+        netCDF::NcVar::ChunkMode chunkMode;
+        std::vector<size_t> chunkSizes;
+        var.getChunkingParameters(chunkMode, chunkSizes);
+        EXPECT_EQ(chunkMode, netCDF::NcVar::nc_CHUNKED);
+        EXPECT_EQ(chunkSizes, (std::vector<size_t>{20, 3}));
+
+        bool shuffle;
+        bool deflate;
+        int deflateLevel;
+        var.getCompressionParameters(shuffle, deflate, deflateLevel);
+        EXPECT_TRUE(shuffle);
+        EXPECT_TRUE(deflate);
+        EXPECT_EQ(deflateLevel, 4);
+    }
+    std::remove(templatePath);
+    std::remove(path);
+}
+
+/**
+ * @brief Tests copying a file to an NCZarr store and back to HDF5.
+ *
+ * This test ensures:
+ * - `netcdfCopy` writes an NCZarr directory store for a `.zarr` path.
+ * - The groups and the numeric and string data survive the round trip.
+ *
+ * It is skipped if NetCDF is built without NCZarr.
+ */
+TEST(NetcdfCopy, ZarrRoundTrip) {
+#if !defined(NC_HAS_NCZARR) || !NC_HAS_NCZARR
+    GTEST_SKIP() << "NetCDF is built without NCZarr";
+#else
+    const char *path = "netcdf_copy_test.nc";
+    const char *zarrPath = "netcdf_copy_test.zarr";
+    const char *copyPath = "netcdf_copy_test_back.nc";
+    const char *dimNames[] = {"nlocs"};
+    int netcdfID;
+    int dimID;
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "MetaData"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", 3, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "latitude", NC_FLOAT, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "station_id", NC_STRING, 1, dimNames), 0);
+    const float latitude[] = {10.5f, -20.25f, 89.0f};
+    const char *stationIds[] = {"72469", "72451", "1"};
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarReal(netcdfID, "MetaData", "latitude", latitude), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutVarString(netcdfID, "MetaData", "station_id", stationIds), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    ASSERT_EQ(Obs2Ioda::netcdfCopy(path, zarrPath), 0);
+    EXPECT_TRUE(std::filesystem::is_directory(zarrPath));
+    ASSERT_EQ(Obs2Ioda::netcdfCopy(zarrPath, copyPath), 0);
+
+    {
+        const netCDF::NcFile file(copyPath, netCDF::NcFile::read);
+        const auto metaData = file.getGroup("MetaData");
+        std::vector<float> latitudeValues(3);
+        metaData.getVar("latitude").getVar(latitudeValues.data());
+        EXPECT_EQ(latitudeValues, (std::vector<float>{10.5f, -20.25f, 89.0f}));
+        std::vector<char *> stationIdValues(3);
+        metaData.getVar("stationIdentification").getVar(stationIdValues.data());
+        EXPECT_EQ(std::string(stationIdValues[0]), "72469");
+        EXPECT_EQ(std::string(stationIdValues[2]), "1");
+        nc_free_string(3, stationIdValues.data());
+    }
+    std::remove(path);
+    std::remove(copyPath);
+    std::filesystem::remove_all(zarrPath);
+#endif
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "netcdf_attribute.h"
+#include "netcdf_dimension.h"
+#include "netcdf_file.h"
+#include "netcdf_group.h"
+#include "netcdf_merge.h"
+#include "netcdf_variable.h"
+
+namespace {
+    /// Writes a small IODA file with `dateTime`, `station_id` and two channels of `brightnessTemperature`.
+    void writeIodaFile(
+        const char *path,
+        const std::vector<long long> &dateTime,
+        const std::vector<const char *> &stationIds,
+        const std::vector<float> &brightnessTemperature
+    ) {
+        const char *dimNames[] = {"nlocs", "nchans"};
+        const char *channelDim[] = {"nchans"};
+        const int nlocs = static_cast<int>(dateTime.size());
+        const int channels[] = {7, 8};
+        int netcdfID;
+        int dimID;
+        ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 2), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "MetaData"), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "ObsValue"), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", nlocs, &dimID), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nchans", 2, &dimID), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfPutAttInt(netcdfID, "nlocs", &nlocs, nullptr, nullptr), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "dateTime", NC_INT64, 1, dimNames), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "station_id", NC_STRING, 1, dimNames), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "sensorChannelNumber", NC_INT, 1, channelDim), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "ObsValue", "brightnessTemperature", NC_FLOAT, 2, dimNames), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfPutVarInt64(netcdfID, "MetaData", "dateTime", dateTime.data()), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfPutVarString(netcdfID, "MetaData", "station_id",
+                                               const_cast<const char **>(stationIds.data())), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfPutVarInt(netcdfID, "MetaData", "sensorChannelNumber", channels), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfPutVarReal(netcdfID, "ObsValue", "brightnessTemperature",
+                                             brightnessTemperature.data()), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+    }
+}
+
+/**
+ * @brief Tests the inquiry and the whole and hyperslab reads of variables.
+ *
+ * This test ensures:
+ * - The type and dimension lengths of a variable are reported.
+ * - Whole variables and hyperslabs are read in row-major order.
+ * - Strings are read blank-padded to a fixed length.
+ */
+TEST(NetcdfMerge, Read) {
+    const char *path = "netcdf_read_test.nc";
+    writeIodaFile(path, {0, 3600, 7200}, {"72469", "1", "72451"}, {1, 2, 3, 4, 5, 6});
+    int netcdfID;
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 0), 0);
+    nc_type type;
+    int numDims;
+    size_t dimLens[2];
+    ASSERT_EQ(Obs2Ioda::netcdfInqVar(netcdfID, "ObsValue", "brightnessTemperature", &type, &numDims, 2, dimLens), 0);
+    EXPECT_EQ(type, NC_FLOAT);
+    EXPECT_EQ(numDims, 2);
+    EXPECT_EQ(dimLens[0], 3u);
+    EXPECT_EQ(dimLens[1], 2u);
+
+    std::vector<long long> dateTime(3);
+    ASSERT_EQ(Obs2Ioda::netcdfGetVarInt64(netcdfID, "MetaData", "dateTime", dateTime.data()), 0);
+    EXPECT_EQ(dateTime, (std::vector<long long>{0, 3600, 7200}));
+    const size_t start[] = {1, 1};
+    const size_t count[] = {2, 1};
+    std::vector<double> values(2);
+    ASSERT_EQ(Obs2Ioda::netcdfGetVarSlabDouble(netcdfID, "ObsValue", "brightnessTemperature", 2, start, count,
+                                               values.data()), 0);
+    EXPECT_EQ(values, (std::vector<double>{4, 6}));
+    char stationIds[12];
+    ASSERT_EQ(Obs2Ioda::netcdfGetVarSlabString(netcdfID, "MetaData", "station_id", 1, start, count, 6,
+                                               stationIds), 0);
+    EXPECT_EQ(std::string(stationIds, 12), "1     72451 ");
+    EXPECT_NE(Obs2Ioda::netcdfGetVarInt(netcdfID, "MetaData", "noSuchVariable", nullptr), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+    std::remove(path);
+}
+
+/**
+ * @brief Tests merging files and splitting a file into time windows.
+ *
+ * This test ensures:
+ * - Merged files hold the locations of all inputs in input order, and the
+ *   variables without a location dimension of the first input.
+ * - The `nlocs` and `min_datetime`/`max_datetime` attributes cover all locations.
+ * - Split files hold the locations of their window in input order, and are named
+ *   by the centre of the window.
+ */
+TEST(NetcdfMerge, MergeAndSplit) {
+    writeIodaFile("netcdf_merge_a.nc", {1523750400, 1523757600}, {"a", "b"}, {1, 2, 3, 4});
+    writeIodaFile("netcdf_merge_b.nc", {1523754000, 1523750500, 1523757000}, {"c", "d", "e"}, {5, 6, 7, 8, 9, 10});
+    {
+        const netCDF::NcFile file("netcdf_merge_a.nc", netCDF::NcFile::write);
+        file.putAtt("min_datetime", "2018-04-15T00:00:00Z");
+        file.putAtt("max_datetime", "2018-04-15T02:00:00Z");
+    }
+    const char *inputs[] = {"netcdf_merge_a.nc", "netcdf_merge_b.nc"};
+    ASSERT_EQ(Obs2Ioda::netcdfMerge(2, inputs, "netcdf_merge_ab.nc"), 0);
+    {
+        const netCDF::NcFile file("netcdf_merge_ab.nc", netCDF::NcFile::read);
+        EXPECT_EQ(file.getDim("Location").getSize(), 5u);
+        int nlocs = 0;
+        file.getAtt("nlocs").getValues(&nlocs);
+        EXPECT_EQ(nlocs, 5);
+        std::vector<float> values(10);
+        file.getGroup("ObsValue").getVar("brightnessTemperature").getVar(values.data());
+        EXPECT_EQ(values, (std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+        std::vector<int> channels(2);
+        file.getGroup("MetaData").getVar("sensorChannelNumber").getVar(channels.data());
+        EXPECT_EQ(channels, (std::vector<int>{7, 8}));
+        std::string maxDatetime;
+        file.getAtt("max_datetime").getValues(maxDatetime);
+        EXPECT_EQ(maxDatetime, "2018-04-15T02:00:00Z");
+    }
+
+    int numOutputs = 0;
+    ASSERT_EQ(Obs2Ioda::netcdfSplit("netcdf_merge_ab.nc", "netcdf_split_", 3600, &numOutputs), 0);
+    EXPECT_EQ(numOutputs, 3);
+    {
+        const netCDF::NcFile file("netcdf_split_2018041500.nc", netCDF::NcFile::read);
+        EXPECT_EQ(file.getDim("Location").getSize(), 2u);
+        std::vector<long long> dateTime(2);
+        file.getGroup("MetaData").getVar("dateTime").getVar(dateTime.data());
+        EXPECT_EQ(dateTime, (std::vector<long long>{1523750400, 1523750500}));
+        std::vector<float> values(4);
+        file.getGroup("ObsValue").getVar("brightnessTemperature").getVar(values.data());
+        EXPECT_EQ(values, (std::vector<float>{1, 2, 7, 8}));
+        std::string maxDatetime;
+        file.getAtt("max_datetime").getValues(maxDatetime);
+        EXPECT_EQ(maxDatetime, "2018-04-15T00:01:40Z");
+    }
+    {
+        const netCDF::NcFile file("netcdf_split_2018041502.nc", netCDF::NcFile::read);
+        EXPECT_EQ(file.getDim("Location").getSize(), 2u);
+        std::vector<char *> stationIds(2);
+        file.getGroup("MetaData").getVar("stationIdentification").getVar(stationIds.data());
+        EXPECT_EQ(std::string(stationIds[0]), "b");
+        EXPECT_EQ(std::string(stationIds[1]), "e");
+        nc_free_string(2, stationIds.data());
+    }
+    for (const char *path: {"netcdf_merge_a.nc", "netcdf_merge_b.nc", "netcdf_merge_ab.nc",
+                            "netcdf_split_2018041500.nc", "netcdf_split_2018041501.nc",
+                            "netcdf_split_2018041502.nc"}) {
+        std::remove(path);
+    }
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "netcdf_parallel.h"
+
+/**
+ * @brief Initializes MPI once for all tests and finalizes it at exit.
+ *
+ * The tests run on a single rank, with or without MPI support, so every
+ * collective reduces to the values of this rank.
+ */
+class ParallelEnvironment : public ::testing::Environment {
+public:
+    void SetUp() override {
+        ASSERT_EQ(Obs2Ioda::netcdfParallelInit(&comm, &rank, &size), 0);
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(Obs2Ioda::netcdfParallelFinalize(), 0);
+    }
+
+    static int comm;
+    static int rank;
+    static int size;
+};
+
+int ParallelEnvironment::comm = 0;
+int ParallelEnvironment::rank = -1;
+int ParallelEnvironment::size = 0;
+
+const auto *const parallelEnvironment =
+        ::testing::AddGlobalTestEnvironment(new ParallelEnvironment);
+
+TEST(NetcdfParallel, SingleRank) {
+    EXPECT_EQ(ParallelEnvironment::rank, 0);
+    EXPECT_EQ(ParallelEnvironment::size, 1);
+}
+
+/**
+ * @brief Tests the location offsets of a single rank.
+ *
+ * The only rank starts at offset 0 and holds all locations.
+ */
+TEST(NetcdfParallel, Exscan) {
+    long long offset = -1;
+    long long total = -1;
+    ASSERT_EQ(Obs2Ioda::netcdfParallelExscan(ParallelEnvironment::comm, 42, &offset, &total), 0);
+    EXPECT_EQ(offset, 0);
+    EXPECT_EQ(total, 42);
+}
+
+TEST(NetcdfParallel, ReduceInt) {
+    int result = 0;
+    for (const auto reduceOp: {Obs2Ioda::PARALLEL_MIN, Obs2Ioda::PARALLEL_MAX, Obs2Ioda::PARALLEL_SUM}) {
+        ASSERT_EQ(Obs2Ioda::netcdfParallelReduceInt(ParallelEnvironment::comm, 7, reduceOp, &result), 0);
+        EXPECT_EQ(result, 7);
+    }
+}
+
+/**
+ * @brief Tests the string reduction used for the min_datetime and max_datetime attributes.
+ *
+ * This test ensures:
+ * - The string of the only rank is returned.
+ * - Results longer than the output buffer are truncated and null-terminated.
+ */
+TEST(NetcdfParallel, ReduceString) {
+    char result[21];
+    ASSERT_EQ(Obs2Ioda::netcdfParallelReduceString(ParallelEnvironment::comm, "2024-01-01T00:00:00Z",
+                                                   Obs2Ioda::PARALLEL_MIN, result, sizeof(result)), 0);
+    EXPECT_STREQ(result, "2024-01-01T00:00:00Z");
+
+    char shortResult[11];
+    ASSERT_EQ(Obs2Ioda::netcdfParallelReduceString(ParallelEnvironment::comm, "2024-01-01T00:00:00Z",
+                                                   Obs2Ioda::PARALLEL_MAX, shortResult, sizeof(shortResult)), 0);
+    EXPECT_STREQ(shortResult, "2024-01-01");
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "epoch_time.h"
+#include "netcdf_attribute.h"
+#include "netcdf_dimension.h"
+#include "netcdf_file.h"
+#include "netcdf_group.h"
+#include "netcdf_parallel.h"
+#include "netcdf_variable.h"
+
+/**
+ * @brief Initializes MPI once for all tests and finalizes it at exit.
+ *
+ * The tests run on two or more ranks, started by `mpiexec`.
+ */
+class ParallelEnvironment : public ::testing::Environment {
+public:
+    void SetUp() override {
+        ASSERT_EQ(Obs2Ioda::netcdfParallelInit(&comm, &rank, &size), 0);
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(Obs2Ioda::netcdfParallelFinalize(), 0);
+    }
+
+    static int comm;
+    static int rank;
+    static int size;
+};
+
+int ParallelEnvironment::comm = 0;
+int ParallelEnvironment::rank = -1;
+int ParallelEnvironment::size = 0;
+
+const auto *const parallelEnvironment =
+        ::testing::AddGlobalTestEnvironment(new ParallelEnvironment);
+
+namespace {
+    const long long firstDateTime = 1704067200;
+
+    float latitudeOf(
+        const long long location
+    ) {
+        return -45.0f + 0.5f * static_cast<float>(location);
+    }
+
+    long long dateTimeOf(
+        const long long location
+    ) {
+        return firstDateTime + 60 * location;
+    }
+
+    void defineFile(
+        const int netcdfID,
+        const size_t numLocations
+    ) {
+        const char *dimNames[] = {"nlocs"};
+        int dimID;
+        ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "MetaData"), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", numLocations, &dimID), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "latitude", NC_FLOAT, 1, dimNames), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "dateTime", NC_INT64, 1, dimNames), 0);
+    }
+
+    void writeLocations(
+        const int netcdfID,
+        const long long offset,
+        const long long numLocations
+    ) {
+        std::vector<float> latitude;
+        std::vector<long long> dateTime;
+        for (long long i = offset; i < offset + numLocations; i++) {
+            latitude.push_back(latitudeOf(i));
+            dateTime.push_back(dateTimeOf(i));
+        }
+        const size_t start[] = {static_cast<size_t>(offset)};
+        const size_t count[] = {static_cast<size_t>(numLocations)};
+        ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabReal(netcdfID, "MetaData", "latitude", 1, start, count,
+                                                 latitude.data()), 0);
+        ASSERT_EQ(Obs2Ioda::netcdfPutVarSlabInt64(netcdfID, "MetaData", "dateTime", 1, start, count,
+                                                  dateTime.data()), 0);
+    }
+
+    template<typename T>
+    std::vector<T> readVar(
+        const netCDF::NcFile &file,
+        const std::string &varName
+    ) {
+        const auto var = file.getGroup("MetaData").getVar(varName);
+        std::vector<T> values(var.getDim(0).getSize());
+        var.getVar(values.data());
+        return values;
+    }
+
+    std::string readAtt(
+        const netCDF::NcFile &file,
+        const std::string &attName
+    ) {
+        std::string value;
+        file.getAtt(attName).getValues(value);
+        return value;
+    }
+}
+
+/**
+ * @brief Tests a file written by several ranks against the same file written by one.
+ *
+ * Each rank holds `rank + 2` consecutive locations, as the radiance readers
+ * hold the locations of their share of the input.
+ *
+ * This test ensures:
+ * - `netcdfParallelExscan` places the locations of each rank after those of
+ *   the lower ranks, and counts all of them.
+ * - The hyperslabs written collectively with `netcdfPutVarSlab` merge into the
+ *   data of a serial write.
+ * - `netcdfParallelReduceString` and `netcdfParallelReduceInt` reduce the
+ *   `min_datetime`, `max_datetime` and `nlocs` attributes to those of the serial file.
+ */
+TEST(NetcdfParallelMpi, MergedOutputMatchesSerial) {
+    ASSERT_GE(ParallelEnvironment::size, 2);
+    const int comm = ParallelEnvironment::comm;
+    const int rank = ParallelEnvironment::rank;
+    const char *parallelPath = "netcdf_parallel_mpi_test.nc";
+    const char *serialPath = "netcdf_parallel_mpi_serial_test.nc";
+
+    const long long numLocations = rank + 2;
+    long long offset = -1;
+    long long total = -1;
+    ASSERT_EQ(Obs2Ioda::netcdfParallelExscan(comm, numLocations, &offset, &total), 0);
+    const long long size = ParallelEnvironment::size;
+    EXPECT_EQ(offset, rank * (rank + 3) / 2);
+    EXPECT_EQ(total, size * (size + 3) / 2);
+
+    char minDatetime[Obs2Ioda::datetimeLength + 1];
+    char maxDatetime[Obs2Ioda::datetimeLength + 1];
+    int nlocs = 0;
+    ASSERT_EQ(Obs2Ioda::netcdfParallelReduceString(comm, Obs2Ioda::epochToDatetime(dateTimeOf(offset)).c_str(),
+                                                   Obs2Ioda::PARALLEL_MIN, minDatetime, sizeof(minDatetime)), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfParallelReduceString(comm,
+                                                   Obs2Ioda::epochToDatetime(
+                                                       dateTimeOf(offset + numLocations - 1)).c_str(),
+                                                   Obs2Ioda::PARALLEL_MAX, maxDatetime, sizeof(maxDatetime)), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfParallelReduceInt(comm, static_cast<int>(numLocations), Obs2Ioda::PARALLEL_SUM,
+                                                &nlocs), 0);
+
+    int netcdfID;
+    ASSERT_EQ(Obs2Ioda::netcdfCreatePar(parallelPath, &netcdfID, 2, comm), 0);
+    defineFile(netcdfID, total);
+    writeLocations(netcdfID, offset, numLocations);
+    ASSERT_EQ(Obs2Ioda::netcdfPutAttString(netcdfID, "min_datetime", minDatetime, nullptr, nullptr), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutAttString(netcdfID, "max_datetime", maxDatetime, nullptr, nullptr), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutAttInt(netcdfID, "nlocs", &nlocs, nullptr, nullptr), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    if (rank != 0) {
+        return;
+    }
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(serialPath, &netcdfID, 2), 0);
+    defineFile(netcdfID, total);
+    writeLocations(netcdfID, 0, total);
+    const int serialNlocs = static_cast<int>(total);
+    ASSERT_EQ(Obs2Ioda::netcdfPutAttString(netcdfID, "min_datetime",
+                                           Obs2Ioda::epochToDatetime(dateTimeOf(0)).c_str(), nullptr, nullptr), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutAttString(netcdfID, "max_datetime",
+                                           Obs2Ioda::epochToDatetime(dateTimeOf(total - 1)).c_str(), nullptr,
+                                           nullptr), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutAttInt(netcdfID, "nlocs", &serialNlocs, nullptr, nullptr), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+
+    {
+        const netCDF::NcFile parallelFile(parallelPath, netCDF::NcFile::read);
+        const netCDF::NcFile serialFile(serialPath, netCDF::NcFile::read);
+        EXPECT_EQ(readVar<float>(parallelFile, "latitude"), readVar<float>(serialFile, "latitude"));
+        EXPECT_EQ(readVar<long long>(parallelFile, "dateTime"), readVar<long long>(serialFile, "dateTime"));
+        EXPECT_EQ(readAtt(parallelFile, "min_datetime"), readAtt(serialFile, "min_datetime"));
+        EXPECT_EQ(readAtt(parallelFile, "max_datetime"), readAtt(serialFile, "max_datetime"));
+        int parallelNlocs = 0;
+        parallelFile.getAtt("nlocs").getValues(&parallelNlocs);
+        EXPECT_EQ(parallelNlocs, serialNlocs);
+    }
+    std::remove(parallelPath);
+    std::remove(serialPath);
+}
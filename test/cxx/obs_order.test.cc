@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "obs_order.h"
+
+/**
+ * @brief Tests the radix sort against a stable comparison sort.
+ *
+ * This test ensures:
+ * - Negative and positive keys are ordered, and ties keep their input order.
+ * - A later key breaks the ties of an earlier one.
+ * - The threaded sort gives the same order as the single-threaded one.
+ */
+TEST(ObsOrder, RadixSort) {
+    const std::vector<long long> time = {30, -5, 30, 1LL << 40, -5, 0};
+    const std::vector<long long> station = {2, 1, 1, 0, 1, 7};
+    EXPECT_EQ(Obs2Ioda::radixSortPermutation(time.size(), {time.data()}), (std::vector<size_t>{1, 4, 5, 0, 2, 3}));
+    EXPECT_EQ(Obs2Ioda::radixSortPermutation(time.size(), {time.data(), station.data()}),
+              (std::vector<size_t>{1, 4, 5, 2, 0, 3}));
+
+    const size_t numKeys = 3 * Obs2Ioda::radixSortParallelThreshold + 17;
+    std::mt19937_64 random(42);
+    std::vector<long long> large(numKeys);
+    for (auto &value: large) {
+        value = 1700000000 + static_cast<long long>(random() % 21600);
+    }
+    std::vector<size_t> expected(numKeys);
+    for (size_t i = 0; i < numKeys; i++) {
+        expected[i] = i;
+    }
+    std::stable_sort(expected.begin(), expected.end(), [&](const size_t a, const size_t b) {
+        return large[a] < large[b];
+    });
+    EXPECT_EQ(Obs2Ioda::radixSortPermutation(numKeys, {large.data()}, 1), expected);
+    EXPECT_EQ(Obs2Ioda::radixSortPermutation(numKeys, {large.data()}, 4), expected);
+}
+
+/**
+ * @brief Tests the output order and record numbers of observations.
+ *
+ * This test ensures:
+ * - Locations are ordered by time and then by station ID.
+ * - Consecutive locations with the same time and station form one record.
+ */
+TEST(ObsOrder, ObsOrder) {
+    const long long dateTime[] = {600, 0, 600, 0, 600};
+    const char stationIds[] = "72469 " "72451 " "72451 " "72451 " "72469 ";
+    long long order[5];
+    long long recordNumber[5];
+    long long numRecords = 0;
+    ASSERT_EQ(Obs2Ioda::obsOrder(5, dateTime, stationIds, 6, order, recordNumber, &numRecords), 0);
+    EXPECT_EQ(std::vector<long long>(order, order + 5), (std::vector<long long>{1, 3, 2, 0, 4}));
+    EXPECT_EQ(std::vector<long long>(recordNumber, recordNumber + 5), (std::vector<long long>{1, 1, 2, 3, 3}));
+    EXPECT_EQ(numRecords, 3);
+
+    ASSERT_EQ(Obs2Ioda::obsOrder(5, dateTime, nullptr, 0, order, recordNumber, &numRecords), 0);
+    EXPECT_EQ(std::vector<long long>(order, order + 5), (std::vector<long long>{1, 3, 0, 2, 4}));
+    EXPECT_EQ(numRecords, 2);
+}
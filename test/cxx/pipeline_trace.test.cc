@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "pipeline_trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @brief Tests that nested stages are recorded in the order they end, with
+ * their nesting level, observation counts and resident set size.
+ */
+TEST(PipelineTrace, NestedStages) {
+    auto &trace = Obs2Ioda::PipelineTrace::getInstance();
+    trace.init("test_pipeline_trace.json");
+    ASSERT_TRUE(trace.isEnabled());
+
+    trace.begin("cycle");
+    trace.begin("read_prepbufr");
+    trace.end("read_prepbufr", -1);
+    trace.begin("write_obs");
+    trace.end("write_obs", 42);
+    trace.end("cycle", -1);
+
+    const auto &events = trace.getEvents();
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].name, "read_prepbufr");
+    EXPECT_EQ(events[0].depth, 1);
+    EXPECT_EQ(events[1].name, "write_obs");
+    EXPECT_EQ(events[1].count, 42);
+    EXPECT_EQ(events[2].name, "cycle");
+    EXPECT_EQ(events[2].depth, 0);
+    EXPECT_GE(events[2].duration, events[0].duration + events[1].duration);
+    EXPECT_GE(events[2].peakRss, events[1].peakRss);
+    EXPECT_GT(events[2].rss, 0);
+}
+
+/**
+ * @brief Tests that a stage can only be ended innermost-first.
+ */
+TEST(PipelineTrace, MismatchedEnd) {
+    auto &trace = Obs2Ioda::PipelineTrace::getInstance();
+    trace.init("test_pipeline_trace.json");
+    trace.begin("outer");
+    trace.begin("inner");
+    EXPECT_THROW(trace.end("outer", -1), std::logic_error);
+    EXPECT_NE(Obs2Ioda::traceEnd("outer", -1), 0);
+    EXPECT_EQ(Obs2Ioda::traceEnd("inner", -1), 0);
+    EXPECT_EQ(Obs2Ioda::traceEnd("outer", -1), 0);
+}
+
+/**
+ * @brief Tests the trace file and summary written by `traceFinalize`.
+ *
+ * This test ensures:
+ * - The file holds a complete ("X") event per stage with its observation count.
+ * - The summary lists each stage name once with its number of calls.
+ * - Tracing is disabled afterwards.
+ */
+TEST(PipelineTrace, Finalize) {
+    const std::string path = "test_pipeline_trace.json";
+    ASSERT_EQ(Obs2Ioda::traceInit(path.c_str(), 0), 0);
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(Obs2Ioda::traceBegin("sort_obs_conv"), 0);
+        ASSERT_EQ(Obs2Ioda::traceEnd("sort_obs_conv", 10), 0);
+    }
+    const auto summary = Obs2Ioda::PipelineTrace::getInstance().summary();
+    EXPECT_NE(summary.find("sort_obs_conv"), std::string::npos);
+    EXPECT_NE(summary.find("20"), std::string::npos);
+    ASSERT_EQ(Obs2Ioda::traceFinalize(), 0);
+    EXPECT_FALSE(Obs2Ioda::PipelineTrace::getInstance().isEnabled());
+
+    std::ifstream in(path);
+    ASSERT_TRUE(in.good());
+    std::stringstream contents;
+    contents << in.rdbuf();
+    const auto json = contents.str();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\""), 0u);
+    EXPECT_NE(json.find("\"name\":\"sort_obs_conv\",\"cat\":\"obs2ioda\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"observations\":10"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief Tests that tracing stays off, and stages are ignored, without a trace file.
+ *
+ * `OBS2IODA_TRACE` is unset first, since its path is used when no trace file is given.
+ */
+TEST(PipelineTrace, Disabled) {
+    unsetenv("OBS2IODA_TRACE");
+    ASSERT_EQ(Obs2Ioda::traceInit("", 0), 0);
+    EXPECT_FALSE(Obs2Ioda::PipelineTrace::getInstance().isEnabled());
+    EXPECT_EQ(Obs2Ioda::traceBegin("read_HSD"), 0);
+    EXPECT_EQ(Obs2Ioda::traceEnd("write_obs", -1), 0);
+    EXPECT_TRUE(Obs2Ioda::PipelineTrace::getInstance().getEvents().empty());
+    EXPECT_EQ(Obs2Ioda::traceFinalize(), 0);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+#include "netcdf_dimension.h"
+#include "netcdf_file.h"
+#include "netcdf_group.h"
+#include "netcdf_variable.h"
+#include "spatial_index.h"
+
+/**
+ * @brief Tests the numbering of locations along the Hilbert curve.
+ *
+ * This test ensures:
+ * - The four quadrants of a one-bit grid are visited in Hilbert order.
+ * - Longitudes -180-180 and 0-360 give the same index.
+ * - The cells of an aligned 2 x 2 block of the full grid are consecutive on the curve.
+ */
+TEST(SpatialIndex, HilbertIndex) {
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(-45.0, 90.0, 1), 0);
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(45.0, 90.0, 1), 1);
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(45.0, 270.0, 1), 2);
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(-45.0, 270.0, 1), 3);
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(45.0, -90.0, 1), 2);
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(-90.0, 0.0), 0);
+    EXPECT_LT(Obs2Ioda::hilbertIndex(90.0, 359.99), 1LL << (2 * Obs2Ioda::hilbertBits));
+
+    // the four cells of an aligned 2 x 2 block are consecutive on the curve
+    const double width = 360.0 / (1 << Obs2Ioda::hilbertBits);
+    const double height = 180.0 / (1 << Obs2Ioda::hilbertBits);
+    const long long first = Obs2Ioda::hilbertIndex(-90.0 + 2000.5 * height, 1000.5 * width) / 4;
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(-90.0 + 2001.5 * height, 1000.5 * width) / 4, first);
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(-90.0 + 2000.5 * height, 1001.5 * width) / 4, first);
+    EXPECT_EQ(Obs2Ioda::hilbertIndex(-90.0 + 2001.5 * height, 1001.5 * width) / 4, first);
+}
+
+/**
+ * @brief Tests the spatial order and the bounding boxes of blocks of locations.
+ *
+ * This test ensures:
+ * - Locations of one quadrant are ordered together, and locations without a
+ *   valid latitude and longitude last.
+ * - Every block covers the latitude, longitude and time range of its valid locations.
+ * - Longitudes are normalised to 0-360, so that west longitudes given as
+ *   negative and as above 180 degrees give the same box.
+ */
+TEST(SpatialIndex, Blocks) {
+    const float lat[] = {-45.0f, 45.0f, -999.0f, -40.0f, 50.0f};
+    const float lon[] = {90.0f, 270.0f, -999.0f, 95.0f, -85.0f};
+    const long long dateTime[] = {10, 20, 30, 40, 50};
+    long long order[5];
+    ASSERT_EQ(Obs2Ioda::spatialOrder(5, lat, lon, dateTime, order), 0);
+    EXPECT_EQ(order[4], 2);
+    EXPECT_EQ(std::abs(order[0] - order[1]), 3);
+
+    const auto blocks = Obs2Ioda::spatialBlocks(5, lat, lon, dateTime, 2);
+    ASSERT_EQ(blocks.size(), 3u);
+    EXPECT_EQ(blocks[0].latitudeMin, -45.0f);
+    EXPECT_EQ(blocks[0].latitudeMax, 45.0f);
+    EXPECT_EQ(blocks[0].dateTimeMax, 20);
+    EXPECT_EQ(blocks[1].longitudeMin, 95.0f);
+    EXPECT_EQ(blocks[1].longitudeMax, 95.0f);
+    EXPECT_EQ(blocks[1].dateTimeMin, 40);
+    EXPECT_EQ(blocks[2].latitudeMin, 50.0f);
+    EXPECT_EQ(blocks[2].longitudeMin, 275.0f);
+
+    const float westLat[] = {10.0f, 11.0f};
+    const float westLon[] = {-170.0f, 191.0f};
+    const auto westBlocks = Obs2Ioda::spatialBlocks(2, westLat, westLon, dateTime, 2);
+    ASSERT_EQ(westBlocks.size(), 1u);
+    EXPECT_EQ(westBlocks[0].longitudeMin, 190.0f);
+    EXPECT_EQ(westBlocks[0].longitudeMax, 191.0f);
+}
+
+/**
+ * @brief Tests the chunking of location variables and the spatial index of a file.
+ *
+ * This test ensures:
+ * - Location variables are chunked by blocks of locations, and 2D variables
+ *   split along their second dimension.
+ * - The `SpatialIndex` group holds one bounding box per block.
+ * - The number of locations is passed as a 64-bit count, as for `spatialOrder`,
+ *   and a negative count is rejected.
+ */
+TEST(SpatialIndex, File) {
+    const char *path = "spatial_index_test.nc";
+    const char *dimNames[] = {"nlocs", "nchans"};
+    int netcdfID;
+    int dimID;
+    ASSERT_EQ(Obs2Ioda::netcdfSetLocationBlocks(2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfCreate(path, &netcdfID, 2), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddGroup(netcdfID, nullptr, "MetaData"), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nlocs", 5, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddDim(netcdfID, nullptr, "nchans", 3, &dimID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "latitude", NC_FLOAT, 1, dimNames), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfAddVar(netcdfID, "MetaData", "channelValue", NC_FLOAT, 2, dimNames), 0);
+    const float lat[] = {-45.0f, 45.0f, -999.0f, -40.0f, 50.0f};
+    const float lon[] = {90.0f, 270.0f, -999.0f, 95.0f, -85.0f};
+    const long long dateTime[] = {10, 20, 30, 40, 50};
+    static_assert(std::is_same<decltype(&Obs2Ioda::netcdfPutSpatialIndex),
+                               int (*)(int, long long, const float *, const float *, const long long *)>::value,
+                  "netcdfPutSpatialIndex takes a 64-bit number of locations");
+    EXPECT_NE(Obs2Ioda::netcdfPutSpatialIndex(netcdfID, -1, lat, lon, dateTime), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfPutSpatialIndex(netcdfID, 5, lat, lon, dateTime), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfClose(netcdfID), 0);
+    ASSERT_EQ(Obs2Ioda::netcdfSetLocationBlocks(0), 0);
+
+    {
+        const netCDF::NcFile file(path, netCDF::NcFile::read);
+        netCDF::NcVar::ChunkMode mode;
+        std::vector<size_t> chunkSizes;
+        file.getGroup("MetaData").getVar("latitude").getChunkingParameters(mode, chunkSizes);
+        EXPECT_EQ(mode, netCDF::NcVar::nc_CHUNKED);
+        EXPECT_EQ(chunkSizes, std::vector<size_t>{2});
+        file.getGroup("MetaData").getVar("channelValue").getChunkingParameters(mode, chunkSizes);
+        EXPECT_EQ(chunkSizes, (std::vector<size_t>{2, 3}));
+
+        const auto index = file.getGroup("SpatialIndex");
+        int blockLocs = 0;
+        index.getAtt("locationsPerBlock").getValues(&blockLocs);
+        EXPECT_EQ(blockLocs, 2);
+        EXPECT_EQ(index.getDim("Block").getSize(), 3u);
+        std::vector<float> latitudeMax(3);
+        index.getVar("latitudeMax").getVar(latitudeMax.data());
+        EXPECT_EQ(latitudeMax, (std::vector<float>{45.0f, -40.0f, 50.0f}));
+        std::vector<long long> dateTimeMin(3);
+        index.getVar("dateTimeMin").getVar(dateTimeMin.data());
+        EXPECT_EQ(dateTimeMin, (std::vector<long long>{10, 40, 50}));
+    }
+    std::remove(path);
+}
@@ -0,0 +1,142 @@
+! bufr_index_test:
+!   Unit test for the `bufr_index_scan`, `bufr_index_build` and `bufr_index_range`
+!   subroutines in bufr_index_mod.
+!
+!   Description:
+!     This program writes a file of synthetic BUFR messages (section headers only)
+!     of edition 3 and 4, with an optional section 2, a BUFR table message and
+!     record markers between the messages. It verifies the offsets, message types,
+!     dates and subset counts of the index, that the cached index reads back the
+!     same, that a rewritten file of the same size is scanned again, and that
+!     the messages are split into contiguous ranges by subset count.
+!
+!   Notes:
+!     - Fails with a non-zero exit code if any check fails.
+program bufr_index_test
+    use kinds, only : i_kind, i_llong
+    use bufr_index_mod, only : bufr_index_type, bufr_index_scan, bufr_index_build, &
+            bufr_index_range, bufr_index_matches
+    implicit none
+    character(len=*), parameter :: fname = 'bufr_index_test.bufr'
+    character(len=4), parameter :: marker = achar(0) // achar(0) // achar(0) // achar(41)
+    type(bufr_index_type) :: bindex, cached
+    character(len=:), allocatable :: stream
+    integer(i_kind) :: iunit, iret, first, last, i
+    integer(i_llong) :: offsets(4)
+
+    stream = ''
+    offsets(1) = len(stream)
+    stream = stream // msg_ed4(21, 23, 2024, 1, 15, 6, 100, .false.) // marker
+    stream = stream // msg_ed4(11, 1, 2024, 1, 15, 6, 1, .false.) // marker
+    offsets(2) = len(stream)
+    stream = stream // msg_ed3(21, 23, 24, 1, 15, 7, 300) // marker
+    offsets(3) = len(stream)
+    stream = stream // msg_ed4(5, 30, 2024, 1, 15, 8, 200, .true.) // marker
+    offsets(4) = len(stream)
+    stream = stream // msg_ed4(21, 203, 2024, 1, 15, 9, 400, .false.)
+
+    open(newunit=iunit, file=fname, access='stream', form='unformatted', status='replace')
+    write(iunit) stream
+    close(iunit)
+
+    call bufr_index_scan(fname, bindex, iret)
+    call check(iret == 0, "scan status")
+    call check(bindex%nmsg == 4, "table message is not indexed")
+    call check(bindex%file_size == len(stream), "file size")
+    call check(all(bindex%msg(:)%offset == offsets), "message offsets")
+    call check(bindex%msg(1)%subset == 'NC021023', "edition 4 message type")
+    call check(bindex%msg(2)%subset == 'NC021023', "edition 3 message type")
+    call check(bindex%msg(3)%subset == 'NC005030', "message type after section 2")
+    call check(all(bindex%msg(:)%nsubsets == (/ 100, 300, 200, 400 /)), "subset counts")
+    call check(all(bindex%msg(:)%idate == (/ 2024011506, 2024011507, 2024011508, 2024011509 /)), "message dates")
+    call check(bufr_index_matches(bindex, 3, 'NC005030'), "message 3 matches")
+    call check(.not. bufr_index_matches(bindex, 5, 'NC021023'), "no message 5")
+
+    ! the cache written by the first build is read back by the second
+    call bufr_index_build(fname, cached, iret)
+    call check(iret == 0, "build status")
+    call bufr_index_build(fname, cached, iret)
+    call check(iret == 0, "cached build status")
+    call check(cached%nmsg == bindex%nmsg, "cached message count")
+    do i = 1, bindex%nmsg
+        call check(cached%msg(i)%offset == bindex%msg(i)%offset .and. &
+                cached%msg(i)%subset == bindex%msg(i)%subset .and. &
+                cached%msg(i)%nsubsets == bindex%msg(i)%nsubsets, "cached message")
+    end do
+
+    ! a file rewritten with the same size is scanned again
+    stream(len(stream) - len(msg_ed4(21, 203, 2024, 1, 15, 9, 400, .false.)) + 1:) = &
+            msg_ed4(21, 204, 2024, 1, 15, 9, 400, .false.)
+    open(newunit=iunit, file=fname, access='stream', form='unformatted', status='replace')
+    write(iunit) stream
+    close(iunit)
+    call bufr_index_build(fname, cached, iret)
+    call check(iret == 0, "rebuild status")
+    call check(cached%msg(4)%subset == 'NC021204', "rewritten message type")
+
+    ! 1000 subsets on 2 ranks: messages 1-3 (600 subsets) and message 4
+    call bufr_index_range(bindex, 0, 2, first, last)
+    call check(first == 1 .and. last == 3, "range of rank 0")
+    call bufr_index_range(bindex, 1, 2, first, last)
+    call check(first == 4 .and. last == 4, "range of rank 1")
+    call bufr_index_range(bindex, 0, 1, first, last, wanted=(/ 'NC005030' /))
+    call check(first == 3 .and. last == 3, "range of wanted messages")
+    call bufr_index_range(bindex, 0, 1, first, last, wanted=(/ 'NC005090' /))
+    call check(first > last, "no wanted messages")
+
+    open(newunit=iunit, file=fname, status='old')
+    close(iunit, status='delete')
+    open(newunit=iunit, file=fname // '.idx', status='old')
+    close(iunit, status='delete')
+
+contains
+
+    function octets(val, n) result(buf)
+        integer(i_kind), intent(in) :: val, n
+        character(len=n) :: buf
+        integer(i_kind) :: i
+
+        do i = 1, n
+            buf(i:i) = achar(ibits(val, 8 * (n - i), 8))
+        end do
+    end function octets
+
+    function msg_ed4(category, subcategory, year, month, day, hour, nsubsets, with_sec2) result(msg)
+        integer(i_kind), intent(in) :: category, subcategory, year, month, day, hour, nsubsets
+        logical, intent(in) :: with_sec2
+        character(len=:), allocatable :: msg
+        character(len=:), allocatable :: body
+
+        body = octets(22, 3) // octets(0, 1) // octets(7, 2) // octets(0, 2) // octets(0, 1) &
+                // octets(merge(128, 0, with_sec2), 1) // octets(category, 1) // octets(0, 1) &
+                // octets(subcategory, 1) // octets(13, 1) // octets(1, 1) // octets(year, 2) &
+                // octets(month, 1) // octets(day, 1) // octets(hour, 1) // octets(0, 2)
+        if (with_sec2) body = body // octets(6, 3) // octets(0, 3)
+        body = body // octets(7, 3) // octets(0, 1) // octets(nsubsets, 2) // octets(0, 1) // '7777'
+        msg = 'BUFR' // octets(8 + len(body), 3) // octets(4, 1) // body
+    end function msg_ed4
+
+    function msg_ed3(category, subcategory, year, month, day, hour, nsubsets) result(msg)
+        integer(i_kind), intent(in) :: category, subcategory, year, month, day, hour, nsubsets
+        character(len=:), allocatable :: msg
+        character(len=:), allocatable :: body
+
+        body = octets(18, 3) // octets(0, 1) // octets(7, 2) // octets(0, 1) // octets(0, 1) &
+                // octets(category, 1) // octets(subcategory, 1) // octets(13, 1) // octets(1, 1) &
+                // octets(year, 1) // octets(month, 1) // octets(day, 1) // octets(hour, 1) &
+                // octets(0, 1) // octets(0, 1)
+        body = body // octets(7, 3) // octets(0, 1) // octets(nsubsets, 2) // octets(0, 1) // '7777'
+        msg = 'BUFR' // octets(8 + len(body), 3) // octets(3, 1) // body
+    end function msg_ed3
+
+    subroutine check(passed, name)
+        logical, intent(in) :: passed
+        character(*), intent(in) :: name
+
+        if (.not. passed) then
+            print *, "Unexpected BUFR index: ", name
+            stop 1
+        end if
+    end subroutine check
+
+end program bufr_index_test
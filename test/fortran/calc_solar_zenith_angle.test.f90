@@ -103,18 +103,78 @@ subroutine test_symmetric_noon(name, status)
     end if
 end subroutine test_symmetric_noon
 
+! Test that the SIMD kernel geoSolarAngles agrees with the scalar routine
+! over a grid of locations at several times of the year and day
+subroutine test_kernel_equivalence(name, status)
+    use ieee_arithmetic, only : ieee_is_nan
+    use ahi_HSD_mod, only : calc_solar_zenith_angle
+    use netcdf_cxx_mod, only : geoSolarAngles
+    use kinds, only : r_single
+    implicit none
+
+    character(*), intent(in) :: name
+    integer, intent(out) :: status
+    integer, parameter :: nlon = 49, nlat = 25
+    real(r_single), parameter :: tol = 0.01_r_single
+    integer, parameter :: julians(5) = (/ 1, 79, 80, 172, 366 /)
+    integer, parameter :: hours(3) = (/ 0, 7, 23 /)
+    real(r_single) :: lat(nlon, nlat), lon(nlon, nlat), zenith(nlon, nlat), azimuth(nlon, nlat)
+    real(r_single) :: solzen
+    integer :: i, j, k, m
+
+    do j = 1, nlat
+        do i = 1, nlon
+            lat(i, j) = -90.0 + 7.5 * (j - 1)
+            lon(i, j) = -180.0 + 7.5 * (i - 1)
+        end do
+    end do
+    ! a location without lat/lon
+    lat(1, 1) = -999.0
+    lon(1, 1) = -999.0
+
+    status = 0
+    do k = 1, size(julians)
+        do m = 1, size(hours)
+            if (geoSolarAngles(julians(k), hours(m), 37, lat, lon, zenith, azimuth) /= 0) then
+                status = 1
+                return
+            end if
+            do j = 1, nlat
+                do i = 1, nlon
+                    solzen = -999.0
+                    call calc_solar_zenith_angle(lat(i, j), lon(i, j), hours(m), 37, julians(k), solzen)
+                    if (ieee_is_nan(zenith(i, j)) .or. abs(zenith(i, j) - solzen) > tol) then
+                        write(*, *) trim(name), ": lat =", lat(i, j), ", lon =", lon(i, j), &
+                                ", kernel =", zenith(i, j), ", scalar =", solzen
+                        status = 1
+                    end if
+                    if (solzen >= 0.0 .and. (azimuth(i, j) < 0.0 .or. azimuth(i, j) > 360.0)) then
+                        status = 1
+                    end if
+                end do
+            end do
+        end do
+    end do
+
+    ! an invalid time is an error, as it is NaN for the scalar routine
+    if (geoSolarAngles(80, 24, 0, lat, lon, zenith) == 0) then
+        status = 1
+    end if
+end subroutine test_kernel_equivalence
+
 ! Driver program to run solar zenith angle unit tests
 program calc_solar_zenith_angle_test
     implicit none
     integer :: i
-    integer :: test_status(5)
-    character(len = 20) :: test_names(5)
+    integer :: test_status(6)
+    character(len = 24) :: test_names(6)
 
     test_names(1) = "Test Equator Noon"
     test_names(2) = "Test Invalid Hour"
     test_names(3) = "Test Symmetric Noon"
     test_names(4) = "Test Invalid Minute"
     test_names(5) = "Test Invalid Julian Day"
+    test_names(6) = "Test Kernel Equivalence"
     test_status(:) = 0
 
 
@@ -124,6 +184,7 @@ program calc_solar_zenith_angle_test
     call test_symmetric_noon(test_names(3), test_status(3))
     call test_invalid_minute(test_names(4), test_status(4))
     call test_invalid_day(test_names(5), test_status(5))
+    call test_kernel_equivalence(test_names(6), test_status(6))
 
     do i = 1, size(test_status)
         if (test_status(i) /= 0) then
@@ -0,0 +1,32 @@
+! conversion_jobs_test:
+!   Unit test for the `conversion_jobs` function in utils_mod.
+!
+!   Description:
+!     This program verifies that -j runs the requested number of processes on
+!     one rank without -batch, and that it is ignored with -batch, whose caches
+!     are kept in one process, and on several MPI ranks.
+!
+!   Notes:
+!     - Fails with a non-zero exit code if any number of processes is wrong.
+program conversion_jobs_test
+    use kinds, only : i_kind
+    use utils_mod, only : conversion_jobs
+    implicit none
+
+    if (conversion_jobs(4, 1, .false.) /= 4) then
+        print *, "Unexpected number of processes without -batch: ", conversion_jobs(4, 1, .false.)
+        stop 1
+    end if
+    if (conversion_jobs(4, 1, .true.) /= 1) then
+        print *, "-j not ignored with -batch: ", conversion_jobs(4, 1, .true.)
+        stop 1
+    end if
+    if (conversion_jobs(4, 2, .false.) /= 1) then
+        print *, "-j not ignored on several ranks: ", conversion_jobs(4, 2, .false.)
+        stop 1
+    end if
+    if (conversion_jobs(0, 1, .false.) /= 1) then
+        print *, "Unexpected number of processes for -j 0: ", conversion_jobs(0, 1, .false.)
+        stop 1
+    end if
+end program conversion_jobs_test
@@ -0,0 +1,38 @@
+! fork_process_test:
+!   Unit test for the `fork_process` and `wait_process` functions in utils_mod.
+!
+!   Description:
+!     This program forks a child that exits with a known status and verifies
+!     that the parent receives the child's process ID and exit code, and that
+!     waiting again reports that no child is left.
+!
+!   Notes:
+!     - Fails with a non-zero exit code if the process could not be forked or
+!       if any reported value is wrong.
+program fork_process_test
+    use kinds, only : i_kind
+    use utils_mod, only : fork_process, wait_process
+    implicit none
+    integer(i_kind) :: pid, child_pid, exit_status
+
+    pid = fork_process()
+    if (pid == 0) then
+        stop 3
+    end if
+    if (pid < 0) then
+        print *, "Failed to fork"
+        stop 1
+    end if
+
+    child_pid = wait_process(pid, exit_status)
+    if (child_pid /= pid .or. exit_status /= 3) then
+        print *, "Unexpected child: ", child_pid, " status: ", exit_status
+        stop 1
+    end if
+
+    child_pid = wait_process(-1, exit_status)
+    if (child_pid >= 0) then
+        print *, "Unexpected child left: ", child_pid
+        stop 1
+    end if
+end program fork_process_test
@@ -0,0 +1,45 @@
+! planck_radiance_to_bt_test:
+!   Unit test for the `planck_radiance_to_bt` subroutine in radiance_mod.
+!
+!   Description:
+!     This program verifies that the vectorized inverse Planck kernel matches the
+!     scalar formula previously used in `radiance_to_temperature`:
+!       T = (c2 / log(c1 / R + 1) - band_c1) / band_c2
+!     and that non-positive radiances are passed through unchanged.
+!
+!   Notes:
+!     - The coefficients approximate IASI channel 1 (645 cm-1).
+!     - Fails with a non-zero exit code if any converted value differs from the
+!       reference by more than the tolerance.
+program planck_radiance_to_bt_test
+    use kinds, only : i_kind, r_double
+    use radiance_mod, only : planck_radiance_to_bt
+    implicit none
+    integer(i_kind), parameter :: n = 7
+    real(r_double), parameter :: planck_c1 = 3.2137e-04_r_double
+    real(r_double), parameter :: planck_c2 = 928.0176_r_double
+    real(r_double), parameter :: band_c1 = 0.0_r_double
+    real(r_double), parameter :: band_c2 = 1.0_r_double
+    real(r_double), dimension(n) :: rad, expected
+    integer :: i
+
+    rad = [5.0e-05_r_double, 6.0e-05_r_double, 7.0e-05_r_double, 0.0_r_double, &
+           -999.0_r_double, 8.0e-05_r_double, 9.0e-05_r_double]
+    do i = 1, n
+        if (rad(i) > 0.0_r_double) then
+            expected(i) = (planck_c2 / log((planck_c1 / rad(i)) + 1.0_r_double) - band_c1) / band_c2
+        else
+            expected(i) = rad(i)
+        end if
+    end do
+
+    call planck_radiance_to_bt(n, rad, planck_c1, planck_c2, band_c1, band_c2)
+
+    do i = 1, n
+        if (abs(rad(i) - expected(i)) > 1.0e-9_r_double) then
+            print *, "Test failed for radiance ", i
+            print *, "Expected:", expected(i), "Got:", rad(i)
+            stop 1
+        end if
+    end do
+end program
@@ -0,0 +1,72 @@
+! qc_evaluate_test:
+!   Unit test for the `qc_evaluate` subroutine in qc_rules_mod.
+!
+!   Description:
+!     This program evaluates the built-in QC rules for a few prepbufr winds and
+!     temperatures and for satwnd AMVs, and verifies the use flags against the
+!     rules of GSI read_prepbufr.f90 and read_satwnd.f90. Report types
+!     without rules of their own, inside the range of those with rules,
+!     keep the default use flag.
+!
+!   Notes:
+!     - Fails with a non-zero exit code if any observation is used or rejected
+!       unexpectedly.
+program qc_evaluate_test
+    use kinds, only : i_kind, r_kind
+    use define_mod, only : missing_r
+    use qc_rules_mod, only : qc_evaluate, nqc_check, qc_qm, qc_prs, qc_qi, qc_satzen, qc_prs_land
+    implicit none
+    integer(i_kind), parameter :: n = 5
+    integer(i_kind) :: rptype(n), satid(n)
+    real(r_kind) :: cols(n, nqc_check)
+    logical :: used(n), listed(n)
+
+    ! winds: listed type, listed satellite with good and bad QI, unlisted satellite, bad QM
+    rptype = (/ 220, 243, 243, 243, 220 /)
+    satid = (/ 0, 55, 70, 57, 0 /)
+    cols(:,:) = missing_r
+    cols(:,qc_qm) = (/ 2.0, 1.0, 1.0, 1.0, 4.0 /)
+    cols(:,qc_qi) = (/ missing_r, 90.0, 80.0, 90.0, missing_r /)
+    call qc_evaluate('uv', n, rptype, satid, cols, .false., used, listed=listed)
+    call check(all(used .eqv. (/ .true., .true., .false., .false., .false. /)), "uv used")
+    call check(all(listed .eqv. (/ .true., .true., .true., .false., .true. /)), "uv listed")
+
+    ! winds: types without rules between listed ones, also with a satellite, keep the default
+    rptype = (/ 222, 225, 256, 241, 220 /)
+    satid = (/ 0, 0, 0, 55, 0 /)
+    cols(:,qc_qm) = 1.0
+    cols(:,qc_qi) = missing_r
+    call qc_evaluate('uv', n, rptype, satid, cols, .false., used, listed=listed)
+    call check(all(used .eqv. (/ .false., .false., .false., .false., .true. /)), "uv unlisted used")
+    call check(all(listed .eqv. (/ .false., .false., .false., .false., .true. /)), "uv unlisted listed")
+
+    ! temperatures: listed and unlisted types, missing QM passes
+    rptype = (/ 120, 130, 131, 180, 120 /)
+    satid = 0
+    cols(:,qc_qm) = (/ 1.0, 3.0, 1.0, missing_r, 9.0 /)
+    call qc_evaluate('t', n, rptype, satid, cols, .false., used)
+    call check(all(used .eqv. (/ .true., .true., .false., .true., .false. /)), "t used")
+
+    ! AMVs: used unless rejected; large zenith angle, low QI, high over land, low pressure
+    rptype = (/ 999, 245, 260, 245, 245 /)
+    cols(:,:) = missing_r
+    cols(:,qc_satzen) = (/ 30.0, 70.0, 30.0, 30.0, 30.0 /)
+    cols(:,qc_qi) = (/ missing_r, 95.0, 80.0, 95.0, 95.0 /)
+    cols(:,qc_prs) = (/ 50000.0, 50000.0, 50000.0, 90000.0, 10000.0 /)
+    cols(:,qc_prs_land) = (/ missing_r, missing_r, missing_r, 90000.0, missing_r /)
+    call qc_evaluate('amv', n, rptype, satid, cols, .true., used)
+    call check(all(used .eqv. (/ .true., .false., .false., .false., .false. /)), "amv used")
+
+contains
+
+    subroutine check(passed, name)
+        logical, intent(in) :: passed
+        character(*), intent(in) :: name
+
+        if (.not. passed) then
+            print *, "Unexpected QC result: ", name, used
+            stop 1
+        end if
+    end subroutine check
+
+end program qc_evaluate_test
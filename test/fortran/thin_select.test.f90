@@ -0,0 +1,65 @@
+! thin_select_test:
+!   Unit test for the `thin_select` subroutine in thinning_mod.
+!
+!   Description:
+!     Two locations 1 km apart share a 100 km box and a third one is far away.
+!     The test verifies which locations are kept with each selection criterion,
+!     that pressure and time bins split the shared box, and that locations
+!     with missing coordinates are always kept.
+!
+!   Notes:
+!     - Fails with a non-zero exit code if any kept location is wrong.
+program thin_select_test
+    use kinds, only : i_kind, i_llong, r_kind
+    use define_mod, only : missing_r
+    use thinning_mod, only : thin_select, thin_centre, thin_time, thin_qc
+    implicit none
+    integer(i_kind), parameter :: n = 3
+    real(r_kind) :: lat(n), lon(n), prs(n)
+    integer(i_llong) :: tim(n)
+    integer(i_kind) :: qm(n)
+    logical :: keep(n)
+
+    lat = (/ 10.0, 10.01, -30.0 /)
+    lon = (/ 20.0, 20.01, 200.0 /)
+    prs = (/ 85000.0, 50000.0, 85000.0 /)
+    tim = (/ 0_i_llong, 3000_i_llong, 3600_i_llong /)
+    qm = (/ 2, 0, 2 /)
+
+    ! one of the two close locations is kept
+    call thin_select(n, lat, lon, prs, tim, qm, 100.0_r_kind, 0.0_r_kind, 0.0_r_kind, thin_centre, keep)
+    call check(count(keep) == 2 .and. keep(3) .and. (keep(1) .neqv. keep(2)), "centre")
+
+    ! the better quality marker wins
+    call thin_select(n, lat, lon, prs, tim, qm, 100.0_r_kind, 0.0_r_kind, 0.0_r_kind, thin_qc, keep)
+    call check(all(keep .eqv. (/ .false., .true., .true. /)), "qc")
+
+    ! the location closer to the middle of the data window wins
+    call thin_select(n, lat, lon, prs, tim, qm, 100.0_r_kind, 0.0_r_kind, 0.0_r_kind, thin_time, keep)
+    call check(all(keep .eqv. (/ .false., .true., .true. /)), "time")
+
+    ! pressure and time bins separate the two close locations
+    call thin_select(n, lat, lon, prs, tim, qm, 100.0_r_kind, 100.0_r_kind, 0.0_r_kind, thin_centre, keep)
+    call check(all(keep), "pressure bins")
+    call thin_select(n, lat, lon, prs, tim, qm, 100.0_r_kind, 0.0_r_kind, 30.0_r_kind, thin_centre, keep)
+    call check(all(keep), "time bins")
+
+    ! a location without coordinates is kept
+    lat(1) = missing_r
+    lat(2) = 10.0
+    call thin_select(n, lat, lon, prs, tim, qm, 100.0_r_kind, 0.0_r_kind, 0.0_r_kind, thin_centre, keep)
+    call check(all(keep), "missing latitude")
+
+contains
+
+    subroutine check(passed, name)
+        logical, intent(in) :: passed
+        character(*), intent(in) :: name
+
+        if (.not. passed) then
+            print *, "Unexpected locations kept: ", name, keep
+            stop 1
+        end if
+    end subroutine check
+
+end program thin_select_test